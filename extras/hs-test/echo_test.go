@@ -1,12 +1,17 @@
 package main
 
 import (
+	"fmt"
+	"regexp"
+	"strconv"
+
 	. "fd.io/hs-test/infra"
+	"github.com/onsi/gomega/gmeasure"
 )
 
 func init() {
 	RegisterVethTests(EchoBuiltinTest)
-	RegisterSoloVethTests(TcpWithLossTest)
+	RegisterSoloVethTests(TcpWithLossTest, EchoBuiltinCpsTest)
 }
 
 func EchoBuiltinTest(s *VethsSuite) {
@@ -45,3 +50,34 @@ func TcpWithLossTest(s *VethsSuite) {
 	s.AssertNotEqual(len(output), 0)
 	s.AssertNotContains(output, "failed", output)
 }
+
+type echoCpsData struct {
+	vpp *VppInstance
+	uri string
+}
+
+var echoCpsRegexp = regexp.MustCompile(`three-way handshakes in [\d.]+ seconds ([\d.]+)/s`)
+
+func echoCpsBenchmark(s *HstSuite, experiment *gmeasure.Experiment, data interface{}) {
+	d, isValid := data.(echoCpsData)
+	s.AssertEqual(true, isValid)
+	o := d.vpp.Vppctl("test echo client nclients 1000 bytes 1 fifo-size 4k" +
+		" syn-timeout 100 test-timeout 100 uri " + d.uri)
+	s.Log(o)
+	s.AssertNotContains(o, "failed:")
+	match := echoCpsRegexp.FindStringSubmatch(o)
+	s.AssertEqual(2, len(match), o)
+	cps, err := strconv.ParseFloat(match[1], 64)
+	s.AssertNil(err, fmt.Sprint(err))
+	experiment.RecordValue("Connections per second", cps, gmeasure.Precision(0))
+}
+
+func EchoBuiltinCpsTest(s *VethsSuite) {
+	uri := "tcp://" + s.Interfaces.Server.Ip4AddressString() + "/1234"
+	serverVpp := s.Containers.ServerVpp.VppInstance
+
+	serverVpp.Vppctl("test echo server fifo-size 4k uri " + uri)
+
+	data := echoCpsData{vpp: s.Containers.ClientVpp.VppInstance, uri: uri}
+	s.RunBenchmark("Echo client connections per second", 5, 0, echoCpsBenchmark, data)
+}
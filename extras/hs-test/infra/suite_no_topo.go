@@ -126,7 +126,8 @@ func (s *NoTopoSuite) CreateNginxServer() {
 	)
 }
 
-func (s *NoTopoSuite) AddNginxVclConfig(multiThreadWorkers bool) {
+// mtWorkers is the vcl multi-thread-workers option, if any
+func (s *NoTopoSuite) AddNginxVclConfig(mtWorkers string) {
 	vclFileName := s.Containers.Nginx.GetHostWorkDir() + "/vcl.conf"
 	appSocketApi := fmt.Sprintf("app-socket-api %s/var/run/app_ns_sockets/default",
 		s.Containers.Nginx.GetContainerWorkDir())
@@ -142,8 +143,8 @@ func (s *NoTopoSuite) AddNginxVclConfig(multiThreadWorkers bool) {
 		Append("event-queue-size 100000").
 		Append("use-mq-eventfd").
 		Append(appSocketApi)
-	if multiThreadWorkers {
-		vclConf.Append("multi-thread-workers")
+	if mtWorkers != "" {
+		vclConf.Append(mtWorkers)
 	}
 
 	err := vclConf.Close().SaveToFile(vclFileName)
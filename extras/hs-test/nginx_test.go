@@ -12,7 +12,8 @@ import (
 func init() {
 	RegisterNoTopoTests(NginxHttp3Test, NginxAsServerTest, NginxPerfCpsTest, NginxPerfRpsTest, NginxPerfWrkTest,
 		NginxPerfCpsInterruptModeTest, NginxPerfRpsInterruptModeTest, NginxPerfWrkInterruptModeTest)
-	RegisterNoTopoSoloTests(NginxPerfRpsMultiThreadTest, NginxPerfCpsMultiThreadTest)
+	RegisterNoTopoSoloTests(NginxPerfRpsMultiThreadTest, NginxPerfCpsMultiThreadTest,
+		NginxPerfRpsMultiThreadLocklessTest, NginxPerfCpsMultiThreadLocklessTest)
 }
 
 func NginxHttp3Test(s *NoTopoSuite) {
@@ -44,7 +45,7 @@ func NginxAsServerTest(s *NoTopoSuite) {
 
 	s.Containers.Nginx.Create()
 	s.CreateNginxConfig(s.Containers.Nginx, false)
-	s.AddNginxVclConfig(false)
+	s.AddNginxVclConfig("")
 	s.Containers.Nginx.Start()
 
 	vpp := s.Containers.Vpp.VppInstance
@@ -70,7 +71,7 @@ func parseString(s, pattern string) string {
 	return ""
 }
 
-func runNginxPerf(s *NoTopoSuite, mode, ab_or_wrk string, multiThreadWorkers bool) error {
+func runNginxPerf(s *NoTopoSuite, mode, ab_or_wrk string, mtWorkers string) error {
 	nRequests := 1000000
 	nClients := 1000
 
@@ -79,8 +80,8 @@ func runNginxPerf(s *NoTopoSuite, mode, ab_or_wrk string, multiThreadWorkers boo
 	vpp := s.Containers.Vpp.VppInstance
 
 	s.Containers.Nginx.Create()
-	s.AddNginxVclConfig(multiThreadWorkers)
-	s.CreateNginxConfig(s.Containers.Nginx, multiThreadWorkers)
+	s.AddNginxVclConfig(mtWorkers)
+	s.CreateNginxConfig(s.Containers.Nginx, mtWorkers != "")
 	s.Containers.Nginx.Start()
 	vpp.WaitForApp("nginx-", 5)
 
@@ -121,11 +122,15 @@ func NginxPerfCpsInterruptModeTest(s *NoTopoSuite) {
 }
 
 func NginxPerfCpsMultiThreadTest(s *NoTopoSuite) {
-	s.AssertNil(runNginxPerf(s, "cps", "ab", true))
+	s.AssertNil(runNginxPerf(s, "cps", "ab", "multi-thread-workers"))
+}
+
+func NginxPerfCpsMultiThreadLocklessTest(s *NoTopoSuite) {
+	s.AssertNil(runNginxPerf(s, "cps", "ab", "multi-thread-workers lockless"))
 }
 
 func NginxPerfCpsTest(s *NoTopoSuite) {
-	s.AssertNil(runNginxPerf(s, "cps", "ab", false))
+	s.AssertNil(runNginxPerf(s, "cps", "ab", ""))
 }
 
 func NginxPerfRpsInterruptModeTest(s *NoTopoSuite) {
@@ -133,11 +138,15 @@ func NginxPerfRpsInterruptModeTest(s *NoTopoSuite) {
 }
 
 func NginxPerfRpsMultiThreadTest(s *NoTopoSuite) {
-	s.AssertNil(runNginxPerf(s, "rps", "ab", true))
+	s.AssertNil(runNginxPerf(s, "rps", "ab", "multi-thread-workers"))
+}
+
+func NginxPerfRpsMultiThreadLocklessTest(s *NoTopoSuite) {
+	s.AssertNil(runNginxPerf(s, "rps", "ab", "multi-thread-workers lockless"))
 }
 
 func NginxPerfRpsTest(s *NoTopoSuite) {
-	s.AssertNil(runNginxPerf(s, "rps", "ab", false))
+	s.AssertNil(runNginxPerf(s, "rps", "ab", ""))
 }
 
 func NginxPerfWrkInterruptModeTest(s *NoTopoSuite) {
@@ -145,5 +154,5 @@ func NginxPerfWrkInterruptModeTest(s *NoTopoSuite) {
 }
 
 func NginxPerfWrkTest(s *NoTopoSuite) {
-	s.AssertNil(runNginxPerf(s, "", "wrk", false))
+	s.AssertNil(runNginxPerf(s, "", "wrk", ""))
 }
@@ -0,0 +1,215 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/plugin/plugin.h>
+#include <vnet/crypto/crypto.h>
+#include <native/crypto_native.h>
+#include <vppinfra/crypto/chacha20_poly1305.h>
+
+#if __GNUC__ > 4 && !__clang__ && CLIB_DEBUG == 0
+#pragma GCC optimize("O3")
+#endif
+
+static_always_inline u32
+chacha20_poly1305_ops (vnet_crypto_op_t *ops[], u32 n_ops,
+		       vnet_crypto_op_chunk_t *chunks, int is_enc, u32 fixed,
+		       u32 aad_len)
+{
+  crypto_native_main_t *cm = &crypto_native_main;
+  clib_chacha20_poly1305_ctx_t ctx[CHACHA20_MAX_LANES];
+  clib_chacha20_poly1305_ctx_t *cp[CHACHA20_MAX_LANES];
+  const u8 *keys[CHACHA20_MAX_LANES], *nonces[CHACHA20_MAX_LANES];
+  const u8 *src[CHACHA20_MAX_LANES];
+  u8 *dst[CHACHA20_MAX_LANES];
+  u32 len[CHACHA20_MAX_LANES];
+  vnet_crypto_op_t *op = ops[0];
+  u32 n_left = n_ops, n_fail = 0;
+
+  for (int i = 0; i < CHACHA20_MAX_LANES; i++)
+    cp[i] = ctx + i;
+
+  while (n_left)
+    {
+      u32 n = clib_min (n_left, CHACHA20_MAX_LANES);
+
+      /* one-time poly1305 keys of up to CHACHA20_MAX_LANES ops are
+       * calculated in parallel */
+      for (u32 i = 0; i < n; i++)
+	{
+	  keys[i] = cm->key_data[op[i].key_index];
+	  nonces[i] = op[i].iv;
+	}
+      clib_chacha20_poly1305_init_multi (cp, keys, nonces, n);
+
+      for (u32 i = 0; i < n; i++)
+	clib_chacha20_poly1305_aad (cp[i], op[i].aad,
+				    fixed ? aad_len : op[i].aad_len);
+
+      if (chunks)
+	{
+	  for (u32 i = 0; i < n; i++)
+	    {
+	      clib_chacha20_poly1305_ctx_t *c = cp[i];
+	      vnet_crypto_op_chunk_t *chp = chunks + op[i].chunk_index;
+
+	      if (!(op[i].flags & VNET_CRYPTO_OP_FLAG_CHAINED_BUFFERS))
+		{
+		  if (is_enc)
+		    clib_chacha20_poly1305_enc_update (c, op[i].src, op[i].dst,
+						       op[i].len);
+		  else
+		    clib_chacha20_poly1305_dec_update (c, op[i].src, op[i].dst,
+						       op[i].len);
+		  continue;
+		}
+
+	      for (int j = 0; j < op[i].n_chunks; j++, chp++)
+		if (is_enc)
+		  clib_chacha20_poly1305_enc_update (c, chp->src, chp->dst,
+						     chp->len);
+		else
+		  clib_chacha20_poly1305_dec_update (c, chp->src, chp->dst,
+						     chp->len);
+	    }
+	}
+      else
+	{
+	  /* keystream blocks of all ops are computed together */
+	  for (u32 i = 0; i < n; i++)
+	    {
+	      src[i] = op[i].src;
+	      dst[i] = op[i].dst;
+	      len[i] = op[i].len;
+	    }
+	  if (is_enc)
+	    clib_chacha20_poly1305_enc_update_multi (cp, src, dst, len, n);
+	  else
+	    clib_chacha20_poly1305_dec_update_multi (cp, src, dst, len, n);
+	}
+
+      for (u32 i = 0; i < n; i++, op++)
+	{
+	  clib_chacha20_poly1305_ctx_t *c = cp[i];
+
+	  if (is_enc)
+	    {
+	      clib_chacha20_poly1305_final (c, op->tag);
+	      op->status = VNET_CRYPTO_OP_STATUS_COMPLETED;
+	    }
+	  else if (clib_chacha20_poly1305_final_verify (
+		     c, op->tag, fixed ? 16 : op->tag_len))
+	    op->status = VNET_CRYPTO_OP_STATUS_COMPLETED;
+	  else
+	    {
+	      op->status = VNET_CRYPTO_OP_STATUS_FAIL_BAD_HMAC;
+	      n_fail++;
+	    }
+	}
+
+      n_left -= n;
+    }
+
+  return n_ops - n_fail;
+}
+
+static void *
+chacha20_poly1305_key_exp (vnet_crypto_key_t *key)
+{
+  u8 *kd;
+
+  kd = clib_mem_alloc_aligned (CHACHA20_KEY_SIZE, CLIB_CACHE_LINE_BYTES);
+  clib_memcpy_fast (kd, key->data, CHACHA20_KEY_SIZE);
+
+  return kd;
+}
+
+#define foreach_chacha20_poly1305_handler_type                                \
+  _ (, 0, 0)                                                                  \
+  _ (_tag16_aad0, 1, 0)                                                       \
+  _ (_tag16_aad8, 1, 8)                                                       \
+  _ (_tag16_aad12, 1, 12)
+
+#define _(n, f, a)                                                            \
+  static u32 chacha20_poly1305_enc##n (vlib_main_t *vm,                       \
+				       vnet_crypto_op_t *ops[], u32 n_ops)    \
+  {                                                                           \
+    return chacha20_poly1305_ops (ops, n_ops, 0, 1, f, a);                    \
+  }                                                                           \
+  static u32 chacha20_poly1305_dec##n (vlib_main_t *vm,                       \
+				       vnet_crypto_op_t *ops[], u32 n_ops)    \
+  {                                                                           \
+    return chacha20_poly1305_ops (ops, n_ops, 0, 0, f, a);                    \
+  }                                                                           \
+  static u32 chacha20_poly1305_enc##n##_chained (                             \
+    vlib_main_t *vm, vnet_crypto_op_t *ops[], vnet_crypto_op_chunk_t *chunks, \
+    u32 n_ops)                                                                \
+  {                                                                           \
+    return chacha20_poly1305_ops (ops, n_ops, chunks, 1, f, a);               \
+  }                                                                           \
+  static u32 chacha20_poly1305_dec##n##_chained (                             \
+    vlib_main_t *vm, vnet_crypto_op_t *ops[], vnet_crypto_op_chunk_t *chunks, \
+    u32 n_ops)                                                                \
+  {                                                                           \
+    return chacha20_poly1305_ops (ops, n_ops, chunks, 0, f, a);               \
+  }
+
+foreach_chacha20_poly1305_handler_type;
+#undef _
+
+static int
+probe ()
+{
+#if defined(__AVX512F__)
+  if (clib_cpu_supports_avx512f ())
+    return 30;
+#elif defined(__AVX2__)
+  if (clib_cpu_supports_avx2 ())
+    return 20;
+#elif defined(__SSE4_2__)
+  if (clib_cpu_supports_sse42 ())
+    return 10;
+#elif __aarch64__
+  return 10;
+#endif
+  return -1;
+}
+
+CRYPTO_NATIVE_OP_HANDLER (chacha20_poly1305_enc) = {
+  .op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_ENC,
+  .fn = chacha20_poly1305_enc,
+  .cfn = chacha20_poly1305_enc_chained,
+  .probe = probe,
+};
+
+CRYPTO_NATIVE_OP_HANDLER (chacha20_poly1305_dec) = {
+  .op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_DEC,
+  .fn = chacha20_poly1305_dec,
+  .cfn = chacha20_poly1305_dec_chained,
+  .probe = probe,
+};
+
+#define _(a)                                                                  \
+  CRYPTO_NATIVE_OP_HANDLER (chacha20_poly1305_tag16_aad##a##_enc) = {         \
+    .op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_TAG16_AAD##a##_ENC,             \
+    .fn = chacha20_poly1305_enc_tag16_aad##a,                                 \
+    .cfn = chacha20_poly1305_enc_tag16_aad##a##_chained,                      \
+    .probe = probe,                                                           \
+  };                                                                          \
+                                                                              \
+  CRYPTO_NATIVE_OP_HANDLER (chacha20_poly1305_tag16_aad##a##_dec) = {         \
+    .op_id = VNET_CRYPTO_OP_CHACHA20_POLY1305_TAG16_AAD##a##_DEC,             \
+    .fn = chacha20_poly1305_dec_tag16_aad##a,                                 \
+    .cfn = chacha20_poly1305_dec_tag16_aad##a##_chained,                      \
+    .probe = probe,                                                           \
+  };
+
+_ (0) _ (8) _ (12)
+#undef _
+
+CRYPTO_NATIVE_KEY_HANDLER (chacha20_poly1305) = {
+  .alg_id = VNET_CRYPTO_ALG_CHACHA20_POLY1305,
+  .key_fn = chacha20_poly1305_key_exp,
+  .probe = probe,
+};
@@ -39,6 +39,7 @@
 
 #include "fa_node.h"
 #include "public_inlines.h"
+#include "tree_lookup.h"
 
 acl_main_t acl_main;
 
@@ -2560,6 +2561,23 @@ acl_set_aclplugin_fn (vlib_main_t * vm,
       am->use_hash_acl_matching = (val != 0);
       goto done;
     }
+  if (unformat (input, "lookup-context %u engine", &val))
+    {
+      acl_lookup_engine_t engine;
+      if (unformat (input, "tree"))
+	engine = ACL_LOOKUP_ENGINE_TREE;
+      else if (unformat (input, "hash"))
+	engine = ACL_LOOKUP_ENGINE_HASH;
+      else
+	{
+	  error = clib_error_return (0, "expecting engine tree|hash, got `%U`",
+				     format_unformat_error, input);
+	  goto done;
+	}
+      if (acl_plugin_set_lookup_engine_for_context (val, engine))
+	error = clib_error_return (0, "lookup context %u does not exist", val);
+      goto done;
+    }
   if (unformat (input, "l4-match-nonfirst-fragment %u", &val))
     {
       am->l4_match_nonfirst_fragment = (val != 0);
@@ -2570,6 +2588,11 @@ acl_set_aclplugin_fn (vlib_main_t * vm,
       am->reclassify_sessions = (val != 0);
       goto done;
     }
+  if (unformat (input, "shared-sessions %u", &val))
+    {
+      am->shared_sessions = (val != 0);
+      goto done;
+    }
   if (unformat (input, "event-trace"))
     {
       if (!unformat (input, "%u", &val))
@@ -3583,6 +3606,7 @@ acl_plugin_show_sessions (acl_main_t * am,
 		   ((f64) am->fa_current_cleaner_timer_wait_interval) *
 		   1000.0 / (f64) vm->clib_time.clocks_per_second);
   vlib_cli_output (vm, "Reclassify sessions: %d", am->reclassify_sessions);
+  vlib_cli_output (vm, "Shared sessions: %d", am->shared_sessions);
 }
 
 static clib_error_t *
@@ -3620,6 +3644,8 @@ acl_show_aclplugin_tables_fn (vlib_main_t * vm,
   int show_mask_type = 0;
   int show_bihash = 0;
   u32 show_bihash_verbose = 0;
+  int show_tree = 0;
+  u32 show_tree_verbose = 0;
 
   if (unformat (input, "acl"))
     {
@@ -3642,16 +3668,23 @@ acl_show_aclplugin_tables_fn (vlib_main_t * vm,
       show_bihash = 1;
       unformat (input, "verbose %u", &show_bihash_verbose);
     }
+  else if (unformat (input, "tree"))
+    {
+      show_tree = 1;
+      unformat (input, "lc_index %u", &lc_index);
+      unformat (input, "verbose %u", &show_tree_verbose);
+    }
 
   if (!
       (show_mask_type || show_acl_hash_info || show_applied_info
-       || show_bihash))
+       || show_bihash || show_tree))
     {
       /* if no qualifiers specified, show all */
       show_mask_type = 1;
       show_acl_hash_info = 1;
       show_applied_info = 1;
       show_bihash = 1;
+      show_tree = 1;
     }
   vlib_cli_output (vm, "Stats counters enabled for interface ACLs: %d",
 		   acl_main.interface_acl_counters_enabled);
@@ -3665,6 +3698,8 @@ acl_show_aclplugin_tables_fn (vlib_main_t * vm,
     acl_plugin_show_tables_applied_info (lc_index);
   if (show_bihash)
     acl_plugin_show_tables_bihash (show_bihash_verbose);
+  if (show_tree)
+    acl_plugin_show_tables_tree (lc_index, show_tree_verbose);
 
   return error;
 }
@@ -3730,7 +3765,7 @@ VLIB_CLI_COMMAND (aclplugin_show_sessions_command, static) = {
 
 VLIB_CLI_COMMAND (aclplugin_show_tables_command, static) = {
     .path = "show acl-plugin tables",
-    .short_help = "show acl-plugin tables [ acl [index N] | applied [ lc_index N ] | mask | hash [verbose N] ]",
+    .short_help = "show acl-plugin tables [ acl [index N] | applied [ lc_index N ] | mask | hash [verbose N] | tree [lc_index N] [verbose N] ]",
     .function = acl_show_aclplugin_tables_fn,
 };
 
@@ -3867,6 +3902,7 @@ acl_plugin_config (vlib_main_t * vm, unformat_input_t * input)
   u32 hash_lookup_hash_buckets;
   uword hash_lookup_hash_memory;
   u32 reclassify_sessions;
+  u32 shared_sessions;
   u32 use_tuple_merge;
   u32 tuple_merge_split_threshold;
 
@@ -3916,6 +3952,9 @@ acl_plugin_config (vlib_main_t * vm, unformat_input_t * input)
 			 &reclassify_sessions))
 	am->reclassify_sessions = reclassify_sessions;
 
+      else if (unformat (input, "shared sessions %d", &shared_sessions))
+	am->shared_sessions = shared_sessions;
+
       else
 	return clib_error_return (0, "unknown input '%U'",
 				  format_unformat_error, input);
@@ -3963,6 +4002,7 @@ acl_init (vlib_main_t * vm)
     ACL_FA_CONN_TABLE_DEFAULT_HASH_MEMORY_SIZE;
   am->fa_conn_table_max_entries = ACL_FA_CONN_TABLE_DEFAULT_MAX_ENTRIES;
   am->reclassify_sessions = 0;
+  am->shared_sessions = 0;
   vlib_thread_main_t *tm = vlib_get_thread_main ();
 
   am->fa_min_deleted_sessions_per_interval =
@@ -32,6 +32,7 @@
 #include "types.h"
 #include "fa_node.h"
 #include "hash_lookup_types.h"
+#include "tree_lookup_types.h"
 #include "lookup_context.h"
 
 #define  ACL_PLUGIN_VERSION_MAJOR 1
@@ -137,6 +138,10 @@ typedef struct {
 */
   applied_hash_ace_entry_t **hash_entry_vec_by_lc_index;
   applied_hash_acl_info_t *applied_hash_acl_info_by_lc_index;
+  /* decision trees of the lookup contexts using the tree engine */
+  applied_tree_acl_info_t *applied_tree_acl_info_by_lc_index;
+  /* lookup contexts whose trees are waiting to be (re)built */
+  uword *tree_acl_pending_lc_bitmap;
 
   /* Corresponding lookup context indices for in/out lookups per sw_if_index */
   u32 *input_lc_index_by_sw_if_index;
@@ -168,6 +173,12 @@ typedef struct {
   /* whether we need to take the epoch of the session into account */
   int reclassify_sessions;
 
+  /*
+   * whether the sessions may be tracked by any worker without
+   * signalling the owner, e.g. when RSS is asymmetric
+   */
+  int shared_sessions;
+
 
 
   /* Total count of interface+direction pairs enabled */
@@ -52,6 +52,7 @@ _(ACL_EXIST_SESSION, "existing session packets") \
 _(ACL_CHECK, "checked packets") \
 _(ACL_RESTART_SESSION_TIMER, "restart session timer") \
 _(ACL_TOO_MANY_SESSIONS, "too many sessions to add new") \
+_(ACL_SHARED_SESSION, "existing shared session packets on non-owner thread") \
 /* end  of errors */
 
 typedef enum
@@ -189,11 +190,30 @@ process_established_session (vlib_main_t * vm, acl_main_t * am,
   fa_session_t *sess = get_session_ptr_no_check (am, f_sess_id.thread_index,
 						 f_sess_id.session_index);
 
+  int is_foreign = f_sess_id.thread_index != os_get_thread_index ();
   int old_timeout_type = fa_session_get_timeout_type (am, sess);
-  action =
-    acl_fa_track_session (am, is_input, sw_if_index[0], now,
-			  sess, &fa_5tuple[0], pkt_len);
+  if (PREDICT_FALSE (am->shared_sessions))
+    {
+      action = acl_fa_track_shared_session (am, is_input, now, sess,
+					    &fa_5tuple[0]);
+      if (is_foreign)
+	vlib_node_increment_counter (vm, counter_node_index,
+				     ACL_FA_ERROR_ACL_SHARED_SESSION, 1);
+    }
+  else
+    action =
+      acl_fa_track_session (am, is_input, sw_if_index[0], now,
+			    sess, &fa_5tuple[0], pkt_len);
   int new_timeout_type = fa_session_get_timeout_type (am, sess);
+  /*
+   * A shared session owned by another worker whose timeout grows
+   * does not need to be requeued right away: the owner will find it
+   * still active at the idle check and requeue it to the right list.
+   */
+  if (PREDICT_FALSE (am->shared_sessions) && is_foreign
+      && am->session_timeout_sec[new_timeout_type] >=
+      am->session_timeout_sec[old_timeout_type])
+    old_timeout_type = new_timeout_type;
   /* Tracking might have changed the session timeout type, e.g. from transient to established */
   if (PREDICT_FALSE (old_timeout_type != new_timeout_type))
     {
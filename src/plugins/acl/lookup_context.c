@@ -18,6 +18,7 @@
 #include <vlib/unix/plugin.h>
 #include <plugins/acl/public_inlines.h>
 #include "hash_lookup.h"
+#include "tree_lookup.h"
 #include "elog_acl_trace.h"
 
 /* check if a given ACL exists */
@@ -114,6 +115,7 @@ static int acl_plugin_get_lookup_context_index (u32 acl_user_id, u32 val1, u32 v
   acontext->context_user_id = acl_user_id;
   acontext->user_val1 = val1;
   acontext->user_val2 = val2;
+  acontext->lookup_engine = ACL_LOOKUP_ENGINE_HASH;
 
   u32 new_context_id = acontext - am->acl_lookup_contexts;
   vec_add1(am->acl_users[acl_user_id].lookup_contexts, new_context_id);
@@ -205,6 +207,7 @@ static void acl_plugin_put_lookup_context_index (u32 lc_index)
   vec_del1(am->acl_users[acontext->context_user_id].lookup_contexts, index);
   unapply_acl_vec(lc_index, acontext->acl_indices);
   unlock_acl_vec(lc_index, acontext->acl_indices);
+  tree_acl_lc_free(am, lc_index);
   vec_free(acontext->acl_indices);
   pool_put(am->acl_lookup_contexts, acontext);
 }
@@ -258,6 +261,7 @@ static int acl_plugin_set_acl_vec_for_context (u32 lc_index, u32 *acl_list)
   unlock_acl_vec(lc_index, old_acl_vector);
   lock_acl_vec(lc_index, acontext->acl_indices);
   apply_acl_vec(lc_index, acontext->acl_indices);
+  tree_acl_lc_update(am, lc_index);
 
   vec_free(old_acl_vector);
 
@@ -280,6 +284,35 @@ void acl_plugin_lookup_context_notify_acl_change(u32 acl_num)
     /* this is a deletion notification */
     hash_acl_delete(am, acl_num);
   }
+  if (acl_num < vec_len(am->lc_index_vec_by_acl)) {
+    u32 *lc_index;
+    vec_foreach(lc_index, am->lc_index_vec_by_acl[acl_num]) {
+      tree_acl_lc_update(am, *lc_index);
+    }
+  }
+}
+
+/*
+ * Select the lookup engine of a context. The tree engine compiles
+ * the ACLs of the context into a decision tree, which is rebuilt
+ * every time the ACLs change.
+ */
+int acl_plugin_set_lookup_engine_for_context (u32 lc_index, acl_lookup_engine_t engine)
+{
+  acl_main_t *am = &acl_main;
+  acl_lookup_context_t *acontext;
+
+  if (!acl_lc_index_valid(am, lc_index))
+    return VNET_API_ERROR_NO_SUCH_ENTRY;
+
+  acontext = pool_elt_at_index(am->acl_lookup_contexts, lc_index);
+  if (acontext->lookup_engine == engine)
+    return 0;
+
+  elog_acl_cond_trace_X2(am, (am->trace_acl), "LOOKUP-CONTEXT: set-engine lc_index %d engine %d", "i4i4", lc_index, engine);
+  acontext->lookup_engine = engine;
+  tree_acl_lc_update(am, lc_index);
+  return 0;
 }
 
 
@@ -339,9 +372,10 @@ acl_plugin_show_lookup_context (u32 lc_index)
     if ((lc_index == ~0) || (curr_lc_index == lc_index)) {
       if (acl_user_id_valid(am, acontext->context_user_id)) {
         acl_lookup_context_user_t *auser = pool_elt_at_index(am->acl_users, acontext->context_user_id);
-        vlib_cli_output (vm, "index %d:%s %s: %d %s: %d, acl_indices: %U",
+        vlib_cli_output (vm, "index %d:%s %s: %d %s: %d, engine: %s, acl_indices: %U",
                        curr_lc_index, auser->user_module_name, auser->val1_label,
                        acontext->user_val1, auser->val2_label, acontext->user_val2,
+                       acontext->lookup_engine == ACL_LOOKUP_ENGINE_TREE ? "tree" : "hash",
                        format_vec32, acontext->acl_indices, "%d");
       } else {
         vlib_cli_output (vm, "index %d: user_id: %d user_val1: %d user_val2: %d, acl_indices: %U",
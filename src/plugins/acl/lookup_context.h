@@ -27,6 +27,13 @@ typedef struct {
   u32 *lookup_contexts;
 } acl_lookup_context_user_t;
 
+typedef enum {
+  /* hash or linear matching, as per use_hash_acl_matching */
+  ACL_LOOKUP_ENGINE_HASH = 0,
+  /* compiled decision tree */
+  ACL_LOOKUP_ENGINE_TREE,
+} acl_lookup_engine_t;
+
 typedef struct {
   /* vector of acl #s within this context */
   u32 *acl_indices;
@@ -36,9 +43,12 @@ typedef struct {
   u32 user_val1;
   /* per-instance user value 2 */
   u32 user_val2;
+  /* lookup engine used for this context */
+  acl_lookup_engine_t lookup_engine;
 } acl_lookup_context_t;
 
 void acl_plugin_lookup_context_notify_acl_change(u32 acl_num);
+int acl_plugin_set_lookup_engine_for_context (u32 lc_index, acl_lookup_engine_t engine);
 
 void acl_plugin_show_lookup_context (u32 lc_index);
 void acl_plugin_show_lookup_user (u32 user_index);
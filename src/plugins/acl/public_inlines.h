@@ -649,6 +649,57 @@ hash_multi_acl_match_5tuple (void *p_acl_main, u32 lc_index, fa_5tuple_t * pkt_5
 
 
 
+always_inline tree_acl_t *
+acl_plugin_lc_tree (acl_main_t * am, u32 lc_index, int is_ip6)
+{
+  if (PREDICT_TRUE (lc_index >= vec_len (am->applied_tree_acl_info_by_lc_index)))
+    return 0;
+  return clib_atomic_load_acq_n (&am->applied_tree_acl_info_by_lc_index[lc_index].trees[is_ip6]);
+}
+
+always_inline int
+tree_multi_acl_match_5tuple (acl_main_t * am, tree_acl_t * tree, fa_5tuple_t * pkt_5tuple,
+                       int is_ip6, u8 *action, u32 *acl_pos_p, u32 * acl_match_p,
+                       u32 * rule_match_p, u32 * trace_bitmap)
+{
+  tree_acl_node_t *node = tree->nodes;
+  u32 v[TREE_ACL_N_DIMS];
+  u32 i, *leaf_rules;
+
+  if (is_ip6) {
+    v[TREE_ACL_DIM_SRC_ADDR] = clib_net_to_host_u32 (pkt_5tuple->ip6_addr[0].as_u32[0]);
+    v[TREE_ACL_DIM_DST_ADDR] = clib_net_to_host_u32 (pkt_5tuple->ip6_addr[1].as_u32[0]);
+  } else {
+    v[TREE_ACL_DIM_SRC_ADDR] = clib_net_to_host_u32 (pkt_5tuple->ip4_addr[0].as_u32);
+    v[TREE_ACL_DIM_DST_ADDR] = clib_net_to_host_u32 (pkt_5tuple->ip4_addr[1].as_u32);
+  }
+  v[TREE_ACL_DIM_SRC_PORT] = pkt_5tuple->l4.port[0];
+  v[TREE_ACL_DIM_DST_PORT] = pkt_5tuple->l4.port[1];
+  v[TREE_ACL_DIM_PROTO] = pkt_5tuple->l4.proto;
+
+  while (node->dim != TREE_ACL_DIM_LEAF)
+    node = tree->nodes + node->index + ((v[node->dim] >> node->shift) & node->mask);
+
+  /* the decision was made by the tree engine */
+  *trace_bitmap |= 0x20000000;
+
+  /* the leaf rules are in priority order, the first match wins */
+  leaf_rules = tree->leaf_rules + node->index;
+  for (i = 0; i < node->n_rules; i++) {
+    tree_acl_rule_t *r = tree->rules + leaf_rules[i];
+    if (single_rule_match_5tuple (&r->rule, is_ip6, pkt_5tuple)) {
+      r->hitcount++;
+      *acl_pos_p = r->acl_position;
+      *acl_match_p = r->acl_index;
+      *rule_match_p = r->ace_index;
+      *action = r->rule.is_permit;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+
 always_inline int
 acl_plugin_match_5tuple_inline (void *p_acl_main, u32 lc_index,
                                            fa_5tuple_opaque_t * pkt_5tuple,
@@ -660,7 +711,12 @@ acl_plugin_match_5tuple_inline (void *p_acl_main, u32 lc_index,
 {
   acl_main_t *am = p_acl_main;
   fa_5tuple_t * pkt_5tuple_internal = (fa_5tuple_t *)pkt_5tuple;
+  tree_acl_t *tree = acl_plugin_lc_tree (am, lc_index, is_ip6);
   pkt_5tuple_internal->pkt.lc_index = lc_index;
+  if (PREDICT_FALSE(tree != 0) && !pkt_5tuple_internal->pkt.is_nonfirst_fragment) {
+    return tree_multi_acl_match_5tuple(am, tree, pkt_5tuple_internal, is_ip6, r_action,
+                                 r_acl_pos_p, r_acl_match_p, r_rule_match_p, trace_bitmap);
+  }
   if (PREDICT_TRUE(am->use_hash_acl_matching)) {
     if (PREDICT_FALSE(pkt_5tuple_internal->pkt.is_nonfirst_fragment)) {
       /*
@@ -695,8 +751,12 @@ acl_plugin_match_5tuple_inline_and_count (void *p_acl_main, u32 lc_index,
   acl_main_t *am = p_acl_main;
   int ret = 0;
   fa_5tuple_t * pkt_5tuple_internal = (fa_5tuple_t *)pkt_5tuple;
+  tree_acl_t *tree = acl_plugin_lc_tree (am, lc_index, is_ip6);
   pkt_5tuple_internal->pkt.lc_index = lc_index;
-  if (PREDICT_TRUE(am->use_hash_acl_matching)) {
+  if (PREDICT_FALSE(tree != 0) && !pkt_5tuple_internal->pkt.is_nonfirst_fragment) {
+    ret = tree_multi_acl_match_5tuple(am, tree, pkt_5tuple_internal, is_ip6, r_action,
+                                 r_acl_pos_p, r_acl_match_p, r_rule_match_p, trace_bitmap);
+  } else if (PREDICT_TRUE(am->use_hash_acl_matching)) {
     if (PREDICT_FALSE(pkt_5tuple_internal->pkt.is_nonfirst_fragment)) {
       /*
        * tuplemerge does not take fragments into account,
@@ -566,6 +566,67 @@ send_interrupts_to_workers (vlib_main_t * vm, acl_main_t * am)
     }
 }
 
+/*
+ * Peek, from the cleaner process, at the head of a list of a running
+ * worker. The worker may requeue or free the session meanwhile, so the
+ * head and the enqueue time are read with atomic loads; the session pools
+ * are fixed-size, so the memory stays valid. A stale answer only costs
+ * a spurious interrupt, or delays the check by one cleaner cycle.
+ */
+static int
+acl_fa_conn_list_head_is_due (acl_main_t * am, acl_fa_per_worker_data_t * pw,
+			      u64 now, u8 list_id)
+{
+  u32 session_index =
+    clib_atomic_load_relax_n (&pw->fa_conn_list_head[list_id]);
+  u64 enqueue_time;
+  fa_session_t *sess;
+
+  /* also covers FA_SESSION_BOGUS_INDEX */
+  if (session_index >= vec_len (pw->fa_sessions_pool))
+    return 0;
+  sess = pw->fa_sessions_pool + session_index;
+  enqueue_time = clib_atomic_load_relax_n (&sess->link_enqueue_time);
+  return (enqueue_time + fa_session_get_list_timeout (am, sess) < now)
+    || (enqueue_time <= clib_atomic_load_relax_n (&pw->swipe_end_time));
+}
+
+/*
+ * Find the workers which have sessions due for the check or pending
+ * cleaner work. In the shared sessions mode only those get interrupted,
+ * so the cost of a cleaner cycle does not grow with the number of idle
+ * workers.
+ */
+static void
+acl_fa_get_due_workers (acl_main_t * am, u64 now, uword ** due_workers)
+{
+  u16 ti;
+  u8 tt;
+
+  clib_bitmap_zero (*due_workers);
+  for (ti = 0; ti < vec_len (am->per_worker_data); ti++)
+    {
+      acl_fa_per_worker_data_t *pw = &am->per_worker_data[ti];
+      int is_due = clib_atomic_load_relax_n (&pw->interrupt_is_needed)
+	|| clib_atomic_load_relax_n (&pw->clear_in_process);
+
+      if (!is_due)
+	{
+	  /* the reschedule requests posted by the other workers */
+	  clib_spinlock_lock_if_init
+	    (&pw->pending_session_change_request_lock);
+	  is_due = vec_len (pw->pending_session_change_requests) != 0;
+	  clib_spinlock_unlock_if_init
+	    (&pw->pending_session_change_request_lock);
+	}
+
+      for (tt = 0; !is_due && tt < vec_len (pw->fa_conn_list_head); tt++)
+	is_due = acl_fa_conn_list_head_is_due (am, pw, now, tt);
+      if (is_due)
+	*due_workers = clib_bitmap_set (*due_workers, ti, 1);
+    }
+}
+
 /* centralized process to drive per-worker cleaners */
 static uword
 acl_fa_session_cleaner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
@@ -578,6 +639,7 @@ acl_fa_session_cleaner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
   /* We should check if there are connections to clean up - at least twice a second */
   u64 max_timer_wait_interval = cpu_cps / 2;
   uword event_type, *event_data = 0;
+  uword *due_workers = 0;
   acl_fa_per_worker_data_t *pw0;
 
   am->fa_current_cleaner_timer_wait_interval = max_timer_wait_interval;
@@ -784,7 +846,23 @@ acl_fa_session_cleaner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	  break;
 	}
 
-      send_interrupts_to_workers (vm, am);
+      if (am->shared_sessions)
+	{
+	  uword wi;
+
+	  acl_fa_get_due_workers (am, clib_cpu_time_now (), &due_workers);
+	  clib_bitmap_foreach (wi, due_workers)
+	    {
+	      send_one_worker_interrupt (vm, am, wi);
+	    }
+	}
+      else
+	{
+	  send_interrupts_to_workers (vm, am);
+	  clib_bitmap_zero (due_workers);
+	  due_workers = clib_bitmap_set_region (due_workers, 0, 1,
+						vec_len (am->per_worker_data));
+	}
 
       if (event_data)
 	vec_set_len (event_data, 0);
@@ -800,7 +878,8 @@ acl_fa_session_cleaner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	  need_more_wait = 0;
 	  vec_foreach (pw0, am->per_worker_data)
 	  {
-	    if (pw0->interrupt_generation != am->fa_interrupt_generation)
+	    if (clib_bitmap_get (due_workers, pw0 - am->per_worker_data)
+		&& pw0->interrupt_generation != am->fa_interrupt_generation)
 	      {
 		need_more_wait = 1;
 	      }
@@ -291,6 +291,26 @@ acl_fa_track_session (acl_main_t * am, int is_input, u32 sw_if_index, u64 now,
   return 3;
 }
 
+/*
+ * With shared sessions any worker may see the packets of a session,
+ * so the activity timestamp and the TCP flags are updated atomically.
+ * The owner picks up the new values when the session comes up
+ * for the idle check.
+ */
+always_inline u8
+acl_fa_track_shared_session (acl_main_t * am, int is_input, u64 now,
+			     fa_session_t * sess, fa_5tuple_t * pkt_5tuple)
+{
+  u8 *flags_seen = &sess->tcp_flags_seen.as_u8[is_input];
+  u8 pkt_flags = pkt_5tuple->pkt.tcp_flags;
+
+  clib_atomic_store_relax_n (&sess->last_active_time, now);
+  if (pkt_5tuple->pkt.tcp_flags_valid
+      && PREDICT_FALSE ((*flags_seen | pkt_flags) != *flags_seen))
+    clib_atomic_fetch_or (flags_seen, pkt_flags);
+  return 3;
+}
+
 always_inline u64
 reverse_l4_u64_fastpath (u64 l4, int is_ip6)
 {
@@ -500,13 +520,30 @@ acl_fa_try_recycle_session (acl_main_t * am, int is_input, u16 thread_index,
       sess_id.session_index = pw->fa_conn_list_head[ACL_TIMEOUT_PURGATORY];
     }
   sess_id.session_index = pw->fa_conn_list_head[ACL_TIMEOUT_TCP_TRANSIENT];
-  if (FA_SESSION_BOGUS_INDEX != sess_id.session_index)
+  while (FA_SESSION_BOGUS_INDEX != sess_id.session_index)
     {
       sess_id.thread_index = thread_index;
+      fa_session_t *sess =
+	get_session_ptr (am, sess_id.thread_index, sess_id.session_index);
+      if (fa_session_get_timeout_type (am, sess) != ACL_TIMEOUT_TCP_TRANSIENT)
+	{
+	  /*
+	   * Established by another worker and not requeued yet,
+	   * move it to the right list rather than recycle it.
+	   */
+	  if (n_recycled++ >= am->fa_max_deleted_sessions_per_interval)
+	    break;
+	  acl_fa_conn_list_delete_session (am, sess_id, now);
+	  acl_fa_conn_list_add_session (am, sess_id, now);
+	  sess_id.session_index =
+	    pw->fa_conn_list_head[ACL_TIMEOUT_TCP_TRANSIENT];
+	  continue;
+	}
       acl_fa_conn_list_delete_session (am, sess_id, now);
       acl_fa_deactivate_session (am, sw_if_index, sess_id);
       /* this goes to purgatory list */
       acl_fa_conn_list_add_session (am, sess_id, now);
+      break;
     }
 }
 
@@ -0,0 +1,552 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+/*
+ * Decision tree lookup engine.
+ *
+ * The rules of all the ACLs of a lookup context are compiled into
+ * a HiCuts-style decision tree [1]: each internal node cuts the range of
+ * one dimension of its region into 2^k equal parts, until the number
+ * of rules overlapping a region is small enough to be matched linearly.
+ * Unlike the hash engine, the lookup cost does not depend on how many
+ * rules share a mask or overlap in port ranges, only on the tree depth
+ * and the leaf size.
+ *
+ * [1] Pankaj Gupta, Nick McKeown "Packet Classification using Hierarchical
+ * Intelligent Cuttings", In Proc. Hot Interconnects VII, 1999
+ */
+
+#include <vlib/vlib.h>
+#include <vnet/vnet.h>
+#include <acl/acl.h>
+#include <acl/public_inlines.h>
+
+#include "tree_lookup.h"
+
+/* a leaf is not cut further when it has at most this many rules */
+#define TREE_ACL_LEAF_MAX_RULES 8
+/*
+ * The rules replicated into the children of a node, plus the children
+ * themselves, are at most this many times the rules of the node.
+ */
+#define TREE_ACL_SPACE_FACTOR	4
+#define TREE_ACL_MAX_DEPTH	24
+#define TREE_ACL_MAX_LOG2_CUTS	8
+/* stop cutting once the leaves hold this many copies of each rule */
+#define TREE_ACL_MAX_REPLICATION 64
+
+static const u8 tree_acl_dim_width[TREE_ACL_N_DIMS] = { 32, 32, 16, 16, 8 };
+
+typedef struct
+{
+  u32 lo[TREE_ACL_N_DIMS];
+  u32 hi[TREE_ACL_N_DIMS];
+} tree_acl_range_t;
+
+typedef struct
+{
+  tree_acl_t *tree;
+  /* range of each rule in each dimension */
+  tree_acl_range_t *ranges;
+  u32 max_leaf_rules;
+} tree_acl_build_ctx_t;
+
+static void
+tree_acl_prefix_range (ip46_address_t *addr, u8 prefixlen, int is_ip6,
+		       u32 *lo, u32 *hi)
+{
+  u32 v = is_ip6 ? clib_net_to_host_u32 (addr->ip6.as_u32[0]) :
+		   clib_net_to_host_u32 (addr->ip4.as_u32);
+  u32 mask = prefixlen ? ~0 << (32 - clib_min (prefixlen, 32)) : 0;
+
+  *lo = v & mask;
+  *hi = *lo | ~mask;
+}
+
+static void
+tree_acl_rule_range (acl_rule_t *r, tree_acl_range_t *rr)
+{
+  tree_acl_prefix_range (&r->src, r->src_prefixlen, r->is_ipv6,
+			 &rr->lo[TREE_ACL_DIM_SRC_ADDR],
+			 &rr->hi[TREE_ACL_DIM_SRC_ADDR]);
+  tree_acl_prefix_range (&r->dst, r->dst_prefixlen, r->is_ipv6,
+			 &rr->lo[TREE_ACL_DIM_DST_ADDR],
+			 &rr->hi[TREE_ACL_DIM_DST_ADDR]);
+  if (r->proto)
+    {
+      rr->lo[TREE_ACL_DIM_PROTO] = rr->hi[TREE_ACL_DIM_PROTO] = r->proto;
+      rr->lo[TREE_ACL_DIM_SRC_PORT] = r->src_port_or_type_first;
+      rr->hi[TREE_ACL_DIM_SRC_PORT] = r->src_port_or_type_last;
+      rr->lo[TREE_ACL_DIM_DST_PORT] = r->dst_port_or_code_first;
+      rr->hi[TREE_ACL_DIM_DST_PORT] = r->dst_port_or_code_last;
+    }
+  else
+    {
+      /* the ports are not looked at when the protocol is a wildcard */
+      rr->lo[TREE_ACL_DIM_PROTO] = 0;
+      rr->hi[TREE_ACL_DIM_PROTO] = 0xff;
+      rr->lo[TREE_ACL_DIM_SRC_PORT] = rr->lo[TREE_ACL_DIM_DST_PORT] = 0;
+      rr->hi[TREE_ACL_DIM_SRC_PORT] = rr->hi[TREE_ACL_DIM_DST_PORT] = 0xffff;
+    }
+}
+
+/* The children of a region that a rule overlaps when cut at a given shift */
+static_always_inline void
+tree_acl_rule_cuts (tree_acl_range_t *rr, u32 dim, u32 lo, u8 width,
+		    u8 shift, u32 *c_lo, u32 *c_hi)
+{
+  u64 hi = (u64) lo + (1ULL << width) - 1;
+  u64 rlo = clib_max ((u64) rr->lo[dim], (u64) lo);
+  u64 rhi = clib_min ((u64) rr->hi[dim], hi);
+
+  *c_lo = (rlo - lo) >> shift;
+  *c_hi = (rhi - lo) >> shift;
+}
+
+static int
+tree_acl_u64_cmp (void *a1, void *a2)
+{
+  u64 *v1 = a1, *v2 = a2;
+
+  return (*v1 > *v2) - (*v1 < *v2);
+}
+
+/* The number of different ranges the rules have within the region */
+static u32
+tree_acl_count_distinct (tree_acl_build_ctx_t *ctx, u32 *rules, u32 dim,
+			 u32 lo, u8 width)
+{
+  u64 *keys = 0, hi = (u64) lo + (1ULL << width) - 1;
+  u32 *ri, i, n_distinct = 0;
+
+  vec_foreach (ri, rules)
+    {
+      tree_acl_range_t *rr = vec_elt_at_index (ctx->ranges, *ri);
+      u64 rlo = clib_max ((u64) rr->lo[dim], (u64) lo);
+      u64 rhi = clib_min ((u64) rr->hi[dim], hi);
+      vec_add1 (keys, (rlo << 32) | rhi);
+    }
+
+  vec_sort_with_function (keys, tree_acl_u64_cmp);
+  for (i = 0; i < vec_len (keys); i++)
+    if (i == 0 || keys[i] != keys[i - 1])
+      n_distinct++;
+
+  vec_free (keys);
+  return n_distinct;
+}
+
+/* Pick the largest number of cuts that stays within the space factor */
+static u8
+tree_acl_choose_log2_cuts (tree_acl_build_ctx_t *ctx, u32 *rules, u32 dim,
+			   u32 lo, u8 width)
+{
+  u8 log2_cuts = 1, max_log2_cuts = clib_min (width, TREE_ACL_MAX_LOG2_CUTS);
+  u32 *ri, c_lo, c_hi;
+  u64 space;
+
+  while (log2_cuts < max_log2_cuts)
+    {
+      u8 shift = width - (log2_cuts + 1);
+
+      space = 1ULL << (log2_cuts + 1);
+      vec_foreach (ri, rules)
+	{
+	  tree_acl_rule_cuts (vec_elt_at_index (ctx->ranges, *ri), dim, lo,
+			      width, shift, &c_lo, &c_hi);
+	  space += c_hi - c_lo + 1;
+	}
+      if (space > (u64) TREE_ACL_SPACE_FACTOR * vec_len (rules))
+	break;
+      log2_cuts++;
+    }
+
+  return log2_cuts;
+}
+
+static void
+tree_acl_build_node (tree_acl_build_ctx_t *ctx, u32 node_index, u32 *rules,
+		     u32 *lo, u8 *width, u32 depth)
+{
+  tree_acl_t *tree = ctx->tree;
+  u32 n_rules = vec_len (rules);
+  u32 best_dim = ~0, best_distinct = 1;
+  u32 **children = 0, *ri, dim, c, c_lo, c_hi, saved_lo, first_child;
+  tree_acl_node_t *node;
+  u8 log2_cuts, shift;
+  int progress = 0;
+
+  tree->max_depth = clib_max (tree->max_depth, depth);
+
+  if (n_rules <= TREE_ACL_LEAF_MAX_RULES || depth >= TREE_ACL_MAX_DEPTH ||
+      vec_len (tree->leaf_rules) > ctx->max_leaf_rules)
+    goto leaf;
+
+  /* cut the dimension where the rules differ most */
+  for (dim = 0; dim < TREE_ACL_N_DIMS; dim++)
+    {
+      u32 n_distinct;
+
+      if (width[dim] == 0)
+	continue;
+      n_distinct =
+	tree_acl_count_distinct (ctx, rules, dim, lo[dim], width[dim]);
+      if (n_distinct > best_distinct)
+	{
+	  best_distinct = n_distinct;
+	  best_dim = dim;
+	}
+    }
+
+  if (best_dim == ~0)
+    goto leaf;
+
+  dim = best_dim;
+  log2_cuts = tree_acl_choose_log2_cuts (ctx, rules, dim, lo[dim], width[dim]);
+  shift = width[dim] - log2_cuts;
+
+  vec_validate (children, (1 << log2_cuts) - 1);
+  vec_foreach (ri, rules)
+    {
+      tree_acl_rule_cuts (vec_elt_at_index (ctx->ranges, *ri), dim, lo[dim],
+			  width[dim], shift, &c_lo, &c_hi);
+      for (c = c_lo; c <= c_hi; c++)
+	vec_add1 (children[c], *ri);
+    }
+
+  /* cutting is pointless if every child inherits all the rules */
+  for (c = 0; c < vec_len (children); c++)
+    if (vec_len (children[c]) < n_rules)
+      progress = 1;
+
+  if (!progress)
+    {
+      for (c = 0; c < vec_len (children); c++)
+	vec_free (children[c]);
+      vec_free (children);
+      goto leaf;
+    }
+
+  first_child = vec_len (tree->nodes);
+  vec_validate (tree->nodes, first_child + vec_len (children) - 1);
+
+  node = vec_elt_at_index (tree->nodes, node_index);
+  node->dim = dim;
+  node->shift = shift;
+  node->mask = (1 << log2_cuts) - 1;
+  node->index = first_child;
+  node->n_rules = n_rules;
+
+  saved_lo = lo[dim];
+  width[dim] -= log2_cuts;
+  for (c = 0; c < vec_len (children); c++)
+    {
+      lo[dim] = saved_lo + (c << shift);
+      tree_acl_build_node (ctx, first_child + c, children[c], lo, width,
+			   depth + 1);
+      vec_free (children[c]);
+    }
+  lo[dim] = saved_lo;
+  width[dim] += log2_cuts;
+
+  vec_free (children);
+  return;
+
+leaf:
+  node = vec_elt_at_index (tree->nodes, node_index);
+  node->dim = TREE_ACL_DIM_LEAF;
+  node->index = vec_len (tree->leaf_rules);
+  node->n_rules = n_rules;
+  vec_append (tree->leaf_rules, rules);
+  tree->n_leaves++;
+}
+
+static tree_acl_t *
+tree_acl_build (acl_main_t *am, acl_lookup_context_t *acontext, int is_ip6)
+{
+  tree_acl_build_ctx_t ctx = {};
+  u32 lo[TREE_ACL_N_DIMS] = {};
+  u8 width[TREE_ACL_N_DIMS];
+  f64 start = vlib_time_now (am->vlib_main);
+  u32 *rule_indices = 0;
+  tree_acl_rule_t *tr;
+  tree_acl_t *tree;
+  u32 i, j;
+
+  tree = clib_mem_alloc (sizeof (*tree));
+  clib_memset (tree, 0, sizeof (*tree));
+
+  /* the rules in the order they would be tried by the linear lookup */
+  for (i = 0; i < vec_len (acontext->acl_indices); i++)
+    {
+      u32 acl_index = acontext->acl_indices[i];
+      acl_rule_t *rules;
+
+      if (pool_is_free_index (am->acls, acl_index))
+	continue;
+
+      rules = am->acls[acl_index].rules;
+      for (j = 0; j < vec_len (rules); j++)
+	{
+	  if (rules[j].is_ipv6 != is_ip6)
+	    continue;
+	  vec_add2 (tree->rules, tr, 1);
+	  tr->rule = rules[j];
+	  tr->acl_position = i;
+	  tr->acl_index = acl_index;
+	  tr->ace_index = j;
+	  tr->hitcount = 0;
+	}
+    }
+
+  vec_validate (ctx.ranges, vec_len (tree->rules));
+  for (i = 0; i < vec_len (tree->rules); i++)
+    {
+      tree_acl_rule_range (&tree->rules[i].rule, &ctx.ranges[i]);
+      vec_add1 (rule_indices, i);
+    }
+
+  ctx.tree = tree;
+  ctx.max_leaf_rules = TREE_ACL_MAX_REPLICATION * vec_len (tree->rules);
+  clib_memcpy_fast (width, tree_acl_dim_width, sizeof (width));
+
+  vec_validate (tree->nodes, 0);
+  tree_acl_build_node (&ctx, 0, rule_indices, lo, width, 0);
+
+  vec_free (rule_indices);
+  vec_free (ctx.ranges);
+
+  tree->build_time = vlib_time_now (am->vlib_main) - start;
+  return tree;
+}
+
+static void
+tree_acl_free (tree_acl_t *tree)
+{
+  if (!tree)
+    return;
+  vec_free (tree->nodes);
+  vec_free (tree->leaf_rules);
+  vec_free (tree->rules);
+  clib_mem_free (tree);
+}
+
+/*
+ * Replace the trees of a lookup context. Publishing a tree where there
+ * was none is safe while the workers run; growing the vector or retiring
+ * a tree they may be walking is not, so those take the worker barrier,
+ * once, unless the caller already holds it.
+ */
+static void
+tree_acl_lc_swap (acl_main_t *am, u32 lc_index, tree_acl_t **new_trees)
+{
+  applied_tree_acl_info_t *ati;
+  tree_acl_t *old_trees[2] = {};
+  int need_barrier = 0;
+  int i;
+
+  if (lc_index < vec_len (am->applied_tree_acl_info_by_lc_index))
+    {
+      ati = vec_elt_at_index (am->applied_tree_acl_info_by_lc_index, lc_index);
+      old_trees[0] = ati->trees[0];
+      old_trees[1] = ati->trees[1];
+    }
+  else
+    need_barrier = 1;
+
+  if (!new_trees[0] && !new_trees[1] && !old_trees[0] && !old_trees[1])
+    return;
+
+  if (old_trees[0] || old_trees[1])
+    need_barrier = 1;
+  if (vlib_worker_thread_barrier_held ())
+    need_barrier = 0;
+
+  if (need_barrier)
+    vlib_worker_thread_barrier_sync (am->vlib_main);
+
+  vec_validate (am->applied_tree_acl_info_by_lc_index, lc_index);
+  ati = vec_elt_at_index (am->applied_tree_acl_info_by_lc_index, lc_index);
+  for (i = 0; i < 2; i++)
+    clib_atomic_store_rel_n (&ati->trees[i], new_trees[i]);
+
+  if (need_barrier)
+    vlib_worker_thread_barrier_release (am->vlib_main);
+
+  /* no worker can reach the old trees anymore */
+  for (i = 0; i < 2; i++)
+    tree_acl_free (old_trees[i]);
+}
+
+typedef enum
+{
+  TREE_ACL_EVENT_BUILD = 1,
+} tree_acl_process_event_t;
+
+static vlib_node_registration_t tree_acl_build_process_node;
+
+void
+tree_acl_lc_update (acl_main_t *am, u32 lc_index)
+{
+  acl_lookup_context_t *acontext =
+    pool_elt_at_index (am->acl_lookup_contexts, lc_index);
+  tree_acl_t *no_trees[2] = {};
+
+  /*
+   * The trees compiled from the previous ACLs are dropped right away,
+   * the hash or linear lookups stand in for them until the build process
+   * has compiled the new ones, off the worker barrier the caller holds.
+   */
+  tree_acl_lc_swap (am, lc_index, no_trees);
+
+  if (acontext->lookup_engine != ACL_LOOKUP_ENGINE_TREE)
+    {
+      am->tree_acl_pending_lc_bitmap =
+	clib_bitmap_set (am->tree_acl_pending_lc_bitmap, lc_index, 0);
+      return;
+    }
+
+  am->tree_acl_pending_lc_bitmap =
+    clib_bitmap_set (am->tree_acl_pending_lc_bitmap, lc_index, 1);
+  vlib_process_signal_event (am->vlib_main,
+			     tree_acl_build_process_node.index,
+			     TREE_ACL_EVENT_BUILD, 0);
+}
+
+void
+tree_acl_lc_free (acl_main_t *am, u32 lc_index)
+{
+  tree_acl_t *no_trees[2] = {};
+
+  am->tree_acl_pending_lc_bitmap =
+    clib_bitmap_set (am->tree_acl_pending_lc_bitmap, lc_index, 0);
+  tree_acl_lc_swap (am, lc_index, no_trees);
+}
+
+static uword
+tree_acl_build_process (vlib_main_t *vm, vlib_node_runtime_t *rt,
+			vlib_frame_t *f)
+{
+  acl_main_t *am = &acl_main;
+  u32 *lc_indices = 0, *lc_index, i;
+
+  while (1)
+    {
+      vlib_process_wait_for_event (vm);
+      vlib_process_get_events (vm, 0);
+
+      /*
+       * The process does not suspend between reading the ACLs and
+       * publishing the trees, so they cannot change under the build.
+       */
+      clib_bitmap_foreach (i, am->tree_acl_pending_lc_bitmap)
+	vec_add1 (lc_indices, i);
+      clib_bitmap_zero (am->tree_acl_pending_lc_bitmap);
+
+      vec_foreach (lc_index, lc_indices)
+	{
+	  acl_lookup_context_t *acontext;
+	  tree_acl_t *new_trees[2];
+
+	  if (pool_is_free_index (am->acl_lookup_contexts, *lc_index))
+	    continue;
+	  acontext = pool_elt_at_index (am->acl_lookup_contexts, *lc_index);
+	  if (acontext->lookup_engine != ACL_LOOKUP_ENGINE_TREE)
+	    continue;
+
+	  new_trees[0] = tree_acl_build (am, acontext, 0 /* is_ip6 */);
+	  new_trees[1] = tree_acl_build (am, acontext, 1 /* is_ip6 */);
+	  tree_acl_lc_swap (am, *lc_index, new_trees);
+	}
+      vec_reset_length (lc_indices);
+    }
+
+  return 0;
+}
+
+VLIB_REGISTER_NODE (tree_acl_build_process_node, static) = {
+  .function = tree_acl_build_process,
+  .type = VLIB_NODE_TYPE_PROCESS,
+  .name = "acl-plugin-tree-build-process",
+};
+
+static void
+acl_plugin_print_tree (vlib_main_t *vm, tree_acl_t *tree, int is_ip6,
+		       u32 verbose)
+{
+  u32 i;
+
+  vlib_cli_output (vm,
+		   "  %s: rules %u nodes %u leaves %u leaf rules %u "
+		   "max depth %u build time %.6f",
+		   is_ip6 ? "ip6" : "ip4", vec_len (tree->rules),
+		   vec_len (tree->nodes), tree->n_leaves,
+		   vec_len (tree->leaf_rules), tree->max_depth,
+		   tree->build_time);
+
+  if (verbose < 1)
+    return;
+
+  for (i = 0; i < vec_len (tree->rules); i++)
+    {
+      tree_acl_rule_t *tr = &tree->rules[i];
+      vlib_cli_output (vm,
+		       "    rule %4u: acl %u rule %u acl_pos %u hitcount %llu",
+		       i, tr->acl_index, tr->ace_index, tr->acl_position,
+		       tr->hitcount);
+    }
+
+  if (verbose < 2)
+    return;
+
+  for (i = 0; i < vec_len (tree->nodes); i++)
+    {
+      tree_acl_node_t *node = &tree->nodes[i];
+
+      if (node->dim == TREE_ACL_DIM_LEAF)
+	{
+	  u8 *s = 0;
+	  u32 j;
+
+	  for (j = 0; j < node->n_rules; j++)
+	    s = format (s, "%s%u", j ? ", " : "",
+			tree->leaf_rules[node->index + j]);
+	  vlib_cli_output (vm, "    %6u: leaf rules %v", i, s);
+	  vec_free (s);
+	}
+      else
+	vlib_cli_output (vm,
+			 "    %6u: dim %u shift %u cuts %u children %u "
+			 "rules %u",
+			 i, node->dim, node->shift, node->mask + 1,
+			 node->index, node->n_rules);
+    }
+}
+
+void
+acl_plugin_show_tables_tree (u32 lc_index, u32 verbose)
+{
+  acl_main_t *am = &acl_main;
+  vlib_main_t *vm = am->vlib_main;
+  u32 lci;
+  int is_ip6;
+
+  vlib_cli_output (vm, "Decision trees for lookup contexts");
+
+  for (lci = 0; lci < vec_len (am->applied_tree_acl_info_by_lc_index); lci++)
+    {
+      applied_tree_acl_info_t *ati =
+	vec_elt_at_index (am->applied_tree_acl_info_by_lc_index, lci);
+
+      if ((lc_index != ~0) && (lc_index != lci))
+	continue;
+      if (!ati->trees[0] && !ati->trees[1])
+	continue;
+
+      vlib_cli_output (vm, "lc_index %d:", lci);
+      for (is_ip6 = 0; is_ip6 < 2; is_ip6++)
+	if (ati->trees[is_ip6])
+	  acl_plugin_print_tree (vm, ati->trees[is_ip6], is_ip6, verbose);
+    }
+}
@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+#ifndef _ACL_TREE_LOOKUP_H_
+#define _ACL_TREE_LOOKUP_H_
+
+#include "lookup_context.h"
+#include "acl.h"
+
+/*
+ * Drop the decision trees of a lookup context and, if it uses the tree
+ * engine, schedule their recompilation from its current ACL vector.
+ */
+void tree_acl_lc_update (acl_main_t *am, u32 lc_index);
+
+/* Release the decision trees of a lookup context */
+void tree_acl_lc_free (acl_main_t *am, u32 lc_index);
+
+void acl_plugin_show_tables_tree (u32 lc_index, u32 verbose);
+
+#endif
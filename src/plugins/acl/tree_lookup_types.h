@@ -0,0 +1,74 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+#ifndef _ACL_TREE_LOOKUP_TYPES_H_
+#define _ACL_TREE_LOOKUP_TYPES_H_
+
+#include "types.h"
+
+/*
+ * The dimensions the decision tree cuts on. For IPv6 only the
+ * most significant 32 bits of the addresses are used for the cuts,
+ * the leaf rules are always matched in full.
+ */
+typedef enum
+{
+  TREE_ACL_DIM_SRC_ADDR = 0,
+  TREE_ACL_DIM_DST_ADDR,
+  TREE_ACL_DIM_SRC_PORT,
+  TREE_ACL_DIM_DST_PORT,
+  TREE_ACL_DIM_PROTO,
+  TREE_ACL_N_DIMS,
+} tree_acl_dim_t;
+
+#define TREE_ACL_DIM_LEAF 0xff
+
+typedef struct
+{
+  /* dimension this node cuts, or TREE_ACL_DIM_LEAF */
+  u8 dim;
+  /* child index is (value >> shift) & mask */
+  u8 shift;
+  u16 mask;
+  /* first child in the node vector, or first entry in leaf_rules */
+  u32 index;
+  /* number of rules in the leaf */
+  u32 n_rules;
+} tree_acl_node_t;
+
+typedef struct
+{
+  acl_rule_t rule;
+  /* the position of the ACL in the lookup context, the ACL# and rule# */
+  u32 acl_position;
+  u32 acl_index;
+  u32 ace_index;
+  /* matches since the tree was built, like the applied hash ACE hitcount */
+  u64 hitcount;
+} tree_acl_rule_t;
+
+/*
+ * A decision tree compiled from the ACLs of one lookup context,
+ * for one address family. The root is nodes[0].
+ */
+typedef struct
+{
+  tree_acl_node_t *nodes;
+  /* indices into rules, in priority order within each leaf */
+  u32 *leaf_rules;
+  /* applied rules in priority order */
+  tree_acl_rule_t *rules;
+  /* build statistics */
+  u32 max_depth;
+  u32 n_leaves;
+  f64 build_time;
+} tree_acl_t;
+
+typedef struct
+{
+  /* the compiled trees, [is_ip6] */
+  tree_acl_t *trees[2];
+} applied_tree_acl_info_t;
+
+#endif
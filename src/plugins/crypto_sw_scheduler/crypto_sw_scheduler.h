@@ -25,6 +25,14 @@ STATIC_ASSERT ((0 == (CRYPTO_SW_SCHEDULER_QUEUE_SIZE &
 		      (CRYPTO_SW_SCHEDULER_QUEUE_SIZE - 1))),
 	       "CRYPTO_SW_SCHEDULER_QUEUE_SIZE is not pow2");
 
+/* number of frame elements a worker claims at once, so a large frame can
+ * be processed by several workers in parallel */
+#define CRYPTO_SW_SCHEDULER_SUB_BATCH_SIZE 16
+
+/* consecutive batches a worker takes from its own queues before it gives
+ * backlogged peers a chance */
+#define CRYPTO_SW_SCHEDULER_MAX_OWN_BATCHES 8
+
 typedef enum crypto_sw_scheduler_queue_type_t_
 {
   CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT = 0,
@@ -32,19 +40,30 @@ typedef enum crypto_sw_scheduler_queue_type_t_
   CRYPTO_SW_SCHED_QUEUE_N_TYPES
 } crypto_sw_scheduler_queue_type_t;
 
+typedef struct
+{
+  vnet_crypto_async_frame_t *frame;
+  /* queue position of the job (bits 32-63), number of frame elements
+   * (bits 16-31) and first unclaimed element (bits 0-15), updated with
+   * compare and swap so claims on a recycled slot fail */
+  u64 claim;
+  /* number of processed elements */
+  u16 n_done;
+  u8 error;
+} crypto_sw_scheduler_job_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   u32 head;
   u32 tail;
-  vnet_crypto_async_frame_t **jobs;
+  crypto_sw_scheduler_job_t *jobs;
 } crypto_sw_scheduler_queue_t;
 
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
   crypto_sw_scheduler_queue_t queue[CRYPTO_SW_SCHED_QUEUE_N_TYPES];
-  u32 last_serve_lcore_id;
   u8 last_serve_encrypt;
   u8 last_return_queue;
   vnet_crypto_op_t *crypto_ops;
@@ -53,6 +72,17 @@ typedef struct
   vnet_crypto_op_t *chained_integ_ops;
   vnet_crypto_op_chunk_t *chunks;
   u8 self_crypto_enabled;
+  u8 n_own_batches;
+
+  /* counters */
+  u64 n_stolen_batches;
+  u64 n_stolen_elts;
+  u64 n_remote_numa_batches;
+
+  /* updated by all workers */
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
+  /* frame elements enqueued on this thread and not claimed yet */
+  u32 n_unclaimed;
 } crypto_sw_scheduler_per_thread_data_t;
 
 typedef struct
@@ -61,6 +91,8 @@ typedef struct
   crypto_sw_scheduler_per_thread_data_t *per_thread_data;
   vnet_crypto_key_t *keys;
   u32 crypto_sw_scheduler_queue_mask;
+  /* idle workers do not steal frames enqueued on another numa node */
+  u8 numa_local_steal_only;
 } crypto_sw_scheduler_main_t;
 
 extern crypto_sw_scheduler_main_t crypto_sw_scheduler_main;
@@ -83,9 +83,11 @@ crypto_sw_scheduler_frame_enqueue (vlib_main_t *vm,
   crypto_sw_scheduler_queue_t *current_queue =
     is_enc ? &ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT] :
 	     &ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT];
-  u64 head = current_queue->head;
+  u32 head = current_queue->head;
+  crypto_sw_scheduler_job_t *job =
+    current_queue->jobs + (head & cm->crypto_sw_scheduler_queue_mask);
 
-  if (current_queue->jobs[head & cm->crypto_sw_scheduler_queue_mask])
+  if (job->frame)
     {
       u32 n_elts = frame->n_elts, i;
       for (i = 0; i < n_elts; i++)
@@ -93,10 +95,17 @@ crypto_sw_scheduler_frame_enqueue (vlib_main_t *vm,
       return -1;
     }
 
-  current_queue->jobs[head & cm->crypto_sw_scheduler_queue_mask] = frame;
-  head += 1;
+  if (PREDICT_FALSE (frame->n_elts == 0))
+    frame->state = VNET_CRYPTO_FRAME_STATE_SUCCESS;
+
+  job->frame = frame;
+  job->n_done = 0;
+  job->error = 0;
+  clib_atomic_store_rel_n (&job->claim,
+			   (u64) head << 32 | (u64) frame->n_elts << 16);
+  clib_atomic_fetch_add (&ptd->n_unclaimed, frame->n_elts);
   CLIB_MEMORY_STORE_BARRIER ();
-  current_queue->head = head;
+  current_queue->head = head + 1;
   return 0;
 }
 
@@ -311,15 +320,17 @@ process_chained_ops (vlib_main_t * vm, vnet_crypto_async_frame_t * f,
     }
 }
 
-static_always_inline void
+/* process n_elts elements of the frame starting at first, returns state of
+ * the processed batch */
+static_always_inline u8
 crypto_sw_scheduler_process_aead (vlib_main_t *vm,
 				  crypto_sw_scheduler_per_thread_data_t *ptd,
-				  vnet_crypto_async_frame_t *f, u32 aead_op,
-				  u32 aad_len, u32 digest_len)
+				  vnet_crypto_async_frame_t *f, u32 first,
+				  u32 n_elts, u32 aead_op, u32 aad_len,
+				  u32 digest_len)
 {
   vnet_crypto_async_frame_elt_t *fe;
   u32 *bi;
-  u32 n_elts = f->n_elts;
   u8 state = VNET_CRYPTO_FRAME_STATE_SUCCESS;
 
   vec_reset_length (ptd->crypto_ops);
@@ -328,36 +339,37 @@ crypto_sw_scheduler_process_aead (vlib_main_t *vm,
   vec_reset_length (ptd->chained_integ_ops);
   vec_reset_length (ptd->chunks);
 
-  fe = f->elts;
-  bi = f->buffer_indices;
+  fe = f->elts + first;
+  bi = f->buffer_indices + first;
 
   while (n_elts--)
     {
       if (n_elts > 1)
 	clib_prefetch_load (fe + 1);
 
+      /* other batches of the frame may fail */
+      fe->status = VNET_CRYPTO_OP_STATUS_COMPLETED;
       crypto_sw_scheduler_convert_aead (vm, ptd, fe, fe - f->elts, bi[0],
 					aead_op, aad_len, digest_len);
       bi++;
       fe++;
     }
 
-      process_ops (vm, f, ptd->crypto_ops, &state);
-      process_chained_ops (vm, f, ptd->chained_crypto_ops, ptd->chunks,
-			   &state);
-      f->state = state;
+  process_ops (vm, f, ptd->crypto_ops, &state);
+  process_chained_ops (vm, f, ptd->chained_crypto_ops, ptd->chunks, &state);
+  return state;
 }
 
-static_always_inline void
+static_always_inline u8
 crypto_sw_scheduler_process_link (vlib_main_t *vm,
 				  crypto_sw_scheduler_main_t *cm,
 				  crypto_sw_scheduler_per_thread_data_t *ptd,
-				  vnet_crypto_async_frame_t *f, u32 crypto_op,
-				  u32 auth_op, u16 digest_len, u8 is_enc)
+				  vnet_crypto_async_frame_t *f, u32 first,
+				  u32 n_elts, u32 crypto_op, u32 auth_op,
+				  u16 digest_len, u8 is_enc)
 {
   vnet_crypto_async_frame_elt_t *fe;
   u32 *bi;
-  u32 n_elts = f->n_elts;
   u8 state = VNET_CRYPTO_FRAME_STATE_SUCCESS;
 
   vec_reset_length (ptd->crypto_ops);
@@ -365,14 +377,15 @@ crypto_sw_scheduler_process_link (vlib_main_t *vm,
   vec_reset_length (ptd->chained_crypto_ops);
   vec_reset_length (ptd->chained_integ_ops);
   vec_reset_length (ptd->chunks);
-  fe = f->elts;
-  bi = f->buffer_indices;
+  fe = f->elts + first;
+  bi = f->buffer_indices + first;
 
   while (n_elts--)
     {
       if (n_elts > 1)
 	clib_prefetch_load (fe + 1);
 
+      fe->status = VNET_CRYPTO_OP_STATUS_COMPLETED;
       crypto_sw_scheduler_convert_link_crypto (
 	vm, ptd, cm->keys + fe->key_index, fe, fe - f->elts, bi[0], crypto_op,
 	auth_op, digest_len, is_enc);
@@ -397,7 +410,7 @@ crypto_sw_scheduler_process_link (vlib_main_t *vm,
 			   &state);
     }
 
-  f->state = state;
+  return state;
 }
 
 static_always_inline int
@@ -444,102 +457,215 @@ convert_async_crypto_id (vnet_crypto_op_id_t async_op_id, u32 *crypto_op,
   return -1;
 }
 
-static_always_inline vnet_crypto_async_frame_t *
-crypto_sw_scheduler_dequeue (vlib_main_t *vm, u32 *nb_elts_processed,
-			     u32 *enqueue_thread_idx)
+typedef struct
 {
-  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
-  crypto_sw_scheduler_per_thread_data_t *ptd =
-    cm->per_thread_data + vm->thread_index;
-  vnet_crypto_async_frame_t *f = 0;
-  crypto_sw_scheduler_queue_t *current_queue = 0;
-  u32 tail, head;
-  u8 found = 0;
-  u8 recheck_queues = 1;
+  crypto_sw_scheduler_job_t *job;
+  u16 first;
+  u16 n_elts;
+} crypto_sw_scheduler_batch_t;
 
-run_next_queues:
-  /* get a pending frame to process */
-  if (ptd->self_crypto_enabled)
+/* claim up to CRYPTO_SW_SCHEDULER_SUB_BATCH_SIZE elements of the oldest
+ * frame in the queue which still has unclaimed elements */
+static_always_inline int
+crypto_sw_scheduler_claim_batch (crypto_sw_scheduler_main_t *cm,
+				 crypto_sw_scheduler_queue_t *q,
+				 crypto_sw_scheduler_batch_t *b)
+{
+  u32 tail = q->tail;
+  u32 head = q->head;
+  u32 j;
+
+  /* tail and head are read without lock, skip the queue if the pair is
+   * not consistent */
+  if (head - tail > cm->crypto_sw_scheduler_queue_mask + 1)
+    return 0;
+
+  for (j = tail; j != head; j++)
     {
-      u32 i = ptd->last_serve_lcore_id + 1;
+      crypto_sw_scheduler_job_t *job =
+	q->jobs + (j & cm->crypto_sw_scheduler_queue_mask);
+      u64 claim = clib_atomic_load_acq_n (&job->claim);
 
-      while (1)
+      while ((u32) (claim >> 32) == j)
 	{
-	  crypto_sw_scheduler_per_thread_data_t *st;
-	  u32 j;
+	  u16 n_elts = claim >> 16, next = claim, n;
 
-	  if (i >= vec_len (cm->per_thread_data))
-	    i = 0;
+	  if (next >= n_elts)
+	    break;
 
-	  st = cm->per_thread_data + i;
+	  n = clib_min (n_elts - next, CRYPTO_SW_SCHEDULER_SUB_BATCH_SIZE);
 
-	  if (ptd->last_serve_encrypt)
-	    current_queue = &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT];
-	  else
-	    current_queue = &st->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT];
+	  /* on failure claim is updated with the current value */
+	  if (clib_atomic_cmp_and_swap_acq_relax_n (&job->claim, &claim,
+						    claim + n, 0))
+	    {
+	      b->job = job;
+	      b->first = next;
+	      b->n_elts = n;
+	      return 1;
+	    }
+	}
+    }
+
+  return 0;
+}
 
-	  tail = current_queue->tail;
-	  head = current_queue->head;
+static_always_inline int
+crypto_sw_scheduler_claim (crypto_sw_scheduler_main_t *cm,
+			   crypto_sw_scheduler_per_thread_data_t *ptd,
+			   crypto_sw_scheduler_per_thread_data_t *st,
+			   crypto_sw_scheduler_batch_t *b)
+{
+  crypto_sw_scheduler_queue_t *q[2];
 
-	  /* Skip this queue unless tail < head or head has overflowed
-	   * and tail has not. At the point where tail overflows (== 0),
-	   * the largest possible value of head is (queue size - 1).
-	   * Prior to that, the largest possible value of head is
-	   * (queue size - 2).
-	   */
-	  if ((tail > head) && (head >= cm->crypto_sw_scheduler_queue_mask))
-	    goto skip_queue;
+  if (st->n_unclaimed == 0)
+    return 0;
 
-	  for (j = tail; j != head; j++)
-	    {
+  /* alternate between encrypt and decrypt queues */
+  q[0] = st->queue + (ptd->last_serve_encrypt ?
+			CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT :
+			CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT);
+  q[1] = st->queue + (ptd->last_serve_encrypt ?
+			CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT :
+			CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT);
+  ptd->last_serve_encrypt = !ptd->last_serve_encrypt;
 
-	      f = current_queue->jobs[j & cm->crypto_sw_scheduler_queue_mask];
+  if (crypto_sw_scheduler_claim_batch (cm, q[0], b) ||
+      crypto_sw_scheduler_claim_batch (cm, q[1], b))
+    {
+      clib_atomic_fetch_sub (&st->n_unclaimed, b->n_elts);
+      return 1;
+    }
 
-	      if (!f)
-		continue;
+  return 0;
+}
 
-	      if (clib_atomic_bool_cmp_and_swap (
-		    &f->state, VNET_CRYPTO_FRAME_STATE_PENDING,
-		    VNET_CRYPTO_FRAME_STATE_WORK_IN_PROGRESS))
-		{
-		  found = 1;
-		  break;
-		}
-	    }
+/* the most backlogged peer, peers on the local numa node are preferred */
+static_always_inline crypto_sw_scheduler_per_thread_data_t *
+crypto_sw_scheduler_find_victim (vlib_main_t *vm,
+				 crypto_sw_scheduler_main_t *cm,
+				 crypto_sw_scheduler_per_thread_data_t *ptd)
+{
+  crypto_sw_scheduler_per_thread_data_t *st, *local = 0, *remote = 0;
+  u32 local_max = 0, remote_max = 0;
 
-	skip_queue:
-	  if (found || i == ptd->last_serve_lcore_id)
+  vec_foreach (st, cm->per_thread_data)
+    {
+      u32 n = st->n_unclaimed;
+
+      if (st == ptd || n == 0)
+	continue;
+
+      if (vlib_get_main_by_index (st - cm->per_thread_data)->numa_node ==
+	  vm->numa_node)
+	{
+	  if (n > local_max)
 	    {
-	      CLIB_MEMORY_STORE_BARRIER ();
-	      ptd->last_serve_encrypt = !ptd->last_serve_encrypt;
-	      break;
+	      local_max = n;
+	      local = st;
 	    }
+	}
+      else if (n > remote_max)
+	{
+	  remote_max = n;
+	  remote = st;
+	}
+    }
+
+  if (local || cm->numa_local_steal_only)
+    return local;
+
+  return remote;
+}
+
+static_always_inline vnet_crypto_async_frame_t *
+crypto_sw_scheduler_dequeue (vlib_main_t *vm, u32 *nb_elts_processed,
+			     u32 *enqueue_thread_idx)
+{
+  crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
+  crypto_sw_scheduler_per_thread_data_t *ptd =
+    cm->per_thread_data + vm->thread_index;
+  crypto_sw_scheduler_per_thread_data_t *st;
+  vnet_crypto_async_frame_t *f = 0;
+  crypto_sw_scheduler_queue_t *current_queue = 0;
+  crypto_sw_scheduler_batch_t b;
+  u32 tail;
+  u8 found = 0;
+  u8 recheck_queues = 1;
 
-	  i++;
+run_next_queues:
+  /* own frames first, when idle steal a batch from the most backlogged
+   * peer. Peers with crypto disabled rely on others, so a busy worker
+   * still looks for a victim after a number of own batches */
+  if (ptd->self_crypto_enabled)
+    {
+      if (ptd->n_own_batches < CRYPTO_SW_SCHEDULER_MAX_OWN_BATCHES &&
+	  crypto_sw_scheduler_claim (cm, ptd, ptd, &b))
+	{
+	  found = 1;
+	  ptd->n_own_batches++;
 	}
+      else
+	{
+	  ptd->n_own_batches = 0;
+	  st = crypto_sw_scheduler_find_victim (vm, cm, ptd);
 
-      ptd->last_serve_lcore_id = i;
+	  if (st && crypto_sw_scheduler_claim (cm, ptd, st, &b))
+	    {
+	      found = 1;
+	      ptd->n_stolen_batches++;
+	      ptd->n_stolen_elts += b.n_elts;
+	      if (vlib_get_main_by_index (st - cm->per_thread_data)
+		    ->numa_node != vm->numa_node)
+		ptd->n_remote_numa_batches++;
+	    }
+	  else
+	    found = crypto_sw_scheduler_claim (cm, ptd, ptd, &b);
+	}
     }
 
   if (found)
     {
-      u32 crypto_op, auth_op_or_aad_len;
+      crypto_sw_scheduler_job_t *job = b.job;
+      u32 crypto_op, auth_op_or_aad_len, n_elts;
       u16 digest_len;
-      u8 is_enc;
+      u8 is_enc, state = VNET_CRYPTO_FRAME_STATE_SUCCESS;
       int ret;
 
+      /* slot is not recycled until all claimed elements are done */
+      f = job->frame;
+
       ret = convert_async_crypto_id (f->op, &crypto_op, &auth_op_or_aad_len,
 				     &digest_len, &is_enc);
 
       if (ret == 1)
-	crypto_sw_scheduler_process_aead (vm, ptd, f, crypto_op,
-					  auth_op_or_aad_len, digest_len);
+	state = crypto_sw_scheduler_process_aead (
+	  vm, ptd, f, b.first, b.n_elts, crypto_op, auth_op_or_aad_len,
+	  digest_len);
       else if (ret == 0)
-	crypto_sw_scheduler_process_link (
-	  vm, cm, ptd, f, crypto_op, auth_op_or_aad_len, digest_len, is_enc);
+	state = crypto_sw_scheduler_process_link (
+	  vm, cm, ptd, f, b.first, b.n_elts, crypto_op, auth_op_or_aad_len,
+	  digest_len, is_enc);
+
+      if (state != VNET_CRYPTO_FRAME_STATE_SUCCESS)
+	job->error = 1;
 
+      /* once the last batch is accounted the owner may complete and
+       * recycle the frame, so nothing is read from it after the add
+       * unless this worker finished the last batch */
+      n_elts = f->n_elts;
       *enqueue_thread_idx = f->enqueue_thread_index;
-      *nb_elts_processed = f->n_elts;
+      *nb_elts_processed = b.n_elts;
+
+      /* last worker to finish a batch of the frame completes it, the
+       * release makes every worker's element results visible to the
+       * owner before the state */
+      if (clib_atomic_add_fetch (&job->n_done, b.n_elts) == n_elts)
+	{
+	  state = job->error ? VNET_CRYPTO_FRAME_STATE_ELT_ERROR :
+			       VNET_CRYPTO_FRAME_STATE_SUCCESS;
+	  clib_atomic_store_rel_n (&f->state, state);
+	}
     }
 
   if (ptd->last_return_queue)
@@ -554,15 +680,14 @@ run_next_queues:
     }
 
   tail = current_queue->tail & cm->crypto_sw_scheduler_queue_mask;
+  f = current_queue->jobs[tail].frame;
 
-  if (current_queue->jobs[tail] &&
-      current_queue->jobs[tail]->state >= VNET_CRYPTO_FRAME_STATE_SUCCESS)
+  if (f && clib_atomic_load_acq_n (&f->state) >=
+	     VNET_CRYPTO_FRAME_STATE_SUCCESS)
     {
-
       CLIB_MEMORY_STORE_BARRIER ();
       current_queue->tail++;
-      f = current_queue->jobs[tail];
-      current_queue->jobs[tail] = 0;
+      current_queue->jobs[tail].frame = 0;
 
       return f;
     }
@@ -646,20 +771,28 @@ sw_scheduler_show_workers (vlib_main_t * vm, unformat_input_t * input,
   crypto_sw_scheduler_main_t *cm = &crypto_sw_scheduler_main;
   u32 i;
 
-  vlib_cli_output (vm, "%-7s%-20s%-8s", "ID", "Name", "Crypto");
+  vlib_cli_output (vm, "%-7s%-20s%-8s%-10s%-16s%-16s%-16s", "ID", "Name",
+		   "Crypto", "Numa", "Stolen batches", "Stolen elts",
+		   "Remote batches");
   for (i = 1; i < vlib_thread_main.n_vlib_mains; i++)
     {
-      vlib_cli_output (vm, "%-7d%-20s%-8s", vlib_get_worker_index (i),
+      crypto_sw_scheduler_per_thread_data_t *ptd = cm->per_thread_data + i;
+
+      vlib_cli_output (vm, "%-7d%-20s%-8s%-10u%-16lu%-16lu%-16lu",
+		       vlib_get_worker_index (i),
 		       (vlib_worker_threads + i)->name,
-		       cm->
-		       per_thread_data[i].self_crypto_enabled ? "on" : "off");
+		       ptd->self_crypto_enabled ? "on" : "off",
+		       vlib_get_main_by_index (i)->numa_node,
+		       ptd->n_stolen_batches, ptd->n_stolen_elts,
+		       ptd->n_remote_numa_batches);
     }
 
   return 0;
 }
 
 /*?
- * This command displays sw_scheduler workers.
+ * This command displays sw_scheduler workers and how many batches of
+ * frames enqueued on other threads each of them has processed.
  *
  * @cliexpar
  * Example of how to show workers:
@@ -754,6 +887,8 @@ crypto_sw_scheduler_config (vlib_main_t *vm, unformat_input_t *input)
 					crypto_sw_scheduler_queue_size);
 	    }
 	}
+      else if (unformat (input, "numa-local-steal-only"))
+	cm->numa_local_steal_only = 1;
       else
 	{
 	  cm->crypto_sw_scheduler_queue_mask =
@@ -778,7 +913,7 @@ crypto_sw_scheduler_config (vlib_main_t *vm, unformat_input_t *input)
 
       vec_validate_aligned (
 	ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_DECRYPT].jobs,
-	CRYPTO_SW_SCHEDULER_QUEUE_SIZE - 1, CLIB_CACHE_LINE_BYTES);
+	crypto_sw_scheduler_queue_size - 1, CLIB_CACHE_LINE_BYTES);
 
       ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT].head = 0;
       ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT].tail = 0;
@@ -788,7 +923,7 @@ crypto_sw_scheduler_config (vlib_main_t *vm, unformat_input_t *input)
 
       vec_validate_aligned (
 	ptd->queue[CRYPTO_SW_SCHED_QUEUE_TYPE_ENCRYPT].jobs,
-	CRYPTO_SW_SCHEDULER_QUEUE_SIZE - 1, CLIB_CACHE_LINE_BYTES);
+	crypto_sw_scheduler_queue_size - 1, CLIB_CACHE_LINE_BYTES);
     }
 
   if (error)
@@ -65,6 +65,7 @@ typedef struct
   hs_test_t post_test;
   uint8_t proto;
   uint8_t incremental_stats;
+  uint8_t use_ring;
   uint32_t n_workers;
   volatile int active_workers;
   volatile int test_running;
@@ -681,6 +682,135 @@ vtc_worker_run_epoll (vcl_test_client_worker_t *wrk)
   return 0;
 }
 
+static void
+vtc_ring_submit_op (uint32_t ring, vcl_test_session_t *ts, uint8_t op)
+{
+  vcl_test_client_main_t *vcm = &vcl_client_main;
+  vppcom_ring_sqe_t *sqe;
+
+  /* Ring is sized for one read and one write per session */
+  sqe = vppcom_ring_get_sqe (ring);
+  if (!sqe)
+    vtfail ("vppcom_ring_get_sqe()", VPPCOM_ENOMEM);
+
+  sqe->op = op;
+  sqe->session_handle = ts->fd;
+  sqe->user_data = (uint64_t) ts->session_index << 8 | op;
+  switch (op)
+    {
+    case VPPCOM_RING_OP_READ:
+      sqe->buf = ts->rxbuf;
+      sqe->len = ts->rxbuf_size;
+      break;
+    case VPPCOM_RING_OP_WRITE:
+      sqe->buf = ts->txbuf;
+      sqe->len = ts->cfg.txbuf_size;
+      break;
+    case VPPCOM_RING_OP_CONNECT:
+      sqe->ep = &vcm->server_endpt;
+      break;
+    default:
+      break;
+    }
+}
+
+static int
+vtc_worker_run_ring (vcl_test_client_worker_t *wrk)
+{
+  vcl_test_client_main_t *vcm = &vcl_client_main;
+  uint32_t n_active_sessions, n_connected = 0, flags, flen;
+  vppcom_ring_cqe_t *cqes;
+  vcl_test_session_t *ts;
+  int i, rv, ring, n_cqes, check_rx;
+  uint8_t op;
+
+  ring = vppcom_ring_create (2 * wrk->cfg.num_test_sessions);
+  if (ring < 0)
+    vtfail ("vppcom_ring_create()", ring);
+
+  /* Sessions are blocking, the ring switches them to non-blocking */
+  for (i = 0; i < wrk->cfg.num_test_sessions; i++)
+    {
+      ts = &wrk->sessions[i];
+      ts->fd = vppcom_session_create (VPPCOM_PROTO_TCP, 0 /* nonblock */);
+      if (ts->fd < 0)
+	vtfail ("vppcom_session_create()", ts->fd);
+      vtc_ring_submit_op (ring, ts, VPPCOM_RING_OP_CONNECT);
+    }
+
+  check_rx = wrk->cfg.test != HS_TEST_TYPE_UNI;
+  n_active_sessions = wrk->cfg.num_test_sessions;
+
+  while (n_active_sessions && vcm->test_running)
+    {
+      rv = vppcom_ring_submit (ring);
+      if (rv < 0)
+	vtfail ("vppcom_ring_submit()", rv);
+
+      n_cqes = vppcom_ring_peek_cqes (ring, &cqes);
+      if (n_cqes < 0)
+	vtfail ("vppcom_ring_peek_cqes()", n_cqes);
+
+      for (i = 0; i < n_cqes; i++)
+	{
+	  ts = &wrk->sessions[cqes[i].user_data >> 8];
+	  op = cqes[i].user_data & 0xff;
+	  rv = cqes[i].result;
+	  if (rv < 0)
+	    vtfail ("ring op", rv);
+
+	  switch (op)
+	    {
+	    case VPPCOM_RING_OP_CONNECT:
+	      ts->is_open = 1;
+	      if (++n_connected == wrk->cfg.num_test_sessions)
+		vtc_worker_start_transfer (wrk);
+	      vtc_ring_submit_op (ring, ts, VPPCOM_RING_OP_WRITE);
+	      if (check_rx)
+		vtc_ring_submit_op (ring, ts, VPPCOM_RING_OP_READ);
+	      break;
+	    case VPPCOM_RING_OP_WRITE:
+	      ts->stats.tx_xacts++;
+	      ts->stats.tx_bytes += rv;
+	      if (rv < ts->cfg.txbuf_size)
+		ts->stats.tx_incomp++;
+	      if (ts->stats.tx_bytes < ts->cfg.total_bytes)
+		vtc_ring_submit_op (ring, ts, VPPCOM_RING_OP_WRITE);
+	      break;
+	    case VPPCOM_RING_OP_READ:
+	      ts->stats.rx_xacts++;
+	      ts->stats.rx_bytes += rv;
+	      if (rv < ts->rxbuf_size)
+		ts->stats.rx_incomp++;
+	      if (ts->stats.rx_bytes < ts->cfg.total_bytes)
+		vtc_ring_submit_op (ring, ts, VPPCOM_RING_OP_READ);
+	      break;
+	    default:
+	      break;
+	    }
+	  if (!ts->is_done && vtc_session_check_is_done (ts, check_rx))
+	    n_active_sessions -= 1;
+	}
+      vppcom_ring_cq_advance (ring, n_cqes);
+    }
+
+  rv = vppcom_ring_destroy (ring);
+  if (rv < 0)
+    vtfail ("vppcom_ring_destroy()", rv);
+
+  /* Sessions should be blocking again once the ring is gone */
+  for (i = 0; i < wrk->cfg.num_test_sessions; i++)
+    {
+      flen = sizeof (flags);
+      rv = vppcom_session_attr (wrk->sessions[i].fd, VPPCOM_ATTR_GET_FLAGS,
+				&flags, &flen);
+      if (rv < 0 || (flags & O_NONBLOCK))
+	vtfail ("ring session blocking mode restore", VPPCOM_EINVAL);
+    }
+
+  return 0;
+}
+
 static inline int
 vtc_worker_run (vcl_test_client_worker_t *wrk)
 {
@@ -1012,6 +1142,7 @@ print_usage_and_exit (void)
     "  -I <N>           Use N sessions.\n"
     "  -s <N>           Use N sessions.\n"
     "  -S	       	Print incremental stats per session.\n"
+    "  -r               Use completion ring for tcp stream tests.\n"
     "  -q <n>           QUIC : use N Ssessions on top of n Qsessions\n");
   exit (1);
 }
@@ -1023,7 +1154,7 @@ vtc_process_opts (vcl_test_client_main_t * vcm, int argc, char **argv)
   int c, v;
 
   opterr = 0;
-  while ((c = getopt (argc, argv, "chnp:w:xXE:I:N:R:T:b:UBV6DLs:q:S")) != -1)
+  while ((c = getopt (argc, argv, "chnp:w:xXE:I:N:R:T:b:UBV6DLs:q:Sr")) != -1)
     switch (c)
       {
       case 'c':
@@ -1201,6 +1332,10 @@ vtc_process_opts (vcl_test_client_main_t * vcm, int argc, char **argv)
 	vcm->incremental_stats = 1;
 	break;
 
+      case 'r':
+	vcm->use_ring = 1;
+	break;
+
       case '?':
 	switch (optopt)
 	  {
@@ -1233,6 +1368,12 @@ vtc_process_opts (vcl_test_client_main_t * vcm, int argc, char **argv)
       print_usage_and_exit ();
     }
 
+  if (vcm->use_ring && vcm->proto != VPPCOM_PROTO_TCP)
+    {
+      vtwrn ("Completion ring only supported with tcp!");
+      print_usage_and_exit ();
+    }
+
   ctrl->cfg.num_test_qsessions = vcm->proto != VPPCOM_PROTO_QUIC ? 0 :
     (ctrl->cfg.num_test_sessions + ctrl->cfg.num_test_sessions_perq - 1) /
     ctrl->cfg.num_test_sessions_perq;
@@ -1372,7 +1513,10 @@ vtc_alloc_workers (vcl_test_client_main_t *vcm)
   vcm->workers = calloc (vcm->n_workers, sizeof (vcl_test_client_worker_t));
   vt->wrk = calloc (vcm->n_workers, sizeof (vcl_test_wrk_t));
 
-  if (vcm->ctrl_session.cfg.num_test_sessions > VCL_TEST_CFG_MAX_SELECT_SESS)
+  if (vcm->use_ring)
+    run_fn = vtc_worker_run_ring;
+  else if (vcm->ctrl_session.cfg.num_test_sessions >
+	   VCL_TEST_CFG_MAX_SELECT_SESS)
     run_fn = vtc_worker_run_epoll;
   else
     run_fn = vtc_worker_run_select;
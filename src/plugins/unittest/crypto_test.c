@@ -974,13 +974,118 @@ done:
   return err;
 }
 
+#define REORDER_OP_ENC VNET_CRYPTO_OP_AES_128_GCM_TAG16_AAD8_ENC
+#define REORDER_OP_DEC VNET_CRYPTO_OP_AES_128_GCM_TAG16_AAD8_DEC
+#define REORDER_N_FRAMES (VNET_CRYPTO_REORDER_MAX_FRAMES + 8)
+
+/* complete frame seq of op, check the frames delivered, in order */
+static clib_error_t *
+test_crypto_reorder_one (vnet_crypto_thread_t *ct,
+			 vnet_crypto_async_frame_t *frames,
+			 vnet_crypto_op_id_t op, u32 seq, u32 first_ready,
+			 u32 n_ready)
+{
+  vnet_crypto_async_frame_t **ready = 0;
+  clib_error_t *err = 0;
+  u32 i;
+
+  frames += (op == REORDER_OP_ENC ? 0 : REORDER_N_FRAMES) + seq;
+  vnet_crypto_reorder_frame (ct, frames, &ready);
+
+  if (vec_len (ready) != n_ready)
+    err = clib_error_return (0, "op %u seq %u: %u frames ready, expected %u",
+			     op, seq, vec_len (ready), n_ready);
+  else
+    for (i = 0; i < n_ready; i++)
+      if (ready[i]->op != op || ready[i]->seq != first_ready + i)
+	{
+	  err = clib_error_return (0, "op %u seq %u: frame %u is op %u seq %u",
+				   op, seq, i, ready[i]->op, ready[i]->seq);
+	  break;
+	}
+
+  vec_free (ready);
+  return err;
+}
+
+#define REORDER_TEST(op, seq, first, n)                                       \
+  if ((err = test_crypto_reorder_one (ct, frames, op, seq, first, n)))        \
+    goto done;
+
+#define REORDER_CHECK(cond)                                                   \
+  if (!(cond))                                                                \
+    {                                                                         \
+      err = clib_error_return (0, "reorder check '%s' failed", #cond);        \
+      goto done;                                                              \
+    }
+
+static clib_error_t *
+test_crypto_reorder (vlib_main_t *vm, crypto_test_main_t *tm)
+{
+  vnet_crypto_async_frame_t *frames = 0;
+  vnet_crypto_thread_t *ct;
+  clib_error_t *err = 0;
+  u32 i;
+
+  ct = clib_mem_alloc_aligned (sizeof (*ct), CLIB_CACHE_LINE_BYTES);
+  clib_memset (ct, 0, sizeof (*ct));
+  vec_validate_aligned (frames, 2 * REORDER_N_FRAMES - 1,
+			CLIB_CACHE_LINE_BYTES);
+  for (i = 0; i < REORDER_N_FRAMES; i++)
+    {
+      frames[i].op = REORDER_OP_ENC;
+      frames[i].seq = i;
+      frames[REORDER_N_FRAMES + i].op = REORDER_OP_DEC;
+      frames[REORDER_N_FRAMES + i].seq = i;
+    }
+
+  /* out of order completion: 1 and 3 wait for 0 and 2 */
+  REORDER_TEST (REORDER_OP_ENC, 1, 0, 0);
+  REORDER_TEST (REORDER_OP_ENC, 3, 0, 0);
+  REORDER_TEST (REORDER_OP_ENC, 0, 0, 2);
+  REORDER_TEST (REORDER_OP_ENC, 2, 2, 2);
+  REORDER_CHECK (vec_len (ct->reorder_frames) == 0);
+  REORDER_CHECK (ct->n_reordered == 2);
+
+  /* gap skip: frame 4 is lost, parking one frame too many skips it */
+  for (i = 5; i < 5 + VNET_CRYPTO_REORDER_MAX_FRAMES; i++)
+    REORDER_TEST (REORDER_OP_ENC, i, 0, 0);
+  REORDER_TEST (REORDER_OP_ENC, i, 5, VNET_CRYPTO_REORDER_MAX_FRAMES + 1);
+  REORDER_CHECK (ct->n_reorder_skipped == 1);
+  REORDER_CHECK (ct->complete_seq[REORDER_OP_ENC] == i + 1);
+
+  /* late arrival: frame 4 is delivered on its own, nothing is parked */
+  REORDER_TEST (REORDER_OP_ENC, 4, 4, 1);
+  REORDER_CHECK (ct->n_reorder_late == 1);
+  REORDER_CHECK (ct->complete_seq[REORDER_OP_ENC] == i + 1);
+  REORDER_CHECK (vec_len (ct->reorder_frames) == 0);
+
+  /* the limit is per op: frames parked for another op don't count */
+  clib_memset (ct->complete_seq, 0, sizeof (ct->complete_seq));
+  REORDER_TEST (REORDER_OP_DEC, 1, 0, 0);
+  for (i = 1; i <= VNET_CRYPTO_REORDER_MAX_FRAMES; i++)
+    REORDER_TEST (REORDER_OP_ENC, i, 0, 0);
+  REORDER_CHECK (ct->n_reorder_skipped == 1);
+  REORDER_TEST (REORDER_OP_ENC, 0, 0, VNET_CRYPTO_REORDER_MAX_FRAMES + 1);
+  REORDER_TEST (REORDER_OP_DEC, 0, 0, 2);
+  REORDER_CHECK (vec_len (ct->reorder_frames) == 0);
+
+  vlib_cli_output (vm, "async frame reorder: OK");
+
+done:
+  vec_free (ct->reorder_frames);
+  clib_mem_free (ct);
+  vec_free (frames);
+  return err;
+}
+
 static clib_error_t *
 test_crypto_command_fn (vlib_main_t * vm,
 			unformat_input_t * input, vlib_cli_command_t * cmd)
 {
   crypto_test_main_t *tm = &crypto_test_main;
   unittest_crypto_test_registration_t *tr;
-  int is_perf = 0;
+  int is_perf = 0, is_reorder = 0;
 
   tr = tm->test_registrations;
   memset (tm, 0, sizeof (crypto_test_main_t));
@@ -1004,6 +1109,8 @@ test_crypto_command_fn (vlib_main_t * vm,
 	;
       else if (unformat (input, "buffer-size %u", &tm->buffer_size))
 	;
+      else if (unformat (input, "reorder"))
+	is_reorder = 1;
       else
 	return clib_error_return (0, "unknown input '%U'",
 				  format_unformat_error, input);
@@ -1011,6 +1118,8 @@ test_crypto_command_fn (vlib_main_t * vm,
 
   if (is_perf)
     return test_crypto_perf (vm, tm);
+  else if (is_reorder)
+    return test_crypto_reorder (vm, tm);
   else
     return test_crypto (vm, tm);
 }
@@ -1018,7 +1127,7 @@ test_crypto_command_fn (vlib_main_t * vm,
 VLIB_CLI_COMMAND (test_crypto_command, static) =
 {
   .path = "test crypto",
-  .short_help = "test crypto",
+  .short_help = "test crypto [reorder]",
   .function = test_crypto_command_fn,
 };
 
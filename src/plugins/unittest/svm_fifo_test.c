@@ -1991,6 +1991,229 @@ sfifo_test_fifo_indirect (vlib_main_t * vm, unformat_input_t * input)
   return 0;
 }
 
+static int
+sfifo_test_fifo_reserve (vlib_main_t *vm, unformat_input_t *input)
+{
+  int __clib_unused verbose = 0, fifo_size = 4096;
+  fifo_segment_main_t _fsm = { 0 }, *fsm = &_fsm;
+  u8 *test_data = 0, *data_buf = 0;
+  svm_fifo_seg_t fsegs[4];
+  u32 n_segs, n_bytes, i;
+  fifo_segment_t *fs;
+  svm_fifo_t *f;
+  int rv;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "verbose"))
+	verbose = 1;
+      else
+	{
+	  vlib_cli_output (vm, "parse error: '%U'", format_unformat_error,
+			   input);
+	  return -1;
+	}
+    }
+
+  /*
+   * Init fifo with one 4096 chunk that can grow to 3 chunks
+   */
+  fs = fifo_segment_prepare (fsm, "fifo-reserve", 0);
+  f = fifo_prepare (fs, fifo_size);
+
+  fifo_size = 3 * 4096;
+  svm_fifo_set_size (f, fifo_size);
+  validate_test_and_buf_vecs (&test_data, &data_buf, fifo_size);
+
+  /*
+   * Reserve over first chunk boundary, chunk should be allocated
+   */
+  n_segs = 4;
+  rv = svm_fifo_enqueue_reserve (f, 0, fsegs, &n_segs, 6000);
+  SFIFO_TEST (rv == 6000, "reserved %d", rv);
+  SFIFO_TEST (n_segs == 2, "segments %u", n_segs);
+  SFIFO_TEST (fsegs[0].len == 4096, "first seg len %u", fsegs[0].len);
+  SFIFO_TEST (fsegs[1].len == 6000 - 4096, "second seg len %u",
+	      fsegs[1].len);
+  SFIFO_TEST (svm_fifo_max_dequeue (f) == 0, "nothing enqueued");
+
+  /*
+   * Second reservation, past the first, up to fifo size
+   */
+  n_segs = 4;
+  rv = svm_fifo_enqueue_reserve (f, 6000, &fsegs[2], &n_segs, ~0);
+  SFIFO_TEST (rv == fifo_size - 6000, "reserved %d", rv);
+  SFIFO_TEST (svm_fifo_max_dequeue (f) == 0, "nothing enqueued");
+
+  n_segs = 1;
+  rv = svm_fifo_enqueue_reserve (f, fifo_size, fsegs, &n_segs, ~0);
+  SFIFO_TEST (rv == SVM_FIFO_EFULL, "no space left %d", rv);
+
+  /*
+   * Fill reservations in reverse order and commit once
+   */
+  n_segs = 4;
+  rv = svm_fifo_enqueue_reserve (f, 6000, &fsegs[2], &n_segs, ~0);
+  n_bytes = 6000;
+  for (i = 2; i < 2 + n_segs; i++)
+    {
+      clib_memcpy_fast (fsegs[i].data, test_data + n_bytes, fsegs[i].len);
+      n_bytes += fsegs[i].len;
+    }
+  SFIFO_TEST (n_bytes == fifo_size, "filled %u", n_bytes);
+
+  clib_memcpy_fast (fsegs[0].data, test_data, fsegs[0].len);
+  clib_memcpy_fast (fsegs[1].data, test_data + fsegs[0].len, fsegs[1].len);
+
+  svm_fifo_enqueue_nocopy (f, fifo_size);
+  SFIFO_TEST (svm_fifo_is_sane (f), "fifo should be sane");
+  SFIFO_TEST (svm_fifo_max_dequeue (f) == fifo_size, "max deq %u",
+	      svm_fifo_max_dequeue (f));
+
+  rv = svm_fifo_dequeue (f, fifo_size, data_buf);
+  SFIFO_TEST (rv == fifo_size, "dequeued %d", rv);
+  rv = compare_data (data_buf, test_data, 0, fifo_size, &i);
+  SFIFO_TEST (rv == 0, "[%d] dequeued %u expected %u", i, data_buf[i],
+	      test_data[i]);
+
+  /*
+   * Tail at chunk boundary, no empty first segment
+   */
+  n_segs = 4;
+  rv = svm_fifo_enqueue_reserve (f, 0, fsegs, &n_segs, 100);
+  SFIFO_TEST (rv == 100, "reserved %d", rv);
+  SFIFO_TEST (n_segs == 1 && fsegs[0].len == 100, "one segment %u",
+	      n_segs);
+
+  /*
+   * Cleanup
+   */
+
+  ft_fifo_free (fs, f);
+  ft_fifo_segment_free (fsm, fs);
+  vec_free (test_data);
+  vec_free (data_buf);
+
+  return 0;
+}
+
+/*
+ * Enqueue segments such that many holes are left and fill the holes in
+ * random order
+ */
+static int
+sfifo_test_fifo_ooo_holes (vlib_main_t *vm, unformat_input_t *input)
+{
+  u32 n_holes = 2048, seg_size = 100, fifo_size, seed = 0xdeaddabe;
+  fifo_segment_main_t _fsm = { 0 }, *fsm = &_fsm;
+  u8 *test_data = 0, *data_buf = 0;
+  u32 *holes = 0, i, j, tmp, offset;
+  int rv, verbose = 0;
+  fifo_segment_t *fs;
+  f64 start, add_time, merge_time;
+  svm_fifo_t *f;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "holes %u", &n_holes))
+	;
+      else if (unformat (input, "seg-size %u", &seg_size))
+	;
+      else if (unformat (input, "seed %u", &seed))
+	;
+      else if (unformat (input, "verbose"))
+	verbose = 1;
+      else
+	{
+	  vlib_cli_output (vm, "parse error: '%U'", format_unformat_error,
+			   input);
+	  return -1;
+	}
+    }
+
+  /*
+   * Odd segments are enqueued out of order, even ones are holes
+   */
+  fifo_size = 2 * n_holes * seg_size;
+  fs = fifo_segment_prepare (fsm, "fifo-ooo-holes", 0);
+  f = fifo_segment_alloc_fifo (fs, fifo_size, FIFO_SEGMENT_RX_FIFO);
+  svm_fifo_init_ooo_lookup (f, 0 /* enq ooo */);
+  validate_test_and_buf_vecs (&test_data, &data_buf, fifo_size);
+
+  start = vlib_time_now (vm);
+  for (i = 0; i < n_holes; i++)
+    {
+      offset = (2 * i + 1) * seg_size;
+      rv = svm_fifo_enqueue_with_offset (f, offset, seg_size,
+					 test_data + offset);
+      if (rv)
+	SFIFO_TEST (0, "enqueue at %u returned %d", offset, rv);
+    }
+  add_time = vlib_time_now (vm) - start;
+
+  rv = svm_fifo_n_ooo_segments (f);
+  SFIFO_TEST (rv == n_holes, "number of ooo segments %u", rv);
+
+  /*
+   * Fill all holes but the first in random order
+   */
+  for (i = 1; i < n_holes; i++)
+    vec_add1 (holes, i);
+  for (i = 0; i < vec_len (holes); i++)
+    {
+      j = random_u32 (&seed) % vec_len (holes);
+      tmp = holes[i];
+      holes[i] = holes[j];
+      holes[j] = tmp;
+    }
+
+  start = vlib_time_now (vm);
+  for (i = 0; i < vec_len (holes); i++)
+    {
+      offset = 2 * holes[i] * seg_size;
+      rv = svm_fifo_enqueue_with_offset (f, offset, seg_size,
+					 test_data + offset);
+      if (rv)
+	SFIFO_TEST (0, "enqueue at %u returned %d", offset, rv);
+    }
+  merge_time = vlib_time_now (vm) - start;
+
+  rv = svm_fifo_n_ooo_segments (f);
+  SFIFO_TEST (rv == 1, "number of ooo segments %u", rv);
+  SFIFO_TEST (svm_fifo_max_dequeue (f) == 0, "nothing in order");
+
+  /*
+   * Fill first hole. Tail should advance over all ooo data
+   */
+  rv = svm_fifo_enqueue (f, seg_size, test_data);
+  SFIFO_TEST (rv == fifo_size, "enqueued %d", rv);
+  rv = svm_fifo_n_ooo_segments (f);
+  SFIFO_TEST (rv == 0, "number of ooo segments %u", rv);
+
+  rv = svm_fifo_dequeue (f, fifo_size, data_buf);
+  SFIFO_TEST (rv == fifo_size, "dequeued %d", rv);
+  rv = compare_data (data_buf, test_data, 0, fifo_size, &i);
+  SFIFO_TEST (rv == 0, "[%d] dequeued %u expected %u", i, data_buf[i],
+	      test_data[i]);
+
+  if (verbose)
+    vlib_cli_output (vm, "%u holes: add %.2f us/seg merge %.2f us/seg",
+		     n_holes, add_time * 1e6 / n_holes,
+		     merge_time * 1e6 / clib_max (n_holes - 1, 1));
+
+  /*
+   * Cleanup
+   */
+
+  ft_fifo_free (fs, f);
+  ft_fifo_segment_free (fsm, fs);
+  vec_free (test_data);
+  vec_free (data_buf);
+  vec_free (holes);
+
+  return 0;
+}
+
 svm_fifo_trace_elem_t fifo_trace[] = {};
 
 static int
@@ -2675,6 +2898,138 @@ sfifo_test_fifo_segment_prealloc (int verbose)
   return 0;
 }
 
+static fifo_segment_t *
+sfifo_test_segment_create (char *name, u32 size, u32 n_slices)
+{
+  fifo_segment_main_t *sm = &segment_main;
+  fifo_segment_t *fs;
+
+  pool_get_zero (sm->segments, fs);
+
+  fs->ssvm.ssvm_size = size;
+  fs->ssvm.is_server = 1;
+  fs->ssvm.my_pid = getpid ();
+  fs->ssvm.name = format (0, "%s%c", name, 0);
+  fs->ssvm.requested_va = ~0ULL;
+
+  if (ssvm_server_init (&fs->ssvm, SSVM_SEGMENT_PRIVATE))
+    {
+      pool_put (sm->segments, fs);
+      return 0;
+    }
+
+  fs->n_slices = n_slices;
+  fifo_segment_init (fs);
+
+  return fs;
+}
+
+static int
+sfifo_test_fifo_segment_reclaim (int verbose)
+{
+  u32 n_chunks, n_split, lost, free_chunks;
+  fifo_segment_main_t *sm = &segment_main;
+  svm_fifo_t *f, *tf;
+  fifo_segment_t *fs;
+  int rv;
+
+  /*
+   * Chunks cached by idle slice are reclaimed by busy slice
+   */
+  fs = sfifo_test_segment_create ("fifo-test-reclaim", 256 << 10, 2);
+  SFIFO_TEST (fs != 0, "segment should be created");
+  fs->h->pct_first_alloc = 100;
+
+  rv = fifo_segment_prealloc_fifo_hdrs (fs, 0, 2);
+  SFIFO_TEST (rv == 0, "fifo hdr prealloc should work");
+
+  /* Move all free memory to slice 1 chunk free lists */
+  n_chunks = 0;
+  while (!fifo_segment_prealloc_fifo_chunks (fs, 1, 4096, 1))
+    n_chunks++;
+  SFIFO_TEST (n_chunks > 2, "prealloc chunks %u", n_chunks);
+
+  f = fifo_segment_alloc_fifo_w_slice (fs, 0, 4096, FIFO_SEGMENT_RX_FIFO);
+  SFIFO_TEST (f != 0, "fifo allocated in slice 0");
+  SFIFO_TEST (svm_fifo_is_sane (f), "fifo should be sane");
+
+  rv = fifo_segment_num_reclaimed_chunks (fs);
+  SFIFO_TEST (rv == 1, "reclaimed chunks expected %u is %u", 1, rv);
+  rv = fifo_segment_num_free_chunks (fs, 4096);
+  SFIFO_TEST (rv == n_chunks - 1, "free chunks expected %u is %u",
+	      n_chunks - 1, rv);
+  rv = fifo_segment_fl_chunk_bytes (fs);
+  SFIFO_TEST (rv == (n_chunks - 1) * 4096, "chunk free space expected %u "
+	      "is %u", (n_chunks - 1) * 4096, rv);
+  rv = fifo_segment_cached_bytes (fs);
+  SFIFO_TEST (rv == (n_chunks - 1) * 4096, "cached bytes expected %u is %u",
+	      (n_chunks - 1) * 4096, rv);
+
+  /* Reclaimed chunk is now owned by slice 0 */
+  fifo_segment_free_fifo (fs, f);
+  f = fifo_segment_alloc_fifo_w_slice (fs, 0, 4096, FIFO_SEGMENT_RX_FIFO);
+  SFIFO_TEST (f != 0, "fifo allocated in slice 0");
+  rv = fifo_segment_num_reclaimed_chunks (fs);
+  SFIFO_TEST (rv == 1, "reclaimed chunks expected %u is %u", 1, rv);
+
+  fifo_segment_free_fifo (fs, f);
+  fifo_segment_delete (sm, fs);
+
+  /*
+   * Larger free chunks are split once segment is full
+   */
+  fs = sfifo_test_segment_create ("fifo-test-split", 256 << 10, 2);
+  SFIFO_TEST (fs != 0, "segment should be created");
+  fs->h->pct_first_alloc = 100;
+
+  rv = fifo_segment_prealloc_fifo_hdrs (fs, 0, 2);
+  SFIFO_TEST (rv == 0, "fifo hdr prealloc should work");
+  rv = fifo_segment_prealloc_fifo_hdrs (fs, 1, 20);
+  SFIFO_TEST (rv == 0, "fifo hdr prealloc should work");
+
+  n_chunks = 0;
+  while (!fifo_segment_prealloc_fifo_chunks (fs, 1, 64 << 10, 1))
+    n_chunks++;
+  SFIFO_TEST (n_chunks > 0, "prealloc chunks %u", n_chunks);
+
+  /* Use remaining segment memory so only large chunks are left free */
+  while (!fifo_segment_prealloc_fifo_chunks (fs, 1, 4096, 1))
+    ;
+  while (fifo_segment_num_free_chunks (fs, 4096))
+    {
+      tf = fifo_segment_alloc_fifo_w_slice (fs, 1, 4096,
+					    FIFO_SEGMENT_RX_FIFO);
+      SFIFO_TEST (tf != 0, "fifo allocated in slice 1");
+    }
+  rv = fifo_segment_free_bytes (fs);
+  n_split = 4096 + sizeof (svm_fifo_chunk_t);
+  SFIFO_TEST (rv < n_split, "free bytes expected less than %u is %u", n_split,
+	      rv);
+
+  f = fifo_segment_alloc_fifo_w_slice (fs, 0, 4096, FIFO_SEGMENT_RX_FIFO);
+  SFIFO_TEST (f != 0, "fifo allocated in slice 0");
+  SFIFO_TEST (svm_fifo_is_sane (f), "fifo should be sane");
+
+  n_split = (sizeof (svm_fifo_chunk_t) + (64 << 10)) /
+	    (sizeof (svm_fifo_chunk_t) + 4096);
+  lost = (64 << 10) - n_split * 4096;
+
+  rv = fifo_segment_num_split_chunks (fs);
+  SFIFO_TEST (rv == 1, "split chunks expected %u is %u", 1, rv);
+  rv = fifo_segment_split_lost_bytes (fs);
+  SFIFO_TEST (rv == lost, "split lost bytes expected %u is %u", lost, rv);
+  free_chunks = fifo_segment_num_free_chunks (fs, 4096);
+  SFIFO_TEST (free_chunks == n_split - 1, "free chunks expected %u is %u",
+	      n_split - 1, free_chunks);
+  rv = fifo_segment_num_free_chunks (fs, 64 << 10);
+  SFIFO_TEST (rv == n_chunks - 1, "free large chunks expected %u is %u",
+	      n_chunks - 1, rv);
+
+  fifo_segment_delete (sm, fs);
+
+  return 0;
+}
+
 static int
 sfifo_test_fifo_segment (vlib_main_t * vm, unformat_input_t * input)
 {
@@ -2709,6 +3064,11 @@ sfifo_test_fifo_segment (vlib_main_t * vm, unformat_input_t * input)
 	  if ((rv = sfifo_test_fifo_segment_prealloc (verbose)))
 	    return -1;
 	}
+      else if (unformat (input, "reclaim"))
+	{
+	  if ((rv = sfifo_test_fifo_segment_reclaim (verbose)))
+	    return -1;
+	}
       else if (unformat (input, "all"))
 	{
 	  if ((rv = sfifo_test_fifo_segment_hello_world (verbose)))
@@ -2719,6 +3079,8 @@ sfifo_test_fifo_segment (vlib_main_t * vm, unformat_input_t * input)
 	    return -1;
 	  if ((rv = sfifo_test_fifo_segment_prealloc (verbose)))
 	    return -1;
+	  if ((rv = sfifo_test_fifo_segment_reclaim (verbose)))
+	    return -1;
 	  /* Pretty slow so avoid running it always
 	     if ((rv = sfifo_test_fifo_segment_master_slave (verbose)))
 	     return -1;
@@ -2769,6 +3131,10 @@ svm_fifo_test (vlib_main_t * vm, unformat_input_t * input,
 	res = sfifo_test_fifo_shrink (vm, input);
       else if (unformat (input, "indirect"))
 	res = sfifo_test_fifo_indirect (vm, input);
+      else if (unformat (input, "reserve"))
+	res = sfifo_test_fifo_reserve (vm, input);
+      else if (unformat (input, "ooo-holes"))
+	res = sfifo_test_fifo_ooo_holes (vm, input);
       else if (unformat (input, "zero"))
 	res = sfifo_test_fifo_make_rcv_wnd_zero (vm, input);
       else if (unformat (input, "segment"))
@@ -2835,6 +3201,12 @@ svm_fifo_test (vlib_main_t * vm, unformat_input_t * input,
 	  if ((res = sfifo_test_fifo_indirect (vm, input)))
 	    goto done;
 
+	  if ((res = sfifo_test_fifo_reserve (vm, input)))
+	    goto done;
+
+	  if ((res = sfifo_test_fifo_ooo_holes (vm, input)))
+	    goto done;
+
 	  if ((res = sfifo_test_fifo_make_rcv_wnd_zero (vm, input)))
 	    goto done;
 
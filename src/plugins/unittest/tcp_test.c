@@ -1545,6 +1545,538 @@ tcp_test_bt (vlib_main_t * vm, unformat_input_t * input)
   return 0;
 }
 
+static int
+tcp_test_rack (vlib_main_t * vm, unformat_input_t * input)
+{
+  u32 thread_index = 0, interval;
+  tcp_rate_sample_t _rs = { 0 }, *rs = &_rs;
+  tcp_connection_t _tc, *tc = &_tc;
+  sack_scoreboard_t *sb = &tc->sack_sb;
+  sack_scoreboard_hole_t *hole;
+  sack_block_t block;
+  u32 tx_times[] = { 10, 20, 29, 30 };
+  int i;
+
+  clib_memset (tc, 0, sizeof (*tc));
+  tc->state = TCP_STATE_ESTABLISHED;
+  tc->cfg_flags |= TCP_CFG_F_RACK | TCP_CFG_F_RATE_SAMPLE;
+  tc->rcv_opts.flags |= TCP_OPTS_FLAG_SACK | TCP_OPTS_FLAG_SACK_PERMITTED;
+  tc->snd_mss = 100;
+  tc->srtt = 10 / TCP_TICK;
+  scoreboard_init (sb);
+  tcp_bt_init (tc);
+  tcp_rack_init (tc);
+
+  /* 1) send 4 segments, the last two close in time */
+  /* [0:100]@10 [100:200]@20 [200:300]@29 [300:400]@30 */
+  for (i = 0; i < ARRAY_LEN (tx_times); i++)
+    {
+      tcp_test_set_time (thread_index, tx_times[i]);
+      tcp_bt_track_tx (tc, 100);
+      tc->snd_nxt += 100;
+    }
+
+  /* 2) sack second and last segments at time 36 */
+  /* SACK: [100:200][300:400] */
+  tcp_test_set_time (thread_index, 36);
+  block.start = 100;
+  block.end = 200;
+  vec_add1 (tc->rcv_opts.sacks, block);
+  block.start = 300;
+  block.end = 400;
+  vec_add1 (tc->rcv_opts.sacks, block);
+  tc->rcv_opts.n_sack_blocks = vec_len (tc->rcv_opts.sacks);
+  tcp_rcv_sacks (tc, 0);
+
+  TCP_TEST (sb->lost_bytes == 0, "no dupthresh loss with rack");
+
+  tcp_bt_sample_delivery_rate (tc, rs);
+
+  TCP_TEST (tc->rack.xmit_ts == 30, "rack xmit ts should be 30 is %.2f",
+	    tc->rack.xmit_ts);
+  TCP_TEST (tc->rack.end_seq == 400, "rack end seq should be 400 is %u",
+	    tc->rack.end_seq);
+  TCP_TEST (tc->rack.min_rtt == 6, "min rtt should be 6 is %.2f",
+	    tc->rack.min_rtt);
+  TCP_TEST (!tc->rack.reordering_seen, "no reordering seen");
+
+  /* 3) first segment is lost, third is within reordering window */
+  TCP_TEST (tcp_rack_detect_loss (tc) == 100, "100 bytes should be lost");
+  hole = scoreboard_first_hole (sb);
+  TCP_TEST (hole->start == 0 && hole->is_lost, "first hole is lost");
+  hole = scoreboard_next_hole (sb, hole);
+  TCP_TEST (hole->start == 200 && !hole->is_lost, "second hole not lost");
+  TCP_TEST (tc->rack.reo_timeout == 0.5,
+	    "reo timeout should be 0.5 is %.2f", tc->rack.reo_timeout);
+
+  interval = tcp_rack_timer_interval (tc, 100000);
+  TCP_TEST (tc->rack.timer == TCP_RXT_TIMER_REO, "reo timer pending");
+  TCP_TEST (interval == 5000, "interval should be 5000 is %u", interval);
+
+  /* 4) reordering window expires at time 37 */
+  tcp_test_set_time (thread_index, 37);
+  TCP_TEST (tcp_rack_detect_loss (tc) == 100, "100 bytes should be lost");
+  TCP_TEST (hole->is_lost, "second hole is lost");
+  TCP_TEST (sb->lost_bytes == 200, "lost bytes should be 200 is %u",
+	    sb->lost_bytes);
+  TCP_TEST (tc->rack.reo_timeout == 0, "no reo timeout");
+
+  /* 5) nothing pending, so probe if 2 srtt plus delayed ack allowance,
+   * as less than one mss is in flight, is shorter than rto */
+  interval = tcp_rack_timer_interval (tc, 300000);
+  TCP_TEST (tc->rack.timer == TCP_RXT_TIMER_TLP, "tlp timer pending");
+  TCP_TEST (interval == 202000, "interval should be 202000 is %u",
+	    interval);
+  interval = tcp_rack_timer_interval (tc, 100000);
+  TCP_TEST (tc->rack.timer == TCP_RXT_TIMER_RTO, "rto timer pending");
+  TCP_TEST (interval == 100000, "interval should be 100000 is %u",
+	    interval);
+
+  /* 6) retransmit first segment at time 38. Its sample, now first and
+   * newer than rack reference, does not end the search for older ones */
+  tcp_test_set_time (thread_index, 38);
+  tcp_bt_track_rxt (tc, 0, 100);
+  hole->is_lost = 0;
+  sb->lost_bytes -= 100;
+  TCP_TEST (tcp_rack_detect_loss (tc) == 100, "100 bytes should be lost");
+  TCP_TEST (hole->is_lost, "second hole is lost");
+
+  vec_free (tc->rcv_opts.sacks);
+  scoreboard_clear (sb);
+  tcp_bt_cleanup (tc);
+
+  return 0;
+}
+
+static void
+tcp_test_bbr_ack (tcp_connection_t *tc, u32 bytes, u32 lost)
+{
+  tcp_rate_sample_t rs = { 0 };
+
+  /* every ack ends a round, i.e., acks all data in flight at its start */
+  rs.prior_delivered = tc->delivered;
+  rs.delivered = bytes;
+  rs.acked_and_sacked = bytes;
+  rs.interval_time = 0.01;
+  rs.tx_in_flight = tcp_flight_size (tc);
+  tc->delivered += bytes;
+  tc->lost += lost;
+  tc->snd_una += bytes;
+  tc->snd_nxt += bytes;
+  tc->cc_algo->rcv_ack (tc, &rs);
+}
+
+static int
+tcp_test_bbr (vlib_main_t * vm, unformat_input_t * input)
+{
+  u32 thread_index = 0, mss = 1000;
+  tcp_connection_t _tc, *tc = &_tc;
+  u64 rate;
+
+  clib_memset (tc, 0, sizeof (*tc));
+  tc->snd_mss = mss;
+  tc->tx_fifo_size = 1 << 24;
+  tc->cc_algo = tcp_cc_algo_get (TCP_CC_BBR);
+  tcp_test_set_time (thread_index, 1);
+  tc->cc_algo->init (tc);
+
+  /* 1) no rtt sample yet, pace initial window with startup gain over
+   * tcp's initial 100ms rtt */
+  tc->srtt = 0;
+  tc->mrtt_us = (u32) ~0;
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 28 * tc->cwnd && rate < 29 * tc->cwnd,
+	    "initial pacing rate %lu cwnd %u", rate, tc->cwnd);
+
+  /* 2) startup, delivery rate doubles every round (10ms rtt) and cwnd
+   * grows with delivered bytes, 1MB/s, 2MB/s and 4MB/s */
+  tc->srtt = 10000;
+  tc->mrtt_us = 0.01;
+  tc->snd_nxt = 60000;
+  tcp_test_bbr_ack (tc, 10000, 0);
+  TCP_TEST (tc->cwnd == tcp_initial_cwnd (tc) + 10000, "cwnd %u",
+	    tc->cwnd);
+  tcp_test_bbr_ack (tc, 20000, 0);
+  tcp_test_bbr_ack (tc, 40000, 0);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 2.8 * 4e6 && rate < 2.9 * 4e6,
+	    "startup pacing rate %lu", rate);
+
+  /* 3) three rounds without growth, the pipe is full, drain the queue
+   * while inflight is above bdp (40000) */
+  tcp_test_bbr_ack (tc, 40000, 0);
+  tcp_test_bbr_ack (tc, 40000, 0);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 2.8 * 4e6, "still in startup, rate %lu", rate);
+  tcp_test_bbr_ack (tc, 40000, 0);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 4e6 / 3 && rate < 4e6 / 2.8, "drain pacing rate %lu",
+	    rate);
+  TCP_TEST (tc->ssthresh == 43000, "ssthresh %u", tc->ssthresh);
+
+  /* 4) inflight drops below bdp, probe bandwidth. Never starts with the
+   * drain phase, so gain is 1 or 1.25, cwnd is 2 bdp (+ 2 mss if probing)
+   */
+  tc->snd_nxt = tc->snd_una + 20000;
+  tcp_test_bbr_ack (tc, 40000, 0);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 0.98 * 4e6 && rate < 1.25 * 4e6,
+	    "probe bw pacing rate %lu", rate);
+  TCP_TEST (tc->cwnd == 83000 || tc->cwnd == 85000, "cwnd %u", tc->cwnd);
+
+  /* 5) min rtt not refreshed for 10s, probe rtt with 4 segment cwnd */
+  tcp_test_set_time (thread_index, 12);
+  tcp_test_bbr_ack (tc, 40000, 0);
+  TCP_TEST (tc->cwnd == 4 * mss, "probe rtt cwnd %u", tc->cwnd);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 0.98 * 4e6 && rate <= 4e6, "probe rtt pacing rate %lu",
+	    rate);
+
+  /* 6) once inflight is at most 4 segments for 200ms and a round, go back
+   * to probing bandwidth with the cwnd saved before probe rtt */
+  tc->snd_nxt = tc->snd_una + 3000;
+  tcp_test_bbr_ack (tc, 3000, 0);
+  TCP_TEST (tc->cwnd == 4 * mss, "still probing rtt, cwnd %u", tc->cwnd);
+  tcp_test_set_time (thread_index, 13);
+  tcp_test_bbr_ack (tc, 3000, 0);
+  TCP_TEST (tc->cwnd >= 83000, "cwnd restored %u", tc->cwnd);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 0.98 * 4e6, "probe bw pacing rate %lu", rate);
+
+  /* 7) restart after idle paces at the estimated bandwidth */
+  tcp_cc_event (tc, TCP_CC_EVT_START_TX);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 0.98 * 4e6 && rate <= 4e6, "idle restart pacing rate %lu",
+	    rate);
+
+  tc->cc_algo->cleanup (tc);
+
+  /* 8) a single loss in startup is tolerated, excess loss ends it and
+   * bounds inflight to beta (0.7) times inflight when data was lost */
+  clib_memset (tc, 0, sizeof (*tc));
+  tc->snd_mss = mss;
+  tc->tx_fifo_size = 1 << 24;
+  tc->cc_algo = tcp_cc_algo_get (TCP_CC_BBR);
+  tc->cc_algo->init (tc);
+  tc->srtt = 10000;
+  tc->mrtt_us = 0.01;
+  tc->snd_nxt = 60000;
+
+  tcp_test_bbr_ack (tc, 10000, 0);
+  tcp_test_bbr_ack (tc, 20000, 2000);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate > 2.8 * 2e6, "startup pacing rate %lu", rate);
+  tcp_test_bbr_ack (tc, 40000, 10000);
+  rate = tcp_cc_get_pacing_rate (tc);
+  TCP_TEST (rate < 4e6 / 2.8, "drain pacing rate %lu", rate);
+  TCP_TEST (tc->cwnd == 42000, "cwnd bounded %u", tc->cwnd);
+
+  tc->cc_algo->cleanup (tc);
+
+  return 0;
+}
+
+static int
+tcp_test_cubic (vlib_main_t * vm, unformat_input_t * input)
+{
+  tcp_rate_sample_t _rs, *rs = &_rs;
+  tcp_connection_t _tc, *tc = &_tc;
+  u32 thread_index = 0, cwnd, i;
+
+  clib_memset (tc, 0, sizeof (*tc));
+  tc->snd_mss = 100;
+  tc->tx_fifo_size = 1 << 20;
+  tc->cfg_flags |= TCP_CFG_F_RATE_SAMPLE;
+  tc->cc_algo = tcp_cc_algo_get (TCP_CC_CUBIC);
+  tcp_test_set_time (thread_index, 1);
+  tcp_bt_init (tc);
+  tc->cc_algo->init (tc);
+  cwnd = tc->cwnd;
+
+  /* 10 segments sent at time 1 and acked one by one at time 2. With rate
+   * sampling, delivered covers all acks since the segments were sent, so
+   * slow start must grow cwnd by bytes newly acked instead */
+  tcp_bt_track_tx (tc, 1000);
+  tc->snd_nxt = 1000;
+  tcp_test_set_time (thread_index, 2);
+  for (i = 0; i < 10; i++)
+    {
+      clib_memset (rs, 0, sizeof (*rs));
+      tc->bytes_acked = 100;
+      tc->snd_una += 100;
+      tcp_bt_sample_delivery_rate (tc, rs);
+      tc->cc_algo->rcv_ack (tc, rs);
+    }
+
+  TCP_TEST (rs->delivered == 1000, "delivered %u", rs->delivered);
+  TCP_TEST (tc->cwnd == cwnd + 1000, "cwnd grew by %u", tc->cwnd - cwnd);
+
+  tcp_bt_cleanup (tc);
+
+  return 0;
+}
+
+static fifo_segment_main_t tcp_test_segment_main;
+
+/* build an ip4 ack segment of connection tc with len bytes of payload
+ * whose bytes are the low bits of their sequence numbers */
+static u32
+tcp_test_coalesce_segment (vlib_main_t *vm, tcp_connection_t *tc, u32 seq,
+			   u16 len, u16 window, tcp_options_t *opts)
+{
+  u32 bi, error = 0, hdr_len, i;
+  vlib_buffer_t *b;
+  ip4_header_t *ip4;
+  tcp_header_t *th;
+  u8 *data;
+
+  if (vlib_buffer_alloc (vm, &bi, 1) != 1)
+    return ~0;
+
+  b = vlib_get_buffer (vm, bi);
+  ip4 = vlib_buffer_get_current (b);
+  th = (tcp_header_t *) (ip4 + 1);
+  clib_memset (ip4, 0, sizeof (*ip4) + sizeof (*th));
+
+  hdr_len = sizeof (*th);
+  if (opts)
+    hdr_len += tcp_options_write ((u8 *) (th + 1), opts);
+
+  ip4->ip_version_and_header_length = 0x45;
+  ip4->ttl = 64;
+  ip4->protocol = IP_PROTOCOL_TCP;
+  ip4->length = clib_host_to_net_u16 (sizeof (*ip4) + hdr_len + len);
+  ip4->src_address.as_u32 = tc->c_rmt_ip4.as_u32;
+  ip4->dst_address.as_u32 = tc->c_lcl_ip4.as_u32;
+
+  th->src_port = tc->c_rmt_port;
+  th->dst_port = tc->c_lcl_port;
+  th->seq_number = clib_host_to_net_u32 (seq);
+  th->ack_number = clib_host_to_net_u32 (tc->snd_una);
+  th->data_offset_and_reserved = hdr_len << 2;
+  th->flags = TCP_FLAG_ACK;
+  th->window = clib_host_to_net_u16 (window);
+
+  data = (u8 *) th + hdr_len;
+  for (i = 0; i < len; i++)
+    data[i] = seq + i;
+
+  b->current_length = sizeof (*ip4) + hdr_len + len;
+  vnet_buffer (b)->tcp.connection_index = tc->c_c_index;
+  tcp_input_lookup_buffer (b, 0, &error, 1 /* is_ip4 */, 1 /* nolookup */);
+
+  return bi;
+}
+
+static void
+tcp_test_coalesce_dispatch (vlib_main_t *vm, u32 *bis, u32 n_bis)
+{
+  vlib_node_t *node;
+  vlib_frame_t *f;
+
+  node = vlib_get_node_by_name (vm, (u8 *) "tcp4-established");
+  f = vlib_get_frame_to_node (vm, node->index);
+  clib_memcpy_fast (vlib_frame_vector_args (f), bis, n_bis * sizeof (u32));
+  f->n_vectors = n_bis;
+  vlib_put_frame_to_node (vm, node->index, f);
+
+  /* let the main loop run the node */
+  vlib_process_suspend (vm, 1e-3);
+}
+
+static u64
+tcp_test_coalesce_errors (vlib_main_t *vm, u32 error)
+{
+  vlib_node_t *node;
+
+  node = vlib_get_node_by_name (vm, (u8 *) "tcp4-established");
+  return vm->error_main.counters[node->error_heap_index + error];
+}
+
+static u32
+tcp_test_coalesce_buffers_used (vlib_main_t *vm)
+{
+  vlib_buffer_pool_t *bp = vlib_get_buffer_pool (vm, 0);
+  vlib_buffer_pool_thread_t *bpt;
+  u32 cached = 0;
+
+  vec_foreach (bpt, bp->threads)
+    cached += bpt->n_cached;
+
+  return bp->n_buffers - bp->n_avail - cached;
+}
+
+static int
+tcp_test_coalesce_data (svm_fifo_t *f, u32 offset, u32 seq, u32 len)
+{
+  u8 *data = 0;
+  int i, rv = 0;
+
+  vec_validate (data, len - 1);
+  if (svm_fifo_peek (f, offset, len, data) != len)
+    rv = -1;
+  for (i = 0; i < len && !rv; i++)
+    if (data[i] != (u8) (seq + i))
+      rv = -1;
+  vec_free (data);
+
+  return rv;
+}
+
+static int
+tcp_test_coalesce (vlib_main_t *vm, unformat_input_t *input)
+{
+  fifo_segment_main_t *sm = &tcp_test_segment_main;
+  fifo_segment_create_args_t _a = {}, *a = &_a;
+  tcp_options_t _opts = {}, *opts = &_opts;
+  u8 rx_coalesce = tcp_cfg.rx_coalesce, *junk = 0;
+  u32 bis[5], seq, fifo_size, used, i;
+  u64 coalesced, errors;
+  fifo_segment_t *fs;
+  tcp_connection_t *tc;
+  svm_fifo_t *f, *txf;
+  session_t *s;
+  int rv;
+
+  a->segment_name = "tcp-coalesce-test";
+  a->segment_size = 256 << 10;
+  a->segment_type = SSVM_SEGMENT_PRIVATE;
+  rv = fifo_segment_create (sm, a);
+  TCP_TEST (!rv, "fifo segment create returned %d", rv);
+  fs = fifo_segment_get_segment (sm, a->new_segment_indices[0]);
+  vec_free (a->new_segment_indices);
+  f = fifo_segment_alloc_fifo_w_slice (fs, 0, 4096, FIFO_SEGMENT_RX_FIFO);
+  txf = fifo_segment_alloc_fifo_w_slice (fs, 0, 4096, FIFO_SEGMENT_TX_FIFO);
+  TCP_TEST (f != 0 && txf != 0, "fifos allocated");
+  fifo_size = svm_fifo_size (f);
+
+  /*
+   * Fake established connection, with session and rx fifo
+   */
+  pool_get (session_main.wrk[0].sessions, s);
+  clib_memset (s, 0, sizeof (*s));
+  s->session_index = s - session_main.wrk[0].sessions;
+  s->session_state = SESSION_STATE_READY;
+  s->rx_fifo = f;
+  s->tx_fifo = txf;
+  /* pending rx event, so enqueues don't notify the missing app */
+  s->flags = SESSION_F_RX_EVT;
+
+  tc = tcp_connection_alloc (0);
+  tc->connection.s_index = s->session_index;
+  s->connection_index = tc->c_c_index;
+  tc->state = TCP_STATE_ESTABLISHED;
+  tc->c_lcl_port = clib_host_to_net_u16 (1234);
+  tc->c_rmt_port = clib_host_to_net_u16 (11234);
+  tc->c_is_ip4 = 1;
+  tc->c_lcl_ip4.as_u32 = clib_host_to_net_u32 (0x06000101);
+  tc->c_rmt_ip4.as_u32 = clib_host_to_net_u32 (0x06000102);
+  tc->rcv_opts.mss = 1460;
+  tc->cfg_flags |= TCP_CFG_F_NO_ENDPOINT;
+  tc->cc_algo = tcp_cc_algo_get (TCP_CC_NEWRENO);
+  tcp_connection_init_vars (tc);
+
+  /* ack already programmed, so none is sent */
+  tc->flags |= TCP_CONN_SNDACK;
+  tc->rcv_nxt = tc->rcv_las = 1000;
+  tc->rcv_wnd = fifo_size;
+  tc->snd_una = tc->snd_nxt = 5000;
+  tc->snd_wnd = 64 << 10;
+
+  tcp_cfg.rx_coalesce = 1;
+
+  /*
+   * In-order segments with equal headers are merged. Last one advertises
+   * a different window so it is received on its own
+   */
+  coalesced = tcp_test_coalesce_errors (vm, TCP_ERROR_COALESCED);
+  seq = tc->rcv_nxt;
+  for (i = 0; i < 5; i++)
+    {
+      bis[i] = tcp_test_coalesce_segment (vm, tc, seq + i * 500, 500,
+					  i < 4 ? 60000 : 61000, 0);
+      TCP_TEST (bis[i] != ~0, "buffer allocated");
+    }
+  tcp_test_coalesce_dispatch (vm, bis, 5);
+
+  TCP_TEST (tc->rcv_nxt == seq + 2500, "rcv_nxt %u", tc->rcv_nxt - seq);
+  TCP_TEST (tc->data_segs_in == 5, "data segs in %u", tc->data_segs_in);
+  errors = tcp_test_coalesce_errors (vm, TCP_ERROR_COALESCED) - coalesced;
+  TCP_TEST (errors == 3, "coalesced %lu", errors);
+  TCP_TEST (svm_fifo_max_dequeue (f) == 2500, "fifo has %u bytes",
+	    svm_fifo_max_dequeue (f));
+  TCP_TEST (!tcp_test_coalesce_data (f, 0, seq, 2500), "fifo data ok");
+  svm_fifo_dequeue_drop (f, 2500);
+
+  /*
+   * Merged run larger than the free space in the fifo is partially
+   * enqueued and rcv_nxt only advances by what was written
+   */
+  vec_validate (junk, fifo_size - 1200 - 1);
+  svm_fifo_enqueue (f, vec_len (junk), junk);
+  vec_free (junk);
+
+  errors = tcp_test_coalesce_errors (vm, TCP_ERROR_PARTIALLY_ENQUEUED);
+  seq = tc->rcv_nxt;
+  for (i = 0; i < 4; i++)
+    {
+      bis[i] = tcp_test_coalesce_segment (vm, tc, seq + i * 500, 500, 60000,
+					  0);
+      TCP_TEST (bis[i] != ~0, "buffer allocated");
+    }
+  tcp_test_coalesce_dispatch (vm, bis, 4);
+
+  TCP_TEST (tc->rcv_nxt == seq + 1200, "rcv_nxt %u", tc->rcv_nxt - seq);
+  errors =
+    tcp_test_coalesce_errors (vm, TCP_ERROR_PARTIALLY_ENQUEUED) - errors;
+  TCP_TEST (errors == 4, "partially enqueued %lu", errors);
+  TCP_TEST (svm_fifo_is_full (f), "fifo is full");
+  TCP_TEST (!tcp_test_coalesce_data (f, fifo_size - 1200, seq, 1200),
+	    "fifo data ok");
+  svm_fifo_dequeue_drop (f, fifo_size);
+
+  /*
+   * Merged run that fails validation, here paws, is dropped as a whole
+   */
+  opts->flags = TCP_OPTS_FLAG_TSTAMP;
+  opts->tsval = 100;
+  tc->rcv_opts.flags |= TCP_OPTS_FLAG_TSTAMP;
+  tc->tsval_recent = 200;
+  tc->tsval_recent_age = tcp_time_tstamp (0);
+
+  coalesced = tcp_test_coalesce_errors (vm, TCP_ERROR_COALESCED);
+  errors = tcp_test_coalesce_errors (vm, TCP_ERROR_PAWS);
+  used = tcp_test_coalesce_buffers_used (vm);
+  seq = tc->rcv_nxt;
+  for (i = 0; i < 4; i++)
+    {
+      bis[i] = tcp_test_coalesce_segment (vm, tc, seq + i * 500, 500, 60000,
+					  opts);
+      TCP_TEST (bis[i] != ~0, "buffer allocated");
+    }
+  tcp_test_coalesce_dispatch (vm, bis, 4);
+
+  TCP_TEST (tc->rcv_nxt == seq, "rcv_nxt %u", tc->rcv_nxt - seq);
+  TCP_TEST (svm_fifo_max_dequeue (f) == 0, "fifo has %u bytes",
+	    svm_fifo_max_dequeue (f));
+  errors = tcp_test_coalesce_errors (vm, TCP_ERROR_PAWS) - errors;
+  TCP_TEST (errors == 4, "paws %lu", errors);
+  errors = tcp_test_coalesce_errors (vm, TCP_ERROR_COALESCED) - coalesced;
+  TCP_TEST (errors == 3, "coalesced %lu", errors);
+  TCP_TEST (tcp_test_coalesce_buffers_used (vm) == used,
+	    "buffers in use %u, expected %u",
+	    tcp_test_coalesce_buffers_used (vm), used);
+
+  tcp_cfg.rx_coalesce = rx_coalesce;
+  tcp_connection_cleanup (tc);
+  pool_put (session_main.wrk[0].sessions, s);
+  fifo_segment_free_fifo (fs, f);
+  fifo_segment_free_fifo (fs, txf);
+  fifo_segment_delete (sm, fs);
+
+  return 0;
+}
+
 static clib_error_t *
 tcp_test (vlib_main_t * vm,
 	  unformat_input_t * input, vlib_cli_command_t * cmd_arg)
@@ -1578,6 +2110,22 @@ tcp_test (vlib_main_t * vm,
 	{
 	  res = tcp_test_bt (vm, input);
 	}
+      else if (unformat (input, "rack"))
+	{
+	  res = tcp_test_rack (vm, input);
+	}
+      else if (unformat (input, "bbr"))
+	{
+	  res = tcp_test_bbr (vm, input);
+	}
+      else if (unformat (input, "cubic"))
+	{
+	  res = tcp_test_cubic (vm, input);
+	}
+      else if (unformat (input, "coalesce"))
+	{
+	  res = tcp_test_coalesce (vm, input);
+	}
       else if (unformat (input, "all"))
 	{
 	  if ((res = tcp_test_sack (vm, input)))
@@ -1586,6 +2134,14 @@ tcp_test (vlib_main_t * vm,
 	    goto done;
 	  if ((res = tcp_test_delivery (vm, input)))
 	    goto done;
+	  if ((res = tcp_test_rack (vm, input)))
+	    goto done;
+	  if ((res = tcp_test_bbr (vm, input)))
+	    goto done;
+	  if ((res = tcp_test_cubic (vm, input)))
+	    goto done;
+	  if ((res = tcp_test_coalesce (vm, input)))
+	    goto done;
 	}
       else
 	break;
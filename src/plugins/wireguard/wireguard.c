@@ -36,6 +36,25 @@ wg_set_async_mode (u32 is_enabled)
     wg_op_mode_unset_ASYNC ();
 }
 
+static walk_rc_t
+wg_peer_reset_send_blocks (index_t peeri, void *arg)
+{
+  noise_remote_reset_send_blocks (&wg_peer_get (peeri)->remote);
+  return (WALK_CONTINUE);
+}
+
+void
+wg_set_parallel_mode (u32 is_enabled)
+{
+  if (is_enabled)
+    wg_op_mode_set_PARALLEL ();
+  else
+    wg_op_mode_unset_PARALLEL ();
+
+  /* reserved nonce blocks are only valid for one parallel period */
+  wg_peer_walk (wg_peer_reset_send_blocks, NULL);
+}
+
 static void
 wireguard_register_post_node (vlib_main_t *vm)
 
@@ -73,8 +73,12 @@ extern wg_main_t wg_main;
 
 /**
  * Wireguard operation mode
+ * parallel: a peer's packets are processed by whichever worker receives
+ * them rather than handed off to the peer's input/output thread
  **/
-#define foreach_wg_op_mode_flags _ (0, ASYNC, "async")
+#define foreach_wg_op_mode_flags                                              \
+  _ (0, ASYNC, "async")                                                       \
+  _ (1, PARALLEL, "parallel")
 
 /**
  * Helper function to set/unset and check op modes
@@ -119,6 +123,7 @@ STATIC_ASSERT (sizeof (wg_post_data_t) <=
 #define WG_START_EVENT	1
 void wg_feature_init (wg_main_t * wmp);
 void wg_set_async_mode (u32 is_enabled);
+void wg_set_parallel_mode (u32 is_enabled);
 
 void wg_secure_zero_memory (void *v, size_t n);
 
@@ -15,7 +15,7 @@
 
 #include <wireguard/wireguard.h>
 #include <wireguard/wireguard_chachapoly.h>
-#include <wireguard/wireguard_hchacha20.h>
+#include <vppinfra/crypto/chacha20_poly1305.h>
 
 bool
 wg_chacha20poly1305_calc (vlib_main_t *vm, u8 *src, u32 src_len, u8 *dst,
@@ -61,33 +61,24 @@ wg_chacha20poly1305_calc (vlib_main_t *vm, u8 *src, u32 src_len, u8 *dst,
   return (op->status == VNET_CRYPTO_OP_STATUS_COMPLETED);
 }
 
+/* XChaCha20-Poly1305 is used only for cookie messages with a one-time key,
+ * so it runs directly on vppinfra implementation instead of registering a
+ * temporary key with the crypto engines */
 void
 wg_xchacha20poly1305_encrypt (vlib_main_t *vm, u8 *src, u32 src_len, u8 *dst,
 			      u8 *aad, u32 aad_len,
 			      u8 nonce[XCHACHA20POLY1305_NONCE_SIZE],
 			      u8 key[CHACHA20POLY1305_KEY_SIZE])
 {
-  int i;
-  u32 derived_key[CHACHA20POLY1305_KEY_SIZE / sizeof (u32)];
-  u64 h_nonce;
+  u8 derived_key[CHACHA20POLY1305_KEY_SIZE];
+  u8 iv[CHACHA20_NONCE_SIZE] = {};
 
-  clib_memcpy (&h_nonce, nonce + 16, sizeof (h_nonce));
-  h_nonce = clib_little_to_host_u64 (h_nonce);
-  hchacha20 (derived_key, nonce, key);
+  clib_hchacha20 (key, nonce, derived_key);
+  clib_memcpy (iv + 4, nonce + 16, sizeof (u64));
 
-  for (i = 0; i < (sizeof (derived_key) / sizeof (derived_key[0])); i++)
-    (derived_key[i]) = clib_host_to_little_u32 ((derived_key[i]));
+  clib_chacha20_poly1305_enc (derived_key, iv, aad, aad_len, src, dst,
+			      src_len, dst + src_len);
 
-  uint32_t key_idx;
-
-  key_idx =
-    vnet_crypto_key_add (vm, VNET_CRYPTO_ALG_CHACHA20_POLY1305,
-			 (uint8_t *) derived_key, CHACHA20POLY1305_KEY_SIZE);
-
-  wg_chacha20poly1305_calc (vm, src, src_len, dst, aad, aad_len, h_nonce,
-			    VNET_CRYPTO_OP_CHACHA20_POLY1305_ENC, key_idx);
-
-  vnet_crypto_key_del (vm, key_idx);
   wg_secure_zero_memory (derived_key, CHACHA20POLY1305_KEY_SIZE);
 }
 
@@ -97,28 +88,21 @@ wg_xchacha20poly1305_decrypt (vlib_main_t *vm, u8 *src, u32 src_len, u8 *dst,
 			      u8 nonce[XCHACHA20POLY1305_NONCE_SIZE],
 			      u8 key[CHACHA20POLY1305_KEY_SIZE])
 {
-  int ret, i;
-  u32 derived_key[CHACHA20POLY1305_KEY_SIZE / sizeof (u32)];
-  u64 h_nonce;
-
-  clib_memcpy (&h_nonce, nonce + 16, sizeof (h_nonce));
-  h_nonce = clib_little_to_host_u64 (h_nonce);
-  hchacha20 (derived_key, nonce, key);
+  u8 derived_key[CHACHA20POLY1305_KEY_SIZE];
+  u8 iv[CHACHA20_NONCE_SIZE] = {};
+  int ret;
 
-  for (i = 0; i < (sizeof (derived_key) / sizeof (derived_key[0])); i++)
-    (derived_key[i]) = clib_host_to_little_u32 ((derived_key[i]));
+  if (src_len < NOISE_AUTHTAG_LEN)
+    return false;
 
-  uint32_t key_idx;
+  src_len -= NOISE_AUTHTAG_LEN;
 
-  key_idx =
-    vnet_crypto_key_add (vm, VNET_CRYPTO_ALG_CHACHA20_POLY1305,
-			 (uint8_t *) derived_key, CHACHA20POLY1305_KEY_SIZE);
+  clib_hchacha20 (key, nonce, derived_key);
+  clib_memcpy (iv + 4, nonce + 16, sizeof (u64));
 
-  ret =
-    wg_chacha20poly1305_calc (vm, src, src_len, dst, aad, aad_len, h_nonce,
-			      VNET_CRYPTO_OP_CHACHA20_POLY1305_DEC, key_idx);
+  ret = clib_chacha20_poly1305_dec (derived_key, iv, aad, aad_len, src, dst,
+				    src_len, src + src_len);
 
-  vnet_crypto_key_del (vm, key_idx);
   wg_secure_zero_memory (derived_key, CHACHA20POLY1305_KEY_SIZE);
 
   return ret;
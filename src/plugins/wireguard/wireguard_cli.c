@@ -385,6 +385,48 @@ VLIB_CLI_COMMAND (wg_set_async_mode_command, static) = {
   .function = wg_set_async_mode_command_fn,
 };
 
+static clib_error_t *
+wg_set_parallel_mode_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				 vlib_cli_command_t *cmd)
+{
+  unformat_input_t _line_input, *line_input = &_line_input;
+  int parallel_enable = 0;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return 0;
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "on"))
+	parallel_enable = 1;
+      else if (unformat (line_input, "off"))
+	parallel_enable = 0;
+      else
+	return (clib_error_return (0, "unknown input '%U'",
+				   format_unformat_error, line_input));
+    }
+
+  wg_set_parallel_mode (parallel_enable);
+
+  unformat_free (line_input);
+  return (NULL);
+}
+
+/*?
+ * Process the packets of a peer on whichever worker receives them, rather
+ * than handing them off to the worker the peer is pinned to. Send nonces
+ * are reserved by each worker in blocks, so the remote peer sees them
+ * slightly out of order. Combined with async mode the crypto work of a
+ * single worker is spread over all workers and completed in order.
+ *
+ * @cliexcmd{set wireguard parallel mode on}
+?*/
+VLIB_CLI_COMMAND (wg_set_parallel_mode_command, static) = {
+  .path = "set wireguard parallel mode",
+  .short_help = "set wireguard parallel mode on|off",
+  .function = wg_set_parallel_mode_command_fn,
+};
+
 static clib_error_t *
 wg_show_mode_command_fn (vlib_main_t *vm, unformat_input_t *input,
 			 vlib_cli_command_t *cmd)
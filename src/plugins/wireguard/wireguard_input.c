@@ -336,7 +336,7 @@ wg_handshake_process (vlib_main_t *vm, wg_main_t *wmp, vlib_buffer_t *b,
 static_always_inline int
 wg_input_post_process (vlib_main_t *vm, vlib_buffer_t *b, u16 *next,
 		       wg_peer_t *peer, message_data_t *data,
-		       bool *is_keepalive)
+		       bool *is_keepalive, u8 is_parallel)
 {
   next[0] = WG_INPUT_NEXT_PUNT;
   noise_keypair_t *kp;
@@ -346,7 +346,8 @@ wg_input_post_process (vlib_main_t *vm, vlib_buffer_t *b, u16 *next,
       NULL)
     return -1;
 
-  if (!noise_counter_recv (&kp->kp_ctr, data->counter))
+  if (is_parallel ? !noise_counter_recv_parallel (kp, data->counter) :
+		    !noise_counter_recv (&kp->kp_ctr, data->counter))
     {
       return -1;
     }
@@ -572,7 +573,7 @@ wg_input_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
 		  vlib_buffer_t *lb, u32 buf_idx, noise_remote_t *r,
 		  uint32_t r_idx, uint64_t nonce, uint8_t *src, size_t srclen,
 		  size_t srclen_total, uint8_t *dst, u32 from_idx, u8 *iv,
-		  f64 time, u8 is_async, u16 async_next_node)
+		  f64 time, u8 is_async, u8 is_parallel, u16 async_next_node)
 {
   noise_keypair_t *kp;
   enum noise_state_crypt ret = SC_FAILED;
@@ -636,7 +637,11 @@ wg_input_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
       clib_rwlock_writer_lock (&r->r_keypair_lock);
       if (kp == r->r_next && kp->kp_local_index == r_idx)
 	{
-	  noise_remote_keypair_free (vm, r, &r->r_previous);
+	  /* other workers may still hold the previous keypair */
+	  if (is_parallel)
+	    noise_remote_keypair_free_from_mt (r, r->r_previous);
+	  else
+	    noise_remote_keypair_free (vm, r, &r->r_previous);
 	  r->r_previous = r->r_current;
 	  r->r_current = r->r_next;
 	  r->r_next = NULL;
@@ -709,6 +714,7 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u16 data_nexts[VLIB_FRAME_SIZE], *data_next = data_nexts, n_data = 0;
   u16 n_async = 0;
   const u8 is_async = wg_op_mode_is_set_ASYNC ();
+  const u8 is_parallel = wg_op_mode_is_set_PARALLEL ();
   vnet_crypto_async_frame_t *async_frame = NULL;
 
   vlib_get_buffers (vm, from, bufs, n_left_from);
@@ -780,7 +786,7 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	      goto out;
 	    }
 
-	  if (PREDICT_FALSE (~0 == peer->input_thread_index))
+	  if (PREDICT_FALSE (!is_parallel && ~0 == peer->input_thread_index))
 	    {
 	      /* this is the first packet to use this peer, claim the peer
 	       * for this thread.
@@ -789,7 +795,9 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 					wg_peer_assign_thread (thread_index));
 	    }
 
-	  if (PREDICT_TRUE (thread_index != peer->input_thread_index))
+	  /* in parallel mode every worker decrypts for the peer */
+	  if (PREDICT_TRUE (!is_parallel &&
+			    thread_index != peer->input_thread_index))
 	    {
 	      other_next[n_other] = WG_INPUT_NEXT_HANDOFF_DATA;
 	      other_bi[n_other] = buf_idx;
@@ -853,7 +861,8 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 			      buf_idx, &peer->remote, data->receiver_index,
 			      data->counter, data->encrypted_data, decr_len,
 			      decr_len_total, data->encrypted_data, n_data,
-			      iv_data, time, is_async, async_next_node);
+			      iv_data, time, is_async, is_parallel,
+			      async_next_node);
 
 	  if (PREDICT_FALSE (state_cr == SC_FAILED))
 	    {
@@ -988,7 +997,8 @@ wg_input_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
       if (PREDICT_TRUE (peer != NULL))
 	{
 	  if (PREDICT_FALSE (wg_input_post_process (vm, b[0], data_next, peer,
-						    data, &is_keepalive) < 0))
+						    data, &is_keepalive,
+						    is_parallel) < 0))
 	    goto trace;
 	}
       else
@@ -1088,6 +1098,7 @@ wg_input_post (vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame,
   index_t peeri = INDEX_INVALID;
   u32 last_rec_idx = ~0;
   f64 time = clib_time_now (&vm->clib_time) + vm->time_offset;
+  const u8 is_parallel = wg_op_mode_is_set_PARALLEL ();
 
   vlib_get_buffers (vm, from, b, n_left);
 
@@ -1135,7 +1146,8 @@ wg_input_post (vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame,
       if (PREDICT_TRUE (peer != NULL))
 	{
 	  if (PREDICT_FALSE (wg_input_post_process (vm, b[0], next, peer, data,
-						    &is_keepalive) < 0))
+						    &is_keepalive,
+						    is_parallel) < 0))
 	    goto trace;
 	}
       else
@@ -16,6 +16,7 @@
  */
 
 #include <openssl/hmac.h>
+#include <vlibmemory/api.h>
 #include <wireguard/wireguard.h>
 #include <wireguard/wireguard_chachapoly.h>
 
@@ -411,6 +412,10 @@ noise_remote_begin_session (vlib_main_t * vm, noise_remote_t * r)
   kp.kp_remote_index = hs->hs_remote_index;
   kp.kp_birthdate = vlib_time_now (vm);
   clib_memset (&kp.kp_ctr, 0, sizeof (kp.kp_ctr));
+  kp.kp_send_blocks = 0;
+  vec_validate_aligned (kp.kp_send_blocks, vlib_get_n_threads () - 1,
+			CLIB_CACHE_LINE_BYTES);
+  clib_spinlock_init (&kp.kp_recv_lock);
 
   /* Now we need to add_new_keypair */
   clib_rwlock_writer_lock (&r->r_keypair_lock);
@@ -483,6 +488,67 @@ noise_remote_expire_current (noise_remote_t * r)
   clib_rwlock_writer_unlock (&r->r_keypair_lock);
 }
 
+typedef struct
+{
+  noise_keypair_t *kp;
+  struct noise_upcall upcall;
+} noise_keypair_free_args_t;
+
+static void
+noise_keypair_free_thread_fn (void *arg)
+{
+  noise_keypair_free_args_t *a = arg;
+
+  noise_keypair_free (vlib_get_main (), &a->upcall, a->kp);
+}
+
+/*
+ * Free a keypair dropped by a worker. In parallel mode other workers may
+ * still be using it, the main thread frees it under the barrier. The
+ * interface, and with it the local, may be deleted before the RPC runs,
+ * so the upcalls are copied rather than looked up from the local index.
+ */
+void
+noise_remote_keypair_free_from_mt (noise_remote_t *r, noise_keypair_t *kp)
+{
+  noise_keypair_free_args_t a = {
+    .kp = kp,
+    .upcall = noise_local_get (r->r_local_idx)->l_upcall,
+  };
+
+  if (kp)
+    vl_api_rpc_call_main_thread (noise_keypair_free_thread_fn, (u8 *) &a,
+				 sizeof (a));
+}
+
+static void
+noise_keypair_reset_send_blocks (noise_keypair_t *kp)
+{
+  noise_counter_block_t *cb;
+
+  if (kp == NULL)
+    return;
+
+  vec_foreach (cb, kp->kp_send_blocks)
+    cb->cb_next = cb->cb_end = 0;
+}
+
+/*
+ * Drop the nonce blocks the workers reserved from the remote's keypairs.
+ * The serial path keeps counting from the shared counter, so a block left
+ * over from before parallel mode was turned off would hand out nonces far
+ * behind it once the mode is turned on again. Called under the barrier.
+ */
+void
+noise_remote_reset_send_blocks (noise_remote_t *r)
+{
+  clib_rwlock_writer_lock (&r->r_keypair_lock);
+  noise_keypair_reset_send_blocks (r->r_next);
+  noise_keypair_reset_send_blocks (r->r_current);
+  noise_keypair_reset_send_blocks (r->r_previous);
+  clib_rwlock_writer_unlock (&r->r_keypair_lock);
+}
+
 bool
 noise_remote_ready (noise_remote_t * r)
 {
@@ -522,7 +588,9 @@ noise_remote_encrypt (vlib_main_t * vm, noise_remote_t * r, uint32_t * r_idx,
   if (!kp->kp_valid ||
       wg_birthdate_has_expired (kp->kp_birthdate, REJECT_AFTER_TIME) ||
       kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      /* atomic, workers may be reserving nonce blocks in parallel mode */
+      ((*nonce = clib_atomic_fetch_add_relax (&kp->kp_ctr.c_send, 1)) >
+       REJECT_AFTER_MESSAGES))
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
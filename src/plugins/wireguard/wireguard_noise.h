@@ -76,6 +76,9 @@ typedef struct noise_handshake
   uint8_t hs_ck[NOISE_HASH_LEN];
 } noise_handshake_t;
 
+/* nonces a worker reserves at a time from a keypair in parallel mode */
+#define NOISE_COUNTER_SEND_BLOCK_SIZE 32
+
 typedef struct noise_counter
 {
   uint64_t c_send;
@@ -83,6 +86,14 @@ typedef struct noise_counter
   unsigned long c_backtrack[COUNTER_NUM];
 } noise_counter_t;
 
+typedef struct noise_counter_block
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  /* next nonce to hand out and end of the reserved block */
+  uint64_t cb_next;
+  uint64_t cb_end;
+} noise_counter_block_t;
+
 typedef struct noise_keypair
 {
   int kp_valid;
@@ -93,6 +104,10 @@ typedef struct noise_keypair
   vnet_crypto_key_index_t kp_recv_index;
   f64 kp_birthdate;
   noise_counter_t kp_ctr;
+  /* parallel mode: per thread block of reserved send nonces */
+  noise_counter_block_t *kp_send_blocks;
+  /* parallel mode: serialises the receive window between workers */
+  clib_spinlock_t kp_recv_lock;
 } noise_keypair_t;
 
 typedef struct noise_local noise_local_t;
@@ -144,6 +159,27 @@ noise_counter_send (noise_counter_t *ctr)
   return ret;
 }
 
+/*
+ * Send nonce for a keypair used by several workers. Each worker reserves
+ * NOISE_COUNTER_SEND_BLOCK_SIZE nonces with one atomic add and hands them
+ * out locally, so the keypair's counter is only touched once per block.
+ */
+static_always_inline uint64_t
+noise_counter_send_parallel (noise_keypair_t *kp, u32 thread_index)
+{
+  noise_counter_block_t *cb =
+    vec_elt_at_index (kp->kp_send_blocks, thread_index);
+
+  if (PREDICT_FALSE (cb->cb_next == cb->cb_end))
+    {
+      cb->cb_next = clib_atomic_fetch_add_relax (
+	&kp->kp_ctr.c_send, NOISE_COUNTER_SEND_BLOCK_SIZE);
+      cb->cb_end = cb->cb_next + NOISE_COUNTER_SEND_BLOCK_SIZE;
+    }
+
+  return cb->cb_next++;
+}
+
 void noise_local_init (noise_local_t *, struct noise_upcall *);
 bool noise_local_set_private (noise_local_t *,
 			      const uint8_t[NOISE_PUBLIC_KEY_LEN]);
@@ -187,6 +223,9 @@ bool noise_consume_response (vlib_main_t * vm, noise_remote_t *,
 bool noise_remote_begin_session (vlib_main_t * vm, noise_remote_t * r);
 void noise_remote_clear (vlib_main_t * vm, noise_remote_t * r);
 void noise_remote_expire_current (noise_remote_t * r);
+void noise_remote_keypair_free_from_mt (noise_remote_t *r,
+					noise_keypair_t *kp);
+void noise_remote_reset_send_blocks (noise_remote_t *r);
 
 bool noise_remote_ready (noise_remote_t *);
 
@@ -258,19 +297,37 @@ error:
   return ret;
 }
 
+/* the receive window of a keypair used by several workers */
+static_always_inline bool
+noise_counter_recv_parallel (noise_keypair_t *kp, uint64_t recv)
+{
+  bool ret;
+
+  clib_spinlock_lock (&kp->kp_recv_lock);
+  ret = noise_counter_recv (&kp->kp_ctr, recv);
+  clib_spinlock_unlock (&kp->kp_recv_lock);
+
+  return ret;
+}
+
+static_always_inline void
+noise_keypair_free (vlib_main_t *vm, const struct noise_upcall *u,
+		    noise_keypair_t *kp)
+{
+  u->u_index_drop (vm, kp->kp_local_index);
+  vnet_crypto_key_del (vm, kp->kp_send_index);
+  vnet_crypto_key_del (vm, kp->kp_recv_index);
+  vec_free (kp->kp_send_blocks);
+  clib_spinlock_free (&kp->kp_recv_lock);
+  clib_mem_free (kp);
+}
+
 static_always_inline void
 noise_remote_keypair_free (vlib_main_t *vm, noise_remote_t *r,
 			   noise_keypair_t **kp)
 {
-  noise_local_t *local = noise_local_get (r->r_local_idx);
-  struct noise_upcall *u = &local->l_upcall;
   if (*kp)
-    {
-      u->u_index_drop (vm, (*kp)->kp_local_index);
-      vnet_crypto_key_del (vm, (*kp)->kp_send_index);
-      vnet_crypto_key_del (vm, (*kp)->kp_recv_index);
-      clib_mem_free (*kp);
-    }
+    noise_keypair_free (vm, &noise_local_get (r->r_local_idx)->l_upcall, *kp);
 }
 
 #endif /* __included_wg_noise_h__ */
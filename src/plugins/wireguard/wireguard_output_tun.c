@@ -269,12 +269,21 @@ wg_output_tun_add_to_frame (vlib_main_t *vm, vnet_crypto_async_frame_t *f,
   f->next_node_index[index] = next_node;
 }
 
+static_always_inline uint64_t
+wg_output_tun_nonce (vlib_main_t *vm, noise_keypair_t *kp, u8 is_parallel)
+{
+  if (is_parallel)
+    return noise_counter_send_parallel (kp, vm->thread_index);
+  return noise_counter_send (&kp->kp_ctr);
+}
+
 static_always_inline enum noise_state_crypt
 wg_output_tun_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
 		       vlib_buffer_t *b, vlib_buffer_t *lb,
 		       vnet_crypto_op_t **crypto_ops, noise_remote_t *r,
 		       uint32_t *r_idx, uint64_t *nonce, uint8_t *src,
-		       size_t srclen, uint8_t *dst, u32 bi, u8 *iv, f64 time)
+		       size_t srclen, uint8_t *dst, u32 bi, u8 *iv, f64 time,
+		       u8 is_parallel)
 {
   noise_keypair_t *kp;
   enum noise_state_crypt ret = SC_FAILED;
@@ -292,7 +301,8 @@ wg_output_tun_process (vlib_main_t *vm, wg_per_thread_data_t *ptd,
       wg_birthdate_has_expired_opt (kp->kp_birthdate, REJECT_AFTER_TIME,
 				    time) ||
       kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      ((*nonce = wg_output_tun_nonce (vm, kp, is_parallel)) >
+       REJECT_AFTER_MESSAGES))
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
@@ -327,7 +337,7 @@ wg_add_to_async_frame (vlib_main_t *vm, wg_per_thread_data_t *ptd,
 		       vlib_buffer_t *b, vlib_buffer_t *lb, u8 *payload,
 		       u32 payload_len, u32 bi, u16 next, u16 async_next,
 		       noise_remote_t *r, uint32_t *r_idx, uint64_t *nonce,
-		       u8 *iv, f64 time)
+		       u8 *iv, f64 time, u8 is_parallel)
 {
   wg_post_data_t *post = wg_post_data (b);
   u8 flag = 0;
@@ -352,7 +362,8 @@ wg_add_to_async_frame (vlib_main_t *vm, wg_per_thread_data_t *ptd,
       wg_birthdate_has_expired_opt (kp->kp_birthdate, REJECT_AFTER_TIME,
 				    time) ||
       kp->kp_ctr.c_recv >= REJECT_AFTER_MESSAGES ||
-      ((*nonce = noise_counter_send (&kp->kp_ctr)) > REJECT_AFTER_MESSAGES))
+      ((*nonce = wg_output_tun_nonce (vm, kp, is_parallel)) >
+       REJECT_AFTER_MESSAGES))
     goto error;
 
   /* We encrypt into the same buffer, so the caller must ensure that buf
@@ -440,6 +451,7 @@ wg_output_tun_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u16 n_sync = 0;
   const u16 drop_next = WG_OUTPUT_NEXT_ERROR;
   const u8 is_async = wg_op_mode_is_set_ASYNC ();
+  const u8 is_parallel = wg_op_mode_is_set_PARALLEL ();
   vnet_crypto_async_frame_t *async_frame = NULL;
   u16 n_async = 0;
   u16 noop_nexts[VLIB_FRAME_SIZE], *noop_next = noop_nexts, n_noop = 0;
@@ -502,7 +514,7 @@ wg_output_tun_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  b[0]->error = node->errors[WG_OUTPUT_ERROR_PEER];
 	  goto out;
 	}
-      if (PREDICT_FALSE (~0 == peer->output_thread_index))
+      if (PREDICT_FALSE (!is_parallel && ~0 == peer->output_thread_index))
 	{
 	  /* this is the first packet to use this peer, claim the peer
 	   * for this thread.
@@ -511,7 +523,9 @@ wg_output_tun_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				    wg_peer_assign_thread (thread_index));
 	}
 
-      if (PREDICT_FALSE (thread_index != peer->output_thread_index))
+      /* in parallel mode every worker encrypts for the peer */
+      if (PREDICT_FALSE (!is_parallel &&
+			 thread_index != peer->output_thread_index))
 	{
 	  noop_next[0] = WG_OUTPUT_NEXT_HANDOFF;
 	  err = WG_OUTPUT_NEXT_HANDOFF;
@@ -628,14 +642,15 @@ wg_output_tun_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    vm, ptd, &async_frame, b[0], lb, plain_data, plain_data_len_total,
 	    bi, next[0], async_next_node, &peer->remote,
 	    &message_data_wg->receiver_index, &message_data_wg->counter,
-	    iv_data, time);
+	    iv_data, time, is_parallel);
 	}
       else
 	{
 	  state = wg_output_tun_process (
 	    vm, ptd, b[0], lb, crypto_ops, &peer->remote,
 	    &message_data_wg->receiver_index, &message_data_wg->counter,
-	    plain_data, plain_data_len, plain_data, n_sync, iv_data, time);
+	    plain_data, plain_data_len, plain_data, n_sync, iv_data, time,
+	    is_parallel);
 	}
 
       if (PREDICT_FALSE (state == SC_KEEP_KEY_FRESH))
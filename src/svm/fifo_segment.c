@@ -271,6 +271,12 @@ pfss_fifo_del_active_list (fifo_slice_private_t *pfss, svm_fifo_t *f)
     }
 }
 
+static inline void
+fss_num_chunks_update (fifo_segment_slice_t *fss, u32 fl_index, int inc)
+{
+  clib_atomic_fetch_add_relax (&fss->num_chunks[fl_index], inc);
+}
+
 static inline uword
 fss_fl_chunk_bytes (fifo_segment_slice_t * fss)
 {
@@ -620,7 +626,7 @@ fsh_try_alloc_chunk_batch (fifo_segment_header_t * fsh,
     }
 
   fss_chunk_free_list_push_list (fsh, fss, fl_index, head, tail);
-  fss->num_chunks[fl_index] += batch_size;
+  fss_num_chunks_update (fss, fl_index, batch_size);
   fss_fl_chunk_bytes_add (fss, total_chunk_bytes);
   fsh_cached_bytes_add (fsh, total_chunk_bytes);
 
@@ -655,6 +661,121 @@ fsh_try_alloc_fifo_hdr (fifo_segment_header_t *fsh, fifo_segment_slice_t *fss)
   return sf;
 }
 
+/**
+ * Try to reclaim free chunk of a given size from other slices
+ *
+ * Slice chunk freelists are lock-free stacks, so chunks cached by idle
+ * slices can be popped by any slice. Reclaimed chunks change ownership,
+ * i.e., they are returned to the freelist of the new slice when freed.
+ */
+static svm_fifo_chunk_t *
+fsh_try_reclaim_chunk (fifo_segment_header_t *fsh, fifo_segment_slice_t *fss,
+		       u32 fl_index)
+{
+  u32 fl_size = fs_freelist_index_to_size (fl_index);
+  fifo_segment_slice_t *ofss;
+  svm_fifo_chunk_t *c;
+  int i;
+
+  for (i = 0; i < fsh->n_slices; i++)
+    {
+      ofss = fsh_slice_get (fsh, i);
+      if (ofss == fss || fss_fl_chunk_bytes (ofss) < fl_size)
+	continue;
+
+      c = fss_chunk_free_list_pop (fsh, ofss, fl_index);
+      if (!c)
+	continue;
+
+      c->next = 0;
+      fss_fl_chunk_bytes_sub (ofss, fl_size);
+      fsh_cached_bytes_sub (fsh, fl_size);
+      fss_num_chunks_update (ofss, fl_index, -1);
+      fss_num_chunks_update (fss, fl_index, 1);
+      clib_atomic_fetch_add_relax (&fsh->n_reclaimed_chunks, 1);
+      return c;
+    }
+
+  return 0;
+}
+
+/**
+ * Try to split free chunk larger than requested size
+ *
+ * Last resort once segment has no free bytes left. The smallest larger
+ * chunk found, in this or other slices, is carved into chunks of the
+ * requested size. The first is returned and the rest are added to the
+ * slice's freelist. Because of the additional chunk headers, not all of
+ * the memory of the larger chunk can be reused.
+ */
+static svm_fifo_chunk_t *
+fsh_try_split_chunk (fifo_segment_header_t *fsh, fifo_segment_slice_t *fss,
+		     u32 fl_index)
+{
+  u32 fl_size, big_index, big_size, n_chunks, slice_index, i;
+  svm_fifo_chunk_t *c = 0, *head = 0, *tail = 0;
+  fifo_segment_slice_t *ofss = 0;
+  u8 *cmem;
+
+  slice_index = fss - fsh->slices;
+
+  for (big_index = fl_index + 1; big_index < FS_CHUNK_VEC_LEN; big_index++)
+    {
+      big_size = fs_freelist_index_to_size (big_index);
+      for (i = 0; i < fsh->n_slices; i++)
+	{
+	  ofss = fsh_slice_get (fsh, (slice_index + i) % fsh->n_slices);
+	  if (fss_fl_chunk_bytes (ofss) < big_size)
+	    continue;
+	  c = fss_chunk_free_list_pop (fsh, ofss, big_index);
+	  if (c)
+	    goto split;
+	}
+    }
+
+  return 0;
+
+split:
+
+  fss_fl_chunk_bytes_sub (ofss, big_size);
+  fsh_cached_bytes_sub (fsh, big_size);
+  fss_num_chunks_update (ofss, big_index, -1);
+
+  fl_size = fs_freelist_index_to_size (fl_index);
+  n_chunks = (sizeof (*c) + big_size) / (sizeof (*c) + fl_size);
+
+  cmem = (u8 *) c;
+  for (i = 0; i < n_chunks; i++)
+    {
+      c = (svm_fifo_chunk_t *) cmem;
+      c->start_byte = 0;
+      c->length = fl_size;
+      c->next = fs_chunk_sptr (fsh, head);
+      if (!tail)
+	tail = c;
+      head = c;
+      cmem += sizeof (*c) + fl_size;
+    }
+
+  fss_num_chunks_update (fss, fl_index, n_chunks);
+  clib_atomic_fetch_add_relax (&fsh->n_split_chunks, 1);
+  clib_atomic_fetch_add_relax (&fsh->n_split_lost_bytes,
+			       big_size - n_chunks * fl_size);
+
+  /* Keep last chunk carved and add the others to the freelist */
+  c = head;
+  if (n_chunks > 1)
+    {
+      head = fs_chunk_ptr (fsh, c->next);
+      fss_chunk_free_list_push_list (fsh, fss, fl_index, head, tail);
+      fss_fl_chunk_bytes_add (fss, (n_chunks - 1) * fl_size);
+      fsh_cached_bytes_add (fsh, (n_chunks - 1) * fl_size);
+    }
+  c->next = 0;
+
+  return c;
+}
+
 static svm_fifo_chunk_t *
 fsh_try_alloc_chunk (fifo_segment_header_t * fsh,
 		     fifo_segment_slice_t * fss, u32 data_bytes)
@@ -677,6 +798,11 @@ free_list:
       u32 chunk_size, batch = FIFO_SEGMENT_ALLOC_BATCH_SIZE;
       uword n_free;
 
+      /* Reuse chunks other slices do not need before growing */
+      c = fsh_try_reclaim_chunk (fsh, fss, fl_index);
+      if (c)
+	goto done;
+
       chunk_size = fs_freelist_index_to_size (fl_index);
       n_free = fsh_n_free_bytes (fsh);
 
@@ -712,6 +838,9 @@ free_list:
 
 done:
 
+  if (!c)
+    c = fsh_try_split_chunk (fsh, fss, fl_index);
+
   return c;
 }
 
@@ -1444,6 +1573,24 @@ fifo_segment_fl_chunk_bytes (fifo_segment_t * fs)
   return n_bytes;
 }
 
+uword
+fifo_segment_num_reclaimed_chunks (fifo_segment_t *fs)
+{
+  return clib_atomic_load_relax_n (&fs->h->n_reclaimed_chunks);
+}
+
+uword
+fifo_segment_num_split_chunks (fifo_segment_t *fs)
+{
+  return clib_atomic_load_relax_n (&fs->h->n_split_chunks);
+}
+
+uword
+fifo_segment_split_lost_bytes (fifo_segment_t *fs)
+{
+  return clib_atomic_load_relax_n (&fs->h->n_split_lost_bytes);
+}
+
 u8
 fifo_segment_has_fifos (fifo_segment_t * fs)
 {
@@ -1613,6 +1760,11 @@ format_fifo_segment (u8 * s, va_list * args)
 	      format_memory_size, chunk_bytes, chunk_bytes,
 	      format_memory_size, est_chunk_bytes, est_chunk_bytes,
 	      format_memory_size, tracked_cached_bytes, tracked_cached_bytes);
+  s = format (s, "%Uchunks reclaimed: %lu split: %lu split lost bytes: %U\n",
+	      format_white_space, indent + 2,
+	      fifo_segment_num_reclaimed_chunks (fs),
+	      fifo_segment_num_split_chunks (fs), format_memory_size,
+	      fifo_segment_split_lost_bytes (fs));
   s = format (s, "%Ufifo active: %u hdr free: %u bytes: %U (%u) \n",
 	      format_white_space, indent + 2, fsh->n_active_fifos, free_fifos,
 	      format_memory_size, fifo_hdr, fifo_hdr);
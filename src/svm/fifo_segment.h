@@ -318,6 +318,30 @@ uword fifo_segment_available_bytes (fifo_segment_t * fs);
  * @return		free bytes on chunk free lists
  */
 uword fifo_segment_fl_chunk_bytes (fifo_segment_t * fs);
+
+/**
+ * Number of chunks slices reclaimed from other slices' free lists
+ *
+ * @param fs		fifo segment
+ * @return		number of reclaimed chunks
+ */
+uword fifo_segment_num_reclaimed_chunks (fifo_segment_t *fs);
+
+/**
+ * Number of free chunks split into smaller chunks
+ *
+ * @param fs		fifo segment
+ * @return		number of split chunks
+ */
+uword fifo_segment_num_split_chunks (fifo_segment_t *fs);
+
+/**
+ * Bytes lost to chunk headers and remainders when splitting chunks
+ *
+ * @param fs		fifo segment
+ * @return		bytes no longer usable as fifo memory
+ */
+uword fifo_segment_split_lost_bytes (fifo_segment_t *fs);
 u8 fifo_segment_has_fifos (fifo_segment_t * fs);
 svm_fifo_t *fifo_segment_get_slice_fifo_list (fifo_segment_t * fs,
 					      u32 slice_index);
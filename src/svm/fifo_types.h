@@ -51,6 +51,7 @@ typedef struct
   u32 prev;	/**< Previous linked-list element pool index */
   u32 start;	/**< Start of segment, normalized*/
   u32 length;	/**< Length of segment */
+  u32 rb_index;	/**< Node index in ooo segment rbtree */
 } ooo_segment_t;
 
 typedef struct
@@ -96,6 +97,7 @@ typedef struct _svm_fifo
   rb_tree_t ooo_deq_lookup;	 /**< rbtree for ooo deq chunk lookup */
   svm_fifo_chunk_t *ooo_deq;	 /**< last chunk used for ooo dequeue */
   svm_fifo_chunk_t *ooo_enq;	 /**< last chunk used for ooo enqueue */
+  rb_tree_t ooo_seg_lookup;	 /**< rbtree for ooo segment lookup */
   ooo_segment_t *ooo_segments;	 /**< Pool of ooo segments */
   u32 ooos_list_head;		 /**< Head of out-of-order linked-list */
   u32 ooos_newest;		 /**< Last segment to have been updated */
@@ -160,6 +162,9 @@ struct fifo_segment_header_
   u8 n_slices;				/**< Number of slices */
   u8 pct_first_alloc;			/**< Pct of fifo size to alloc */
   u8 n_mqs;				/**< Num mqs for mqs segment */
+  uword n_reclaimed_chunks;		/**< Chunks taken from other slices */
+  uword n_split_chunks;			/**< Chunks split into smaller ones */
+  uword n_split_lost_bytes;		/**< Bytes lost when splitting */
   CLIB_CACHE_LINE_ALIGN_MARK (allocator);
   uword byte_index;
   uword max_byte_index;
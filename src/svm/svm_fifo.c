@@ -105,6 +105,44 @@ svm_fifo_copy_from_chunk (svm_fifo_t *f, svm_fifo_chunk_t *c, u32 head_idx,
 						   last);
 }
 
+static rb_node_t *
+f_find_node_rbtree (rb_tree_t * rt, u32 pos)
+{
+  rb_node_t *cur, *prev;
+
+  cur = rb_node (rt, rt->root);
+  if (PREDICT_FALSE (rb_node_is_tnil (rt, cur)))
+    return 0;
+
+  while (pos != cur->key)
+    {
+      prev = cur;
+      if (f_pos_lt (pos, cur->key))
+	{
+	  cur = rb_node_left (rt, cur);
+	  if (rb_node_is_tnil (rt, cur))
+	    {
+	      cur = rb_tree_predecessor (rt, prev);
+	      break;
+	    }
+	}
+      else
+	{
+	  cur = rb_node_right (rt, cur);
+	  if (rb_node_is_tnil (rt, cur))
+	    {
+	      cur = prev;
+	      break;
+	    }
+	}
+    }
+
+  if (rb_node_is_tnil (rt, cur))
+    return 0;
+
+  return cur;
+}
+
 static inline u32
 ooo_segment_end_pos (ooo_segment_t * s)
 {
@@ -115,6 +153,7 @@ void
 svm_fifo_free_ooo_data (svm_fifo_t * f)
 {
   pool_free (f->ooo_segments);
+  rb_tree_free_nodes (&f->ooo_seg_lookup);
 }
 
 static inline ooo_segment_t *
@@ -136,6 +175,7 @@ ooo_segment_next (svm_fifo_t * f, ooo_segment_t * s)
 static inline ooo_segment_t *
 ooo_segment_alloc (svm_fifo_t * f, u32 start, u32 length)
 {
+  rb_tree_t *rt = &f->ooo_seg_lookup;
   ooo_segment_t *s;
 
   pool_get (f->ooo_segments, s);
@@ -144,6 +184,12 @@ ooo_segment_alloc (svm_fifo_t * f, u32 start, u32 length)
   s->length = length;
   s->prev = s->next = OOO_SEGMENT_INVALID_INDEX;
 
+  if (PREDICT_FALSE (!rb_tree_is_init (rt)))
+    rb_tree_init (rt);
+
+  s->rb_index =
+    rb_tree_add_custom (rt, start, s - f->ooo_segments, f_pos_lt);
+
   return s;
 }
 
@@ -153,6 +199,9 @@ ooo_segment_free (svm_fifo_t * f, u32 index)
   ooo_segment_t *cur, *prev = 0, *next = 0;
   cur = pool_elt_at_index (f->ooo_segments, index);
 
+  rb_tree_del_node (&f->ooo_seg_lookup,
+		    rb_node (&f->ooo_seg_lookup, cur->rb_index));
+
   if (cur->next != OOO_SEGMENT_INVALID_INDEX)
     {
       next = pool_elt_at_index (f->ooo_segments, cur->next);
@@ -182,6 +231,7 @@ ooo_segment_add (svm_fifo_t * f, u32 offset, u32 head, u32 tail, u32 length)
   ooo_segment_t *s, *new_s, *prev, *next, *it;
   u32 new_index, s_end_pos, s_index;
   u32 offset_pos, offset_end_pos;
+  rb_node_t *n;
 
   ASSERT (offset + length <= f_free_count (f, head, tail));
 
@@ -198,11 +248,20 @@ ooo_segment_add (svm_fifo_t * f, u32 offset, u32 head, u32 tail, u32 length)
       return;
     }
 
-  /* Find first segment that starts after new segment */
-  s = pool_elt_at_index (f->ooo_segments, f->ooos_list_head);
-  while (s->next != OOO_SEGMENT_INVALID_INDEX
-	 && f_pos_lt (s->start, offset_pos))
-    s = pool_elt_at_index (f->ooo_segments, s->next);
+  /* Find first segment that starts after new segment, or last segment if
+   * none does. Lookup last segment that starts before it in the rbtree */
+  n = f_find_node_rbtree (&f->ooo_seg_lookup, offset_pos);
+  if (!n)
+    {
+      s = pool_elt_at_index (f->ooo_segments, f->ooos_list_head);
+    }
+  else
+    {
+      s = pool_elt_at_index (f->ooo_segments, n->opaque);
+      if (f_pos_lt (s->start, offset_pos)
+	  && s->next != OOO_SEGMENT_INVALID_INDEX)
+	s = pool_elt_at_index (f->ooo_segments, s->next);
+    }
 
   /* If we have a previous and we overlap it, use it as starting point */
   prev = ooo_segment_prev (f, s);
@@ -271,6 +330,10 @@ ooo_segment_add (svm_fifo_t * f, u32 offset, u32 head, u32 tail, u32 length)
   /* Merge at head */
   if (f_pos_lt (offset_pos, s->start))
     {
+      /* Segments do not overlap so this does not change the order of
+       * keys in the rbtree. Update the key in place */
+      n = rb_node (&f->ooo_seg_lookup, s->rb_index);
+      n->key = offset_pos;
       s->start = offset_pos;
       s->length = s_end_pos - s->start;
       f->ooos_newest = s - f->ooo_segments;
@@ -537,44 +600,6 @@ svm_fifo_max_write_chunk (svm_fifo_t * f)
   return tail_chunk ? f_chunk_end (tail_chunk) - tail : 0;
 }
 
-static rb_node_t *
-f_find_node_rbtree (rb_tree_t * rt, u32 pos)
-{
-  rb_node_t *cur, *prev;
-
-  cur = rb_node (rt, rt->root);
-  if (PREDICT_FALSE (rb_node_is_tnil (rt, cur)))
-    return 0;
-
-  while (pos != cur->key)
-    {
-      prev = cur;
-      if (f_pos_lt (pos, cur->key))
-	{
-	  cur = rb_node_left (rt, cur);
-	  if (rb_node_is_tnil (rt, cur))
-	    {
-	      cur = rb_tree_predecessor (rt, prev);
-	      break;
-	    }
-	}
-      else
-	{
-	  cur = rb_node_right (rt, cur);
-	  if (rb_node_is_tnil (rt, cur))
-	    {
-	      cur = prev;
-	      break;
-	    }
-	}
-    }
-
-  if (rb_node_is_tnil (rt, cur))
-    return 0;
-
-  return cur;
-}
-
 static svm_fifo_chunk_t *
 f_find_chunk_rbtree (rb_tree_t * rt, u32 pos)
 {
@@ -1273,6 +1298,56 @@ svm_fifo_provision_chunks (svm_fifo_t *f, svm_fifo_seg_t *fs, u32 n_segs,
   return fs_index;
 }
 
+int
+svm_fifo_enqueue_reserve (svm_fifo_t *f, u32 offset, svm_fifo_seg_t *fs,
+			  u32 *n_segs, u32 max_bytes)
+{
+  u32 head, tail, free_count, len, start, n_bytes, pos, fs_index = 1;
+  svm_fifo_chunk_t *c;
+
+  f_load_head_tail_prod (f, &head, &tail);
+
+  /* free space in fifo can only increase while we're working: SPSC */
+  free_count = f_free_count (f, head, tail);
+
+  if (PREDICT_FALSE (free_count <= offset))
+    return SVM_FIFO_EFULL;
+
+  len = clib_min (free_count - offset, max_bytes);
+
+  if (f_pos_gt (tail + offset + len, f_chunk_end (f_end_cptr (f))))
+    {
+      if (PREDICT_FALSE (f_try_chunk_alloc (f, head, tail, offset + len)))
+	{
+	  if (!f_pos_gt (f_chunk_end (f_end_cptr (f)), tail + offset))
+	    return SVM_FIFO_EGROW;
+	  len = f_chunk_end (f_end_cptr (f)) - (tail + offset);
+	}
+    }
+
+  start = tail + offset;
+  c = f_tail_cptr (f);
+  while (!f_chunk_includes_pos (c, start))
+    c = f_cptr (f, c->next);
+
+  pos = start - c->start_byte;
+  fs[0].data = c->data + pos;
+  fs[0].len = clib_min (c->length - pos, len);
+  n_bytes = fs[0].len;
+
+  while (n_bytes < len && fs_index < *n_segs)
+    {
+      c = f_cptr (f, c->next);
+      fs[fs_index].data = c->data;
+      fs[fs_index].len = clib_min (c->length, len - n_bytes);
+      n_bytes += fs[fs_index].len;
+      fs_index += 1;
+    }
+  *n_segs = fs_index;
+
+  return n_bytes;
+}
+
 int
 svm_fifo_segments (svm_fifo_t *f, u32 offset, svm_fifo_seg_t *fs, u32 *n_segs,
 		   u32 max_bytes)
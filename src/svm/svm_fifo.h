@@ -348,6 +348,26 @@ int svm_fifo_enqueue_with_offset (svm_fifo_t * f, u32 offset, u32 len,
  * @param len		number of bytes to add to tail
  */
 void svm_fifo_enqueue_nocopy (svm_fifo_t * f, u32 len);
+/**
+ * Reserve fifo chunk space for zero-copy enqueue
+ *
+ * Populates fifo segment array with pointers to free space in fifo chunks,
+ * starting at offset from tail, and allocates chunks if needed. Data
+ * written to the segments is not visible to the consumer until it is
+ * committed, in order, with @ref svm_fifo_enqueue_nocopy. Producer can
+ * therefore hold multiple disjoint reservations, by passing in offsets
+ * past those already reserved, and publish all of them with one commit.
+ *
+ * @param f		fifo
+ * @param offset	offset from tail where reservation starts
+ * @param fs		array of fifo segments allocated by caller
+ * @param n_segs	number of fifo segments in array, updated with
+ *			number of segments populated
+ * @param max_bytes	max bytes to be reserved
+ * @return		number of bytes reserved or error
+ */
+int svm_fifo_enqueue_reserve (svm_fifo_t *f, u32 offset, svm_fifo_seg_t *fs,
+			      u32 *n_segs, u32 max_bytes);
 /**
  * Enqueue array of @ref svm_fifo_seg_t in order
  *
@@ -43,6 +43,7 @@ vppcom_cfg_init (vppcom_cfg_t * vcl_cfg)
   vcl_cfg->app_timeout = 10 * 60.0;
   vcl_cfg->session_timeout = 10 * 60.0;
   vcl_cfg->event_log_path = "/dev/shm";
+  vcl_cfg->vls_max_sessions = 1 << 16;
 }
 
 #define VCFG_DBG(_lvl, _fmt, _args...) 			\
@@ -458,12 +459,25 @@ vppcom_cfg_read_file (char *conf_fname)
 	      VCFG_DBG (0, "VCL<%d>: configured tls-engine %u (0x%x)",
 			getpid (), vcl_cfg->tls_engine, vcl_cfg->tls_engine);
 	    }
+	  else if (unformat (line_input, "multi-thread-workers lockless"))
+	    {
+	      vcl_cfg->mt_wrk_supported = 1;
+	      vcl_cfg->mt_wrk_lockless = 1;
+	      VCFG_DBG (0, "VCL<%d>: configured with lockless multithread "
+			"workers", getpid ());
+	    }
 	  else if (unformat (line_input, "multi-thread-workers"))
 	    {
 	      vcl_cfg->mt_wrk_supported = 1;
 	      VCFG_DBG (0, "VCL<%d>: configured with multithread workers",
 			getpid ());
 	    }
+	  else if (unformat (line_input, "vls-max-sessions %u",
+			     &vcl_cfg->vls_max_sessions))
+	    {
+	      VCFG_DBG (0, "VCL<%d>: configured vls-max-sessions %u",
+			getpid (), vcl_cfg->vls_max_sessions);
+	    }
 	  else if (unformat (line_input, "app_original_dst"))
 	    {
 	      vcl_cfg->app_original_dst = 1;
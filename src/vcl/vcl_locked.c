@@ -76,6 +76,15 @@
  *    share rpc request is sent to the owning thread via vcl and vpp.
  *    Consequently, a vls session can map to multiple vcl sessions, one per
  *    vcl worker. VLS sessions are locked on use (implicit sharing).
+ *    If configured as lockless, i.e., "multi-thread-workers lockless", the
+ *    vls pool is preallocated so lookups do not take the vls pool lock,
+ *    sh to vlsh tables are kept per vcl worker and vls session locks are
+ *    replaced by an ownership word. A thread that finds the session in use
+ *    waits for the holder to hand it over and, once owner, checks that the
+ *    session was not freed and reallocated meanwhile.
+ *    Sessions are still migrated lazily to the worker of the calling thread
+ *    and epoll sessions are per worker, so threads do not hold them while
+ *    waiting for events.
  *
  * 3) single-worker multi-thread: vls does not make any assumptions about
  *    application threads and therefore implements an aggressive locking
@@ -110,6 +119,27 @@ typedef enum vls_flags_
 #undef _
 } vls_flags_t;
 
+#define VLS_MT_OWN_MAX_SPINS 128
+
+/** Ownership of vls with lockless multi-thread workers */
+typedef union vls_owner_
+{
+  struct
+  {
+    u32 next;	 /**< ticket handed to next thread that wants vls */
+    u32 serving; /**< ticket of thread that owns vls */
+  };
+  u64 as_u64;
+} vls_owner_t;
+
+/** Owner and generation of a vls pool slot with lockless multi-thread
+ * workers. Kept out of the pool, as waiters use them after a free */
+typedef struct vls_mt_slot_
+{
+  volatile vls_owner_t owner; /**< vls owner */
+  volatile u32 gen;	      /**< bumped on free */
+} vls_mt_slot_t;
+
 typedef struct vcl_locked_session_
 {
   clib_spinlock_t lock;	   /**< vls lock when in use */
@@ -123,11 +153,19 @@ typedef struct vcl_locked_session_
   vls_flags_t flags;			 /**< vls flags */
 } vcl_locked_session_t;
 
+typedef struct vls_sh_to_vlsh_table_
+{
+  clib_rwlock_t lock; /**< taken by writer and by other wrks' readers */
+  uword *table;	      /**< map from vcl sh to vls sh */
+} vls_sh_to_vlsh_table_t;
+
 typedef struct vls_worker_
 {
   clib_rwlock_t sh_to_vlsh_table_lock; /**< ht rwlock with mt workers */
   vcl_locked_session_t *vls_pool;      /**< pool of vls session */
+  vls_mt_slot_t *vls_mt_slots;	       /**< vls owners, if lockless */
   uword *sh_to_vlsh_table;	       /**< map from vcl sh to vls sh */
+  vls_sh_to_vlsh_table_t *sh_to_vlsh_tables; /**< per vcl wrk, if lockless */
   u32 *pending_vcl_wrk_cleanup;	       /**< child vcl wrks to cleanup */
   u32 vcl_wrk_index;		       /**< if 1:1 map vls to vcl wrk */
 } vls_worker_t;
@@ -140,6 +178,7 @@ typedef struct vls_local_
   pthread_mutex_t vls_mt_mq_mlock;    /**< vcl mq lock */
   pthread_mutex_t vls_mt_spool_mlock; /**< vcl select or pool lock */
   volatile u8 select_mp_check;	      /**< flag set if select checks done */
+  u8 mt_lockless;		      /**< lockless multi-thread workers */
   struct sigaction old_sa;	      /**< old sigaction to restore */
 } vls_process_local_t;
 
@@ -262,17 +301,20 @@ vls_shared_data_pool_runlock (void)
   clib_rwlock_reader_unlock (&vlsm->shared_data_lock);
 }
 
+/* Lockless vls pools are preallocated, so readers need not synchronize with
+ * writers. Only allocs and frees take the pool lock. */
+
 static inline void
 vls_mt_pool_rlock (void)
 {
-  if (vlsl->vls_mt_n_threads > 1)
+  if (vlsl->vls_mt_n_threads > 1 && !vlsl->mt_lockless)
     clib_rwlock_reader_lock (&vlsl->vls_pool_lock);
 }
 
 static inline void
 vls_mt_pool_runlock (void)
 {
-  if (vlsl->vls_mt_n_threads > 1)
+  if (vlsl->vls_mt_n_threads > 1 && !vlsl->mt_lockless)
     clib_rwlock_reader_unlock (&vlsl->vls_pool_lock);
 }
 
@@ -368,16 +410,82 @@ vls_is_shared (vcl_locked_session_t * vls)
   return (vls->shared_data_index != ~0);
 }
 
+static vls_worker_t *
+vls_worker_get_current (void)
+{
+  return pool_elt_at_index (vlsm->workers, vls_get_worker_index ());
+}
+
+/*
+ * With lockless multi-thread workers, vls locks are replaced by an owner
+ * word. Threads that want a vls in use take a ticket and the holder hands
+ * the session over to the next ticket on release, so ownership passes in
+ * request order and a thread cannot be starved by others that keep
+ * reacquiring the session.
+ */
+
+static inline vls_mt_slot_t *
+vls_mt_slot (vcl_locked_session_t *vls)
+{
+  vls_worker_t *wrk = vls_worker_get_current ();
+  /* No read of vls, it may be free */
+  return wrk->vls_mt_slots + (vls - wrk->vls_pool);
+}
+
+static inline int
+vls_mt_try_own (vcl_locked_session_t *vls)
+{
+  vls_mt_slot_t *slot = vls_mt_slot (vls);
+  vls_owner_t old, new;
+
+  old.as_u64 = clib_atomic_load_relax_n (&slot->owner.as_u64);
+  if (old.next != old.serving)
+    return 0;
+  new = old;
+  new.next += 1;
+  return clib_atomic_cmp_and_swap_acq_relax_n (&slot->owner.as_u64,
+					       &old.as_u64, new.as_u64, 0);
+}
+
+static inline void
+vls_mt_own (vcl_locked_session_t *vls)
+{
+  vls_mt_slot_t *slot = vls_mt_slot (vls);
+  u32 ticket, n_spins = 0;
+
+  ticket = clib_atomic_fetch_add (&slot->owner.next, 1);
+  while (clib_atomic_load_acq_n (&slot->owner.serving) != ticket)
+    {
+      /* Holder or next in line may not be running, let them run */
+      if (++n_spins < VLS_MT_OWN_MAX_SPINS)
+	CLIB_PAUSE ();
+      else
+	sched_yield ();
+    }
+}
+
+static inline void
+vls_mt_release (vcl_locked_session_t *vls)
+{
+  vls_mt_slot_t *slot = vls_mt_slot (vls);
+
+  clib_atomic_store_rel_n (&slot->owner.serving, slot->owner.serving + 1);
+}
+
 static inline void
 vls_lock (vcl_locked_session_t * vls)
 {
-  if ((vlsl->vls_mt_n_threads > 1) || vls_is_shared (vls))
+  if (vlsl->mt_lockless)
+    vls_mt_own (vls);
+  else if ((vlsl->vls_mt_n_threads > 1) || vls_is_shared (vls))
     clib_spinlock_lock (&vls->lock);
 }
 
 static inline int
 vls_trylock (vcl_locked_session_t *vls)
 {
+  if (vlsl->mt_lockless)
+    return !vls_mt_try_own (vls);
   if ((vlsl->vls_mt_n_threads > 1) || vls_is_shared (vls))
     return !clib_spinlock_trylock (&vls->lock);
   return 0;
@@ -386,7 +494,9 @@ vls_trylock (vcl_locked_session_t *vls)
 static inline void
 vls_unlock (vcl_locked_session_t * vls)
 {
-  if ((vlsl->vls_mt_n_threads > 1) || vls_is_shared (vls))
+  if (vlsl->mt_lockless)
+    vls_mt_release (vls);
+  else if ((vlsl->vls_mt_n_threads > 1) || vls_is_shared (vls))
     clib_spinlock_unlock (&vls->lock);
 }
 
@@ -405,18 +515,27 @@ vls_to_sh_tu (vcl_locked_session_t * vls)
   return sh;
 }
 
-static vls_worker_t *
-vls_worker_get_current (void)
-{
-  return pool_elt_at_index (vlsm->workers, vls_get_worker_index ());
-}
-
 static inline u8
 vls_n_workers (void)
 {
   return pool_elts (vlsm->workers);
 }
 
+static void
+vls_worker_lockless_init (vls_worker_t *wrk)
+{
+  vls_sh_to_vlsh_table_t *t;
+
+  pool_init_fixed (wrk->vls_pool, vcm->cfg.vls_max_sessions);
+  /* Owners survive frees, so they are initialized only once */
+  vec_validate_aligned (wrk->vls_mt_slots, vcm->cfg.vls_max_sessions - 1,
+			CLIB_CACHE_LINE_BYTES);
+
+  vec_validate (wrk->sh_to_vlsh_tables, vcm->cfg.max_workers - 1);
+  vec_foreach (t, wrk->sh_to_vlsh_tables)
+    clib_rwlock_init (&t->lock);
+}
+
 static vls_worker_t *
 vls_worker_alloc (void)
 {
@@ -425,6 +544,8 @@ vls_worker_alloc (void)
   pool_get_zero (vlsm->workers, wrk);
   if (vls_mt_wrk_supported ())
     clib_rwlock_init (&wrk->sh_to_vlsh_table_lock);
+  if (vlsl->mt_lockless)
+    vls_worker_lockless_init (wrk);
   wrk->vcl_wrk_index = vcl_get_worker_index ();
   vec_validate (wrk->pending_vcl_wrk_cleanup, 16);
   vec_reset_length (wrk->pending_vcl_wrk_cleanup);
@@ -435,10 +556,19 @@ vls_worker_alloc (void)
 static void
 vls_worker_free (vls_worker_t * wrk)
 {
+  vls_sh_to_vlsh_table_t *t;
+
   hash_free (wrk->sh_to_vlsh_table);
+  vec_foreach (t, wrk->sh_to_vlsh_tables)
+    {
+      hash_free (t->table);
+      clib_rwlock_free (&t->lock);
+    }
+  vec_free (wrk->sh_to_vlsh_tables);
   if (vls_mt_wrk_supported ())
     clib_rwlock_free (&wrk->sh_to_vlsh_table_lock);
   pool_free (wrk->vls_pool);
+  vec_free (wrk->vls_mt_slots);
   pool_put (vlsm->workers, wrk);
 }
 
@@ -450,9 +580,30 @@ vls_worker_get (u32 wrk_index)
   return pool_elt_at_index (vlsm->workers, wrk_index);
 }
 
+/* With lockless mt workers, sh to vlsh tables are per vcl worker and only
+ * updated by the thread of that worker, i.e., sessions are added when
+ * allocated or migrated and removed on close or on cleanup rpc. So the
+ * owning thread reads its table without locking and only other threads,
+ * e.g., on worker cleanup, synchronize with its updates. */
+
+static inline vls_sh_to_vlsh_table_t *
+vls_sh_to_vlsh_table_lockless (vls_worker_t *wrk, vcl_session_handle_t sh)
+{
+  return vec_elt_at_index (wrk->sh_to_vlsh_tables, vppcom_session_worker (sh));
+}
+
 static void
 vls_sh_to_vlsh_table_add (vls_worker_t *wrk, vcl_session_handle_t sh, u32 vlsh)
 {
+  if (vlsl->mt_lockless)
+    {
+      vls_sh_to_vlsh_table_t *t = vls_sh_to_vlsh_table_lockless (wrk, sh);
+      ASSERT (vppcom_session_worker (sh) == vcl_get_worker_index ());
+      clib_rwlock_writer_lock (&t->lock);
+      hash_set (t->table, sh, vlsh);
+      clib_rwlock_writer_unlock (&t->lock);
+      return;
+    }
   if (vls_mt_wrk_supported ())
     clib_rwlock_writer_lock (&wrk->sh_to_vlsh_table_lock);
   hash_set (wrk->sh_to_vlsh_table, sh, vlsh);
@@ -463,6 +614,15 @@ vls_sh_to_vlsh_table_add (vls_worker_t *wrk, vcl_session_handle_t sh, u32 vlsh)
 static void
 vls_sh_to_vlsh_table_del (vls_worker_t *wrk, vcl_session_handle_t sh)
 {
+  if (vlsl->mt_lockless)
+    {
+      vls_sh_to_vlsh_table_t *t = vls_sh_to_vlsh_table_lockless (wrk, sh);
+      ASSERT (vppcom_session_worker (sh) == vcl_get_worker_index ());
+      clib_rwlock_writer_lock (&t->lock);
+      hash_unset (t->table, sh);
+      clib_rwlock_writer_unlock (&t->lock);
+      return;
+    }
   if (vls_mt_wrk_supported ())
     clib_rwlock_writer_lock (&wrk->sh_to_vlsh_table_lock);
   hash_unset (wrk->sh_to_vlsh_table, sh);
@@ -470,15 +630,32 @@ vls_sh_to_vlsh_table_del (vls_worker_t *wrk, vcl_session_handle_t sh)
     clib_rwlock_writer_unlock (&wrk->sh_to_vlsh_table_lock);
 }
 
-static uword *
+static vls_handle_t
 vls_sh_to_vlsh_table_get (vls_worker_t *wrk, vcl_session_handle_t sh)
 {
+  vls_handle_t vlsh;
+  uword *vlshp;
+
+  if (vlsl->mt_lockless)
+    {
+      vls_sh_to_vlsh_table_t *t = vls_sh_to_vlsh_table_lockless (wrk, sh);
+      u8 is_other = vppcom_session_worker (sh) != vcl_get_worker_index ();
+
+      if (is_other)
+	clib_rwlock_reader_lock (&t->lock);
+      vlshp = hash_get (t->table, sh);
+      vlsh = vlshp ? *vlshp : VLS_INVALID_HANDLE;
+      if (is_other)
+	clib_rwlock_reader_unlock (&t->lock);
+      return vlsh;
+    }
   if (vls_mt_wrk_supported ())
     clib_rwlock_reader_lock (&wrk->sh_to_vlsh_table_lock);
-  uword *vlshp = hash_get (wrk->sh_to_vlsh_table, sh);
+  vlshp = hash_get (wrk->sh_to_vlsh_table, sh);
+  vlsh = vlshp ? *vlshp : VLS_INVALID_HANDLE;
   if (vls_mt_wrk_supported ())
     clib_rwlock_reader_unlock (&wrk->sh_to_vlsh_table_lock);
-  return vlshp;
+  return vlsh;
 }
 
 static vls_handle_t
@@ -489,6 +666,12 @@ vls_alloc (vcl_session_handle_t sh)
 
   vls_mt_pool_wlock ();
 
+  if (vlsl->mt_lockless && PREDICT_FALSE (!pool_free_elts (wrk->vls_pool)))
+    {
+      VERR ("vls-max-sessions %u limit reached", vcm->cfg.vls_max_sessions);
+      vls_mt_pool_wunlock ();
+      return VLS_INVALID_HANDLE;
+    }
   pool_get_zero (wrk->vls_pool, vls);
   vls->session_index = vppcom_session_index (sh);
   vls->vcl_wrk_index = vppcom_session_worker (sh);
@@ -501,7 +684,8 @@ vls_alloc (vcl_session_handle_t sh)
 		vls->session_index);
       vls->owner_vcl_wrk_index = vls->vcl_wrk_index;
     }
-  clib_spinlock_init (&vls->lock);
+  if (!vlsl->mt_lockless)
+    clib_spinlock_init (&vls->lock);
 
   vls_mt_pool_wunlock ();
   return vls->vls_index;
@@ -524,6 +708,17 @@ vls_free (vcl_locked_session_t * vls)
   ASSERT (vls != 0);
   vls_sh_to_vlsh_table_del (
     wrk, vcl_session_handle_from_index (vls->session_index));
+  if (vlsl->mt_lockless)
+    {
+      vls_mt_slot_t *slot = vls_mt_slot (vls);
+
+      /* Waiters find a new generation once handed the session and
+       * give up */
+      clib_atomic_store_rel_n (&slot->gen, slot->gen + 1);
+      pool_put (wrk->vls_pool, vls);
+      vls_mt_release (vls);
+      return;
+    }
   clib_spinlock_free (&vls->lock);
   pool_put (wrk->vls_pool, vls);
 }
@@ -533,9 +728,26 @@ vls_get_and_lock (vls_handle_t vlsh)
 {
   vls_worker_t *wrk = vls_worker_get_current ();
   vcl_locked_session_t *vls;
+  u32 gen;
+
   if (pool_is_free_index (wrk->vls_pool, vlsh))
     return 0;
   vls = pool_elt_at_index (wrk->vls_pool, vlsh);
+  if (vlsl->mt_lockless)
+    {
+      vls_mt_slot_t *slot = vls_mt_slot (vls);
+
+      gen = clib_atomic_load_acq_n (&slot->gen);
+      vls_mt_own (vls);
+      /* Session freed, and maybe reallocated, while waiting for it */
+      if (PREDICT_FALSE (slot->gen != gen ||
+			 pool_is_free_index (wrk->vls_pool, vlsh)))
+	{
+	  vls_mt_release (vls);
+	  return 0;
+	}
+      return vls;
+    }
   vls_lock (vls);
   return vls;
 }
@@ -620,11 +832,10 @@ vls_handle_t
 vls_si_wi_to_vlsh (u32 session_index, u32 vcl_wrk_index)
 {
   vls_worker_t *wrk = vls_worker_get_current ();
-  uword *vlshp = vls_sh_to_vlsh_table_get (
+
+  return vls_sh_to_vlsh_table_get (
     wrk,
     vcl_session_handle_from_wrk_session_index (session_index, vcl_wrk_index));
-
-  return vlshp ? *vlshp : VLS_INVALID_HANDLE;
 }
 
 vls_handle_t
@@ -974,6 +1185,8 @@ vls_worker_copy_on_fork (vcl_worker_t * parent_wrk)
   u32 vls_index, session_index, wrk_index;
   vcl_session_handle_t sh;
   vcl_locked_session_t *vls;
+  vls_sh_to_vlsh_table_t *t;
+  u32 i;
 
   /*
    * init vcl worker
@@ -993,8 +1206,39 @@ vls_worker_copy_on_fork (vcl_worker_t * parent_wrk)
     hash_set (vls_wrk->sh_to_vlsh_table,
               vcl_session_handle_from_index (session_index), vls_index);
   }));
+  vec_foreach (t, vls_parent_wrk->sh_to_vlsh_tables)
+    hash_foreach (sh, vls_index, t->table, ({
+      vcl_session_handle_parse (sh, &wrk_index, &session_index);
+      vls_sh_to_vlsh_table_add (vls_wrk,
+                                vcl_session_handle_from_index (session_index),
+                                vls_index);
+    }));
   /* clang-format on */
-  vls_wrk->vls_pool = pool_dup (vls_parent_wrk->vls_pool);
+
+  if (vlsl->mt_lockless)
+    {
+      /* Fixed size pools can't be duplicated. Copy sessions and free lists
+       * into the child's preallocated pool */
+      pool_header_t *ph = pool_header (vls_parent_wrk->vls_pool);
+      pool_header_t *cph = pool_header (vls_wrk->vls_pool);
+
+      clib_memcpy_fast (vls_wrk->vls_pool, vls_parent_wrk->vls_pool,
+			vec_bytes (vls_parent_wrk->vls_pool));
+      clib_memcpy_fast (cph->free_bitmap, ph->free_bitmap,
+			vec_bytes (ph->free_bitmap));
+      vec_set_len (cph->free_indices, vec_len (ph->free_indices));
+      clib_memcpy_fast (cph->free_indices, ph->free_indices,
+			vec_bytes (ph->free_indices));
+      /* Parent threads holding or waiting for sessions do not exist in
+       * child */
+      clib_memcpy_fast (vls_wrk->vls_mt_slots, vls_parent_wrk->vls_mt_slots,
+			vec_bytes (vls_parent_wrk->vls_mt_slots));
+      for (i = 0; i < vec_len (vls_wrk->vls_mt_slots); i++)
+	vls_wrk->vls_mt_slots[i].owner.serving =
+	  vls_wrk->vls_mt_slots[i].owner.next;
+    }
+  else
+    vls_wrk->vls_pool = pool_dup (vls_parent_wrk->vls_pool);
 
   /*
    * Detach vls from parent vcl worker and attach them to child.
@@ -1518,7 +1762,13 @@ vls_close (vls_handle_t vlsh)
     vls_mt_session_cleanup (vls);
 
   vls_mt_unguard ();
-  vls_unlock (vls);
+  /* With lockless workers, keep owning the session until it is freed.
+   * Threads queued for it are handed a freed session and give up,
+   * whereas a trylock could be overtaken by them indefinitely. Holders
+   * of the pool writer lock never wait for a session, so this can't
+   * deadlock */
+  if (!vlsl->mt_lockless)
+    vls_unlock (vls);
   vls_mt_pool_runlock ();
 
   /* Drop mt reader lock on pool and acquire writer lock */
@@ -1527,7 +1777,7 @@ vls_close (vls_handle_t vlsh)
   vls = vls_get (vlsh);
 
   /* Other threads might be still using the session */
-  while (vls_trylock (vls))
+  while (!vlsl->mt_lockless && vls_trylock (vls))
     {
       vls_mt_pool_wunlock ();
       vls_mt_pool_wlock ();
@@ -1648,6 +1898,16 @@ vls_epoll_wait (vls_handle_t ep_vlsh, struct epoll_event *events,
   vls_mt_detect ();
   if (!(vls = vls_get_w_dlock (ep_vlsh)))
     return VPPCOM_EBADFD;
+  if (vlsl->mt_lockless)
+    {
+      /* Epoll sessions are per vcl worker, so do not hold vls while waiting
+       * and let other threads use it meanwhile */
+      vcl_session_handle_t ep_sh = vls_to_sh (vls);
+      vls_dunlock (vls);
+      rv = vppcom_epoll_wait (ep_sh, events, maxevents, wait_for_time);
+      vls_handle_pending_wrk_cleanup ();
+      return rv;
+    }
   vls_mt_guard (vls_tmp, VLS_MT_OP_XPOLL);
   rv = vppcom_epoll_wait (vls_to_sh_tu (vls), events, maxevents,
 			  wait_for_time);
@@ -2087,7 +2347,7 @@ vls_mt_mq_wait_lock (vcl_session_handle_t vcl_sh)
 {
   vcl_locked_session_t *vls;
   vls_worker_t *wrk;
-  uword *vlshp;
+  vls_handle_t vlsh;
 
   /* If mt wrk supported or single threaded just return */
   if (vls_mt_wrk_supported () || (vlsl->vls_mt_n_threads <= 1))
@@ -2097,10 +2357,10 @@ vls_mt_mq_wait_lock (vcl_session_handle_t vcl_sh)
   /* Expect current thread to have dropped lock before calling vcl */
   vls_mt_pool_rlock ();
 
-  vlshp = vls_sh_to_vlsh_table_get (wrk, vcl_sh);
-  if (vlshp)
+  vlsh = vls_sh_to_vlsh_table_get (wrk, vcl_sh);
+  if (vlsh != VLS_INVALID_HANDLE)
     {
-      vls = vls_get (*vlshp);
+      vls = vls_get (vlsh);
       /* Handle case here other threads might've closed the session */
       if (vls->flags & VLS_F_APP_CLOSED)
 	{
@@ -2144,6 +2404,7 @@ vls_app_create (char *app_name)
   pthread_atfork (vls_app_pre_fork, vls_app_fork_parent_handler,
 		  vls_app_fork_child_handler);
   atexit (vls_app_exit);
+  vlsl->mt_lockless = vcm->cfg.mt_wrk_lockless;
   vls_worker_alloc ();
   vlsl->vls_wrk_index = vcl_get_worker_index ();
   vlsl->vls_mt_n_threads = 1;
@@ -149,9 +149,25 @@ vcl_api_app_worker_del (vcl_worker_t * wrk)
   vcl_bapi_app_worker_del (wrk);
 }
 
+void
+vcl_ring_free (vcl_ring_t *ring)
+{
+  u32 i;
+
+  for (i = 0; i < vec_len (ring->ops_by_session); i++)
+    vec_free (ring->ops_by_session[i]);
+  vec_free (ring->ops_by_session);
+  vec_free (ring->ready_sessions);
+  pool_free (ring->ops);
+  vec_free (ring->sq);
+  vec_free (ring->cq);
+}
+
 void
 vcl_worker_cleanup (vcl_worker_t * wrk, u8 notify_vpp)
 {
+  vcl_ring_t *ring;
+
   clib_spinlock_lock (&vcm->workers_lock);
   if (notify_vpp)
     vcl_api_app_worker_del (wrk);
@@ -165,6 +181,9 @@ vcl_worker_cleanup (vcl_worker_t * wrk, u8 notify_vpp)
   vec_free (wrk->mq_msg_vector);
   vec_free (wrk->unhandled_evts_vector);
   vec_free (wrk->pending_session_wrk_updates);
+  pool_foreach (ring, wrk->rings)
+    vcl_ring_free (ring);
+  pool_free (wrk->rings);
   clib_bitmap_free (wrk->rd_bitmap);
   clib_bitmap_free (wrk->wr_bitmap);
   clib_bitmap_free (wrk->ex_bitmap);
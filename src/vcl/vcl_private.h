@@ -144,6 +144,8 @@ typedef enum vcl_session_flags_
   VCL_SESSION_F_PENDING_FREE = 1 << 7,
   VCL_SESSION_F_PENDING_LISTEN = 1 << 8,
   VCL_SESSION_F_APP_CLOSING = 1 << 9,
+  VCL_SESSION_F_HAS_RING = 1 << 10,
+  VCL_SESSION_F_RING_NONBLOCK = 1 << 11,
 } __clib_packed vcl_session_flags_t;
 
 typedef enum vcl_worker_wait_
@@ -162,6 +164,8 @@ typedef struct vcl_session_
 #undef _
   vcl_session_flags_t flags;	/**< see @ref vcl_session_flags_t */
   u32 rx_bytes_pending;		/**< bytes rx-ed as segs but not yet freed */
+  u32 tx_bytes_reserved;	/**< bytes reserved as segs but not committed */
+  u32 ring_index;		/**< ring session is used with, if any */
 
   svm_fifo_t *ct_rx_fifo;
   svm_fifo_t *ct_tx_fifo;
@@ -216,6 +220,8 @@ typedef struct vppcom_cfg_t_
   u8 *vpp_bapi_socket_name;	/**< bapi socket transport socket name */
   u32 tls_engine;
   u8 mt_wrk_supported;
+  u8 mt_wrk_lockless;
+  u32 vls_max_sessions;
   u8 huge_page;
   u8 app_original_dst;
 } vppcom_cfg_t;
@@ -237,6 +243,31 @@ typedef struct vcl_mq_evt_conn_
   int mq_fd;
 } vcl_mq_evt_conn_t;
 
+#define VCL_RING_MAX_ENTRIES (1 << 15)
+
+typedef struct vcl_ring_op_
+{
+  vppcom_ring_sqe_t sqe;	/**< copy of submission */
+  u8 is_connecting;		/**< connect sent, waiting for reply */
+} vcl_ring_op_t;
+
+typedef struct vcl_ring_
+{
+  u32 sq_head;			/**< next entry to be submitted */
+  u32 sq_tail;			/**< next entry to be handed to app */
+  u32 sq_mask;
+  u32 cq_head;			/**< next completion to be consumed */
+  u32 cq_tail;			/**< next completion to be produced */
+  u32 cq_mask;
+  vppcom_ring_sqe_t *sq;	/**< submission queue */
+  vppcom_ring_cqe_t *cq;	/**< completion queue */
+  vcl_ring_op_t *ops;		/**< pool of ops waiting for sessions */
+  u32 **ops_by_session;		/**< waiting ops indices per session index */
+  u32 *ready_sessions;		/**< sessions with ops to be retried */
+} vcl_ring_t;
+
+void vcl_ring_free (vcl_ring_t *ring);
+
 typedef void (*vcl_worker_wait_mq_fn) (u32 vcl_sh);
 typedef struct vcl_worker_
 {
@@ -295,6 +326,9 @@ typedef struct vcl_worker_
   /** Vector of unhandled events */
   session_event_t *unhandled_evts_vector;
 
+  /** Pool of submission/completion rings */
+  vcl_ring_t *rings;
+
   u32 *pending_session_wrk_updates;
 
   /** Used also as a thread stop key buffer */
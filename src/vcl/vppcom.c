@@ -1610,6 +1610,51 @@ vcl_epoll_lt_del (vcl_worker_t *wrk, vcl_session_t *s)
   s->vep.lt_prev = VCL_INVALID_SESSION_INDEX;
 }
 
+static inline vcl_ring_t *
+vcl_ring_get (vcl_worker_t *wrk, u32 ring_handle)
+{
+  if (pool_is_free_index (wrk->rings, ring_handle))
+    return 0;
+  return pool_elt_at_index (wrk->rings, ring_handle);
+}
+
+static inline void
+vcl_ring_complete (vcl_ring_t *ring, vppcom_ring_sqe_t *sqe, int rv)
+{
+  vppcom_ring_cqe_t *cqe;
+
+  ASSERT (ring->cq_tail - ring->cq_head <= ring->cq_mask);
+  cqe = &ring->cq[ring->cq_tail & ring->cq_mask];
+  cqe->user_data = sqe->user_data;
+  cqe->result = rv;
+  cqe->session_handle = sqe->session_handle;
+  ring->cq_tail += 1;
+}
+
+/**
+ * Complete ring ops still waiting for session that is being closed
+ */
+static void
+vcl_ring_session_cancel (vcl_worker_t *wrk, vcl_session_t *s)
+{
+  vcl_ring_t *ring;
+  vcl_ring_op_t *op;
+  u32 *opi;
+
+  s->flags &= ~(VCL_SESSION_F_HAS_RING | VCL_SESSION_F_RING_NONBLOCK);
+  ring = vcl_ring_get (wrk, s->ring_index);
+  if (!ring || s->session_index >= vec_len (ring->ops_by_session))
+    return;
+
+  vec_foreach (opi, ring->ops_by_session[s->session_index])
+    {
+      op = pool_elt_at_index (ring->ops, *opi);
+      vcl_ring_complete (ring, &op->sqe, VPPCOM_EBADFD);
+      pool_put (ring->ops, op);
+    }
+  vec_reset_length (ring->ops_by_session[s->session_index]);
+}
+
 int
 vcl_session_cleanup (vcl_worker_t * wrk, vcl_session_t * s,
 		     vcl_session_handle_t sh, u8 do_disconnect)
@@ -1642,6 +1687,9 @@ vcl_session_cleanup (vcl_worker_t * wrk, vcl_session_t * s,
 	      s->vep.vep_sh, rv, vppcom_retval_str (rv));
     }
 
+  if (s->flags & VCL_SESSION_F_HAS_RING)
+    vcl_ring_session_cancel (wrk, s);
+
   if (!do_disconnect)
     {
       VDBG (1, "session %u [0x%llx] disconnect skipped",
@@ -2364,6 +2412,14 @@ vppcom_session_write_inline (vcl_worker_t *wrk, vcl_session_t *s, void *buf,
       return VPPCOM_EPIPE;
     }
 
+  /* Writes go to the fifo tail, where the reserved bytes are */
+  if (PREDICT_FALSE (s->tx_bytes_reserved))
+    {
+      VDBG (1, "session %u [0x%llx]: has %u bytes reserved for zc write",
+	    s->session_index, s->vpp_handle, s->tx_bytes_reserved);
+      return VPPCOM_EINVAL;
+    }
+
   is_ct = vcl_session_is_ct (s);
   tx_fifo = is_ct ? s->ct_tx_fifo : s->tx_fifo;
   is_nonblocking = vcl_session_has_attr (s, VCL_SESS_ATTR_NONBLOCK);
@@ -2446,6 +2502,10 @@ vppcom_session_write_segments (uint32_t session_handle,
   if (PREDICT_FALSE (s->flags & VCL_SESSION_F_WR_SHUTDOWN))
     return VPPCOM_EPIPE;
 
+  /* Reserved bytes must be committed first */
+  if (PREDICT_FALSE (s->tx_bytes_reserved))
+    return VPPCOM_EINVAL;
+
   is_nonblocking = vcl_session_has_attr (s, VCL_SESS_ATTR_NONBLOCK);
   is_ct = vcl_session_is_ct (s);
   tx_fifo = is_ct ? s->ct_tx_fifo : s->tx_fifo;
@@ -2487,6 +2547,105 @@ vppcom_session_write_segments (uint32_t session_handle,
   return n_write;
 }
 
+int
+vppcom_session_write_zc (uint32_t session_handle, vppcom_data_segment_t *ds,
+			 uint32_t n_segments, uint32_t max_bytes)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  int n_reserved, is_nonblocking;
+  vcl_session_t *s = 0;
+  svm_fifo_t *tx_fifo;
+  u8 is_ct;
+
+  if (PREDICT_FALSE (!ds || !n_segments))
+    return VPPCOM_EFAULT;
+
+  s = vcl_session_get_w_handle (wrk, session_handle);
+  if (PREDICT_FALSE (!s || (s->flags & VCL_SESSION_F_IS_VEP)))
+    return VPPCOM_EBADFD;
+
+  /* Dgrams need headers written with the data */
+  if (PREDICT_FALSE (s->is_dgram))
+    return VPPCOM_ENOTSUP;
+
+  if (PREDICT_FALSE (!vcl_session_is_open (s)))
+    return vcl_session_closed_error (s);
+
+  if (PREDICT_FALSE (s->flags & VCL_SESSION_F_WR_SHUTDOWN))
+    return VPPCOM_EPIPE;
+
+  is_nonblocking = vcl_session_has_attr (s, VCL_SESS_ATTR_NONBLOCK);
+  is_ct = vcl_session_is_ct (s);
+  tx_fifo = is_ct ? s->ct_tx_fifo : s->tx_fifo;
+
+  if (svm_fifo_max_enqueue_prod (tx_fifo) <= s->tx_bytes_reserved)
+    {
+      if (is_nonblocking)
+	return VPPCOM_EWOULDBLOCK;
+
+      while (svm_fifo_max_enqueue_prod (tx_fifo) <= s->tx_bytes_reserved)
+	{
+	  svm_fifo_add_want_deq_ntf (tx_fifo, SVM_FIFO_WANT_DEQ_NOTIF);
+	  if (vcl_session_is_closing (s))
+	    return vcl_session_closing_error (s);
+	  if (s->flags & VCL_SESSION_F_APP_CLOSING)
+	    return vcl_session_closed_error (s);
+
+	  vcl_worker_wait_mq (wrk, session_handle, VCL_WRK_WAIT_IO_TX);
+	  vcl_worker_flush_mq_events (wrk);
+	}
+    }
+
+  n_reserved = svm_fifo_enqueue_reserve (tx_fifo, s->tx_bytes_reserved,
+					 (svm_fifo_seg_t *) ds, &n_segments,
+					 max_bytes);
+
+  /* The underlying fifo segment can run out of memory */
+  if (PREDICT_FALSE (n_reserved < 0))
+    return VPPCOM_EAGAIN;
+
+  s->tx_bytes_reserved += n_reserved;
+  return n_reserved;
+}
+
+int
+vppcom_session_write_zc_commit (uint32_t session_handle, uint32_t n_bytes)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  vcl_session_t *s;
+  u8 is_ct;
+
+  s = vcl_session_get_w_handle (wrk, session_handle);
+  if (PREDICT_FALSE (!s || (s->flags & VCL_SESSION_F_IS_VEP)))
+    return VPPCOM_EBADFD;
+
+  if (PREDICT_FALSE (n_bytes > s->tx_bytes_reserved))
+    return VPPCOM_EINVAL;
+
+  /* Reservations are dropped if session was closed in the meantime */
+  if (PREDICT_FALSE (!vcl_session_is_open (s)))
+    {
+      s->tx_bytes_reserved = 0;
+      return vcl_session_closed_error (s);
+    }
+
+  if (PREDICT_FALSE (!n_bytes))
+    return VPPCOM_OK;
+
+  is_ct = vcl_session_is_ct (s);
+  svm_fifo_enqueue_nocopy (is_ct ? s->ct_tx_fifo : s->tx_fifo, n_bytes);
+
+  /* Bytes not committed are returned to the fifo */
+  s->tx_bytes_reserved = 0;
+
+  if (svm_fifo_set_event (s->tx_fifo))
+    app_send_io_evt_to_vpp (s->vpp_evt_q,
+			    s->tx_fifo->shr->master_session_index,
+			    SESSION_IO_EVT_TX, SVM_Q_WAIT);
+
+  return n_bytes;
+}
+
 int
 vppcom_session_write (uint32_t session_handle, void *buf, size_t n)
 {
@@ -2534,6 +2693,22 @@ if (PREDICT_FALSE (svm_fifo_is_empty (_s->rx_fifo)))			\
       }									\
   }									\
 
+/**
+ * Check if session that got a disconnect or reset was closed by the app
+ * meanwhile. If so, free it if that was postponed until the event.
+ */
+static int
+vcl_session_closed_free_pending (vcl_worker_t *wrk, vcl_session_t *s)
+{
+  if (!vcl_session_is_closed (s))
+    return 0;
+
+  if (s && (s->flags & VCL_SESSION_F_PENDING_FREE))
+    vcl_session_free (wrk, s);
+
+  return 1;
+}
+
 static void
 vcl_select_handle_mq_event (vcl_worker_t * wrk, session_event_t * e,
 			    unsigned long n_bits, unsigned long *read_map,
@@ -2615,12 +2790,8 @@ vcl_select_handle_mq_event (vcl_worker_t * wrk, session_event_t * e,
 	  s = vcl_session_get (wrk, e->session_index);
 	  s->flags &= ~VCL_SESSION_F_PENDING_DISCONNECT;
 	}
-      if (vcl_session_is_closed (s))
-	{
-	  if (s && (s->flags & VCL_SESSION_F_PENDING_FREE))
-	    vcl_session_free (wrk, s);
-	  break;
-	}
+      if (vcl_session_closed_free_pending (wrk, s))
+	break;
       sid = s->session_index;
       if (sid < n_bits && except_map)
 	{
@@ -2641,12 +2812,8 @@ vcl_select_handle_mq_event (vcl_worker_t * wrk, session_event_t * e,
 	  s = vcl_session_get (wrk, sid);
 	  s->flags &= ~VCL_SESSION_F_PENDING_DISCONNECT;
 	}
-      if (vcl_session_is_closed (s))
-	{
-	  if (s && (s->flags & VCL_SESSION_F_PENDING_FREE))
-	    vcl_session_free (wrk, s);
-	  break;
-	}
+      if (vcl_session_closed_free_pending (wrk, s))
+	break;
       if (sid < n_bits && except_map)
 	{
 	  clib_bitmap_set_no_check ((uword *) except_map, sid, 1);
@@ -4673,6 +4840,367 @@ vppcom_poll (vcl_poll_t * vp, uint32_t n_sids, double wait_for_time)
   return num_ev;
 }
 
+/**
+ * Try to execute ring op without blocking
+ *
+ * @return VPPCOM_EAGAIN if op must wait for the session, op result otherwise
+ */
+static int
+vcl_ring_op_try (vcl_worker_t *wrk, u32 ring_index, vppcom_ring_sqe_t *sqe,
+		 u8 *is_connecting)
+{
+  svm_fifo_t *tx_fifo;
+  vcl_session_t *s;
+  int rv;
+
+  s = vcl_session_get_w_handle (wrk, sqe->session_handle);
+  if (!s || !(s->flags & VCL_SESSION_F_HAS_RING) ||
+      s->ring_index != ring_index)
+    return VPPCOM_EBADFD;
+
+  switch (sqe->op)
+    {
+    case VPPCOM_RING_OP_NOP:
+      return VPPCOM_OK;
+    case VPPCOM_RING_OP_READ:
+      rv = vppcom_session_read (sqe->session_handle, sqe->buf, sqe->len);
+      if (rv != VPPCOM_EAGAIN && rv != VPPCOM_EWOULDBLOCK)
+	break;
+      /* Data might've been enqueued before rx event was reset */
+      if (vcl_session_read_ready (s) > 0)
+	rv = vppcom_session_read (sqe->session_handle, sqe->buf, sqe->len);
+      break;
+    case VPPCOM_RING_OP_WRITE:
+      rv = vppcom_session_write (sqe->session_handle, sqe->buf, sqe->len);
+      if (rv != VPPCOM_EAGAIN && rv != VPPCOM_EWOULDBLOCK)
+	break;
+      /* Ask vpp for tx event and check that space was not freed meanwhile */
+      tx_fifo = vcl_session_is_ct (s) ? s->ct_tx_fifo : s->tx_fifo;
+      svm_fifo_add_want_deq_ntf (tx_fifo, SVM_FIFO_WANT_DEQ_NOTIF);
+      rv = vppcom_session_write (sqe->session_handle, sqe->buf, sqe->len);
+      break;
+    case VPPCOM_RING_OP_ACCEPT:
+      rv = vppcom_session_accept (sqe->session_handle, sqe->ep, sqe->flags);
+      break;
+    case VPPCOM_RING_OP_CONNECT:
+      if (!*is_connecting)
+	{
+	  rv = vppcom_session_connect (sqe->session_handle, sqe->ep);
+	  if (rv != VPPCOM_EINPROGRESS)
+	    break;
+	  *is_connecting = 1;
+	  return VPPCOM_EAGAIN;
+	}
+      if (vcl_session_is_ready (s))
+	return VPPCOM_OK;
+      if (s->session_state == VCL_STATE_DETACHED || vcl_session_is_closed (s))
+	return VPPCOM_ECONNREFUSED;
+      return VPPCOM_EAGAIN;
+    default:
+      return VPPCOM_EINVAL;
+    }
+
+  return rv == VPPCOM_EWOULDBLOCK ? VPPCOM_EAGAIN : rv;
+}
+
+static int
+vcl_ring_attach_session (vcl_worker_t *wrk, u32 ring_index,
+			 vppcom_ring_sqe_t *sqe, u32 *session_index)
+{
+  vcl_session_t *s;
+
+  s = vcl_session_get_w_handle (wrk, sqe->session_handle);
+  if (!s || (s->flags & VCL_SESSION_F_IS_VEP))
+    return VPPCOM_EBADFD;
+
+  if (s->flags & VCL_SESSION_F_HAS_RING)
+    {
+      if (s->ring_index != ring_index)
+	return VPPCOM_EINVAL;
+    }
+  else
+    {
+      s->flags |= VCL_SESSION_F_HAS_RING;
+      s->ring_index = ring_index;
+      /* Remember if blocking mode must be restored on ring destroy */
+      if (!vcl_session_has_attr (s, VCL_SESS_ATTR_NONBLOCK))
+	{
+	  s->flags |= VCL_SESSION_F_RING_NONBLOCK;
+	  vcl_session_set_attr (s, VCL_SESS_ATTR_NONBLOCK);
+	}
+    }
+
+  *session_index = s->session_index;
+  return VPPCOM_OK;
+}
+
+static void
+vcl_ring_op_wait (vcl_ring_t *ring, u32 session_index,
+		  vppcom_ring_sqe_t *sqe, u8 is_connecting)
+{
+  vcl_ring_op_t *op;
+
+  pool_get (ring->ops, op);
+  op->sqe = *sqe;
+  op->is_connecting = is_connecting;
+  vec_validate (ring->ops_by_session, session_index);
+  vec_add1 (ring->ops_by_session[session_index], op - ring->ops);
+}
+
+/**
+ * Retry ops waiting for session. Ops of the same type are retried in
+ * submission order, so reads and writes are not reordered.
+ */
+static void
+vcl_ring_session_retry (vcl_worker_t *wrk, vcl_ring_t *ring, u32 ring_index,
+			u32 session_index)
+{
+  u32 i, n_keep = 0, blocked = 0, *op_indices;
+  vcl_ring_op_t *op;
+  int rv;
+
+  if (session_index >= vec_len (ring->ops_by_session))
+    return;
+
+  op_indices = ring->ops_by_session[session_index];
+  for (i = 0; i < vec_len (op_indices); i++)
+    {
+      op = pool_elt_at_index (ring->ops, op_indices[i]);
+      if (blocked & (1 << op->sqe.op))
+	{
+	  op_indices[n_keep++] = op_indices[i];
+	  continue;
+	}
+      rv = vcl_ring_op_try (wrk, ring_index, &op->sqe, &op->is_connecting);
+      if (rv == VPPCOM_EAGAIN)
+	{
+	  blocked |= 1 << op->sqe.op;
+	  op_indices[n_keep++] = op_indices[i];
+	  continue;
+	}
+      vcl_ring_complete (ring, &op->sqe, rv);
+      pool_put (ring->ops, op);
+    }
+  vec_set_len (op_indices, n_keep);
+}
+
+/**
+ * Consume io and postponed control events of sessions that use the ring
+ * and flag those sessions for retry. Events of other sessions are left for
+ * epoll or select.
+ */
+static void
+vcl_ring_handle_events (vcl_worker_t *wrk, vcl_ring_t *ring, u32 ring_index)
+{
+  u32 i, n_keep = 0;
+  session_event_t *e;
+  vcl_session_t *s;
+
+  for (i = 0; i < vec_len (wrk->unhandled_evts_vector); i++)
+    {
+      e = &wrk->unhandled_evts_vector[i];
+      s = vcl_session_get (wrk, e->session_index);
+      /* Accept ops wait on the listener */
+      if (s && e->event_type == SESSION_CTRL_EVT_ACCEPTED &&
+	  s->listener_index != VCL_INVALID_SESSION_INDEX)
+	s = vcl_session_get (wrk, s->listener_index);
+      if (!s || !(s->flags & VCL_SESSION_F_HAS_RING) ||
+	  s->ring_index != ring_index)
+	{
+	  wrk->unhandled_evts_vector[n_keep++] = *e;
+	  continue;
+	}
+      switch (e->event_type)
+	{
+	case SESSION_IO_EVT_TX:
+	  if (vcl_session_is_open (s))
+	    svm_fifo_reset_has_deq_ntf (vcl_session_is_ct (s) ? s->ct_tx_fifo :
+								      s->tx_fifo);
+	  break;
+	case SESSION_CTRL_EVT_CONNECTED:
+	  /* We didn't have a fifo when the op was submitted */
+	  if (!vcl_session_is_closed (s))
+	    vcl_session_add_want_deq_ntf (s, SVM_FIFO_WANT_DEQ_NOTIF_IF_FULL);
+	  break;
+	case SESSION_CTRL_EVT_DISCONNECTED:
+	case SESSION_CTRL_EVT_RESET:
+	  s->flags &= ~VCL_SESSION_F_PENDING_DISCONNECT;
+	  /* Closed by app, ops were completed on close */
+	  if (vcl_session_closed_free_pending (wrk, s))
+	    continue;
+	  break;
+	default:
+	  break;
+	}
+      vec_add1 (ring->ready_sessions, s->session_index);
+    }
+  vec_set_len (wrk->unhandled_evts_vector, n_keep);
+}
+
+int
+vppcom_ring_create (uint32_t n_entries)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  vcl_ring_t *ring;
+
+  if (!n_entries || n_entries > VCL_RING_MAX_ENTRIES)
+    return VPPCOM_EINVAL;
+
+  n_entries = 1 << max_log2 (n_entries);
+
+  pool_get_zero (wrk->rings, ring);
+  vec_validate (ring->sq, n_entries - 1);
+  vec_validate (ring->cq, 2 * n_entries - 1);
+  ring->sq_mask = n_entries - 1;
+  ring->cq_mask = 2 * n_entries - 1;
+
+  VDBG (0, "created ring %u with %u entries", ring - wrk->rings, n_entries);
+
+  return ring - wrk->rings;
+}
+
+int
+vppcom_ring_destroy (uint32_t ring_handle)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  vcl_ring_t *ring;
+  vcl_session_t *s;
+
+  ring = vcl_ring_get (wrk, ring_handle);
+  if (!ring)
+    return VPPCOM_EBADFD;
+
+  /* Detach sessions that still use the ring */
+  pool_foreach (s, wrk->sessions)
+    {
+      if (!(s->flags & VCL_SESSION_F_HAS_RING) || s->ring_index != ring_handle)
+	continue;
+      if (s->flags & VCL_SESSION_F_RING_NONBLOCK)
+	vcl_session_clear_attr (s, VCL_SESS_ATTR_NONBLOCK);
+      s->flags &= ~(VCL_SESSION_F_HAS_RING | VCL_SESSION_F_RING_NONBLOCK);
+    }
+
+  vcl_ring_free (ring);
+  pool_put (wrk->rings, ring);
+
+  return VPPCOM_OK;
+}
+
+vppcom_ring_sqe_t *
+vppcom_ring_get_sqe (uint32_t ring_handle)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  vppcom_ring_sqe_t *sqe;
+  vcl_ring_t *ring;
+
+  ring = vcl_ring_get (wrk, ring_handle);
+  if (!ring || ring->sq_tail - ring->sq_head > ring->sq_mask)
+    return 0;
+
+  sqe = &ring->sq[ring->sq_tail & ring->sq_mask];
+  clib_memset (sqe, 0, sizeof (*sqe));
+  ring->sq_tail += 1;
+
+  return sqe;
+}
+
+int
+vppcom_ring_submit (uint32_t ring_handle)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  u32 session_index, n_submitted = 0;
+  vppcom_ring_sqe_t *sqe;
+  vcl_ring_t *ring;
+  u8 is_connecting;
+  int rv;
+
+  ring = vcl_ring_get (wrk, ring_handle);
+  if (!ring)
+    return VPPCOM_EBADFD;
+
+  while (ring->sq_head != ring->sq_tail)
+    {
+      /* Make sure all accepted ops can be completed */
+      if (ring->cq_tail - ring->cq_head + pool_elts (ring->ops) >
+	  ring->cq_mask)
+	break;
+
+      sqe = &ring->sq[ring->sq_head & ring->sq_mask];
+      ring->sq_head += 1;
+      n_submitted += 1;
+
+      rv = vcl_ring_attach_session (wrk, ring_handle, sqe, &session_index);
+      if (rv)
+	{
+	  vcl_ring_complete (ring, sqe, rv);
+	  continue;
+	}
+
+      /* Queue behind ops already waiting for the session */
+      if (session_index < vec_len (ring->ops_by_session) &&
+	  vec_len (ring->ops_by_session[session_index]))
+	{
+	  vcl_ring_op_wait (ring, session_index, sqe, 0);
+	  vec_add1 (ring->ready_sessions, session_index);
+	  continue;
+	}
+
+      is_connecting = 0;
+      rv = vcl_ring_op_try (wrk, ring_handle, sqe, &is_connecting);
+      if (rv == VPPCOM_EAGAIN)
+	vcl_ring_op_wait (ring, session_index, sqe, is_connecting);
+      else
+	vcl_ring_complete (ring, sqe, rv);
+    }
+
+  return n_submitted;
+}
+
+int
+vppcom_ring_peek_cqes (uint32_t ring_handle, vppcom_ring_cqe_t **cqes)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  u32 n_cqes, cq_head, *sip;
+  vcl_ring_t *ring;
+
+  ring = vcl_ring_get (wrk, ring_handle);
+  if (!ring)
+    return VPPCOM_EBADFD;
+
+  if (!svm_msg_q_is_empty (wrk->app_event_queue) ||
+      vec_len (wrk->mq_msg_vector))
+    vcl_worker_flush_mq_events (wrk);
+
+  if (vec_len (wrk->unhandled_evts_vector))
+    vcl_ring_handle_events (wrk, ring, ring_handle);
+
+  vec_foreach (sip, ring->ready_sessions)
+    vcl_ring_session_retry (wrk, ring, ring_handle, *sip);
+  vec_reset_length (ring->ready_sessions);
+
+  /* Only return completions that do not wrap */
+  cq_head = ring->cq_head & ring->cq_mask;
+  n_cqes = clib_min (ring->cq_tail - ring->cq_head,
+		     ring->cq_mask + 1 - cq_head);
+  *cqes = &ring->cq[cq_head];
+
+  return n_cqes;
+}
+
+void
+vppcom_ring_cq_advance (uint32_t ring_handle, uint32_t n_cqes)
+{
+  vcl_worker_t *wrk = vcl_worker_get_current ();
+  vcl_ring_t *ring;
+
+  ring = vcl_ring_get (wrk, ring_handle);
+  if (!ring)
+    return;
+
+  ASSERT (n_cqes <= ring->cq_tail - ring->cq_head);
+  ring->cq_head += clib_min (n_cqes, ring->cq_tail - ring->cq_head);
+}
+
 int
 vppcom_mq_epoll_fd (void)
 {
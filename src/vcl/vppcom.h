@@ -207,6 +207,35 @@ typedef vppcom_data_segment_t vppcom_data_segments_t[2];
 
 typedef unsigned long vcl_si_set;
 
+typedef enum vppcom_ring_op_
+{
+  VPPCOM_RING_OP_NOP = 0,
+  VPPCOM_RING_OP_READ,
+  VPPCOM_RING_OP_WRITE,
+  VPPCOM_RING_OP_ACCEPT,
+  VPPCOM_RING_OP_CONNECT,
+} vppcom_ring_op_t;
+
+/** Ring submission queue entry */
+typedef struct vppcom_ring_sqe_
+{
+  uint8_t op;			/**< see @ref vppcom_ring_op_t */
+  uint32_t session_handle;	/**< session, or listener for accept */
+  uint32_t flags;		/**< accept flags, e.g., O_NONBLOCK */
+  uint32_t len;			/**< buffer length for read/write */
+  void *buf;			/**< buffer for read/write */
+  vppcom_endpt_t *ep;		/**< connect peer or accepted peer */
+  uint64_t user_data;		/**< opaque, returned in completion */
+} vppcom_ring_sqe_t;
+
+/** Ring completion queue entry */
+typedef struct vppcom_ring_cqe_
+{
+  uint64_t user_data;		/**< user_data of the submission */
+  int32_t result;		/**< bytes, accepted handle, 0 or error */
+  uint32_t session_handle;	/**< session the op was submitted on */
+} vppcom_ring_cqe_t;
+
 /*
  * VPPCOM Public API Functions
  */
@@ -266,6 +295,11 @@ extern int vppcom_session_write_segments (uint32_t session_handle,
 					 uint32_t n_segments);
 extern void vppcom_session_free_segments (uint32_t session_handle,
 					  uint32_t n_bytes);
+extern int vppcom_session_write_zc (uint32_t session_handle,
+				    vppcom_data_segment_t *ds,
+				    uint32_t n_segments, uint32_t max_bytes);
+extern int vppcom_session_write_zc_commit (uint32_t session_handle,
+					   uint32_t n_bytes);
 extern int vppcom_add_cert_key_pair (vppcom_cert_key_pair_t *ckpair);
 extern int vppcom_del_cert_key_pair (uint32_t ckpair_index);
 extern int vppcom_unformat_proto (uint8_t * proto, char *proto_str);
@@ -307,6 +341,64 @@ extern void vppcom_worker_index_set (int);
  */
 extern int vppcom_worker_mqs_epfd (void);
 
+/**
+ * Create submission/completion ring for current worker
+ *
+ * Rings batch read, write, accept and connect operations. Submissions are
+ * executed without blocking when @ref vppcom_ring_submit is called. The
+ * ones that cannot complete are retried once vpp notifies the worker that
+ * the session is ready. Completions are polled from the worker's message
+ * queue, so no syscalls are needed. Sessions used with a ring are switched
+ * to non-blocking mode and can be used by only one ring. Buffers and
+ * endpoints must be valid until the operation completes.
+ *
+ * @param n_entries	submission queue size, rounded up to a power of 2.
+ * 			Completion queue is twice as large.
+ * @return		ring handle or error
+ */
+extern int vppcom_ring_create (uint32_t n_entries);
+
+/**
+ * Destroy ring. Pending operations are dropped without completion and
+ * sessions switched to non-blocking mode by the ring are made blocking again.
+ */
+extern int vppcom_ring_destroy (uint32_t ring_handle);
+
+/**
+ * Get next free submission queue entry
+ *
+ * Entry is only consumed on the next @ref vppcom_ring_submit
+ *
+ * @return	zeroed entry or 0 if submission queue is full
+ */
+extern vppcom_ring_sqe_t *vppcom_ring_get_sqe (uint32_t ring_handle);
+
+/**
+ * Submit all queued entries
+ *
+ * Entries are not consumed if the completion queue could overflow.
+ *
+ * @return	number of entries consumed or error
+ */
+extern int vppcom_ring_submit (uint32_t ring_handle);
+
+/**
+ * Poll for completions without waiting
+ *
+ * Handles pending message queue events and retries operations on sessions
+ * that are ready. Completions are not copied.
+ *
+ * @param cqes	set to first completion available
+ * @return	number of consecutive completions available or error
+ */
+extern int vppcom_ring_peek_cqes (uint32_t ring_handle,
+				  vppcom_ring_cqe_t **cqes);
+
+/**
+ * Mark completions returned by @ref vppcom_ring_peek_cqes as consumed
+ */
+extern void vppcom_ring_cq_advance (uint32_t ring_handle, uint32_t n_cqes);
+
 /**
  * Returns Session error
  *
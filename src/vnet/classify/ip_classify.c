@@ -56,13 +56,91 @@ static char *ip_classify_error_strings[] = {
 #undef _
 };
 
+/*
+ * Start of the key of a packet for a table. Tables match at the ethernet
+ * header unless they use the current data, for both the table walk and
+ * compiled chains.
+ */
+static_always_inline u8 *
+ip_classify_l2_data (vlib_buffer_t *b)
+{
+  return vlib_buffer_get_current (b) - ethernet_buffer_header_size (b);
+}
+
+static_always_inline u8 *
+ip_classify_data (const vnet_classify_table_t *t, vlib_buffer_t *b)
+{
+  return (u8 *) vnet_classify_chain_data (t, ip_classify_l2_data (b),
+					  vlib_buffer_get_current (b));
+}
+
+static_always_inline int
+ip_classify_x8_same_table (vlib_buffer_t **b, u32 table_index)
+{
+  int i;
+
+  for (i = 1; i < 8; i++)
+    if (vnet_buffer (b[i])->l2_classify.table_index != table_index)
+      return 0;
+  return 1;
+}
+
+/*
+ * Apply the result of a lookup: the matching entry if any, or the miss
+ * next of the last table searched.
+ */
+static_always_inline u32
+ip_classify_next (vlib_buffer_t *b0, vnet_classify_table_t *t0,
+		  vnet_classify_entry_t *e0, u32 n_next_nodes, u32 n_next,
+		  u32 *hits, u32 *misses)
+{
+  u32 next0 = IP_LOOKUP_NEXT_DROP;
+
+  vnet_buffer (b0)->l2_classify.opaque_index = ~0;
+
+  if (PREDICT_FALSE (t0 == 0))
+    return next0;
+
+  if (e0)
+    {
+      vnet_buffer (b0)->l2_classify.opaque_index = e0->opaque_index;
+      vlib_buffer_advance (b0, e0->advance);
+      next0 = (e0->next_index < n_next_nodes) ? e0->next_index : next0;
+      *hits += 1;
+    }
+  else
+    {
+      next0 = (t0->miss_next_index < n_next) ? t0->miss_next_index : next0;
+      *misses += 1;
+    }
+
+  return next0;
+}
+
+static_always_inline void
+ip_classify_trace (vlib_main_t *vm, vlib_node_runtime_t *node,
+		   vlib_buffer_t *b0, vnet_classify_main_t *vcm,
+		   vnet_classify_table_t *t0, vnet_classify_entry_t *e0,
+		   u32 next0)
+{
+  if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE) &&
+		     (b0->flags & VLIB_BUFFER_IS_TRACED)))
+    {
+      ip_classify_trace_t *t = vlib_add_trace (vm, node, b0, sizeof (*t));
+      t->next_index = next0;
+      t->table_index = t0 ? t0 - vcm->tables : ~0;
+      t->entry_index = e0 ? e0->opaque_index : ~0;
+    }
+}
+
 static inline uword
 ip_classify_inline (vlib_main_t * vm,
 		    vlib_node_runtime_t * node,
 		    vlib_frame_t * frame, int is_ip4)
 {
-  u32 n_left_from, *from, *to_next;
-  ip_lookup_next_t next_index;
+  vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  u16 nexts[VLIB_FRAME_SIZE], *next;
+  u32 n_left_from, *from;
   vnet_classify_main_t *vcm = &vnet_classify_main;
   f64 now = vlib_time_now (vm);
   u32 hits = 0;
@@ -109,11 +187,9 @@ ip_classify_inline (vlib_main_t * vm,
 
       bi0 = from[0];
       b0 = vlib_get_buffer (vm, bi0);
-      h0 = vlib_buffer_get_current (b0) - ethernet_buffer_header_size (b0);
 
       bi1 = from[1];
       b1 = vlib_get_buffer (vm, bi1);
-      h1 = vlib_buffer_get_current (b1) - ethernet_buffer_header_size (b1);
 
       cd_index0 = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
       cd0 = classify_dpo_get (cd_index0);
@@ -124,8 +200,10 @@ ip_classify_inline (vlib_main_t * vm,
       table_index1 = cd1->cd_table_index;
 
       t0 = pool_elt_at_index (vcm->tables, table_index0);
+      h0 = ip_classify_data (t0, b0);
 
       t1 = pool_elt_at_index (vcm->tables, table_index1);
+      h1 = ip_classify_data (t1, b1);
 
       vnet_buffer (b0)->l2_classify.hash = vnet_classify_hash_packet (t0, h0);
 
@@ -155,13 +233,13 @@ ip_classify_inline (vlib_main_t * vm,
 
       bi0 = from[0];
       b0 = vlib_get_buffer (vm, bi0);
-      h0 = vlib_buffer_get_current (b0) - ethernet_buffer_header_size (b0);
 
       cd_index0 = vnet_buffer (b0)->ip.adj_index[VLIB_TX];
       cd0 = classify_dpo_get (cd_index0);
       table_index0 = cd0->cd_table_index;
 
       t0 = pool_elt_at_index (vcm->tables, table_index0);
+      h0 = ip_classify_data (t0, b0);
       vnet_buffer (b0)->l2_classify.hash = vnet_classify_hash_packet (t0, h0);
 
       vnet_buffer (b0)->l2_classify.table_index = table_index0;
@@ -171,127 +249,118 @@ ip_classify_inline (vlib_main_t * vm,
       n_left_from--;
     }
 
-  next_index = node->cached_next_index;
   from = vlib_frame_vector_args (frame);
   n_left_from = frame->n_vectors;
+  vlib_get_buffers (vm, from, bufs, n_left_from);
+  b = bufs;
+  next = nexts;
 
   while (n_left_from > 0)
     {
-      u32 n_left_to_next;
+      vnet_classify_table_t *t0 = 0;
+      vnet_classify_entry_t *e0 = 0;
+      u32 table_index0;
+      u32 hash0;
+      u8 *h0;
 
-      vlib_get_next_frame (vm, node, next_index, to_next, n_left_to_next);
+      table_index0 = vnet_buffer (b[0])->l2_classify.table_index;
 
-      /* Not enough load/store slots to dual loop... */
-      while (n_left_from > 0 && n_left_to_next > 0)
+      /* Batch of 8 packets classified against the same compiled chain */
+      if (n_left_from >= 8 && table_index0 != ~0 &&
+	  ip_classify_x8_same_table (b, table_index0))
 	{
-	  u32 bi0;
-	  vlib_buffer_t *b0;
-	  u32 next0 = IP_LOOKUP_NEXT_DROP;
-	  u32 table_index0;
-	  vnet_classify_table_t *t0;
-	  vnet_classify_entry_t *e0;
-	  u32 hash0;
-	  u8 *h0;
-
-	  /* Stride 3 seems to work best */
-	  if (PREDICT_TRUE (n_left_from > 3))
+	  t0 = pool_elt_at_index (vcm->tables, table_index0);
+	  if (t0->chain_index != ~0)
 	    {
-	      vlib_buffer_t *p1 = vlib_get_buffer (vm, from[3]);
-	      vnet_classify_table_t *tp1;
-	      u32 table_index1;
-	      u32 phash1;
+	      vnet_classify_table_t *t[8];
+	      vnet_classify_entry_t *e[8];
+	      const u8 *data[8], *current[8];
+	      int i;
 
-	      table_index1 = vnet_buffer (p1)->l2_classify.table_index;
-
-	      if (PREDICT_TRUE (table_index1 != ~0))
+	      for (i = 0; i < 8; i++)
 		{
-		  tp1 = pool_elt_at_index (vcm->tables, table_index1);
-		  phash1 = vnet_buffer (p1)->l2_classify.hash;
-		  vnet_classify_prefetch_entry (tp1, phash1);
+		  data[i] = ip_classify_l2_data (b[i]);
+		  current[i] = vlib_buffer_get_current (b[i]);
 		}
-	    }
 
-	  /* speculatively enqueue b0 to the current next frame */
-	  bi0 = from[0];
-	  to_next[0] = bi0;
-	  from += 1;
-	  to_next += 1;
-	  n_left_from -= 1;
-	  n_left_to_next -= 1;
-
-	  b0 = vlib_get_buffer (vm, bi0);
-	  h0 = b0->data;
-	  table_index0 = vnet_buffer (b0)->l2_classify.table_index;
-	  e0 = 0;
-	  t0 = 0;
-	  vnet_buffer (b0)->l2_classify.opaque_index = ~0;
-
-	  if (PREDICT_TRUE (table_index0 != ~0))
-	    {
-	      hash0 = vnet_buffer (b0)->l2_classify.hash;
-	      t0 = pool_elt_at_index (vcm->tables, table_index0);
+	      vnet_classify_chain_find_entry_x8 (
+		vnet_classify_chain_get (t0->chain_index), data, current, now,
+		e, t);
 
-	      e0 = vnet_classify_find_entry (t0, h0, hash0, now);
-	      if (e0)
-		{
-		  vnet_buffer (b0)->l2_classify.opaque_index
-		    = e0->opaque_index;
-		  vlib_buffer_advance (b0, e0->advance);
-		  next0 = (e0->next_index < node->n_next_nodes) ?
-		    e0->next_index : next0;
-		  hits++;
-		}
-	      else
+	      for (i = 0; i < 8; i++)
 		{
-		  while (1)
-		    {
-		      if (t0->next_table_index != ~0)
-			t0 = pool_elt_at_index (vcm->tables,
-						t0->next_table_index);
-		      else
-			{
-			  next0 = (t0->miss_next_index < n_next) ?
-			    t0->miss_next_index : next0;
-			  misses++;
-			  break;
-			}
-
-		      hash0 = vnet_classify_hash_packet (t0, h0);
-		      e0 = vnet_classify_find_entry (t0, h0, hash0, now);
-		      if (e0)
-			{
-			  vnet_buffer (b0)->l2_classify.opaque_index
-			    = e0->opaque_index;
-			  vlib_buffer_advance (b0, e0->advance);
-			  next0 = (e0->next_index < node->n_next_nodes) ?
-			    e0->next_index : next0;
-			  hits++;
-			  chain_hits++;
-			  break;
-			}
-		    }
+		  next[i] =
+		    ip_classify_next (b[i], t[i], e[i], node->n_next_nodes,
+				      n_next, &hits, &misses);
+		  chain_hits += (e[i] && t[i] != t0);
+		  ip_classify_trace (vm, node, b[i], vcm, t[i], e[i], next[i]);
 		}
+
+	      b += 8;
+	      next += 8;
+	      n_left_from -= 8;
+	      continue;
 	    }
+	}
+
+      /* Stride 3 seems to work best */
+      if (PREDICT_TRUE (n_left_from > 3))
+	{
+	  vnet_classify_table_t *tp1;
+	  u32 table_index1;
+	  u32 phash1;
 
-	  if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE)
-			     && (b0->flags & VLIB_BUFFER_IS_TRACED)))
+	  table_index1 = vnet_buffer (b[3])->l2_classify.table_index;
+
+	  if (PREDICT_TRUE (table_index1 != ~0))
 	    {
-	      ip_classify_trace_t *t =
-		vlib_add_trace (vm, node, b0, sizeof (*t));
-	      t->next_index = next0;
-	      t->table_index = t0 ? t0 - vcm->tables : ~0;
-	      t->entry_index = e0 ? e0->opaque_index : ~0;
+	      tp1 = pool_elt_at_index (vcm->tables, table_index1);
+	      phash1 = vnet_buffer (b[3])->l2_classify.hash;
+	      vnet_classify_prefetch_entry (tp1, phash1);
 	    }
+	}
+
+      if (PREDICT_TRUE (table_index0 != ~0))
+	{
+	  hash0 = vnet_buffer (b[0])->l2_classify.hash;
+	  t0 = pool_elt_at_index (vcm->tables, table_index0);
 
-	  /* verify speculative enqueue, maybe switch current next frame */
-	  vlib_validate_buffer_enqueue_x1 (vm, node, next_index,
-					   to_next, n_left_to_next,
-					   bi0, next0);
+	  if (t0->chain_index != ~0)
+	    {
+	      vnet_classify_table_t *head0 = t0;
+
+	      e0 = vnet_classify_chain_find_entry (
+		vnet_classify_chain_get (t0->chain_index),
+		ip_classify_l2_data (b[0]), vlib_buffer_get_current (b[0]),
+		now, &t0);
+	      chain_hits += (e0 && t0 != head0);
+	    }
+	  else
+	    {
+	      h0 = ip_classify_data (t0, b[0]);
+	      e0 = vnet_classify_find_entry (t0, h0, hash0, now);
+	      while (e0 == 0 && t0->next_table_index != ~0)
+		{
+		  t0 = pool_elt_at_index (vcm->tables, t0->next_table_index);
+		  h0 = ip_classify_data (t0, b[0]);
+		  hash0 = vnet_classify_hash_packet (t0, h0);
+		  e0 = vnet_classify_find_entry (t0, h0, hash0, now);
+		  chain_hits += (e0 != 0);
+		}
+	    }
 	}
 
-      vlib_put_next_frame (vm, node, next_index, n_left_to_next);
+      next[0] = ip_classify_next (b[0], t0, e0, node->n_next_nodes, n_next,
+				  &hits, &misses);
+      ip_classify_trace (vm, node, b[0], vcm, t0, e0, next[0]);
+
+      b += 1;
+      next += 1;
+      n_left_from -= 1;
     }
 
+  vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
+
   vlib_node_increment_counter (vm, node->node_index,
 			       IP_CLASSIFY_ERROR_MISS, misses);
   vlib_node_increment_counter (vm, node->node_index,
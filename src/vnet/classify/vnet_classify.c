@@ -143,6 +143,7 @@ vnet_classify_new_table (vnet_classify_main_t *cm, const u8 *mask,
   clib_memcpy_fast (t->mask, mask, match_n_vectors * sizeof (u32x4));
 
   t->next_table_index = ~0;
+  t->chain_index = ~0;
   t->nbuckets = nbuckets;
   t->log2_nbuckets = max_log2 (nbuckets);
   t->match_n_vectors = match_n_vectors;
@@ -161,6 +162,123 @@ vnet_classify_new_table (vnet_classify_main_t *cm, const u8 *mask,
   return (t);
 }
 
+static int
+vnet_classify_chain_build (vnet_classify_main_t *cm, u32 table_index,
+			   u32 **table_indices, u8 *use_current_data)
+{
+  vnet_classify_table_t *t;
+  u32 *tis = 0;
+  u32 ti;
+
+  *use_current_data = 0;
+
+  for (ti = table_index; ti != ~0; ti = t->next_table_index)
+    {
+      if (pool_is_free_index (cm->tables, ti))
+	goto error;
+      if (vec_len (tis) == VNET_CLASSIFY_CHAIN_MAX_TABLES)
+	goto error;
+      /* a loop in the chain */
+      if (vec_search (tis, ti) != ~0)
+	goto error;
+
+      t = pool_elt_at_index (cm->tables, ti);
+      vec_add1 (tis, ti);
+      if (t->current_data_flag == CLASSIFY_FLAG_USE_CURR_DATA)
+	*use_current_data = 1;
+    }
+
+  *table_indices = tis;
+  return 0;
+
+error:
+  vec_free (tis);
+  return VNET_API_ERROR_INVALID_VALUE;
+}
+
+static void
+vnet_classify_chain_free (vnet_classify_main_t *cm, u32 chain_index)
+{
+  vnet_classify_chain_t *c;
+  vnet_classify_table_t *t;
+
+  c = pool_elt_at_index (cm->chains, chain_index);
+  if (!pool_is_free_index (cm->tables, c->table_indices[0]))
+    {
+      t = pool_elt_at_index (cm->tables, c->table_indices[0]);
+      t->chain_index = ~0;
+    }
+  vec_free (c->table_indices);
+  pool_put (cm->chains, c);
+}
+
+/*
+ * Recompile every chain after a table was added, relinked or deleted.
+ * Chains that can no longer be compiled fall back to the table walk.
+ */
+static void
+vnet_classify_chains_update (vnet_classify_main_t *cm)
+{
+  vnet_classify_chain_t *c;
+  u32 *to_free = 0, *tis, *ci;
+  u8 use_current_data;
+
+  pool_foreach (c, cm->chains)
+    {
+      if (vnet_classify_chain_build (cm, c->table_indices[0], &tis,
+				     &use_current_data))
+	{
+	  vec_add1 (to_free, c - cm->chains);
+	  continue;
+	}
+      vec_free (c->table_indices);
+      c->table_indices = tis;
+      c->use_current_data = use_current_data;
+    }
+
+  vec_foreach (ci, to_free)
+    vnet_classify_chain_free (cm, *ci);
+  vec_free (to_free);
+}
+
+int
+vnet_classify_chain_compile (vnet_classify_main_t *cm, u32 table_index,
+			     int is_add)
+{
+  vnet_classify_chain_t *c;
+  vnet_classify_table_t *t;
+  u32 *tis;
+  u8 use_current_data;
+  int rv;
+
+  if (pool_is_free_index (cm->tables, table_index))
+    return VNET_API_ERROR_CLASSIFY_TABLE_NOT_FOUND;
+
+  t = pool_elt_at_index (cm->tables, table_index);
+
+  if (!is_add)
+    {
+      if (t->chain_index == ~0)
+	return VNET_API_ERROR_NO_SUCH_ENTRY;
+      vnet_classify_chain_free (cm, t->chain_index);
+      return 0;
+    }
+
+  if (t->chain_index != ~0)
+    return VNET_API_ERROR_VALUE_EXIST;
+
+  rv = vnet_classify_chain_build (cm, table_index, &tis, &use_current_data);
+  if (rv)
+    return rv;
+
+  pool_get_zero (cm->chains, c);
+  c->table_indices = tis;
+  c->use_current_data = use_current_data;
+  t->chain_index = c - cm->chains;
+
+  return 0;
+}
+
 void
 vnet_classify_delete_table_index (vnet_classify_main_t * cm,
 				  u32 table_index, int del_chain)
@@ -176,9 +294,14 @@ vnet_classify_delete_table_index (vnet_classify_main_t * cm,
     /* Recursively delete the entire chain */
     vnet_classify_delete_table_index (cm, t->next_table_index, del_chain);
 
+  if (t->chain_index != ~0)
+    vnet_classify_chain_free (cm, t->chain_index);
+
   vec_free (t->buckets);
   clib_mem_destroy_heap (t->mheap);
   pool_put (cm->tables, t);
+
+  vnet_classify_chains_update (cm);
 }
 
 static vnet_classify_entry_t *
@@ -780,6 +903,7 @@ vnet_classify_add_del_table (vnet_classify_main_t *cm, const u8 *mask,
 
 	  t = pool_elt_at_index (cm->tables, *table_index);
 	  t->next_table_index = next_table_index;
+	  vnet_classify_chains_update (cm);
 	}
       return 0;
     }
@@ -1647,6 +1771,62 @@ VLIB_CLI_COMMAND (classify_table, static) =
   .function = classify_table_command_fn,
 };
 
+static clib_error_t *
+classify_compile_chain_command_fn (vlib_main_t *vm, unformat_input_t *input,
+				   vlib_cli_command_t *cmd)
+{
+  vnet_classify_main_t *cm = &vnet_classify_main;
+  u32 table_index = ~0;
+  int is_add = 1;
+  int rv;
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "table %d", &table_index))
+	;
+      else if (unformat (input, "del"))
+	is_add = 0;
+      else
+	break;
+    }
+
+  if (table_index == ~0)
+    return clib_error_return (0, "table index required");
+
+  rv = vnet_classify_chain_compile (cm, table_index, is_add);
+  switch (rv)
+    {
+    case 0:
+      break;
+
+    case VNET_API_ERROR_INVALID_VALUE:
+      return clib_error_return (0,
+				"chain is broken, loops or is longer than "
+				"%d tables",
+				VNET_CLASSIFY_CHAIN_MAX_TABLES);
+
+    default:
+      return clib_error_return (0, "vnet_classify_chain_compile returned %d",
+				rv);
+    }
+  return 0;
+}
+
+/*?
+ * Compile the chain of tables starting at the given table. Nodes that
+ * support compiled chains then compute the hashes of all the tables of the
+ * chain at once instead of following next_table_index one lookup at a
+ * time. The chain is recompiled automatically when its tables change.
+ *
+ * @cliexpar
+ * @cliexcmd{classify compile-chain table 0}
+?*/
+VLIB_CLI_COMMAND (classify_compile_chain_command, static) = {
+  .path = "classify compile-chain",
+  .short_help = "classify compile-chain table <n> [del]",
+  .function = classify_compile_chain_command_fn,
+};
+
 static int
 filter_table_mask_compare (void *a1, void *a2)
 {
@@ -1725,6 +1905,28 @@ classify_sort_table_chain (vnet_classify_main_t * cm, u32 table_index)
 	t->next_table_index = ~0;
     }
 
+  /*
+   * A compiled chain belongs to the head of the table list, move it to the
+   * new head and recompile chains to follow the new links.
+   */
+  t = pool_elt_at_index (cm->tables, table_index);
+  if (tables[0] != table_index && t->chain_index != ~0)
+    {
+      vnet_classify_table_t *head;
+
+      head = pool_elt_at_index (cm->tables, tables[0]);
+      if (head->chain_index == ~0)
+	{
+	  vnet_classify_chain_get (t->chain_index)->table_indices[0] =
+	    tables[0];
+	  head->chain_index = t->chain_index;
+	  t->chain_index = ~0;
+	}
+      else
+	vnet_classify_chain_free (cm, t->chain_index);
+    }
+  vnet_classify_chains_update (cm);
+
   table_index = tables[0];
   vec_free (tables);
 
@@ -2244,6 +2446,9 @@ format_vnet_classify_table (u8 *s, va_list *args)
   s = format (s, "\n  mask %U", format_hex_bytes, t->mask,
 	      t->match_n_vectors * sizeof (u32x4));
   s = format (s, "\n  linear-search buckets %d\n", t->linear_buckets);
+  if (t->chain_index != ~0)
+    s = format (s, "  compiled chain: %U\n", format_vec32,
+		vnet_classify_chain_get (t->chain_index)->table_indices, "%d");
 
   if (verbose == 0)
     return s;
@@ -175,6 +175,9 @@ typedef struct
   /* Miss next index, return if next_table_index = 0 */
   u32 miss_next_index;
 
+  /* Compiled chain headed by this table, ~0 if none */
+  u32 chain_index;
+
   /**
    * All members accessed in the DP above here
    */
@@ -219,11 +222,37 @@ STATIC_ASSERT_OFFSET_OF (vnet_classify_table_t, cacheline1,
 #define VNET_CLASSIFY_VECTOR_SIZE                                             \
   sizeof (((vnet_classify_table_t *) 0)->mask[0])
 
+/**
+ * Maximum number of tables a compiled chain can merge
+ */
+#define VNET_CLASSIFY_CHAIN_MAX_TABLES 16
+
+/**
+ * A compiled table chain.
+ *
+ * The tables reachable from the head via next_table_index are flattened
+ * into an array, so the hashes of all the masks can be computed and the
+ * buckets prefetched up front, instead of walking the chain one dependent
+ * lookup at a time. The chain is rebuilt whenever one of its tables
+ * changes.
+ */
+typedef struct
+{
+  /* Tables in search order, head first */
+  u32 *table_indices;
+
+  /* Set if some table of the chain matches at the current data */
+  u8 use_current_data;
+} vnet_classify_chain_t;
+
 struct _vnet_classify_main
 {
   /* Table pool */
   vnet_classify_table_t *tables;
 
+  /* Compiled chain pool */
+  vnet_classify_chain_t *chains;
+
   /* Registered next-index, opaque unformat fcns */
   unformat_function_t **unformat_l2_next_index_fns;
   unformat_function_t **unformat_ip_next_index_fns;
@@ -581,6 +610,145 @@ vnet_classify_find_entry_inline (const vnet_classify_table_t *t, const u8 *h,
   return 0;
 }
 
+static_always_inline vnet_classify_chain_t *
+vnet_classify_chain_get (u32 chain_index)
+{
+  vnet_classify_main_t *vcm = &vnet_classify_main;
+
+  return (pool_elt_at_index (vcm->chains, chain_index));
+}
+
+static_always_inline const u8 *
+vnet_classify_chain_data (const vnet_classify_table_t *t, const u8 *data,
+			  const u8 *current)
+{
+  if (t->current_data_flag == CLASSIFY_FLAG_USE_CURR_DATA)
+    return current + t->current_data_offset;
+  return data;
+}
+
+/**
+ * Compute the hashes of a packet for all the tables of a compiled chain and
+ * prefetch their buckets.
+ *
+ * The hashes do not depend on each other, so nodes that walk the chain
+ * through next_table_index can use them instead of hashing one table at a
+ * time after each miss. Tables are in walk order, i.e., hashes[i] is for
+ * the i-th table reached from the head.
+ *
+ * @param data     base the tables match at unless they use current data,
+ *                 e.g., b->data
+ * @param current  the packet's current data pointer
+ */
+static_always_inline void
+vnet_classify_chain_hash_prefetch (const vnet_classify_chain_t *c,
+				   const u8 *data, const u8 *current,
+				   vnet_classify_table_t **tables, u32 *hashes)
+{
+  vnet_classify_main_t *vcm = &vnet_classify_main;
+  u32 i, n_tables = vec_len (c->table_indices);
+
+  for (i = 0; i < n_tables; i++)
+    {
+      tables[i] = pool_elt_at_index (vcm->tables, c->table_indices[i]);
+      hashes[i] = vnet_classify_hash_packet_inline (
+	tables[i], vnet_classify_chain_data (tables[i], data, current));
+      vnet_classify_prefetch_bucket (tables[i], hashes[i]);
+    }
+}
+
+/**
+ * Search a compiled chain for a packet.
+ *
+ * @param data     base the tables match at unless they use current data
+ * @param current  the packet's current data pointer
+ * @param tp       set to the table that matched, or to the last table of
+ *                 the chain on a miss so its miss_next_index can be used
+ */
+static_always_inline vnet_classify_entry_t *
+vnet_classify_chain_find_entry (const vnet_classify_chain_t *c,
+				const u8 *data, const u8 *current, f64 now,
+				vnet_classify_table_t **tp)
+{
+  vnet_classify_table_t *tables[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+  u32 hashes[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+  u32 i, n_tables = vec_len (c->table_indices);
+  vnet_classify_entry_t *e;
+
+  vnet_classify_chain_hash_prefetch (c, data, current, tables, hashes);
+
+  for (i = 0; i < n_tables; i++)
+    {
+      e = vnet_classify_find_entry_inline (
+	tables[i], vnet_classify_chain_data (tables[i], data, current),
+	hashes[i], now);
+      if (e)
+	{
+	  *tp = tables[i];
+	  return e;
+	}
+    }
+
+  *tp = tables[n_tables - 1];
+  return 0;
+}
+
+/**
+ * Search a compiled chain for 8 packets at once.
+ *
+ * All 8 x n_tables hashes are computed and their buckets and entries
+ * prefetched before the first entry is compared, so the memory accesses of
+ * the whole batch overlap.
+ */
+static_always_inline void
+vnet_classify_chain_find_entry_x8 (const vnet_classify_chain_t *c,
+				   const u8 **data, const u8 **current,
+				   f64 now, vnet_classify_entry_t **e,
+				   vnet_classify_table_t **tp)
+{
+  vnet_classify_main_t *vcm = &vnet_classify_main;
+  vnet_classify_table_t *tables[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+  u32 hashes[VNET_CLASSIFY_CHAIN_MAX_TABLES][8];
+  u32 i, j, n_tables = vec_len (c->table_indices);
+  u8 done = 0;
+
+  for (i = 0; i < n_tables; i++)
+    {
+      tables[i] = pool_elt_at_index (vcm->tables, c->table_indices[i]);
+      for (j = 0; j < 8; j++)
+	{
+	  hashes[i][j] = vnet_classify_hash_packet_inline (
+	    tables[i], vnet_classify_chain_data (tables[i], data[j], current[j]));
+	  vnet_classify_prefetch_bucket (tables[i], hashes[i][j]);
+	}
+    }
+
+  for (i = 0; i < n_tables; i++)
+    for (j = 0; j < 8; j++)
+      vnet_classify_prefetch_entry (tables[i], hashes[i][j]);
+
+  for (j = 0; j < 8; j++)
+    {
+      e[j] = 0;
+      tp[j] = tables[n_tables - 1];
+    }
+
+  for (i = 0; i < n_tables && done != 0xff; i++)
+    for (j = 0; j < 8; j++)
+      {
+	if (done & (1 << j))
+	  continue;
+	e[j] = vnet_classify_find_entry_inline (
+	  tables[i], vnet_classify_chain_data (tables[i], data[j], current[j]),
+	  hashes[i][j], now);
+	if (e[j])
+	  {
+	    tp[j] = tables[i];
+	    done |= 1 << j;
+	  }
+      }
+}
+
 vnet_classify_table_t *vnet_classify_new_table (vnet_classify_main_t *cm,
 						const u8 *mask, u32 nbuckets,
 						u32 memory_size,
@@ -600,6 +768,8 @@ int vnet_classify_add_del_table (vnet_classify_main_t *cm, const u8 *mask,
 				 int is_add, int del_chain);
 void vnet_classify_delete_table_index (vnet_classify_main_t *cm,
 				       u32 table_index, int del_chain);
+int vnet_classify_chain_compile (vnet_classify_main_t *cm, u32 table_index,
+				 int is_add);
 
 unformat_function_t unformat_ip4_mask;
 unformat_function_t unformat_ip6_mask;
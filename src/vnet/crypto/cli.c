@@ -193,7 +193,11 @@ show_crypto_async_status_command_fn (vlib_main_t * vm,
   vnet_crypto_main_t *cm = &crypto_main;
   vlib_thread_main_t *tm = vlib_get_thread_main ();
   unformat_input_t _line_input, *line_input = &_line_input;
-  int i;
+  vnet_crypto_thread_t *ct;
+  vnet_crypto_engine_t *e;
+  u64 *hist = 0;
+  u8 *s = 0;
+  int i, j;
 
   if (unformat_user (input, unformat_line_input, line_input))
     unformat_free (line_input);
@@ -209,6 +213,46 @@ show_crypto_async_status_command_fn (vlib_main_t * vm,
       if (state == VLIB_NODE_STATE_DISABLED)
 	vlib_cli_output (vm, "threadId: %-6d DISABLED", i);
     }
+
+  vec_foreach_index (i, cm->threads)
+    {
+      ct = cm->threads + i;
+      if (ct->n_reordered || ct->n_reorder_skipped || ct->n_reorder_late)
+	vlib_cli_output (vm,
+			 "threadId: %-6d reordered frames %llu skipped %llu "
+			 "late %llu",
+			 i, ct->n_reordered, ct->n_reorder_skipped,
+			 ct->n_reorder_late);
+      vec_foreach_index (j, ct->batch_hist)
+	{
+	  vec_validate (hist, j);
+	  hist[j] += ct->batch_hist[j];
+	}
+    }
+
+  vec_foreach (e, cm->engines)
+    {
+      u32 base = (e - cm->engines) * VNET_CRYPTO_BATCH_HIST_N_BUCKETS;
+      u64 total = 0;
+
+      for (j = 0; j < VNET_CRYPTO_BATCH_HIST_N_BUCKETS; j++)
+	if (base + j < vec_len (hist))
+	  total += hist[base + j];
+      if (!total)
+	continue;
+
+      s = format (s, "%s frames %llu, batch sizes:", e->name, total);
+      for (j = 0; j < VNET_CRYPTO_BATCH_HIST_N_BUCKETS; j++)
+	if (base + j < vec_len (hist) && hist[base + j])
+	  s = format (s, " %u-%u: %llu", 1 << j,
+		      clib_min ((2 << j) - 1, VNET_CRYPTO_FRAME_SIZE),
+		      hist[base + j]);
+      vlib_cli_output (vm, "%v", s);
+      vec_reset_length (s);
+    }
+
+  vec_free (hist);
+  vec_free (s);
   return 0;
 }
 
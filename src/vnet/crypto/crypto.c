@@ -560,6 +560,86 @@ vnet_crypto_set_async_dispatch (u8 mode, u8 adaptive)
     }
 }
 
+void
+vnet_crypto_async_schedule_flush (vlib_main_t *vm)
+{
+  vlib_node_runtime_t *rt =
+    vlib_node_get_runtime (vm, crypto_main.crypto_node_index);
+
+  /* a polling crypto-dispatch runs every loop anyway */
+  if (rt->state == VLIB_NODE_STATE_INTERRUPT ||
+      (rt->state == VLIB_NODE_STATE_POLLING &&
+       (rt->flags & VLIB_NODE_FLAG_SWITCH_FROM_POLLING_TO_INTERRUPT_MODE)))
+    vlib_node_set_interrupt_pending (vm, crypto_main.crypto_node_index);
+}
+
+/*
+ * Order a frame completed out of submission order, or while frames of its
+ * op are parked. The frames that can now be delivered are appended to
+ * ready in submission order, the others are parked in ct->reorder_frames.
+ * If more than VNET_CRYPTO_REORDER_MAX_FRAMES frames of the op are parked,
+ * an earlier frame is either very late or lost: the completion order skips
+ * ahead to the oldest parked frame. A frame completing after its gap was
+ * skipped is delivered right away.
+ */
+void
+vnet_crypto_reorder_frame (vnet_crypto_thread_t *ct,
+			   vnet_crypto_async_frame_t *cf,
+			   vnet_crypto_async_frame_t ***ready)
+{
+  vnet_crypto_op_id_t op = cf->op;
+  i32 delta = (i32) (cf->seq - ct->complete_seq[op]);
+  vnet_crypto_async_frame_t **pf;
+  u32 i, min_delta = ~0;
+
+  if (delta < 0)
+    {
+      ct->n_reorder_late++;
+      vec_add1 (*ready, cf);
+      return;
+    }
+
+  if (delta == 0)
+    {
+      ct->complete_seq[op]++;
+      vec_add1 (*ready, cf);
+    }
+  else
+    {
+      vec_add1 (ct->reorder_frames, cf);
+      ct->n_parked[op]++;
+      ct->n_reordered++;
+
+      if (ct->n_parked[op] <= VNET_CRYPTO_REORDER_MAX_FRAMES)
+	return;
+
+      vec_foreach (pf, ct->reorder_frames)
+	if (pf[0]->op == op && pf[0]->seq - ct->complete_seq[op] < min_delta)
+	  min_delta = pf[0]->seq - ct->complete_seq[op];
+
+      ct->n_reorder_skipped++;
+      ct->complete_seq[op] += min_delta;
+    }
+
+  /* deliver the parked frames of this op that are now in order */
+again:
+  if (ct->n_parked[op] == 0)
+    return;
+
+  vec_foreach_index (i, ct->reorder_frames)
+    {
+      cf = ct->reorder_frames[i];
+      if (cf->op == op && cf->seq == ct->complete_seq[op])
+	{
+	  vec_delete (ct->reorder_frames, 1, i);
+	  ct->n_parked[op]--;
+	  ct->complete_seq[op]++;
+	  vec_add1 (*ready, cf);
+	  goto again;
+	}
+    }
+}
+
 static void
 vnet_crypto_load_engines (vlib_main_t *vm)
 {
@@ -19,6 +19,11 @@
 #include <vlib/vlib.h>
 
 #define VNET_CRYPTO_FRAME_SIZE 64
+/* log2 buckets of submitted frame sizes, 1 .. VNET_CRYPTO_FRAME_SIZE */
+#define VNET_CRYPTO_BATCH_HIST_N_BUCKETS 7
+/* frames parked waiting for an earlier frame of the same op before the
+ * completion order is given up on */
+#define VNET_CRYPTO_REORDER_MAX_FRAMES 64
 #define VNET_CRYPTO_FRAME_POOL_SIZE 1024
 
 /* CRYPTO_ID, PRETTY_NAME, ARGS*/
@@ -323,6 +328,8 @@ typedef struct
   vnet_crypto_async_frame_state_t state;
   vnet_crypto_op_id_t op : 8;
   u16 n_elts;
+  /* per thread, per op submission order */
+  u32 seq;
   vnet_crypto_async_frame_elt_t elts[VNET_CRYPTO_FRAME_SIZE];
   u32 buffer_indices[VNET_CRYPTO_FRAME_SIZE];
   u16 next_node_index[VNET_CRYPTO_FRAME_SIZE];
@@ -335,6 +342,24 @@ typedef struct
   vnet_crypto_async_frame_t *frame_pool;
   u32 *buffer_indices;
   u16 *nexts;
+
+  /* frames being filled, shared by all producers on this thread and
+   * flushed by crypto-dispatch */
+  vnet_crypto_async_frame_t *open_frames[VNET_CRYPTO_N_OP_IDS];
+  vnet_crypto_op_id_t *open_ops;
+
+  /* in-order completion */
+  u32 submit_seq[VNET_CRYPTO_N_OP_IDS];
+  u32 complete_seq[VNET_CRYPTO_N_OP_IDS];
+  u32 n_parked[VNET_CRYPTO_N_OP_IDS];
+  vnet_crypto_async_frame_t **reorder_frames;
+  vnet_crypto_async_frame_t **ready_frames;
+  u64 n_reordered;
+  u64 n_reorder_skipped;
+  u64 n_reorder_late;
+
+  /* submitted frame sizes, VNET_CRYPTO_BATCH_HIST_N_BUCKETS per engine */
+  u64 *batch_hist;
 } vnet_crypto_thread_t;
 
 typedef u32 vnet_crypto_key_index_t;
@@ -543,14 +568,16 @@ vnet_crypto_async_submit_open_frame (vlib_main_t * vm,
 {
   vnet_crypto_main_t *cm = &crypto_main;
   vlib_thread_main_t *tm = vlib_get_thread_main ();
+  vnet_crypto_thread_t *ct = cm->threads + vm->thread_index;
   vnet_crypto_op_id_t op = frame->op;
   vnet_crypto_frame_enq_fn_t *fn =
     cm->opt_data[op].handlers[VNET_CRYPTO_HANDLER_TYPE_ASYNC];
-  u32 i;
+  u32 i, hist_index;
   vlib_node_t *n;
 
   frame->state = VNET_CRYPTO_FRAME_STATE_PENDING;
   frame->enqueue_thread_index = vm->thread_index;
+  frame->seq = ct->submit_seq[op];
 
   if (PREDICT_FALSE (fn == 0))
     {
@@ -562,6 +589,16 @@ vnet_crypto_async_submit_open_frame (vlib_main_t * vm,
 
   if (PREDICT_TRUE (ret == 0))
     {
+      ct->submit_seq[op]++;
+
+      hist_index =
+	cm->opt_data[op].active_engine_index[VNET_CRYPTO_HANDLER_TYPE_ASYNC] *
+	  VNET_CRYPTO_BATCH_HIST_N_BUCKETS +
+	min_log2 (frame->n_elts);
+      if (PREDICT_FALSE (hist_index >= vec_len (ct->batch_hist)))
+	vec_validate (ct->batch_hist, hist_index);
+      ct->batch_hist[hist_index]++;
+
       n = vlib_get_node (vm, cm->crypto_node_index);
       if (n->state == VLIB_NODE_STATE_INTERRUPT)
 	{
@@ -628,6 +665,53 @@ vnet_crypto_async_frame_is_full (const vnet_crypto_async_frame_t *f)
   return (f->n_elts == VNET_CRYPTO_FRAME_SIZE);
 }
 
+void vnet_crypto_async_schedule_flush (vlib_main_t *vm);
+void vnet_crypto_reorder_frame (vnet_crypto_thread_t *ct,
+				vnet_crypto_async_frame_t *cf,
+				vnet_crypto_async_frame_t ***ready);
+
+/**
+ * Get the thread's open frame for this op, allocating one if needed.
+ * Open frames collect packets from all SAs and all producer nodes on the
+ * thread; a producer that fills one closes and submits it, crypto-dispatch
+ * submits the remaining partial frames on its next run.
+ **/
+static_always_inline vnet_crypto_async_frame_t *
+vnet_crypto_async_get_open_frame (vlib_main_t *vm, vnet_crypto_op_id_t opt)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  vnet_crypto_thread_t *ct = cm->threads + vm->thread_index;
+  vnet_crypto_async_frame_t *f = ct->open_frames[opt];
+
+  if (PREDICT_TRUE (f != 0))
+    return f;
+
+  f = vnet_crypto_async_get_frame (vm, opt);
+  if (PREDICT_FALSE (!f))
+    return 0;
+
+  ct->open_frames[opt] = f;
+  vec_add1 (ct->open_ops, opt);
+  vnet_crypto_async_schedule_flush (vm);
+
+  return f;
+}
+
+/**
+ * Detach a (full) open frame from the thread so that the caller can
+ * submit it.
+ **/
+static_always_inline void
+vnet_crypto_async_close_open_frame (vlib_main_t *vm,
+				    vnet_crypto_async_frame_t *f)
+{
+  vnet_crypto_main_t *cm = &crypto_main;
+  vnet_crypto_thread_t *ct = cm->threads + vm->thread_index;
+
+  ASSERT (ct->open_frames[f->op] == f);
+  ct->open_frames[f->op] = 0;
+}
+
 #endif /* included_vnet_crypto_crypto_h */
 
 /*
@@ -70,6 +70,88 @@ vnet_crypto_async_add_trace (vlib_main_t *vm, vlib_node_runtime_t *node,
   tr->op = op_id;
 }
 
+static_always_inline u32
+crypto_deliver_frame (vlib_main_t *vm, vlib_node_runtime_t *node,
+		      vnet_crypto_thread_t *ct, vnet_crypto_async_frame_t *cf,
+		      u32 n_cache)
+{
+  vec_validate (ct->buffer_indices, n_cache + cf->n_elts);
+  vec_validate (ct->nexts, n_cache + cf->n_elts);
+  clib_memcpy_fast (ct->buffer_indices + n_cache, cf->buffer_indices,
+		    sizeof (u32) * cf->n_elts);
+  if (cf->state == VNET_CRYPTO_FRAME_STATE_SUCCESS)
+    {
+      clib_memcpy_fast (ct->nexts + n_cache, cf->next_node_index,
+			sizeof (u16) * cf->n_elts);
+    }
+  else
+    {
+      u32 i;
+      for (i = 0; i < cf->n_elts; i++)
+	{
+	  if (cf->elts[i].status != VNET_CRYPTO_OP_STATUS_COMPLETED)
+	    {
+	      ct->nexts[i + n_cache] = CRYPTO_DISPATCH_NEXT_ERR_DROP;
+	      vlib_node_increment_counter (vm, node->node_index,
+					   cf->elts[i].status, 1);
+	    }
+	  else
+	    ct->nexts[i + n_cache] = cf->next_node_index[i];
+	}
+    }
+  n_cache += cf->n_elts;
+  if (n_cache >= VLIB_FRAME_SIZE)
+    {
+      vlib_buffer_enqueue_to_next_vec (vm, node, &ct->buffer_indices,
+				       &ct->nexts, n_cache);
+      n_cache = 0;
+    }
+  if (PREDICT_FALSE (node->flags & VLIB_NODE_FLAG_TRACE))
+    {
+      u32 i;
+      for (i = 0; i < cf->n_elts; i++)
+	{
+	  vlib_buffer_t *b = vlib_get_buffer (vm, cf->buffer_indices[i]);
+	  if (b->flags & VLIB_BUFFER_IS_TRACED)
+	    vnet_crypto_async_add_trace (vm, node, b, cf->op,
+					 cf->elts[i].status);
+	}
+    }
+  vnet_crypto_async_free_frame (vm, cf);
+  return n_cache;
+}
+
+/*
+ * Frames of one op submitted by this thread are delivered in submission
+ * order, so packets of an SA leave crypto-dispatch in the order the
+ * producer saw them even when the engine completes frames out of order.
+ */
+static_always_inline u32
+crypto_complete_frame (vlib_main_t *vm, vlib_node_runtime_t *node,
+		       vnet_crypto_thread_t *ct, vnet_crypto_async_frame_t *cf,
+		       u32 n_cache)
+{
+  vnet_crypto_op_id_t op = cf->op;
+  vnet_crypto_async_frame_t **rf;
+
+  if (PREDICT_FALSE (cf->enqueue_thread_index != vm->thread_index))
+    return crypto_deliver_frame (vm, node, ct, cf, n_cache);
+
+  if (PREDICT_TRUE (cf->seq == ct->complete_seq[op] &&
+		    ct->n_parked[op] == 0))
+    {
+      ct->complete_seq[op]++;
+      return crypto_deliver_frame (vm, node, ct, cf, n_cache);
+    }
+
+  vec_reset_length (ct->ready_frames);
+  vnet_crypto_reorder_frame (ct, cf, &ct->ready_frames);
+  vec_foreach (rf, ct->ready_frames)
+    n_cache = crypto_deliver_frame (vm, node, ct, rf[0], n_cache);
+
+  return n_cache;
+}
+
 static_always_inline u32
 crypto_dequeue_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
 		      vnet_crypto_thread_t * ct,
@@ -85,54 +167,7 @@ crypto_dequeue_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
   while (cf || n_elts)
     {
       if (cf)
-	{
-	  vec_validate (ct->buffer_indices, n_cache + cf->n_elts);
-	  vec_validate (ct->nexts, n_cache + cf->n_elts);
-	  clib_memcpy_fast (ct->buffer_indices + n_cache, cf->buffer_indices,
-			    sizeof (u32) * cf->n_elts);
-	  if (cf->state == VNET_CRYPTO_FRAME_STATE_SUCCESS)
-	    {
-	      clib_memcpy_fast (ct->nexts + n_cache, cf->next_node_index,
-				sizeof (u16) * cf->n_elts);
-	    }
-	  else
-	    {
-	      u32 i;
-	      for (i = 0; i < cf->n_elts; i++)
-		{
-		  if (cf->elts[i].status != VNET_CRYPTO_OP_STATUS_COMPLETED)
-		    {
-		      ct->nexts[i + n_cache] = CRYPTO_DISPATCH_NEXT_ERR_DROP;
-		      vlib_node_increment_counter (vm, node->node_index,
-						   cf->elts[i].status, 1);
-		    }
-		  else
-		    ct->nexts[i + n_cache] = cf->next_node_index[i];
-		}
-	    }
-	  n_cache += cf->n_elts;
-	  if (n_cache >= VLIB_FRAME_SIZE)
-	    {
-	      vlib_buffer_enqueue_to_next_vec (vm, node, &ct->buffer_indices,
-					       &ct->nexts, n_cache);
-	      n_cache = 0;
-	    }
-
-	  if (PREDICT_FALSE (node->flags & VLIB_NODE_FLAG_TRACE))
-	    {
-	      u32 i;
-
-	      for (i = 0; i < cf->n_elts; i++)
-		{
-		  vlib_buffer_t *b = vlib_get_buffer (vm,
-						      cf->buffer_indices[i]);
-		  if (b->flags & VLIB_BUFFER_IS_TRACED)
-		    vnet_crypto_async_add_trace (vm, node, b, cf->op,
-						 cf->elts[i].status);
-		}
-	    }
-	  vnet_crypto_async_free_frame (vm, cf);
-	}
+	n_cache = crypto_complete_frame (vm, node, ct, cf, n_cache);
       /* signal enqueue-thread to dequeue the processed frame (n_elts>0) */
       if (n_elts > 0 &&
 	  ((node->state == VLIB_NODE_STATE_POLLING &&
@@ -150,6 +185,42 @@ crypto_dequeue_frame (vlib_main_t * vm, vlib_node_runtime_t * node,
       cf = (hdl) (vm, &n_elts, &enqueue_thread_idx);
       *n_total += n_elts;
     }
+  return n_cache;
+}
+
+/*
+ * Submit the partially filled frames producers left open on this thread.
+ * A frame the engine refuses is dropped here with engine-error.
+ */
+static_always_inline u32
+crypto_flush_open_frames (vlib_main_t *vm, vlib_node_runtime_t *node,
+			  vnet_crypto_thread_t *ct, u32 n_cache)
+{
+  vnet_crypto_op_id_t *op;
+  vnet_crypto_async_frame_t *f;
+  u32 i;
+
+  vec_foreach (op, ct->open_ops)
+    {
+      f = ct->open_frames[op[0]];
+      if (!f)
+	continue;
+      ct->open_frames[op[0]] = 0;
+
+      if (PREDICT_FALSE (!f->n_elts))
+	{
+	  vnet_crypto_async_free_frame (vm, f);
+	  continue;
+	}
+
+      if (vnet_crypto_async_submit_open_frame (vm, f) < 0)
+	{
+	  for (i = 0; i < f->n_elts; i++)
+	    f->elts[i].status = VNET_CRYPTO_OP_STATUS_FAIL_ENGINE_ERR;
+	  n_cache = crypto_deliver_frame (vm, node, ct, f, n_cache);
+	}
+    }
+  vec_reset_length (ct->open_ops);
 
   return n_cache;
 }
@@ -161,6 +232,10 @@ VLIB_NODE_FN (crypto_dispatch_node) (vlib_main_t * vm,
   vnet_crypto_main_t *cm = &crypto_main;
   vnet_crypto_thread_t *ct = cm->threads + vm->thread_index;
   u32 n_dispatched = 0, n_cache = 0, index;
+
+  if (vec_len (ct->open_ops))
+    n_cache = crypto_flush_open_frames (vm, node, ct, n_cache);
+
   vec_foreach_index (index, cm->dequeue_handlers)
     {
       n_cache = crypto_dequeue_frame (
@@ -41,6 +41,21 @@ vnet_sw_interface_gso_enable_disable (u32 sw_if_index, u8 enable)
   return (0);
 }
 
+/**
+ * Check if packets sent on the interface are segmented in software
+ *
+ * Lets senders, e.g., the host stack, emit GSO packets on interfaces
+ * that lack TSO support and defer segmentation to the gso feature.
+ */
+int
+vnet_sw_interface_gso_is_enabled (u32 sw_if_index, u8 is_ip6)
+{
+  if (is_ip6)
+    return vnet_feature_is_enabled ("ip6-output", "gso-ip6", sw_if_index) ==
+	   1;
+  return vnet_feature_is_enabled ("ip4-output", "gso-ip4", sw_if_index) == 1;
+}
+
 static clib_error_t *
 gso_init (vlib_main_t * vm)
 {
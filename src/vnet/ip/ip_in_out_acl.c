@@ -111,6 +111,28 @@ static char *ip_outacl_error_strings[] = {
 #undef _
 };
 
+/*
+ * On a miss in a table that heads a compiled chain, hash the packet for all
+ * the tables of the chain at once and prefetch their buckets, so walking
+ * the chain does not wait on each table in turn. Returns the hashes in walk
+ * order, or 0 if the table heads no compiled chain.
+ */
+static_always_inline u32 *
+ip_in_out_acl_chain_prefetch (vnet_classify_table_t *t, vlib_buffer_t *b,
+			      const int is_output, u32 *hashes)
+{
+  vnet_classify_table_t *tables[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+  u32 l2_len = is_output ? vnet_buffer (b)->l2.l2_len : 0;
+
+  if (PREDICT_TRUE (t->chain_index == ~0))
+    return 0;
+
+  vnet_classify_chain_hash_prefetch (
+    vnet_classify_chain_get (t->chain_index), b->data + l2_len,
+    (u8 *) vlib_buffer_get_current (b) + l2_len, tables, hashes);
+  return hashes;
+}
+
 static_always_inline void
 ip_in_out_acl_inline_trace (
   vlib_main_t *vm, vlib_node_runtime_t *node, vlib_frame_t *frame,
@@ -325,6 +347,11 @@ ip_in_out_acl_inline_trace (
 	    }
 	  else
 	    {
+	      u32 chain_hash0[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+	      u32 chain_pos0 = 0, *chain_hash0p;
+
+	      chain_hash0p = ip_in_out_acl_chain_prefetch (
+		t[0], b[0], is_output, chain_hash0);
 	      while (1)
 		{
 		  table_index[0] = t[0]->next_table_index;
@@ -354,8 +381,9 @@ ip_in_out_acl_inline_trace (
 		  if (is_output)
 		    h[0] += vnet_buffer (b[0])->l2.l2_len;
 
-		  hash[0] =
-		    vnet_classify_hash_packet_inline (t[0], (u8 *) h[0]);
+		  hash[0] = chain_hash0p ? chain_hash0p[++chain_pos0] :
+					   vnet_classify_hash_packet_inline (
+					     t[0], (u8 *) h[0]);
 		  e[0] =
 		    vnet_classify_find_entry_inline (t[0], (u8 *) h[0],
 						     hash[0], now);
@@ -433,6 +461,11 @@ ip_in_out_acl_inline_trace (
 	    }
 	  else
 	    {
+	      u32 chain_hash1[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+	      u32 chain_pos1 = 0, *chain_hash1p;
+
+	      chain_hash1p = ip_in_out_acl_chain_prefetch (
+		t[1], b[1], is_output, chain_hash1);
 	      while (1)
 		{
 		  table_index[1] = t[1]->next_table_index;
@@ -462,8 +495,9 @@ ip_in_out_acl_inline_trace (
 		  if (is_output)
 		    h[1] += vnet_buffer (b[1])->l2.l2_len;
 
-		  hash[1] =
-		    vnet_classify_hash_packet_inline (t[1], (u8 *) h[1]);
+		  hash[1] = chain_hash1p ? chain_hash1p[++chain_pos1] :
+					   vnet_classify_hash_packet_inline (
+					     t[1], (u8 *) h[1]);
 		  e[1] =
 		    vnet_classify_find_entry_inline (t[1], (u8 *) h[1],
 						     hash[1], now);
@@ -636,6 +670,11 @@ ip_in_out_acl_inline_trace (
 	    }
 	  else
 	    {
+	      u32 chain_hash0[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+	      u32 chain_pos0 = 0, *chain_hash0p;
+
+	      chain_hash0p = ip_in_out_acl_chain_prefetch (t0, b[0], is_output,
+							    chain_hash0);
 	      while (1)
 		{
 		  table_index0 = t0->next_table_index;
@@ -665,7 +704,9 @@ ip_in_out_acl_inline_trace (
 		  if (is_output)
 		    h0 += vnet_buffer (b[0])->l2.l2_len;
 
-		  hash0 = vnet_classify_hash_packet_inline (t0, (u8 *) h0);
+		  hash0 = chain_hash0p ? chain_hash0p[++chain_pos0] :
+					 vnet_classify_hash_packet_inline (
+					   t0, (u8 *) h0);
 		  e0 = vnet_classify_find_entry_inline
 		    (t0, (u8 *) h0, hash0, now);
 		  if (e0)
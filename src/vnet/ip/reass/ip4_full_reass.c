@@ -132,6 +132,8 @@ typedef struct
   u64 id;
   // buffer index of first buffer in this reassembly context
   u32 first_bi;
+  // buffer index of last range in this reassembly context
+  u32 last_bi;
   // last octet of packet, ~0 until fragment without more_fragments arrives
   u32 last_packet_octet;
   // length of data collected so far
@@ -151,6 +153,9 @@ typedef struct
   // thread which received fragment with offset 0 and which sends out the
   // completed reassembly
   u32 sendout_thread_index;
+  // lru indexes
+  u32 lru_prev;
+  u32 lru_next;
 } ip4_full_reass_t;
 
 typedef struct
@@ -161,6 +166,11 @@ typedef struct
   // for pacing the main thread timeouts
   u32 last_id;
   clib_spinlock_t lock;
+  // per pool index bitmap of 8-octet blocks covered by fragments
+  uword **covered;
+  // lru indexes
+  u32 lru_first;
+  u32 lru_last;
 } ip4_full_reass_per_thread_t;
 
 typedef struct
@@ -402,10 +412,67 @@ ip4_full_reass_add_trace (vlib_main_t * vm, vlib_node_runtime_t * node,
 #endif
 }
 
+always_inline void
+ip4_full_reass_lru_remove (ip4_full_reass_per_thread_t *rt,
+			   ip4_full_reass_t *reass)
+{
+  if (~0 != reass->lru_prev)
+    {
+      ip4_full_reass_t *lru_prev =
+	pool_elt_at_index (rt->pool, reass->lru_prev);
+      lru_prev->lru_next = reass->lru_next;
+    }
+  if (~0 != reass->lru_next)
+    {
+      ip4_full_reass_t *lru_next =
+	pool_elt_at_index (rt->pool, reass->lru_next);
+      lru_next->lru_prev = reass->lru_prev;
+    }
+  if (rt->lru_first == reass - rt->pool)
+    {
+      rt->lru_first = reass->lru_next;
+    }
+  if (rt->lru_last == reass - rt->pool)
+    {
+      rt->lru_last = reass->lru_prev;
+    }
+}
+
+always_inline void
+ip4_full_reass_lru_add (ip4_full_reass_per_thread_t *rt,
+			ip4_full_reass_t *reass)
+{
+  reass->lru_prev = reass->lru_next = ~0;
+
+  if (~0 != rt->lru_last)
+    {
+      ip4_full_reass_t *lru_last = pool_elt_at_index (rt->pool, rt->lru_last);
+      reass->lru_prev = rt->lru_last;
+      lru_last->lru_next = rt->lru_last = reass - rt->pool;
+    }
+
+  if (~0 == rt->lru_first)
+    {
+      rt->lru_first = rt->lru_last = reass - rt->pool;
+    }
+}
+
+/* move a context to the most recently used end of the lru list */
+always_inline void
+ip4_full_reass_lru_touch (ip4_full_reass_per_thread_t *rt,
+			  ip4_full_reass_t *reass)
+{
+  if (rt->lru_last == reass - rt->pool)
+    return;
+  ip4_full_reass_lru_remove (rt, reass);
+  ip4_full_reass_lru_add (rt, reass);
+}
+
 always_inline void
 ip4_full_reass_free_ctx (ip4_full_reass_per_thread_t * rt,
 			 ip4_full_reass_t * reass)
 {
+  ip4_full_reass_lru_remove (rt, reass);
   pool_put (rt->pool, reass);
   --rt->reass_n;
 }
@@ -425,7 +492,7 @@ ip4_full_reass_free (ip4_full_reass_main_t * rm,
  * could be called from a graphnode, where its managing local copy of these
  * variables, and ignoring those and still trying to enqueue the buffers
  * with local variables would cause either buffer leak or corruption */
-always_inline void
+always_inline u32
 ip4_full_reass_drop_all (vlib_main_t *vm, vlib_node_runtime_t *node,
 			 ip4_full_reass_t *reass)
 {
@@ -433,6 +500,7 @@ ip4_full_reass_drop_all (vlib_main_t *vm, vlib_node_runtime_t *node,
   vlib_buffer_t *range_b;
   vnet_buffer_opaque_t *range_vnb;
   u32 *to_free = NULL;
+  u32 n_dropped;
 
   while (~0 != range_bi)
     {
@@ -473,7 +541,9 @@ ip4_full_reass_drop_all (vlib_main_t *vm, vlib_node_runtime_t *node,
     {
       vlib_buffer_free (vm, to_free, vec_len (to_free));
     }
+  n_dropped = vec_len (to_free);
   vec_free (to_free);
+  return n_dropped;
 }
 
 always_inline void
@@ -536,18 +606,76 @@ always_inline void
 ip4_full_reass_init (ip4_full_reass_t * reass)
 {
   reass->first_bi = ~0;
+  reass->last_bi = ~0;
   reass->last_packet_octet = ~0;
   reass->data_len = 0;
   reass->next_index = ~0;
   reass->error_next_index = ~0;
 }
 
+/*
+ * Look up a context owned by another thread without handing the fragment
+ * off. This only succeeds if the owner's lock can be taken right away, which
+ * is the case whenever the owner is not running its reassembly node or the
+ * expire walk. On success the owner's lock is held and *rtp points to the
+ * owner's per-thread data; the caller releases the lock once done with the
+ * context.
+ */
+always_inline void
+ip4_full_reass_make_kv (vlib_buffer_t *b, ip4_header_t *ip,
+			ip4_full_reass_kv_t *kv)
+{
+  u32 fib_index = (vnet_buffer (b)->sw_if_index[VLIB_TX] == (u32) ~0) ?
+		    vec_elt (ip4_main.fib_index_by_sw_if_index,
+			     vnet_buffer (b)->sw_if_index[VLIB_RX]) :
+		    vnet_buffer (b)->sw_if_index[VLIB_TX];
+
+  clib_memset (kv, 0, sizeof (*kv));
+  kv->k.fib_index = fib_index;
+  kv->k.src.as_u32 = ip->src_address.as_u32;
+  kv->k.dst.as_u32 = ip->dst_address.as_u32;
+  kv->k.frag_id = ip->fragment_id;
+  kv->k.proto = ip->protocol;
+}
+
+always_inline ip4_full_reass_t *
+ip4_full_reass_find_foreign (ip4_full_reass_main_t *rm,
+			     ip4_full_reass_per_thread_t **rtp,
+			     ip4_full_reass_kv_t *kv, f64 now)
+{
+  ip4_full_reass_per_thread_t *ort =
+    &rm->per_thread_data[kv->v.memory_owner_thread_index];
+  ip4_full_reass_t *reass;
+
+  if (!clib_spinlock_trylock (&ort->lock))
+    return NULL;
+
+  /* the context might have been freed or reused since the lookup */
+  if (pool_is_free_index (ort->pool, kv->v.reass_index))
+    goto fail;
+  reass = pool_elt_at_index (ort->pool, kv->v.reass_index);
+  if (memcmp (&reass->key, &kv->k, sizeof (reass->key)) ||
+      now > reass->last_heard + rm->timeout)
+    goto fail;
+
+  reass->last_heard = now;
+  ip4_full_reass_lru_touch (ort, reass);
+  *rtp = ort;
+  return reass;
+
+fail:
+  clib_spinlock_unlock (&ort->lock);
+  return NULL;
+}
+
 always_inline ip4_full_reass_t *
 ip4_full_reass_find_or_create (vlib_main_t *vm, vlib_node_runtime_t *node,
 			       ip4_full_reass_main_t *rm,
-			       ip4_full_reass_per_thread_t *rt,
-			       ip4_full_reass_kv_t *kv, u8 *do_handoff)
+			       ip4_full_reass_per_thread_t **rtp,
+			       ip4_full_reass_kv_t *kv, u64 hash,
+			       u8 *do_handoff)
 {
+  ip4_full_reass_per_thread_t *rt = *rtp;
   ip4_full_reass_t *reass;
   f64 now;
 
@@ -555,10 +683,18 @@ again:
 
   reass = NULL;
   now = vlib_time_now (vm);
-  if (!clib_bihash_search_16_8 (&rm->hash, &kv->kv, &kv->kv))
+  if (!clib_bihash_search_inline_2_with_hash_16_8 (&rm->hash, hash, &kv->kv,
+						   &kv->kv))
     {
       if (vm->thread_index != kv->v.memory_owner_thread_index)
 	{
+	  reass = ip4_full_reass_find_foreign (rm, rtp, kv, now);
+	  if (reass)
+	    {
+	      vlib_node_increment_counter (vm, node->node_index,
+					   IP4_ERROR_REASS_HANDOFF_AVOIDED, 1);
+	      return reass;
+	    }
 	  *do_handoff = 1;
 	  return NULL;
 	}
@@ -580,25 +716,34 @@ again:
   if (reass)
     {
       reass->last_heard = now;
+      ip4_full_reass_lru_touch (rt, reass);
       return reass;
     }
 
   if (rt->reass_n >= rm->max_reass_n)
     {
-      reass = NULL;
-      return reass;
-    }
-  else
-    {
-      pool_get (rt->pool, reass);
-      clib_memset (reass, 0, sizeof (*reass));
-      reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
-      reass->memory_owner_thread_index = vm->thread_index;
-      ++rt->id_counter;
-      ip4_full_reass_init (reass);
-      ++rt->reass_n;
+      if (!rm->max_reass_n || ~0 == rt->lru_first)
+	return NULL;
+
+      /* make room by evicting the least recently used reassembly */
+      reass = pool_elt_at_index (rt->pool, rt->lru_first);
+      vlib_node_increment_counter (vm, node->node_index,
+				   IP4_ERROR_REASS_LRU_EVICTED,
+				   ip4_full_reass_drop_all (vm, node, reass));
+      ip4_full_reass_free (rm, rt, reass);
     }
 
+  pool_get (rt->pool, reass);
+  clib_memset (reass, 0, sizeof (*reass));
+  reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
+  reass->memory_owner_thread_index = vm->thread_index;
+  ++rt->id_counter;
+  ip4_full_reass_init (reass);
+  ++rt->reass_n;
+  ip4_full_reass_lru_add (rt, reass);
+  vec_validate (rt->covered, reass - rt->pool);
+  clib_bitmap_zero (rt->covered[reass - rt->pool]);
+
   clib_memcpy_fast (&reass->key, &kv->kv.key, sizeof (reass->key));
   kv->v.reass_index = (reass - rt->pool);
   kv->v.memory_owner_thread_index = vm->thread_index;
@@ -851,6 +996,10 @@ ip4_full_reass_insert_range_in_chain (vlib_main_t * vm,
 	}
       reass->first_bi = new_next_bi;
     }
+  if (~0 == new_next_vnb->ip.reass.next_range_bi)
+    {
+      reass->last_bi = new_next_bi;
+    }
   vnet_buffer_opaque_t *vnb = vnet_buffer (new_next_b);
   if (!(vnb->ip.reass.range_first >= vnb->ip.reass.fragment_first) &&
       !(vnb->ip.reass.range_last > vnb->ip.reass.fragment_first))
@@ -883,6 +1032,10 @@ ip4_full_reass_remove_range_from_chain (vlib_main_t * vm,
     {
       reass->first_bi = discard_vnb->ip.reass.next_range_bi;
     }
+  if (~0 == discard_vnb->ip.reass.next_range_bi)
+    {
+      reass->last_bi = prev_range_bi;
+    }
   vnet_buffer_opaque_t *vnb = vnet_buffer (discard_b);
   if (!(vnb->ip.reass.range_first >= vnb->ip.reass.fragment_first) &&
       !(vnb->ip.reass.range_last > vnb->ip.reass.fragment_first))
@@ -916,6 +1069,30 @@ ip4_full_reass_remove_range_from_chain (vlib_main_t * vm,
   return IP4_REASS_RC_OK;
 }
 
+/*
+ * Coverage is tracked in 8-octet blocks, the fragment offset unit. Only
+ * blocks which a fragment fills completely are marked, except for the block
+ * holding the last octet of the datagram.
+ */
+always_inline void
+ip4_full_reass_mark_covered (uword **covered, u32 fragment_first,
+			     u32 fragment_last, int more_fragments)
+{
+  u32 first = fragment_first / 8;
+  u32 end = more_fragments ? (fragment_last + 1) / 8 : fragment_last / 8 + 1;
+
+  if (end > first)
+    *covered = clib_bitmap_set_region (*covered, first, 1, end - first);
+}
+
+always_inline int
+ip4_full_reass_is_covered (uword *covered, u32 fragment_first,
+			   u32 fragment_last)
+{
+  return clib_bitmap_next_clear (covered, fragment_first / 8) >
+	 fragment_last / 8;
+}
+
 always_inline ip4_full_reass_rc_t
 ip4_full_reass_update (vlib_main_t * vm, vlib_node_runtime_t * node,
 		       ip4_full_reass_main_t * rm,
@@ -941,6 +1118,7 @@ ip4_full_reass_update (vlib_main_t * vm, vlib_node_runtime_t * node,
   fvnb->ip.reass.fragment_first = fragment_first;
   fvnb->ip.reass.fragment_last = fragment_last;
   int more_fragments = ip4_get_fragment_more (fip);
+  uword **covered = vec_elt_at_index (rt->covered, reass - rt->pool);
   u32 candidate_range_bi = reass->first_bi;
   u32 prev_range_bi = ~0;
   fvnb->ip.reass.range_first = fragment_first;
@@ -966,11 +1144,41 @@ ip4_full_reass_update (vlib_main_t * vm, vlib_node_runtime_t * node,
       *bi0 = ~0;
       reass->min_fragment_length = clib_net_to_host_u16 (fip->length);
       reass->fragments_n = 1;
+      ip4_full_reass_mark_covered (covered, fragment_first, fragment_last,
+				   more_fragments);
       return IP4_REASS_RC_OK;
     }
   reass->min_fragment_length =
     clib_min (clib_net_to_host_u16 (fip->length),
 	      fvnb->ip.reass.estimated_mtu);
+  if (ip4_full_reass_is_covered (*covered, fragment_first, fragment_last))
+    {
+      // all data of this fragment has been received already, ignore it
+      // without walking the ranges
+      if (PREDICT_FALSE (fb->flags & VLIB_BUFFER_IS_TRACED))
+	{
+	  ip4_full_reass_add_trace (vm, node, reass, *bi0, RANGE_OVERLAP, 0,
+				    ~0);
+	}
+      ++reass->fragments_n;
+      *next0 = IP4_FULL_REASS_NEXT_DROP;
+      *error0 = IP4_ERROR_REASS_DUPLICATE_FRAGMENT;
+      return IP4_REASS_RC_OK;
+    }
+  if (~0 != reass->last_bi &&
+      fragment_first >
+	vnet_buffer (vlib_get_buffer (vm, reass->last_bi))->ip.reass.range_last)
+    {
+      // in-order arrival - append behind the last range without walking
+      rc = ip4_full_reass_insert_range_in_chain (vm, reass, reass->last_bi,
+						 *bi0);
+      if (IP4_REASS_RC_OK != rc)
+	{
+	  return rc;
+	}
+      consumed = 1;
+      candidate_range_bi = ~0;
+    }
   while (~0 != candidate_range_bi)
     {
       vlib_buffer_t *candidate_b = vlib_get_buffer (vm, candidate_range_bi);
@@ -1123,13 +1331,14 @@ ip4_full_reass_update (vlib_main_t * vm, vlib_node_runtime_t * node,
 	{
 	  ip4_full_reass_add_trace (vm, node, reass, *bi0, RANGE_NEW, 0, ~0);
 	}
+      ip4_full_reass_mark_covered (covered, fragment_first, fragment_last,
+				   more_fragments);
     }
   if (~0 != reass->last_packet_octet &&
       reass->data_len == reass->last_packet_octet + 1)
     {
       *handoff_thread_idx = reass->sendout_thread_index;
-      int handoff =
-	reass->memory_owner_thread_index != reass->sendout_thread_index;
+      int handoff = vm->thread_index != reass->sendout_thread_index;
       rc =
 	ip4_full_reass_finalize (vm, node, rm, rt, reass, bi0, next0, error0,
 				 is_custom);
@@ -1167,10 +1376,29 @@ ip4_full_reass_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   ip4_full_reass_main_t *rm = &ip4_full_reass_main;
   ip4_full_reass_per_thread_t *rt = &rm->per_thread_data[vm->thread_index];
   u16 nexts[VLIB_FRAME_SIZE];
+  ip4_full_reass_kv_t kvs[VLIB_FRAME_SIZE];
+  u64 hashes[VLIB_FRAME_SIZE];
+  u32 i;
+
+  /* Batch the hash table work: compute key and hash of every fragment in
+   * the frame and prefetch its bucket before doing any lookup */
+  for (i = 0; i < frame->n_vectors; i++)
+    {
+      vlib_buffer_t *b = vlib_get_buffer (vm, from[i]);
+      ip4_header_t *ip = vlib_buffer_get_current (b);
+
+      if (!ip4_get_fragment_more (ip) && !ip4_get_fragment_offset (ip))
+	continue;
+
+      ip4_full_reass_make_kv (b, ip, &kvs[i]);
+      hashes[i] = clib_bihash_hash_16_8 (&kvs[i].kv);
+      clib_bihash_prefetch_bucket_16_8 (&rm->hash, hashes[i]);
+    }
 
   clib_spinlock_lock (&rt->lock);
 
   n_left = frame->n_vectors;
+  i = 0;
   while (n_left > 0)
     {
       u32 bi0;
@@ -1222,22 +1450,12 @@ ip4_full_reass_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  goto packet_enqueue;
 	}
 
-      u32 fib_index = (vnet_buffer (b0)->sw_if_index[VLIB_TX] == (u32) ~0) ?
-			      vec_elt (ip4_main.fib_index_by_sw_if_index,
-				 vnet_buffer (b0)->sw_if_index[VLIB_RX]) :
-			      vnet_buffer (b0)->sw_if_index[VLIB_TX];
-
-      ip4_full_reass_kv_t kv = { .k.fib_index = fib_index,
-				 .k.src.as_u32 = ip0->src_address.as_u32,
-				 .k.dst.as_u32 = ip0->dst_address.as_u32,
-				 .k.frag_id = ip0->fragment_id,
-				 .k.proto = ip0->protocol
-
-      };
+      ip4_full_reass_kv_t *kv = &kvs[i];
+      ip4_full_reass_per_thread_t *ort = rt;
       u8 do_handoff = 0;
 
-      ip4_full_reass_t *reass =
-	ip4_full_reass_find_or_create (vm, node, rm, rt, &kv, &do_handoff);
+      ip4_full_reass_t *reass = ip4_full_reass_find_or_create (
+	vm, node, rm, &ort, kv, hashes[i], &do_handoff);
 
       if (reass)
 	{
@@ -1252,14 +1470,14 @@ ip4_full_reass_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	{
 	  next0 = IP4_FULL_REASS_NEXT_HANDOFF;
 	  vnet_buffer (b0)->ip.reass.owner_thread_index =
-	    kv.v.memory_owner_thread_index;
+	    kv->v.memory_owner_thread_index;
 	}
       else if (reass)
 	{
 	  u32 handoff_thread_idx;
 	  u32 counter = ~0;
-	  switch (ip4_full_reass_update (vm, node, rm, rt, reass, &bi0, &next0,
-					 &error0, CUSTOM == type,
+	  switch (ip4_full_reass_update (vm, node, rm, ort, reass, &bi0,
+					 &next0, &error0, CUSTOM == type,
 					 &handoff_thread_idx))
 	    {
 	    case IP4_REASS_RC_OK:
@@ -1295,9 +1513,15 @@ ip4_full_reass_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    {
 	      vlib_node_increment_counter (vm, node->node_index, counter, 1);
 	      ip4_full_reass_drop_all (vm, node, reass);
-	      ip4_full_reass_free (rm, rt, reass);
-	      goto next_packet;
+	      ip4_full_reass_free (rm, ort, reass);
 	    }
+
+	  /* done with a context found on another thread */
+	  if (ort != rt)
+	    clib_spinlock_unlock (&ort->lock);
+
+	  if (~0 != counter)
+	    goto next_packet;
 	}
       else
 	{
@@ -1347,6 +1571,7 @@ ip4_full_reass_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
     next_packet:
       from += 1;
       n_left -= 1;
+      i += 1;
     }
 
   clib_spinlock_unlock (&rt->lock);
@@ -1582,6 +1807,7 @@ ip4_full_reass_init_function (vlib_main_t * vm)
   {
     clib_spinlock_init (&rt->lock);
     pool_alloc (rt->pool, rm->max_reass_n);
+    rt->lru_first = rt->lru_last = ~0;
   }
 
   node = vlib_get_node_by_name (vm, (u8 *) "ip4-full-reassembly-expire-walk");
@@ -26,6 +26,7 @@
 #include <vnet/ip/ip4_to_ip6.h>
 #include <vppinfra/fifo.h>
 #include <vppinfra/bihash_16_8.h>
+#include <vnet/flow/flow.h>
 #include <vnet/ip/reass/ip4_sv_reass.h>
 
 #define MSEC_PER_SEC			1000
@@ -164,6 +165,9 @@ typedef struct
 
   // extended reassembly refcount - see ip4_sv_reass_enable_disable_extended()
   u32 extended_refcount;
+
+  // fragment steering flow per hw interface, ~0 if not programmed
+  u32 *steering_flow_index_by_hw_if_index;
 } ip4_sv_reass_main_t;
 
 extern ip4_sv_reass_main_t ip4_sv_reass_main;
@@ -1474,6 +1478,7 @@ ip4_sv_reass_init_function (vlib_main_t *vm)
 
   rm->feature_use_refcount_per_intf = NULL;
   rm->output_feature_use_refcount_per_intf = NULL;
+  rm->steering_flow_index_by_hw_if_index = NULL;
 
   return error;
 }
@@ -1648,6 +1653,17 @@ show_ip4_reass (vlib_main_t *vm, unformat_input_t *input,
 		   "walk interval: %lums\n",
 		   (long unsigned) rm->expire_walk_interval_ms);
 
+  u32 hw_if_index;
+  vec_foreach_index (hw_if_index, rm->steering_flow_index_by_hw_if_index)
+    {
+      u32 flow_index = rm->steering_flow_index_by_hw_if_index[hw_if_index];
+      if (~0 == flow_index)
+	continue;
+      vlib_cli_output (vm, "Fragment steering on %U: flow %u\n",
+		       format_vnet_hw_if_index_name, rm->vnet_main,
+		       hw_if_index, flow_index);
+    }
+
   return 0;
 }
 
@@ -1935,6 +1951,138 @@ ip4_sv_reass_output_enable_disable_with_refcnt (u32 sw_if_index, int is_enable)
   return 0;
 }
 
+int
+ip4_sv_reass_steering_enable_disable (u32 sw_if_index, int is_enable)
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  vnet_main_t *vnm = rm->vnet_main;
+  vnet_hw_interface_t *hw;
+  vnet_flow_t flow = {};
+  u32 flow_index;
+  int rv;
+
+  if (pool_is_free_index (vnm->interface_main.sw_interfaces, sw_if_index))
+    return VNET_FLOW_ERROR_NO_SUCH_INTERFACE;
+
+  hw = vnet_get_sup_hw_interface (vnm, sw_if_index);
+  vec_validate_init_empty (rm->steering_flow_index_by_hw_if_index,
+			   hw->hw_if_index, ~0);
+  flow_index = rm->steering_flow_index_by_hw_if_index[hw->hw_if_index];
+
+  if (!is_enable)
+    {
+      if (~0 == flow_index)
+	return VNET_FLOW_ERROR_NO_SUCH_ENTRY;
+      vnet_flow_disable (vnm, flow_index, hw->hw_if_index);
+      rm->steering_flow_index_by_hw_if_index[hw->hw_if_index] = ~0;
+      return vnet_flow_del (vnm, flow_index);
+    }
+
+  if (~0 != flow_index)
+    return VNET_FLOW_ERROR_ALREADY_DONE;
+
+  /*
+   * Match all IPv4 and spread it over every rx queue, but hash fragments on
+   * addresses only. The NIC cannot see the IP ID, so this steers on a
+   * superset of the reassembly key - all fragments of a datagram, first one
+   * included, land on the same queue and hence the same worker, and never
+   * need a handoff.
+   */
+  flow.type = VNET_FLOW_TYPE_IP4;
+  flow.actions = VNET_FLOW_ACTION_RSS;
+  flow.rss_fun = VNET_RSS_FUNC_DEFAULT;
+  flow.rss_types = (1ULL << VNET_FLOW_RSS_TYPES_FRAG_IPV4) |
+		   (1ULL << VNET_FLOW_RSS_TYPES_IPV4_TCP) |
+		   (1ULL << VNET_FLOW_RSS_TYPES_IPV4_UDP) |
+		   (1ULL << VNET_FLOW_RSS_TYPES_IPV4_OTHER);
+  flow.queue_index = 0;
+  flow.queue_num = vec_len (hw->rx_queue_indices);
+
+  if ((rv = vnet_flow_add (vnm, &flow, &flow_index)))
+    return rv;
+
+  if ((rv = vnet_flow_enable (vnm, flow_index, hw->hw_if_index)))
+    {
+      /* not supported by the device - software handoff stays in charge */
+      vnet_flow_del (vnm, flow_index);
+      return rv;
+    }
+
+  rm->steering_flow_index_by_hw_if_index[hw->hw_if_index] = flow_index;
+  return 0;
+}
+
+static clib_error_t *
+ip4_sv_reass_steering_hw_interface_add_del (vnet_main_t *vnm, u32 hw_if_index,
+					    u32 is_add)
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  u32 flow_index;
+
+  if (is_add || hw_if_index >= vec_len (rm->steering_flow_index_by_hw_if_index))
+    return 0;
+
+  /* the flow goes away with the interface, so that a reused index is clean */
+  flow_index = rm->steering_flow_index_by_hw_if_index[hw_if_index];
+  if (~0 != flow_index)
+    {
+      rm->steering_flow_index_by_hw_if_index[hw_if_index] = ~0;
+      vnet_flow_del (vnm, flow_index);
+    }
+  return 0;
+}
+
+VNET_HW_INTERFACE_ADD_DEL_FUNCTION (ip4_sv_reass_steering_hw_interface_add_del);
+
+static clib_error_t *
+set_ip4_sv_reass_steering (vlib_main_t *vm, unformat_input_t *input,
+			   CLIB_UNUSED (vlib_cli_command_t *cmd))
+{
+  ip4_sv_reass_main_t *rm = &ip4_sv_reass_main;
+  unformat_input_t _line_input, *line_input = &_line_input;
+  u32 sw_if_index = ~0;
+  int is_enable = 1;
+  int rv;
+
+  if (!unformat_user (input, unformat_line_input, line_input))
+    return clib_error_return (0, "expected interface name");
+
+  while (unformat_check_input (line_input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (line_input, "%U", unformat_vnet_sw_interface,
+		    rm->vnet_main, &sw_if_index))
+	;
+      else if (unformat (line_input, "disable"))
+	is_enable = 0;
+      else
+	{
+	  unformat_free (line_input);
+	  return clib_error_return (0, "unknown input `%U'",
+				    format_unformat_error, input);
+	}
+    }
+  unformat_free (line_input);
+
+  if (~0 == sw_if_index)
+    return clib_error_return (0, "expected interface name");
+
+  rv = ip4_sv_reass_steering_enable_disable (sw_if_index, is_enable);
+  if (is_enable && VNET_FLOW_ERROR_NOT_SUPPORTED == rv)
+    return clib_error_return (0,
+			      "fragment steering not supported by device, "
+			      "falling back to software handoff");
+  if (rv)
+    return clib_error_return (0, "fragment steering %s failed, rv=%d",
+			      is_enable ? "enable" : "disable", rv);
+  return 0;
+}
+
+VLIB_CLI_COMMAND (set_ip4_sv_reass_steering_cmd, static) = {
+  .path = "set ip4-sv-reassembly steering",
+  .short_help = "set ip4-sv-reassembly steering <interface> [disable]",
+  .function = set_ip4_sv_reass_steering,
+};
+
 void
 ip4_sv_reass_enable_disable_extended (bool is_enable)
 {
@@ -49,6 +49,16 @@ int ip4_sv_reass_enable_disable_with_refcnt (u32 sw_if_index, int is_enable);
 int ip4_sv_reass_output_enable_disable_with_refcnt (u32 sw_if_index,
 						    int is_enable);
 
+/*
+ * Enable or disable hardware fragment steering on the interface's device.
+ *
+ * Programs an RSS flow which hashes IPv4 fragments on addresses only so that
+ * all fragments of a datagram arrive on the same rx queue. Returns a
+ * vnet_flow_error_t - if the device lacks support, fragments keep being
+ * handed off to the owning thread in software.
+ */
+int ip4_sv_reass_steering_enable_disable (u32 sw_if_index, int is_enable);
+
 /*
  * Enable or disable extended reassembly.
  *
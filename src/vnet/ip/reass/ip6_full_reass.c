@@ -112,6 +112,8 @@ typedef struct
   u64 id;
   // buffer index of first buffer in this reassembly context
   u32 first_bi;
+  // buffer index of last range in this reassembly context
+  u32 last_bi;
   // last octet of packet, ~0 until fragment without more_fragments arrives
   u32 last_packet_octet;
   // length of data collected so far
@@ -131,6 +133,9 @@ typedef struct
   // thread which received fragment with offset 0 and which sends out the
   // completed reassembly
   u32 sendout_thread_index;
+  // lru indexes
+  u32 lru_prev;
+  u32 lru_next;
 } ip6_full_reass_t;
 
 typedef struct
@@ -141,6 +146,9 @@ typedef struct
   // for pacing the main thread timeouts
   u32 last_id;
   clib_spinlock_t lock;
+  // lru indexes
+  u32 lru_first;
+  u32 lru_last;
 } ip6_full_reass_per_thread_t;
 
 typedef struct
@@ -399,10 +407,67 @@ ip6_full_reass_add_trace (vlib_main_t * vm, vlib_node_runtime_t * node,
 #endif
 }
 
+always_inline void
+ip6_full_reass_lru_remove (ip6_full_reass_per_thread_t *rt,
+			   ip6_full_reass_t *reass)
+{
+  if (~0 != reass->lru_prev)
+    {
+      ip6_full_reass_t *lru_prev =
+	pool_elt_at_index (rt->pool, reass->lru_prev);
+      lru_prev->lru_next = reass->lru_next;
+    }
+  if (~0 != reass->lru_next)
+    {
+      ip6_full_reass_t *lru_next =
+	pool_elt_at_index (rt->pool, reass->lru_next);
+      lru_next->lru_prev = reass->lru_prev;
+    }
+  if (rt->lru_first == reass - rt->pool)
+    {
+      rt->lru_first = reass->lru_next;
+    }
+  if (rt->lru_last == reass - rt->pool)
+    {
+      rt->lru_last = reass->lru_prev;
+    }
+}
+
+always_inline void
+ip6_full_reass_lru_add (ip6_full_reass_per_thread_t *rt,
+			ip6_full_reass_t *reass)
+{
+  reass->lru_prev = reass->lru_next = ~0;
+
+  if (~0 != rt->lru_last)
+    {
+      ip6_full_reass_t *lru_last = pool_elt_at_index (rt->pool, rt->lru_last);
+      reass->lru_prev = rt->lru_last;
+      lru_last->lru_next = rt->lru_last = reass - rt->pool;
+    }
+
+  if (~0 == rt->lru_first)
+    {
+      rt->lru_first = rt->lru_last = reass - rt->pool;
+    }
+}
+
+/* move a context to the most recently used end of the lru list */
+always_inline void
+ip6_full_reass_lru_touch (ip6_full_reass_per_thread_t *rt,
+			  ip6_full_reass_t *reass)
+{
+  if (rt->lru_last == reass - rt->pool)
+    return;
+  ip6_full_reass_lru_remove (rt, reass);
+  ip6_full_reass_lru_add (rt, reass);
+}
+
 always_inline void
 ip6_full_reass_free_ctx (ip6_full_reass_per_thread_t * rt,
 			 ip6_full_reass_t * reass)
 {
+  ip6_full_reass_lru_remove (rt, reass);
   pool_put (rt->pool, reass);
   --rt->reass_n;
 }
@@ -427,7 +492,7 @@ ip6_full_reass_free (ip6_full_reass_main_t * rm,
  * could be called from a graphnode, where its managing local copy of these
  * variables, and ignoring those and still trying to enqueue the buffers
  * with local variables would cause either buffer leak or corruption */
-always_inline void
+always_inline u32
 ip6_full_reass_drop_all (vlib_main_t *vm, vlib_node_runtime_t *node,
 			 ip6_full_reass_t *reass, u32 *n_left_to_next,
 			 u32 **to_next)
@@ -436,6 +501,7 @@ ip6_full_reass_drop_all (vlib_main_t *vm, vlib_node_runtime_t *node,
   vlib_buffer_t *range_b;
   vnet_buffer_opaque_t *range_vnb;
   u32 *to_free = NULL;
+  u32 n_dropped;
 
   while (~0 != range_bi)
     {
@@ -448,6 +514,7 @@ ip6_full_reass_drop_all (vlib_main_t *vm, vlib_node_runtime_t *node,
 	}
       range_bi = range_vnb->ip.reass.next_range_bi;
     }
+  n_dropped = vec_len (to_free);
 
   /* send to next_error_index */
   if (~0 != reass->error_next_index &&
@@ -493,6 +560,7 @@ ip6_full_reass_drop_all (vlib_main_t *vm, vlib_node_runtime_t *node,
       vlib_buffer_free (vm, to_free, vec_len (to_free));
     }
   vec_free (to_free);
+  return n_dropped;
 }
 
 always_inline void
@@ -590,14 +658,75 @@ ip6_full_reass_on_timeout (vlib_main_t *vm, vlib_node_runtime_t *node,
   ip6_full_reass_drop_all (vm, node, reass, n_left_to_next, to_next);
 }
 
+/*
+ * Look up a context owned by another thread without handing the fragment
+ * off. This only succeeds if the owner's lock can be taken right away, which
+ * is the case whenever the owner is not running its reassembly node or the
+ * expire walk. On success the owner's lock is held and *rtp points to the
+ * owner's per-thread data; the caller releases the lock once done with the
+ * context.
+ */
+always_inline void
+ip6_full_reass_make_kv (vlib_buffer_t *b, ip6_header_t *ip,
+			ip6_frag_hdr_t *frag_hdr, ip6_full_reass_kv_t *kv)
+{
+  u32 fib_index = (vnet_buffer (b)->sw_if_index[VLIB_TX] == (u32) ~0) ?
+		    vec_elt (ip6_main.fib_index_by_sw_if_index,
+			     vnet_buffer (b)->sw_if_index[VLIB_RX]) :
+		    vnet_buffer (b)->sw_if_index[VLIB_TX];
+
+  kv->k.as_u64[0] = ip->src_address.as_u64[0];
+  kv->k.as_u64[1] = ip->src_address.as_u64[1];
+  kv->k.as_u64[2] = ip->dst_address.as_u64[0];
+  kv->k.as_u64[3] = ip->dst_address.as_u64[1];
+  kv->k.as_u64[4] = ((u64) fib_index) << 32 | (u64) frag_hdr->identification;
+  /* RFC 8200: The Next Header values in the Fragment headers of different
+   * fragments of the same original packet may differ. Only the value from
+   * the Offset zero fragment packet is used for reassembly.
+   *
+   * Also, IPv6 Header doesnt contain the protocol value unlike IPv4.*/
+  kv->k.as_u64[5] = 0;
+}
+
+always_inline ip6_full_reass_t *
+ip6_full_reass_find_foreign (ip6_full_reass_main_t *rm,
+			     ip6_full_reass_per_thread_t **rtp,
+			     ip6_full_reass_kv_t *kv, f64 now)
+{
+  ip6_full_reass_per_thread_t *ort =
+    &rm->per_thread_data[kv->v.memory_owner_thread_index];
+  ip6_full_reass_t *reass;
+
+  if (!clib_spinlock_trylock (&ort->lock))
+    return NULL;
+
+  /* the context might have been freed or reused since the lookup */
+  if (pool_is_free_index (ort->pool, kv->v.reass_index))
+    goto fail;
+  reass = pool_elt_at_index (ort->pool, kv->v.reass_index);
+  if (memcmp (&reass->key, &kv->k, sizeof (reass->key)) ||
+      now > reass->last_heard + rm->timeout)
+    goto fail;
+
+  reass->last_heard = now;
+  ip6_full_reass_lru_touch (ort, reass);
+  *rtp = ort;
+  return reass;
+
+fail:
+  clib_spinlock_unlock (&ort->lock);
+  return NULL;
+}
+
 always_inline ip6_full_reass_t *
 ip6_full_reass_find_or_create (vlib_main_t *vm, vlib_node_runtime_t *node,
 			       ip6_full_reass_main_t *rm,
-			       ip6_full_reass_per_thread_t *rt,
-			       ip6_full_reass_kv_t *kv, u32 *icmp_bi,
+			       ip6_full_reass_per_thread_t **rtp,
+			       ip6_full_reass_kv_t *kv, u64 hash, u32 *icmp_bi,
 			       u8 *do_handoff, int skip_bihash,
 			       u32 *n_left_to_next, u32 **to_next)
 {
+  ip6_full_reass_per_thread_t *rt = *rtp;
   ip6_full_reass_t *reass;
   f64 now;
 
@@ -606,10 +735,18 @@ again:
   reass = NULL;
   now = vlib_time_now (vm);
 
-  if (!skip_bihash && !clib_bihash_search_48_8 (&rm->hash, &kv->kv, &kv->kv))
+  if (!skip_bihash && !clib_bihash_search_inline_2_with_hash_48_8 (
+			 &rm->hash, hash, &kv->kv, &kv->kv))
     {
       if (vm->thread_index != kv->v.memory_owner_thread_index)
 	{
+	  reass = ip6_full_reass_find_foreign (rm, rtp, kv, now);
+	  if (reass)
+	    {
+	      vlib_node_increment_counter (vm, node->node_index,
+					   IP6_ERROR_REASS_HANDOFF_AVOIDED, 1);
+	      return reass;
+	    }
 	  *do_handoff = 1;
 	  return NULL;
 	}
@@ -633,29 +770,37 @@ again:
   if (reass)
     {
       reass->last_heard = now;
+      ip6_full_reass_lru_touch (rt, reass);
       return reass;
     }
 
   if (rt->reass_n >= rm->max_reass_n)
     {
-      reass = NULL;
-      return reass;
-    }
-  else
-    {
-      pool_get (rt->pool, reass);
-      clib_memset (reass, 0, sizeof (*reass));
-      reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
-      ++rt->id_counter;
-      reass->first_bi = ~0;
-      reass->last_packet_octet = ~0;
-      reass->data_len = 0;
-      reass->next_index = ~0;
-      reass->error_next_index = ~0;
-      reass->memory_owner_thread_index = vm->thread_index;
-      ++rt->reass_n;
+      if (!rm->max_reass_n || ~0 == rt->lru_first)
+	return NULL;
+
+      /* make room by evicting the least recently used reassembly */
+      reass = pool_elt_at_index (rt->pool, rt->lru_first);
+      vlib_node_increment_counter (
+	vm, node->node_index, IP6_ERROR_REASS_LRU_EVICTED,
+	ip6_full_reass_drop_all (vm, node, reass, n_left_to_next, to_next));
+      ip6_full_reass_free (rm, rt, reass);
     }
 
+  pool_get (rt->pool, reass);
+  clib_memset (reass, 0, sizeof (*reass));
+  reass->id = ((u64) vm->thread_index * 1000000000) + rt->id_counter;
+  ++rt->id_counter;
+  reass->first_bi = ~0;
+  reass->last_bi = ~0;
+  reass->last_packet_octet = ~0;
+  reass->data_len = 0;
+  reass->next_index = ~0;
+  reass->error_next_index = ~0;
+  reass->memory_owner_thread_index = vm->thread_index;
+  ++rt->reass_n;
+  ip6_full_reass_lru_add (rt, reass);
+
   kv->v.reass_index = (reass - rt->pool);
   kv->v.memory_owner_thread_index = vm->thread_index;
   reass->last_heard = now;
@@ -955,6 +1100,10 @@ ip6_full_reass_insert_range_in_chain (vlib_main_t * vm,
 	}
       reass->first_bi = new_next_bi;
     }
+  if (~0 == new_next_vnb->ip.reass.next_range_bi)
+    {
+      reass->last_bi = new_next_bi;
+    }
   reass->data_len += ip6_full_reass_buffer_get_data_len (new_next_b);
 }
 
@@ -1019,6 +1168,14 @@ ip6_full_reass_update (vlib_main_t *vm, vlib_node_runtime_t *node,
   reass->min_fragment_length =
     clib_min (clib_net_to_host_u16 (fip->payload_length),
 	      fvnb->ip.reass.estimated_mtu);
+  if (fragment_first >
+      vnet_buffer (vlib_get_buffer (vm, reass->last_bi))->ip.reass.range_last)
+    {
+      // in-order arrival - append behind the last range without walking
+      ip6_full_reass_insert_range_in_chain (vm, reass, reass->last_bi, *bi0);
+      consumed = 1;
+      candidate_range_bi = ~0;
+    }
   while (~0 != candidate_range_bi)
     {
       vlib_buffer_t *candidate_b = vlib_get_buffer (vm, candidate_range_bi);
@@ -1083,8 +1240,7 @@ check_if_done_maybe:
       reass->data_len == reass->last_packet_octet + 1)
     {
       *handoff_thread_idx = reass->sendout_thread_index;
-      int handoff =
-	reass->memory_owner_thread_index != reass->sendout_thread_index;
+      int handoff = vm->thread_index != reass->sendout_thread_index;
       ip6_full_reass_rc_t rc =
 	ip6_full_reass_finalize (vm, node, rm, rt, reass, bi0, next0, error0,
 				 is_custom_app);
@@ -1193,10 +1349,31 @@ ip6_full_reassembly_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u32 n_left_from, n_left_to_next, *to_next, next_index;
   ip6_full_reass_main_t *rm = &ip6_full_reass_main;
   ip6_full_reass_per_thread_t *rt = &rm->per_thread_data[vm->thread_index];
+  u64 hashes[VLIB_FRAME_SIZE];
+  u32 i;
+
+  /* Batch the hash table work: hash every fragment whose fragment header
+   * directly follows the IPv6 header (the common case) and prefetch its
+   * bucket before doing any lookup */
+  for (i = 0; i < frame->n_vectors; i++)
+    {
+      vlib_buffer_t *b = vlib_get_buffer (vm, from[i]);
+      ip6_header_t *ip = vlib_buffer_get_current (b);
+      ip6_full_reass_kv_t kv;
+
+      if (ip->protocol != IP_PROTOCOL_IPV6_FRAGMENTATION)
+	continue;
+
+      ip6_full_reass_make_kv (b, ip, (ip6_frag_hdr_t *) (ip + 1), &kv);
+      hashes[i] = clib_bihash_hash_48_8 (&kv.kv);
+      clib_bihash_prefetch_bucket_48_8 (&rm->hash, hashes[i]);
+    }
+
   clib_spinlock_lock (&rt->lock);
 
   n_left_from = frame->n_vectors;
   next_index = node->cached_next_index;
+  i = 0;
   while (n_left_from > 0)
     {
       vlib_get_next_frame (vm, node, next_index, to_next, n_left_to_next);
@@ -1269,6 +1446,8 @@ ip6_full_reassembly_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
 	  int skip_bihash = 0;
 	  ip6_full_reass_kv_t kv;
+	  ip6_full_reass_per_thread_t *ort = rt;
+	  u64 hash = 0;
 	  u8 do_handoff = 0;
 
 	  if (0 == ip6_frag_hdr_offset (frag_hdr) &&
@@ -1279,29 +1458,16 @@ ip6_full_reassembly_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    }
 	  else
 	    {
-	      u32 fib_index =
-		(vnet_buffer (b0)->sw_if_index[VLIB_TX] == (u32) ~0) ?
-			vec_elt (ip6_main.fib_index_by_sw_if_index,
-			   vnet_buffer (b0)->sw_if_index[VLIB_RX]) :
-			vnet_buffer (b0)->sw_if_index[VLIB_TX];
-	      kv.k.as_u64[0] = ip0->src_address.as_u64[0];
-	      kv.k.as_u64[1] = ip0->src_address.as_u64[1];
-	      kv.k.as_u64[2] = ip0->dst_address.as_u64[0];
-	      kv.k.as_u64[3] = ip0->dst_address.as_u64[1];
-	      kv.k.as_u64[4] =
-		((u64) fib_index) << 32 | (u64) frag_hdr->identification;
-	      /* RFC 8200: The Next Header values in the Fragment headers of
-	       * different fragments of the same original packet may differ.
-	       * Only the value from the Offset zero fragment packet is used
-	       * for reassembly.
-	       *
-	       * Also, IPv6 Header doesnt contain the protocol value unlike
-	       * IPv4.*/
-	      kv.k.as_u64[5] = 0;
+	      ip6_full_reass_make_kv (b0, ip0, frag_hdr, &kv);
+	      /* reuse the hash computed up front if the fragment header was
+	       * found where it was looked for there */
+	      hash = ((void *) frag_hdr == (void *) (ip0 + 1)) ?
+		       hashes[i] :
+		       clib_bihash_hash_48_8 (&kv.kv);
 	    }
 
 	  ip6_full_reass_t *reass = ip6_full_reass_find_or_create (
-	    vm, node, rm, rt, &kv, &icmp_bi, &do_handoff, skip_bihash,
+	    vm, node, rm, &ort, &kv, hash, &icmp_bi, &do_handoff, skip_bihash,
 	    &n_left_to_next, &to_next);
 
 	  if (reass)
@@ -1323,7 +1489,7 @@ ip6_full_reassembly_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	      u32 handoff_thread_idx;
 	      u32 counter = ~0;
 	      switch (ip6_full_reass_update (
-		vm, node, rm, rt, reass, &bi0, &next0, &error0, frag_hdr,
+		vm, node, rm, ort, reass, &bi0, &next0, &error0, frag_hdr,
 		is_custom_app, &handoff_thread_idx, skip_bihash))
 		{
 		case IP6_FULL_REASS_RC_OK:
@@ -1366,10 +1532,15 @@ ip6_full_reassembly_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 					       1);
 		  ip6_full_reass_drop_all (vm, node, reass, &n_left_to_next,
 					   &to_next);
-		  ip6_full_reass_free (rm, rt, reass);
-		  goto next_packet;
-		  break;
+		  ip6_full_reass_free (rm, ort, reass);
 		}
+
+	      /* done with a context found on another thread */
+	      if (ort != rt)
+		clib_spinlock_unlock (&ort->lock);
+
+	      if (~0 != counter)
+		goto next_packet;
 	    }
 	  else
 	    {
@@ -1437,6 +1608,7 @@ ip6_full_reassembly_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	next_packet:
 	  from += 1;
 	  n_left_from -= 1;
+	  i += 1;
 	}
 
       vlib_put_next_frame (vm, node, next_index, n_left_to_next);
@@ -1674,6 +1846,7 @@ ip6_full_reass_init_function (vlib_main_t * vm)
   {
     clib_spinlock_init (&rt->lock);
     pool_alloc (rt->pool, rm->max_reass_n);
+    rt->lru_first = rt->lru_last = ~0;
   }
 
   node = vlib_get_node_by_name (vm, (u8 *) "ip6-full-reassembly-expire-walk");
@@ -68,6 +68,8 @@ ah_decrypt_err_to_sa_err (u32 err)
       return IPSEC_SA_ERROR_DROP_FRAGMENTS;
     case AH_DECRYPT_ERROR_REPLAY:
       return IPSEC_SA_ERROR_REPLAY;
+    case AH_DECRYPT_ERROR_LATE:
+      return IPSEC_SA_ERROR_LATE;
     }
   return ~0;
 }
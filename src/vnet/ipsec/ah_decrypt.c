@@ -128,7 +128,7 @@ ah_decrypt_inline (vlib_main_t * vm,
   from = vlib_frame_vector_args (from_frame);
   n_left = from_frame->n_vectors;
   ipsec_sa_inb_rt_t *irt = 0;
-  bool anti_replay_result;
+  int anti_replay_result;
   u32 current_sa_index = ~0, current_sa_bytes = 0, current_sa_pkts = 0;
 
   clib_memset (pkt_data, 0, VLIB_FRAME_SIZE * sizeof (pkt_data[0]));
@@ -206,9 +206,12 @@ ah_decrypt_inline (vlib_main_t * vm,
 	irt, pd->seq, ~0, false, &pd->seq_hi);
       if (anti_replay_result)
 	{
-	  ah_decrypt_set_next_index (b[0], node, vm->thread_index,
-				     AH_DECRYPT_ERROR_REPLAY, 0, next,
-				     AH_DECRYPT_NEXT_DROP, current_sa_index);
+	  ah_decrypt_set_next_index (
+	    b[0], node, vm->thread_index,
+	    anti_replay_result == IPSEC_SA_ANTI_REPLAY_LATE ?
+	      AH_DECRYPT_ERROR_LATE :
+	      AH_DECRYPT_ERROR_REPLAY,
+	    0, next, AH_DECRYPT_NEXT_DROP, current_sa_index);
 	  goto next;
 	}
 
@@ -309,12 +312,16 @@ ah_decrypt_inline (vlib_main_t * vm,
       if (PREDICT_TRUE (irt->integ_icv_size))
 	{
 	  /* redo the anti-reply check. see esp_decrypt for details */
-	  if (ipsec_sa_anti_replay_and_sn_advance (irt, pd->seq, pd->seq_hi,
-						   true, NULL))
+	  anti_replay_result = ipsec_sa_anti_replay_and_sn_advance (
+	    irt, pd->seq, pd->seq_hi, true, NULL);
+	  if (anti_replay_result)
 	    {
-	      ah_decrypt_set_next_index (b[0], node, vm->thread_index,
-					 AH_DECRYPT_ERROR_REPLAY, 0, next,
-					 AH_DECRYPT_NEXT_DROP, pd->sa_index);
+	      ah_decrypt_set_next_index (
+		b[0], node, vm->thread_index,
+		anti_replay_result == IPSEC_SA_ANTI_REPLAY_LATE ?
+		  AH_DECRYPT_ERROR_LATE :
+		  AH_DECRYPT_ERROR_REPLAY,
+		0, next, AH_DECRYPT_NEXT_DROP, pd->sa_index);
 	      goto trace;
 	    }
 	  n_lost = ipsec_sa_anti_replay_advance (irt, thread_index, pd->seq,
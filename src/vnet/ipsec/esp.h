@@ -92,6 +92,40 @@ esp_seq_advance (ipsec_sa_outb_rt_t *ort)
   return 0;
 }
 
+/*
+ * Sequence number for a packet of a multi-worker SA. Workers take blocks of
+ * IPSEC_SA_SEQ_BLOCK_SIZE numbers from the SA with one compare-and-swap and
+ * hand them out locally, so the SA's cache line is only touched once per
+ * block. As with esp_seq_advance, the SA's number stops at the maximum and
+ * the packets are dropped as cycled from there on.
+ */
+always_inline int
+esp_seq_advance_multi_worker (ipsec_sa_outb_rt_t *ort, u32 thread_index,
+			      u64 *seq64)
+{
+  ipsec_sa_seq_block_t *sb = vec_elt_at_index (ort->seq_blocks, thread_index);
+  u64 max = ort->use_esn ? CLIB_U64_MAX : CLIB_U32_MAX;
+  u64 base, end;
+
+  if (PREDICT_FALSE (sb->next == sb->end))
+    {
+      base = clib_atomic_load_relax_n (&ort->seq64);
+      do
+	{
+	  if (base == max)
+	    return 1;
+	  end = base + clib_min (max - base, IPSEC_SA_SEQ_BLOCK_SIZE);
+	}
+      while (!__atomic_compare_exchange_n (&ort->seq64, &base, end, 1,
+					   __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+      sb->next = base;
+      sb->end = end;
+    }
+
+  *seq64 = ++sb->next;
+  return 0;
+}
+
 always_inline u16
 esp_aad_fill (u8 *data, const esp_header_t *esp, int use_esn, u32 seq_hi)
 {
@@ -151,6 +185,8 @@ esp_decrypt_err_to_sa_err (u32 err)
       return IPSEC_SA_ERROR_CRYPTO_ENGINE_ERROR;
     case ESP_DECRYPT_ERROR_REPLAY:
       return IPSEC_SA_ERROR_REPLAY;
+    case ESP_DECRYPT_ERROR_LATE:
+      return IPSEC_SA_ERROR_LATE;
     case ESP_DECRYPT_ERROR_RUNT:
       return IPSEC_SA_ERROR_RUNT;
     case ESP_DECRYPT_ERROR_NO_BUFFERS:
@@ -299,6 +335,29 @@ esp_async_recycle_failed_submit (vlib_main_t *vm, vnet_crypto_async_frame_t *f,
   return (f->n_elts);
 }
 
+/* submit a full open frame, dropping its packets if the engine refuses it */
+always_inline void
+esp_async_submit_full_frame (vlib_main_t *vm, vlib_node_runtime_t *node,
+			     vnet_crypto_async_frame_t *f, u32 err,
+			     u32 ipsec_sa_err, u16 drop_next_index,
+			     bool is_encrypt)
+{
+  u32 drop_bi[VNET_CRYPTO_FRAME_SIZE];
+  u16 drop_nexts[VNET_CRYPTO_FRAME_SIZE];
+  u16 n_drop;
+
+  vnet_crypto_async_close_open_frame (vm, f);
+  if (PREDICT_TRUE (vnet_crypto_async_submit_open_frame (vm, f) == 0))
+    return;
+
+  n_drop = esp_async_recycle_failed_submit (vm, f, node, err, ipsec_sa_err,
+					    0, drop_bi, drop_nexts,
+					    drop_next_index, is_encrypt);
+  vlib_buffer_enqueue_to_next (vm, node, drop_bi, drop_nexts, n_drop);
+  vnet_crypto_async_reset_frame (f);
+  vnet_crypto_async_free_frame (vm, f);
+}
+
 #endif /* __ESP_H__ */
 
 /*
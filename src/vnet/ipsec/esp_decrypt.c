@@ -785,7 +785,8 @@ esp_decrypt_post_crypto (vlib_main_t *vm, vlib_node_runtime_t *node,
   const u8 esp_sz = sizeof (esp_header_t);
   u8 pad_length = 0, next_header = 0;
   u16 icv_sz;
-  u64 n_lost;
+  u64 n_lost = 0;
+  int anti_replay_result;
 
   /*
    * redo the anti-reply check
@@ -809,16 +810,38 @@ esp_decrypt_post_crypto (vlib_main_t *vm, vlib_node_runtime_t *node,
    * a sequence s, s+1, s+2, s+3, ... s+n and nothing will prevent any
    * implementation, sequential or batching, from decrypting these.
    */
-  if (ipsec_sa_anti_replay_and_sn_advance (irt, pd->seq, pd->seq_hi, true,
-					   NULL))
+  anti_replay_result = ipsec_sa_anti_replay_and_sn_advance (
+    irt, pd->seq, pd->seq_hi, true, NULL);
+  if (anti_replay_result)
     {
-      esp_decrypt_set_next_index (b, node, vm->thread_index,
-				  ESP_DECRYPT_ERROR_REPLAY, 0, next,
-				  ESP_DECRYPT_NEXT_DROP, pd->sa_index);
+      esp_decrypt_set_next_index (
+	b, node, vm->thread_index,
+	anti_replay_result == IPSEC_SA_ANTI_REPLAY_LATE ?
+	  ESP_DECRYPT_ERROR_LATE :
+	  ESP_DECRYPT_ERROR_REPLAY,
+	0, next, ESP_DECRYPT_NEXT_DROP, pd->sa_index);
       return;
     }
-  n_lost =
-    ipsec_sa_anti_replay_advance (irt, vm->thread_index, pd->seq, pd->seq_hi);
+  if (PREDICT_FALSE (irt->is_multi_worker))
+    {
+      /* other workers may have accepted this SN or moved the window since
+       * the check */
+      anti_replay_result =
+	ipsec_sa_anti_replay_advance_multi_worker (irt, pd->seq, pd->seq_hi);
+      if (anti_replay_result)
+	{
+	  esp_decrypt_set_next_index (
+	    b, node, vm->thread_index,
+	    anti_replay_result == IPSEC_SA_ANTI_REPLAY_LATE ?
+	      ESP_DECRYPT_ERROR_LATE :
+	      ESP_DECRYPT_ERROR_REPLAY,
+	    0, next, ESP_DECRYPT_NEXT_DROP, pd->sa_index);
+	  return;
+	}
+    }
+  else
+    n_lost = ipsec_sa_anti_replay_advance (irt, vm->thread_index, pd->seq,
+					   pd->seq_hi);
 
   vlib_prefetch_simple_counter (&ipsec_sa_err_counters[IPSEC_SA_ERROR_LOST],
 				vm->thread_index, pd->sa_index);
@@ -1085,10 +1108,10 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u32 current_sa_index = ~0, current_sa_bytes = 0, current_sa_pkts = 0;
   const u8 esp_sz = sizeof (esp_header_t);
   ipsec_sa_inb_rt_t *irt = 0;
-  bool anti_replay_result;
+  int anti_replay_result;
   int is_async = 0;
   vnet_crypto_op_id_t async_op = ~0;
-  vnet_crypto_async_frame_t *async_frames[VNET_CRYPTO_N_OP_IDS];
+  vnet_crypto_async_frame_t *async_frame;
   esp_decrypt_error_t err;
 
   vlib_get_buffers (vm, from, b, n_left);
@@ -1096,10 +1119,8 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   vec_reset_length (ptd->integ_ops);
   vec_reset_length (ptd->chained_crypto_ops);
   vec_reset_length (ptd->chained_integ_ops);
-  vec_reset_length (ptd->async_frames);
   vec_reset_length (ptd->chunks);
   clib_memset (sync_nexts, -1, sizeof (sync_nexts));
-  clib_memset (async_frames, 0, sizeof (async_frames));
 
   while (n_left > 0)
     {
@@ -1156,7 +1177,9 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				    ipsec_sa_assign_thread (thread_index));
 	}
 
-      if (PREDICT_FALSE (thread_index != irt->thread_index))
+      /* all workers decrypt for a multi-worker SA */
+      if (PREDICT_FALSE (thread_index != irt->thread_index &&
+			 !irt->is_multi_worker))
 	{
 	  vnet_buffer (b[0])->ipsec.thread_index = irt->thread_index;
 	  err = ESP_DECRYPT_ERROR_HANDOFF;
@@ -1193,7 +1216,9 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
       if (anti_replay_result)
 	{
-	  err = ESP_DECRYPT_ERROR_REPLAY;
+	  err = anti_replay_result == IPSEC_SA_ANTI_REPLAY_LATE ?
+		  ESP_DECRYPT_ERROR_LATE :
+		  ESP_DECRYPT_ERROR_REPLAY;
 	  esp_decrypt_set_next_index (b[0], node, thread_index, err, n_noop,
 				      noop_nexts, ESP_DECRYPT_NEXT_DROP,
 				      current_sa_index);
@@ -1217,35 +1242,32 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	{
 	  async_op = irt->async_op_id;
 
-	  /* get a frame for this op if we don't yet have one or it's full
-	   */
-	  if (NULL == async_frames[async_op] ||
-	      vnet_crypto_async_frame_is_full (async_frames[async_op]))
+	  /* the thread's open frame for this op collects packets of all
+	   * SAs across node dispatches, crypto-dispatch submits it if we
+	   * don't fill it */
+	  async_frame = vnet_crypto_async_get_open_frame (vm, async_op);
+	  if (PREDICT_FALSE (!async_frame))
 	    {
-	      async_frames[async_op] =
-		vnet_crypto_async_get_frame (vm, async_op);
-	      if (PREDICT_FALSE (!async_frames[async_op]))
-		{
-		  err = ESP_DECRYPT_ERROR_NO_AVAIL_FRAME;
-		  esp_decrypt_set_next_index (
-		    b[0], node, thread_index, err, n_noop, noop_nexts,
-		    ESP_DECRYPT_NEXT_DROP, current_sa_index);
-		  goto next;
-		}
-
-	      /* Save the frame to the list we'll submit at the end */
-	      vec_add1 (ptd->async_frames, async_frames[async_op]);
+	      err = ESP_DECRYPT_ERROR_NO_AVAIL_FRAME;
+	      esp_decrypt_set_next_index (b[0], node, thread_index, err,
+					  n_noop, noop_nexts,
+					  ESP_DECRYPT_NEXT_DROP, current_sa_index);
+	      goto next;
 	    }
 
 	  err = esp_decrypt_prepare_async_frame (
-	    vm, ptd, async_frames[async_op], irt, payload, len, cpd.icv_sz,
-	    cpd.iv_sz, pd, pd2, from[b - bufs], b[0], async_next_node);
+	    vm, ptd, async_frame, irt, payload, len, cpd.icv_sz, cpd.iv_sz, pd,
+	    pd2, from[b - bufs], b[0], async_next_node);
 	  if (ESP_DECRYPT_ERROR_RX_PKTS != err)
 	    {
 	      esp_decrypt_set_next_index (
 		b[0], node, thread_index, err, n_noop, noop_nexts,
 		ESP_DECRYPT_NEXT_DROP, current_sa_index);
 	    }
+	  else if (vnet_crypto_async_frame_is_full (async_frame))
+	    esp_async_submit_full_frame (
+	      vm, node, async_frame, ESP_DECRYPT_ERROR_CRYPTO_ENGINE_ERROR,
+	      IPSEC_SA_ERROR_CRYPTO_ENGINE_ERROR, ESP_DECRYPT_NEXT_DROP, false);
 	}
       else
 	{
@@ -1285,28 +1307,6 @@ esp_decrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				     current_sa_index, current_sa_pkts,
 				     current_sa_bytes);
 
-  /* submit or free all of the open frames */
-  vnet_crypto_async_frame_t **async_frame;
-
-  vec_foreach (async_frame, ptd->async_frames)
-    {
-      /* free frame and move on if no ops were successfully added */
-      if (PREDICT_FALSE (!(*async_frame)->n_elts))
-	{
-	  vnet_crypto_async_free_frame (vm, *async_frame);
-	  continue;
-	}
-      if (vnet_crypto_async_submit_open_frame (vm, *async_frame) < 0)
-	{
-	  n_noop += esp_async_recycle_failed_submit (
-	    vm, *async_frame, node, ESP_DECRYPT_ERROR_CRYPTO_ENGINE_ERROR,
-	    IPSEC_SA_ERROR_CRYPTO_ENGINE_ERROR, n_noop, noop_bi, noop_nexts,
-	    ESP_DECRYPT_NEXT_DROP, false);
-	  vnet_crypto_async_reset_frame (*async_frame);
-	  vnet_crypto_async_free_frame (vm, *async_frame);
-	}
-    }
-
   if (n_sync)
     {
       esp_process_ops (vm, node, ptd->integ_ops, sync_bufs, sync_nexts,
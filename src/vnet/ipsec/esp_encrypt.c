@@ -330,7 +330,7 @@ static_always_inline u32
 esp_encrypt_chain_integ (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 			 ipsec_sa_outb_rt_t *ort, vlib_buffer_t *b,
 			 vlib_buffer_t *lb, u8 icv_sz, u8 *start,
-			 u32 start_len, u8 *digest, u16 *n_ch)
+			 u32 start_len, u32 seq_hi, u8 *digest, u16 *n_ch)
 {
   vnet_crypto_op_chunk_t *ch;
   vlib_buffer_t *cb = b;
@@ -350,7 +350,7 @@ esp_encrypt_chain_integ (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 	  total_len += ch->len = cb->current_length - icv_sz;
 	  if (ort->use_esn)
 	    {
-	      *(u32u *) digest = clib_net_to_host_u32 (ort->seq64 >> 32);
+	      *(u32u *) digest = clib_net_to_host_u32 (seq_hi);
 	      ch->len += sizeof (u32);
 	      total_len += sizeof (u32);
 	    }
@@ -473,7 +473,7 @@ esp_prepare_sync_op (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 	  esp_encrypt_chain_integ (vm, ptd, ort, b[0], lb, icv_sz,
 				   payload - iv_sz - sizeof (esp_header_t),
 				   payload_len + iv_sz + sizeof (esp_header_t),
-				   op->digest, &op->n_chunks);
+				   seq_hi, op->digest, &op->n_chunks);
 	}
       else if (ort->use_esn)
 	{
@@ -489,8 +489,8 @@ esp_prepare_async_frame (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 			 vnet_crypto_async_frame_t *async_frame,
 			 ipsec_sa_outb_rt_t *ort, vlib_buffer_t *b,
 			 esp_header_t *esp, u8 *payload, u32 payload_len,
-			 u8 iv_sz, u8 icv_sz, u32 bi, u16 next, u32 hdr_len,
-			 u16 async_next, vlib_buffer_t *lb)
+			 u32 seq_hi, u8 iv_sz, u8 icv_sz, u32 bi, u16 next,
+			 u32 hdr_len, u16 async_next, vlib_buffer_t *lb)
 {
   esp_post_data_t *post = esp_post_data (b);
   u8 *tag, *iv, *aad = 0;
@@ -518,7 +518,7 @@ esp_prepare_async_frame (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 	{
 	  /* constuct aad in a scratch space in front of the nonce */
 	  aad = (u8 *) nonce - sizeof (esp_aead_t);
-	  esp_aad_fill (aad, esp, ort->use_esn, ort->seq64 >> 32);
+	  esp_aad_fill (aad, esp, ort->use_esn, seq_hi);
 	  if (PREDICT_FALSE (ort->is_null_gmac))
 	    {
 	      /* RFC-4543 ENCR_NULL_AUTH_AES_GMAC: IV is part of AAD */
@@ -565,11 +565,11 @@ esp_prepare_async_frame (vlib_main_t *vm, ipsec_per_thread_data_t *ptd,
 	  integ_total_len = esp_encrypt_chain_integ (
 	    vm, ptd, ort, b, lb, icv_sz,
 	    payload - iv_sz - sizeof (esp_header_t),
-	    payload_len + iv_sz + sizeof (esp_header_t), tag, 0);
+	    payload_len + iv_sz + sizeof (esp_header_t), seq_hi, tag, 0);
 	}
       else if (ort->use_esn)
 	{
-	  *(u32u *) tag = clib_net_to_host_u32 (ort->seq64 >> 32);
+	  *(u32u *) tag = clib_net_to_host_u32 (seq_hi);
 	  integ_total_len += sizeof (u32);
 	}
     }
@@ -611,12 +611,14 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   u16 buffer_data_size = vlib_buffer_get_default_data_size (vm);
   u32 current_sa_index = ~0, current_sa_packets = 0;
   u32 current_sa_bytes = 0, spi = 0;
+  u64 seq64 = 0;
+  int seq_cycled;
   u8 esp_align = 4, iv_sz = 0, icv_sz = 0;
   ipsec_sa_outb_rt_t *ort = 0;
   vlib_buffer_t *lb;
   vnet_crypto_op_t **crypto_ops = &ptd->crypto_ops;
   vnet_crypto_op_t **integ_ops = &ptd->integ_ops;
-  vnet_crypto_async_frame_t *async_frames[VNET_CRYPTO_N_OP_IDS];
+  vnet_crypto_async_frame_t *async_frame;
   int is_async = 0;
   vnet_crypto_op_id_t async_op = ~0;
   u16 drop_next =
@@ -629,7 +631,6 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 					       ESP_ENCRYPT_NEXT_HANDOFF_MPLS));
   vlib_buffer_t *sync_bufs[VLIB_FRAME_SIZE];
   u16 sync_nexts[VLIB_FRAME_SIZE], *sync_next = sync_nexts, n_sync = 0;
-  u16 n_async = 0;
   u16 noop_nexts[VLIB_FRAME_SIZE], n_noop = 0;
   u32 sync_bi[VLIB_FRAME_SIZE];
   u32 noop_bi[VLIB_FRAME_SIZE];
@@ -641,9 +642,7 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
   vec_reset_length (ptd->integ_ops);
   vec_reset_length (ptd->chained_crypto_ops);
   vec_reset_length (ptd->chained_integ_ops);
-  vec_reset_length (ptd->async_frames);
   vec_reset_length (ptd->chunks);
-  clib_memset (async_frames, 0, sizeof (async_frames));
 
   while (n_left > 0)
     {
@@ -729,7 +728,9 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 				    ipsec_sa_assign_thread (thread_index));
 	}
 
-      if (PREDICT_FALSE (thread_index != ort->thread_index))
+      /* all workers encrypt for a multi-worker SA */
+      if (PREDICT_FALSE (thread_index != ort->thread_index &&
+			 !ort->is_multi_worker))
 	{
 	  vnet_buffer (b[0])->ipsec.thread_index = ort->thread_index;
 	  err = ESP_ENCRYPT_ERROR_HANDOFF;
@@ -756,7 +757,16 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	    lb = vlib_get_buffer (vm, lb->next_buffer);
 	}
 
-      if (PREDICT_FALSE (esp_seq_advance (ort)))
+      if (PREDICT_FALSE (ort->is_multi_worker))
+	seq_cycled =
+	  esp_seq_advance_multi_worker (ort, thread_index, &seq64);
+      else
+	{
+	  seq_cycled = esp_seq_advance (ort);
+	  seq64 = ort->seq64;
+	}
+
+      if (PREDICT_FALSE (seq_cycled))
 	{
 	  err = ESP_ENCRYPT_ERROR_SEQ_CYCLED;
 	  esp_encrypt_set_next_index (b[0], node, thread_index, err, n_noop,
@@ -1016,41 +1026,38 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	}
 
       esp->spi = spi;
-      esp->seq = clib_net_to_host_u32 (ort->seq64);
+      esp->seq = clib_net_to_host_u32 (seq64);
 
       if (is_async)
 	{
 	  async_op = ort->async_op_id;
 
-	  /* get a frame for this op if we don't yet have one or it's full
-	   */
-	  if (NULL == async_frames[async_op] ||
-	      vnet_crypto_async_frame_is_full (async_frames[async_op]))
+	  /* the thread's open frame for this op collects packets of all
+	   * SAs across node dispatches, crypto-dispatch submits it if we
+	   * don't fill it */
+	  async_frame = vnet_crypto_async_get_open_frame (vm, async_op);
+	  if (PREDICT_FALSE (!async_frame))
 	    {
-	      async_frames[async_op] =
-		vnet_crypto_async_get_frame (vm, async_op);
-
-	      if (PREDICT_FALSE (!async_frames[async_op]))
-		{
-		  err = ESP_ENCRYPT_ERROR_NO_AVAIL_FRAME;
-		  esp_encrypt_set_next_index (b[0], node, thread_index, err,
-					      n_noop, noop_nexts, drop_next,
-					      current_sa_index);
-		  goto trace;
-		}
-
-	      /* Save the frame to the list we'll submit at the end */
-	      vec_add1 (ptd->async_frames, async_frames[async_op]);
+	      err = ESP_ENCRYPT_ERROR_NO_AVAIL_FRAME;
+	      esp_encrypt_set_next_index (b[0], node, thread_index, err,
+					  n_noop, noop_nexts, drop_next,
+					  current_sa_index);
+	      goto trace;
 	    }
 
-	  esp_prepare_async_frame (vm, ptd, async_frames[async_op], ort, b[0],
-				   esp, payload, payload_len, iv_sz, icv_sz,
-				   from[b - bufs], sync_next[0], hdr_len,
-				   async_next_node, lb);
+	  esp_prepare_async_frame (vm, ptd, async_frame, ort, b[0], esp,
+				   payload, payload_len, seq64 >> 32, iv_sz,
+				   icv_sz, from[b - bufs], sync_next[0],
+				   hdr_len, async_next_node, lb);
+
+	  if (vnet_crypto_async_frame_is_full (async_frame))
+	    esp_async_submit_full_frame (
+	      vm, node, async_frame, ESP_ENCRYPT_ERROR_CRYPTO_ENGINE_ERROR,
+	      IPSEC_SA_ERROR_CRYPTO_ENGINE_ERROR, drop_next, true);
 	}
       else
 	esp_prepare_sync_op (vm, ptd, crypto_ops, integ_ops, ort,
-			     ort->seq64 >> 32, payload, payload_len, iv_sz,
+			     seq64 >> 32, payload, payload_len, iv_sz,
 			     icv_sz, n_sync, b, lb, hdr_len, esp);
 
       vlib_buffer_advance (b[0], 0LL - hdr_len);
@@ -1070,7 +1077,7 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	      ipsec_sa_t *sa = ipsec_sa_get (sa_index0);
 	      tr->sa_index = sa_index0;
 	      tr->spi = sa->spi;
-	      tr->seq = ort->seq64;
+	      tr->seq = seq64;
 	      tr->udp_encap = ort->udp_encap;
 	      tr->crypto_alg = sa->crypto_alg;
 	      tr->integ_alg = sa->integ_alg;
@@ -1090,10 +1097,6 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 	  n_sync++;
 	  sync_next++;
 	}
-      else
-	{
-	  n_async++;
-	}
       n_left -= 1;
       b += 1;
     }
@@ -1116,24 +1119,6 @@ esp_encrypt_inline (vlib_main_t *vm, vlib_node_runtime_t *node,
 
       vlib_buffer_enqueue_to_next (vm, node, sync_bi, sync_nexts, n_sync);
     }
-  if (n_async)
-    {
-      /* submit all of the open frames */
-      vnet_crypto_async_frame_t **async_frame;
-
-      vec_foreach (async_frame, ptd->async_frames)
-	{
-	  if (vnet_crypto_async_submit_open_frame (vm, *async_frame) < 0)
-	    {
-	      n_noop += esp_async_recycle_failed_submit (
-		vm, *async_frame, node, ESP_ENCRYPT_ERROR_CRYPTO_ENGINE_ERROR,
-		IPSEC_SA_ERROR_CRYPTO_ENGINE_ERROR, n_noop, noop_bi,
-		noop_nexts, drop_next, true);
-	      vnet_crypto_async_reset_frame (*async_frame);
-	      vnet_crypto_async_free_frame (vm, *async_frame);
-	    }
-	}
-    }
   if (n_noop)
     vlib_buffer_enqueue_to_next (vm, node, noop_bi, noop_nexts, n_noop);
 
@@ -32,6 +32,12 @@
  */
 #define IPSEC4_OUT_SPD_DEFAULT_HASH_NUM_BUCKETS (1 << 22)
 
+/* Per-thread outbound flow caches start this small and double, up to
+ * ipsec4_out_spd_hash_num_buckets, whenever collisions evict live entries
+ * for more than a quarter of the buckets.
+ */
+#define IPSEC4_OUT_SPD_FLOW_CACHE_INIT_BUCKETS (1 << 12)
+
 /* Flow cache is sized for 1 million flows with a load factor of .25.
  */
 #define IPSEC4_SPD_DEFAULT_HASH_NUM_BUCKETS (1 << 22)
@@ -417,6 +423,68 @@ crypto_engine_backend_register_post_node (vlib_main_t * vm)
     vnet_crypto_register_post_node (vm, "esp6-decrypt-tun-post");
 }
 
+void
+ipsec4_out_spd_flow_cache_grow (ipsec_main_t *im,
+				ipsec_per_thread_data_t *ptd)
+{
+  ipsec4_hash_kv_16_8_t *old = ptd->out_flow_cache, *e, *ne;
+  u32 n_buckets = vec_len (old);
+  u64 hash;
+
+  if (n_buckets)
+    n_buckets <<= 1;
+  else
+    n_buckets = clib_min (IPSEC4_OUT_SPD_FLOW_CACHE_INIT_BUCKETS,
+			  im->ipsec4_out_spd_hash_num_buckets);
+
+  ptd->out_flow_cache = 0;
+  vec_validate_aligned (ptd->out_flow_cache, n_buckets - 1,
+			CLIB_CACHE_LINE_BYTES);
+  ptd->out_flow_cache_entries = 0;
+  ptd->out_flow_cache_evictions = 0;
+
+  /* carry the live entries over, colliding ones are simply dropped */
+  vec_foreach (e, old)
+    {
+      if (e->value == 0 || (u32) e->value != ptd->out_flow_cache_epoch)
+	continue;
+      hash = ipsec4_hash_16_8 (e) & (n_buckets - 1);
+      ne = ptd->out_flow_cache + hash;
+      if (ne->value == 0)
+	ptd->out_flow_cache_entries++;
+      clib_memcpy_fast (ne, e, sizeof (*ne));
+    }
+  vec_free (old);
+}
+
+u32
+ipsec4_out_spd_flow_cache_n_entries (ipsec_main_t *im)
+{
+  ipsec_per_thread_data_t *ptd;
+  u32 n_entries = 0;
+
+  vec_foreach (ptd, im->ptd)
+    if (ptd->out_flow_cache_epoch == im->epoch_count)
+      n_entries += ptd->out_flow_cache_entries;
+
+  return n_entries;
+}
+
+void
+ipsec4_out_spd_flow_cache_flush (ipsec_main_t *im)
+{
+  ipsec_per_thread_data_t *ptd;
+
+  vec_foreach (ptd, im->ptd)
+    {
+      clib_memset_u8 (ptd->out_flow_cache, 0,
+		      vec_len (ptd->out_flow_cache) *
+			sizeof (ptd->out_flow_cache[0]));
+      ptd->out_flow_cache_entries = 0;
+      ptd->out_flow_cache_evictions = 0;
+    }
+}
+
 static clib_error_t *
 ipsec_init (vlib_main_t * vm)
 {
@@ -473,9 +541,7 @@ ipsec_init (vlib_main_t * vm)
   im->async_mode = 0;
   crypto_engine_backend_register_post_node (vm);
 
-  im->ipsec4_out_spd_hash_tbl = NULL;
   im->output_flow_cache_flag = 0;
-  im->ipsec4_out_spd_flow_cache_entries = 0;
   im->epoch_count = 0;
   im->ipsec4_out_spd_hash_num_buckets =
     IPSEC4_OUT_SPD_DEFAULT_HASH_NUM_BUCKETS;
@@ -617,11 +683,6 @@ ipsec_config (vlib_main_t *vm, unformat_input_t *input)
 	return clib_error_return (0, "unknown input `%U'",
 				  format_unformat_error, input);
     }
-  if (im->output_flow_cache_flag)
-    {
-      vec_add2 (im->ipsec4_out_spd_hash_tbl, im->ipsec4_out_spd_hash_tbl,
-		im->ipsec4_out_spd_hash_num_buckets);
-    }
   if (im->input_flow_cache_flag)
     {
       vec_add2 (im->ipsec4_in_spd_hash_tbl, im->ipsec4_in_spd_hash_tbl,
@@ -138,7 +138,14 @@ typedef struct
   vnet_crypto_op_t *chained_crypto_ops;
   vnet_crypto_op_t *chained_integ_ops;
   vnet_crypto_op_chunk_t *chunks;
-  vnet_crypto_async_frame_t **async_frames;
+
+  /* ipv4 outbound SPD flow cache, private to the thread so no locking */
+  ipsec4_hash_kv_16_8_t *out_flow_cache;
+  /* live entries and live entries evicted by collisions, both only
+   * valid while out_flow_cache_epoch matches the main epoch_count */
+  u32 out_flow_cache_entries;
+  u32 out_flow_cache_evictions;
+  u32 out_flow_cache_epoch;
 } ipsec_per_thread_data_t;
 
 typedef struct
@@ -181,7 +188,6 @@ typedef struct
   uword *ipsec_if_real_dev_by_show_dev;
   uword *ipsec_if_by_sw_if_index;
 
-  ipsec4_hash_kv_16_8_t *ipsec4_out_spd_hash_tbl;
   ipsec4_hash_kv_16_8_t *ipsec4_in_spd_hash_tbl;
   clib_bihash_8_16_t tun4_protect_by_key;
   clib_bihash_24_16_t tun6_protect_by_key;
@@ -253,9 +259,8 @@ typedef struct
 
   u32 handoff_queue_size;
 
-  /* Number of buckets for flow cache */
+  /* Max number of buckets for per-thread flow cache */
   u32 ipsec4_out_spd_hash_num_buckets;
-  u32 ipsec4_out_spd_flow_cache_entries;
   u32 epoch_count;
   u8 output_flow_cache_flag;
 
@@ -286,6 +291,11 @@ clib_error_t *ipsec_add_del_sa_sess_cb (ipsec_main_t * im, u32 sa_index,
 
 clib_error_t *ipsec_check_support_cb (ipsec_main_t * im, ipsec_sa_t * sa);
 
+void ipsec4_out_spd_flow_cache_grow (ipsec_main_t *im,
+				     ipsec_per_thread_data_t *ptd);
+u32 ipsec4_out_spd_flow_cache_n_entries (ipsec_main_t *im);
+void ipsec4_out_spd_flow_cache_flush (ipsec_main_t *im);
+
 extern vlib_node_registration_t ipsec4_tun_input_node;
 extern vlib_node_registration_t ipsec6_tun_input_node;
 
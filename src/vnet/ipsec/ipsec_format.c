@@ -387,7 +387,7 @@ format_ipsec_out_spd_flow_cache (u8 *s, va_list *args)
   ipsec_main_t *im = &ipsec_main;
 
   s = format (s, "\nipv4-outbound-spd-flow-cache-entries: %u",
-	      im->ipsec4_out_spd_flow_cache_entries);
+	      ipsec4_out_spd_flow_cache_n_entries (im));
 
   return (s);
 }
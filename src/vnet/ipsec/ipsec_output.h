@@ -22,45 +22,63 @@
 #include <vnet/ipsec/ipsec_spd.h>
 #include <vnet/ipsec/ipsec_spd_fp_lookup.h>
 
+always_inline void
+ipsec4_out_spd_flow_cache_insert (ipsec_main_t *im,
+				  ipsec4_spd_5tuple_t *ip4_5tuple, u32 pol_id)
+{
+  ipsec_per_thread_data_t *ptd =
+    vec_elt_at_index (im->ptd, vlib_get_thread_index ());
+  ipsec4_hash_kv_16_8_t *e;
+  u32 epoch = im->epoch_count;
+  u64 hash;
+
+  ip4_5tuple->kv_16_8.value = (((u64) pol_id) << 32) | ((u64) epoch);
+
+  /* counters taken in an older epoch refer to stale entries only */
+  if (PREDICT_FALSE (ptd->out_flow_cache_epoch != epoch))
+    {
+      ptd->out_flow_cache_epoch = epoch;
+      ptd->out_flow_cache_entries = 0;
+      ptd->out_flow_cache_evictions = 0;
+    }
+
+  if (PREDICT_FALSE (vec_len (ptd->out_flow_cache) == 0))
+    ipsec4_out_spd_flow_cache_grow (im, ptd);
+
+  hash = ipsec4_hash_16_8 (&ip4_5tuple->kv_16_8);
+  hash &= (vec_len (ptd->out_flow_cache) - 1);
+  e = ptd->out_flow_cache + hash;
+
+  /* A fresh entry or the overwrite of a stale one adds an active entry.
+   * Overwriting a live entry of another flow is a collision - too many of
+   * those and the cache is too small for the working set of this thread */
+  if (e->value == 0 || (u32) e->value != epoch)
+    ptd->out_flow_cache_entries++;
+  else if (!ipsec4_hash_key_compare_16_8 ((u64 *) e,
+					  (u64 *) &ip4_5tuple->kv_16_8))
+    ptd->out_flow_cache_evictions++;
+
+  e->key[0] = ip4_5tuple->kv_16_8.key[0];
+  e->key[1] = ip4_5tuple->kv_16_8.key[1];
+  e->value = ip4_5tuple->kv_16_8.value;
+
+  if (PREDICT_FALSE (ptd->out_flow_cache_evictions >
+		       vec_len (ptd->out_flow_cache) / 4 &&
+		     vec_len (ptd->out_flow_cache) <
+		       im->ipsec4_out_spd_hash_num_buckets))
+    ipsec4_out_spd_flow_cache_grow (im, ptd);
+}
+
 always_inline void
 ipsec4_out_spd_add_flow_cache_entry (ipsec_main_t *im, u8 pr, u32 la, u32 ra,
 				     u16 lp, u16 rp, u32 pol_id)
 {
-  u64 hash;
-  u8 overwrite = 0, stale_overwrite = 0;
   ipsec4_spd_5tuple_t ip4_5tuple = { .ip4_addr = { (ip4_address_t) la,
 						   (ip4_address_t) ra },
 				     .port = { lp, rp },
 				     .proto = pr };
 
-  ip4_5tuple.kv_16_8.value = (((u64) pol_id) << 32) | ((u64) im->epoch_count);
-
-  hash = ipsec4_hash_16_8 (&ip4_5tuple.kv_16_8);
-  hash &= (im->ipsec4_out_spd_hash_num_buckets - 1);
-
-  ipsec_spinlock_lock (&im->ipsec4_out_spd_hash_tbl[hash].bucket_lock);
-  /* Check if we are overwriting an existing entry so we know
-  whether to increment the flow cache counter. Since flow
-  cache counter is reset on any policy add/remove, but
-  hash table values are not, we also need to check if the entry
-  we are overwriting is stale or not. If it's a stale entry
-  overwrite, we still want to increment flow cache counter */
-  overwrite = (im->ipsec4_out_spd_hash_tbl[hash].value != 0);
-  /* Check for stale entry by comparing with current epoch count */
-  if (PREDICT_FALSE (overwrite))
-    stale_overwrite =
-      (im->epoch_count !=
-       ((u32) (im->ipsec4_out_spd_hash_tbl[hash].value & 0xFFFFFFFF)));
-  clib_memcpy_fast (&im->ipsec4_out_spd_hash_tbl[hash], &ip4_5tuple.kv_16_8,
-		    sizeof (ip4_5tuple.kv_16_8));
-  ipsec_spinlock_unlock (&im->ipsec4_out_spd_hash_tbl[hash].bucket_lock);
-
-  /* Increment the counter to track active flow cache entries
-    when entering a fresh entry or overwriting a stale one */
-  if (!overwrite || stale_overwrite)
-    clib_atomic_fetch_add_relax (&im->ipsec4_out_spd_flow_cache_entries, 1);
-
-  return;
+  ipsec4_out_spd_flow_cache_insert (im, &ip4_5tuple, pol_id);
 }
 
 always_inline void
@@ -68,37 +86,7 @@ ipsec4_out_spd_add_flow_cache_entry_n (ipsec_main_t *im,
 				       ipsec4_spd_5tuple_t *ip4_5tuple,
 				       u32 pol_id)
 {
-  u64 hash;
-  u8 overwrite = 0, stale_overwrite = 0;
-
-  ip4_5tuple->kv_16_8.value = (((u64) pol_id) << 32) | ((u64) im->epoch_count);
-
-  hash = ipsec4_hash_16_8 (&ip4_5tuple->kv_16_8);
-  hash &= (im->ipsec4_out_spd_hash_num_buckets - 1);
-
-  ipsec_spinlock_lock (&im->ipsec4_out_spd_hash_tbl[hash].bucket_lock);
-  /* Check if we are overwriting an existing entry so we know
-  whether to increment the flow cache counter. Since flow
-  cache counter is reset on any policy add/remove, but
-  hash table values are not, we also need to check if the entry
-  we are overwriting is stale or not. If it's a stale entry
-  overwrite, we still want to increment flow cache counter */
-  overwrite = (im->ipsec4_out_spd_hash_tbl[hash].value != 0);
-  /* Check for stale entry by comparing with current epoch count */
-  if (PREDICT_FALSE (overwrite))
-    stale_overwrite =
-      (im->epoch_count !=
-       ((u32) (im->ipsec4_out_spd_hash_tbl[hash].value & 0xFFFFFFFF)));
-  clib_memcpy_fast (&im->ipsec4_out_spd_hash_tbl[hash], &ip4_5tuple->kv_16_8,
-		    sizeof (ip4_5tuple->kv_16_8));
-  ipsec_spinlock_unlock (&im->ipsec4_out_spd_hash_tbl[hash].bucket_lock);
-
-  /* Increment the counter to track active flow cache entries
-    when entering a fresh entry or overwriting a stale one */
-  if (!overwrite || stale_overwrite)
-    clib_atomic_fetch_add_relax (&im->ipsec4_out_spd_flow_cache_entries, 1);
-
-  return;
+  ipsec4_out_spd_flow_cache_insert (im, ip4_5tuple, pol_id);
 }
 
 always_inline void
@@ -280,10 +268,15 @@ always_inline ipsec_policy_t *
 ipsec4_out_spd_find_flow_cache_entry (ipsec_main_t *im, u8 pr, u32 la, u32 ra,
 				      u16 lp, u16 rp)
 {
+  ipsec_per_thread_data_t *ptd =
+    vec_elt_at_index (im->ptd, vlib_get_thread_index ());
   ipsec_policy_t *p = NULL;
-  ipsec4_hash_kv_16_8_t kv_result;
+  ipsec4_hash_kv_16_8_t *kv_result;
   u64 hash;
 
+  if (PREDICT_FALSE (vec_len (ptd->out_flow_cache) == 0))
+    return NULL;
+
   if (PREDICT_FALSE ((pr != IP_PROTOCOL_TCP) && (pr != IP_PROTOCOL_UDP) &&
 		     (pr != IP_PROTOCOL_SCTP)))
     {
@@ -296,20 +289,19 @@ ipsec4_out_spd_find_flow_cache_entry (ipsec_main_t *im, u8 pr, u32 la, u32 ra,
 				     .proto = pr };
 
   hash = ipsec4_hash_16_8 (&ip4_5tuple.kv_16_8);
-  hash &= (im->ipsec4_out_spd_hash_num_buckets - 1);
+  hash &= (vec_len (ptd->out_flow_cache) - 1);
 
-  ipsec_spinlock_lock (&im->ipsec4_out_spd_hash_tbl[hash].bucket_lock);
-  kv_result = im->ipsec4_out_spd_hash_tbl[hash];
-  ipsec_spinlock_unlock (&im->ipsec4_out_spd_hash_tbl[hash].bucket_lock);
+  /* the cache is private to this thread, no need to lock the bucket */
+  kv_result = ptd->out_flow_cache + hash;
 
   if (ipsec4_hash_key_compare_16_8 ((u64 *) &ip4_5tuple.kv_16_8,
-				    (u64 *) &kv_result))
+				    (u64 *) kv_result))
     {
-      if (im->epoch_count == ((u32) (kv_result.value & 0xFFFFFFFF)))
+      if (im->epoch_count == ((u32) (kv_result->value & 0xFFFFFFFF)))
 	{
 	  /* Get the policy based on the index */
-	  p =
-	    pool_elt_at_index (im->policies, ((u32) (kv_result.value >> 32)));
+	  p = pool_elt_at_index (im->policies,
+				 ((u32) (kv_result->value >> 32)));
 	}
     }
 
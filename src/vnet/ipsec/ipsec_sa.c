@@ -227,6 +227,7 @@ ipsec_sa_init_runtime (ipsec_sa_t *sa)
       irt->integ_icv_size = integ_icv_size;
       irt->salt = sa->salt;
       irt->async_op_id = sa->crypto_async_dec_op_id;
+      irt->is_multi_worker = ipsec_sa_is_set_IS_MULTI_WORKER (sa);
       ASSERT (irt->cipher_iv_size <= ESP_MAX_IV_SIZE);
     }
 
@@ -250,6 +251,7 @@ ipsec_sa_init_runtime (ipsec_sa_t *sa)
       ort->tunnel_flags = sa->tunnel.t_encap_decap_flags;
       ort->async_op_id = sa->crypto_async_enc_op_id;
       ort->t_dscp = sa->tunnel.t_dscp;
+      ort->is_multi_worker = ipsec_sa_is_set_IS_MULTI_WORKER (sa);
 
       ASSERT (ort->cipher_iv_size <= ESP_MAX_IV_SIZE);
       ASSERT (ort->esp_block_align <= ESP_MAX_BLOCK_SIZE);
@@ -435,6 +437,10 @@ ipsec_sa_add_and_lock (u32 id, u32 spi, ipsec_protocol_t proto,
   if (p)
     return VNET_API_ERROR_ENTRY_ALREADY_EXISTS;
 
+  /* AH keeps its per SA state non atomic, it stays on one worker */
+  if ((flags & IPSEC_SA_FLAG_IS_MULTI_WORKER) && proto == IPSEC_PROTOCOL_AH)
+    return VNET_API_ERROR_UNSUPPORTED;
+
   if (getrandom (rand, sizeof (rand), 0) != sizeof (rand))
     return VNET_API_ERROR_INIT_FAILED;
 
@@ -472,6 +478,16 @@ ipsec_sa_add_and_lock (u32 id, u32 spi, ipsec_protocol_t proto,
 
   clib_pcg64i_srandom_r (&ort->iv_prng, rand[0], rand[1]);
 
+  if (ipsec_sa_is_set_IS_MULTI_WORKER (sa))
+    {
+      vec_validate_aligned (ort->seq_blocks, vlib_get_n_threads () - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      irt->replay_slots = clib_mem_alloc_aligned (
+	anti_replay_window_size * sizeof (u64), CLIB_CACHE_LINE_BYTES);
+      clib_memset (irt->replay_slots, 0,
+		   anti_replay_window_size * sizeof (u64));
+    }
+
   fib_node_init (&sa->node, FIB_NODE_TYPE_IPSEC_SA);
   fib_node_lock (&sa->node);
 
@@ -652,6 +668,10 @@ ipsec_sa_del (ipsec_sa_t * sa)
     vnet_crypto_key_del (vm, sa->crypto_sync_key_index);
   if (sa->integ_alg != IPSEC_INTEG_ALG_NONE)
     vnet_crypto_key_del (vm, sa->integ_sync_key_index);
+  if (ort)
+    vec_free (ort->seq_blocks);
+  if (irt && irt->replay_slots)
+    clib_mem_free (irt->replay_slots);
   foreach_pointer (p, irt, ort)
     if (p)
       clib_mem_free (p);
@@ -89,6 +89,7 @@ typedef struct ipsec_key_t_
  * IPsec tunnel mode is IPv6 if non-zero,
  * else IPv4 tunnel only valid if is_tunnel is non-zero
  * enable UDP encapsulation for NAT traversal
+ * SA processed by all workers rather than pinned to one (ESP only)
  */
 #define foreach_ipsec_sa_flags                                                \
   _ (0, NONE, "none")                                                         \
@@ -100,7 +101,8 @@ typedef struct ipsec_key_t_
   _ (32, IS_PROTECT, "Protect")                                               \
   _ (64, IS_INBOUND, "inbound")                                               \
   _ (512, IS_ASYNC, "async")                                                  \
-  _ (1024, NO_ALGO_NO_DROP, "no-algo-no-drop")
+  _ (1024, NO_ALGO_NO_DROP, "no-algo-no-drop")                               \
+  _ (2048, IS_MULTI_WORKER, "multi-worker")
 
 typedef enum ipsec_sad_flags_t_
 {
@@ -130,7 +132,8 @@ STATIC_ASSERT (sizeof (ipsec_sa_flags_t) == 2, "IPSEC SA flags != 2 byte");
   _ (12, SEQ_CYCLED, seq_cycled, "sequence number cycled (dropped)")          \
   _ (13, CRYPTO_QUEUE_FULL, crypto_queue_full, "crypto queue full (dropped)") \
   _ (14, NO_ENCRYPTION, no_encryption, "no Encrypting SA (dropped)")          \
-  _ (15, DROP_FRAGMENTS, drop_fragments, "IP fragments drop")
+  _ (15, DROP_FRAGMENTS, drop_fragments, "IP fragments drop")                \
+  _ (16, LATE, late, "SA packet left of the anti-replay window")
 
 typedef enum
 {
@@ -140,6 +143,17 @@ typedef enum
     IPSEC_SA_N_ERRORS,
 } __clib_packed ipsec_sa_err_t;
 
+/* sequence numbers a worker reserves at a time on a multi-worker SA */
+#define IPSEC_SA_SEQ_BLOCK_SIZE 32
+
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+  /* last sequence number handed out and last one reserved */
+  u64 next;
+  u64 end;
+} ipsec_sa_seq_block_t;
+
 typedef struct
 {
   CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
@@ -152,6 +166,7 @@ typedef struct
   u16 is_tunnel : 1;
   u16 is_transport : 1;
   u16 is_async : 1;
+  u16 is_multi_worker : 1;
   u16 cipher_op_id;
   u16 integ_op_id;
   u8 cipher_iv_size;
@@ -164,6 +179,10 @@ typedef struct
   vnet_crypto_key_index_t cipher_key_index;
   vnet_crypto_key_index_t integ_key_index;
   u32 anti_replay_window_size;
+  /* multi-worker SAs: per window slot, 1 + the 64 bit sequence number last
+   * accepted there. replaces replay_window so that workers can update it
+   * with compare-and-swap */
+  u64 *replay_slots;
   uword replay_window[];
 } ipsec_sa_inb_rt_t;
 
@@ -180,6 +199,7 @@ typedef struct
   u16 use_anti_replay : 1;
   u16 drop_no_crypto : 1;
   u16 is_async : 1;
+  u16 is_multi_worker : 1;
   u16 cipher_op_id;
   u16 integ_op_id;
   u8 cipher_iv_size;
@@ -194,6 +214,8 @@ typedef struct
   u64 seq64;
   dpo_id_t dpo;
   clib_pcg64i_random_t iv_prng;
+  /* multi-worker SAs: per thread block of reserved sequence numbers */
+  ipsec_sa_seq_block_t *seq_blocks;
   vnet_crypto_key_index_t cipher_key_index;
   vnet_crypto_key_index_t integ_key_index;
   union
@@ -334,6 +356,16 @@ ipsec_sa_anti_replay_get_64b_window (const ipsec_sa_inb_rt_t *irt)
   u32 tl_win_index = irt->seq64 & (window_size - 1);
   uword *bmp = (uword *) irt->replay_window;
 
+  if (PREDICT_FALSE (irt->is_multi_worker))
+    {
+      u64 top = irt->seq64;
+      w = 0;
+      for (u64 i = 0; i < 64 && i < window_size && i <= top; i++)
+	if (irt->replay_slots[(top - i) & (window_size - 1)] == top - i + 1)
+	  w |= 1ULL << (63 - i);
+      return w;
+    }
+
   if (PREDICT_TRUE (tl_win_index >= 63))
     return uword_bitmap_get_multiple (bmp, tl_win_index - 63, 64);
 
@@ -353,10 +385,27 @@ ipsec_sa_anti_replay_check (const ipsec_sa_inb_rt_t *irt, u32 window_size,
    * if the packet falls left (sa->seq - seq >= window size),
    * the result is wrong */
 
+  if (PREDICT_FALSE (irt->is_multi_worker))
+    {
+      u64 slot = clib_atomic_load_relax_n (
+	&irt->replay_slots[seq & (window_size - 1)]);
+      return (slot != 0 && (u32) (slot - 1) == seq);
+    }
+
   return uword_bitmap_is_bit_set ((uword *) irt->replay_window,
 				  seq & (window_size - 1));
 }
 
+/* anti replay check results, non-zero means drop */
+typedef enum ipsec_sa_anti_replay_result_t_
+{
+  IPSEC_SA_ANTI_REPLAY_OK = 0,
+  /* sequence number already seen */
+  IPSEC_SA_ANTI_REPLAY_REPLAY,
+  /* sequence number left of the window */
+  IPSEC_SA_ANTI_REPLAY_LATE,
+} ipsec_sa_anti_replay_result_t;
+
 /*
  * Anti replay check.
  *  inputs need to be in host byte order.
@@ -379,8 +428,10 @@ ipsec_sa_anti_replay_and_sn_advance (const ipsec_sa_inb_rt_t *irt, u32 seq,
   ASSERT ((post_decrypt == false) == (hi_seq_req != 0));
 
   u32 window_size = irt->anti_replay_window_size;
-  u32 exp_lo = irt->seq64;
-  u32 exp_hi = irt->seq64 >> 32;
+  /* one load, workers of a multi-worker SA move it concurrently */
+  u64 seq64 = clib_atomic_load_relax_n (&irt->seq64);
+  u32 exp_lo = seq64;
+  u32 exp_hi = seq64 >> 32;
   u32 window_lower_bound = exp_lo - window_size + 1;
 
   if (!irt->use_esn)
@@ -397,7 +448,7 @@ ipsec_sa_anti_replay_and_sn_advance (const ipsec_sa_inb_rt_t *irt, u32 seq,
 
       /* does the packet fall out on the left of the window */
       if (exp_lo >= seq + window_size)
-	return 1;
+	return IPSEC_SA_ANTI_REPLAY_LATE;
 
       return ipsec_sa_anti_replay_check (irt, window_size, seq);
     }
@@ -462,7 +513,7 @@ ipsec_sa_anti_replay_and_sn_advance (const ipsec_sa_inb_rt_t *irt, u32 seq,
 		 * packet is the same as the last-sequence number of the SA.
 		 * that means this packet did not cause a wrap.
 		 * this packet is thus out of window and should be dropped */
-		return 1;
+		return IPSEC_SA_ANTI_REPLAY_LATE;
 	      else
 		/* The packet decrypted with a different high sequence number
 		 * to the SA, that means it is the wrap packet and should be
@@ -561,6 +612,42 @@ ipsec_sa_anti_replay_and_sn_advance (const ipsec_sa_inb_rt_t *irt, u32 seq,
   return 0;
 }
 
+/*
+ * Count and clear the set bits of a run of window words. Large windows
+ * (thousands of packets) move by many words at a time under reordering,
+ * so do these with vector stores.
+ */
+always_inline u32
+ipsec_sa_anti_replay_window_take (uword *w, uword n_words)
+{
+  u32 seen = 0;
+
+#if defined(CLIB_HAVE_VEC512) && defined(__AVX512VPOPCNTDQ__)
+  u64x8 cnt = {};
+  for (; n_words >= 8; w += 8, n_words -= 8)
+    {
+      cnt += (u64x8) _mm512_popcnt_epi64 ((__m512i) u64x8_load_unaligned (w));
+      u64x8_store_unaligned (u64x8_splat (0), w);
+    }
+  seen += _mm512_reduce_add_epi64 ((__m512i) cnt);
+#elif defined(CLIB_HAVE_VEC256)
+  for (; n_words >= 4; w += 4, n_words -= 4)
+    {
+      seen += count_set_bits (w[0]) + count_set_bits (w[1]) +
+	      count_set_bits (w[2]) + count_set_bits (w[3]);
+      u64x4_store_unaligned (u64x4_splat (0), w);
+    }
+#endif
+
+  for (; n_words; w++, n_words--)
+    {
+      seen += count_set_bits (w[0]);
+      w[0] = 0;
+    }
+
+  return seen;
+}
+
 always_inline u32
 ipsec_sa_anti_replay_window_shift (ipsec_sa_inb_rt_t *irt, u32 window_size,
 				   u32 inc)
@@ -576,7 +663,7 @@ ipsec_sa_anti_replay_window_shift (ipsec_sa_inb_rt_t *irt, u32 window_size,
       u32 window_lower_bound = (irt->seq64 + 1) & window_mask;
       u32 window_next_lower_bound = (window_lower_bound + inc) & window_mask;
 
-      uword i_block, i_word_start, i_word_end, full_words;
+      uword i_block, i_word_start, i_word_end, full_words, n_words;
       uword n_blocks = window_size >> log2_uword_bits;
       uword mask;
 
@@ -603,46 +690,12 @@ ipsec_sa_anti_replay_window_shift (ipsec_sa_inb_rt_t *irt, u32 window_size,
 	  window[i_block] &= ~mask;
 	  i_block = (i_block + 1) & (n_blocks - 1);
 
-	  /* count set bits in the next full words */
-	  /* even if the last word need to be fully counted, we treat it
-	   * apart */
-	  while (full_words >= 8)
-	    {
-	      if (full_words >= 16)
-		{
-		  /* prefect the next 8 blocks (64 bytes) */
-		  clib_prefetch_store (
-		    &window[(i_block + 8) & (n_blocks - 1)]);
-		}
-
-	      seen += count_set_bits (window[i_block]);
-	      seen += count_set_bits (window[(i_block + 1) & (n_blocks - 1)]);
-	      seen += count_set_bits (window[(i_block + 2) & (n_blocks - 1)]);
-	      seen += count_set_bits (window[(i_block + 3) & (n_blocks - 1)]);
-	      seen += count_set_bits (window[(i_block + 4) & (n_blocks - 1)]);
-	      seen += count_set_bits (window[(i_block + 5) & (n_blocks - 1)]);
-	      seen += count_set_bits (window[(i_block + 6) & (n_blocks - 1)]);
-	      seen += count_set_bits (window[(i_block + 7) & (n_blocks - 1)]);
-	      window[i_block] = 0;
-	      window[(i_block + 1) & (n_blocks - 1)] = 0;
-	      window[(i_block + 2) & (n_blocks - 1)] = 0;
-	      window[(i_block + 3) & (n_blocks - 1)] = 0;
-	      window[(i_block + 4) & (n_blocks - 1)] = 0;
-	      window[(i_block + 5) & (n_blocks - 1)] = 0;
-	      window[(i_block + 6) & (n_blocks - 1)] = 0;
-	      window[(i_block + 7) & (n_blocks - 1)] = 0;
-
-	      i_block = (i_block + 8) & (n_blocks - 1);
-	      full_words -= 8;
-	    }
-	  while (full_words > 0)
-	    {
-	      // last word is treated after the loop
-	      seen += count_set_bits (window[i_block]);
-	      window[i_block] = 0;
-	      i_block = (i_block + 1) & (n_blocks - 1);
-	      full_words--;
-	    }
+	  /* the full words in between, in at most two runs as the ring
+	   * may wrap */
+	  n_words = clib_min (full_words, n_blocks - i_block);
+	  seen += ipsec_sa_anti_replay_window_take (window + i_block, n_words);
+	  seen += ipsec_sa_anti_replay_window_take (window, full_words - n_words);
+	  i_block = (i_block + full_words) & (n_blocks - 1);
 
 	  /* the last word */
 	  mask = pow2_mask (i_word_end);
@@ -663,13 +716,12 @@ ipsec_sa_anti_replay_window_shift (ipsec_sa_inb_rt_t *irt, u32 window_size,
     {
       u32 n_uwords = window_size / uword_bits;
       /* holes in the replay window are lost packets */
-      n_lost = window_size - uword_bitmap_count_set_bits (window, n_uwords);
+      n_lost = window_size - ipsec_sa_anti_replay_window_take (window, n_uwords);
 
       /* any sequence numbers that now fall outside the window
        * are forever lost */
       n_lost += inc - window_size;
 
-      uword_bitmap_clear (window, n_uwords);
       uword_bitmap_set_bits_at_index (window, (irt->seq64 + inc) & window_mask,
 				      1);
     }
@@ -731,6 +783,46 @@ ipsec_sa_anti_replay_advance (ipsec_sa_inb_rt_t *irt, u32 thread_index,
   return n_lost;
 }
 
+/*
+ * Anti replay window advance for multi-worker SAs.
+ * Each window slot records the full sequence number last accepted in it, so
+ * a worker claims a sequence number with one compare-and-swap and no slot
+ * ever needs clearing when the window moves. Fails as a replay if another
+ * worker accepted this sequence number since the check, or as late if a
+ * newer one reused the slot, i.e. the window moved past the packet.
+ * As in ipsec_sa_anti_replay_advance, without anti-replay only the SN moves.
+ * Lost packets are not counted in this mode.
+ */
+always_inline ipsec_sa_anti_replay_result_t
+ipsec_sa_anti_replay_advance_multi_worker (ipsec_sa_inb_rt_t *irt, u32 seq,
+					   u32 hi_seq)
+{
+  u64 s = (u64) (irt->use_esn ? hi_seq : 0) << 32 | seq;
+  u64 *slot, cur, top;
+
+  if (irt->use_anti_replay)
+    {
+      slot = &irt->replay_slots[seq & (irt->anti_replay_window_size - 1)];
+      cur = clib_atomic_load_relax_n (slot);
+      do
+	{
+	  if (cur == s + 1)
+	    return IPSEC_SA_ANTI_REPLAY_REPLAY;
+	  if (cur > s + 1)
+	    return IPSEC_SA_ANTI_REPLAY_LATE;
+	}
+      while (!__atomic_compare_exchange_n (slot, &cur, s + 1, 1,
+					   __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+    }
+
+  top = clib_atomic_load_relax_n (&irt->seq64);
+  while (s > top && !__atomic_compare_exchange_n (&irt->seq64, &top, s, 1,
+						  __ATOMIC_RELAXED,
+						  __ATOMIC_RELAXED))
+    ;
+
+  return IPSEC_SA_ANTI_REPLAY_OK;
+}
 
 /*
  * Makes choice for thread_id should be assigned.
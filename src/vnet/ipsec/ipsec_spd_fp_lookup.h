@@ -20,6 +20,90 @@
 
 #include <vnet/ipsec/ipsec.h>
 
+/**
+ * @brief masked copy of a 16 byte (ip4) or 40 byte (ip6) lookup key
+ **/
+static_always_inline void
+ipsec_fp_mask_key_16 (u64 *key, u64 *match, u64 *mask)
+{
+#if defined(CLIB_HAVE_VEC128) && defined(CLIB_HAVE_VEC128_UNALIGNED_LOAD_STORE)
+  u64x2_store_unaligned (u64x2_load_unaligned (match) &
+			   u64x2_load_unaligned (mask),
+			 key);
+#else
+  key[0] = match[0] & mask[0];
+  key[1] = match[1] & mask[1];
+#endif
+}
+
+static_always_inline void
+ipsec_fp_mask_key_40 (u64 *key, u64 *match, u64 *mask)
+{
+  ipsec_fp_mask_key_16 (key, match, mask);
+  ipsec_fp_mask_key_16 (key + 2, match + 2, mask + 2);
+  key[4] = match[4] & mask[4];
+}
+
+/**
+ * @brief build the keys of a packet for all the mask types of an SPD.
+ *
+ * Hashes are computed and buckets prefetched for every mask type up front,
+ * so that the probes which follow overlap their cache misses instead of
+ * taking them one mask type after another.
+ **/
+static_always_inline u32
+ipsec_fp_ip4_prepare_keys (clib_bihash_16_8_t *h, ipsec_fp_5tuple_t *match,
+			   ipsec_fp_mask_id_t *mask_type_ids, int inbound,
+			   clib_bihash_kv_16_8_t *kvs, u64 *hashes)
+{
+  ipsec_main_t *im = &ipsec_main;
+  ipsec_fp_mask_type_entry_t *mte;
+  ipsec_fp_mask_id_t *mti;
+  u32 n = 0;
+
+  vec_foreach (mti, mask_type_ids)
+    {
+      mte = im->fp_mask_types + mti->mask_type_idx;
+      /* inbound masks carry the action, outbound ones don't */
+      if ((mte->mask.action != 0) != inbound)
+	continue;
+
+      ipsec_fp_mask_key_16 (kvs[n].key, (u64 *) match->kv_16_8.key,
+			    (u64 *) mte->mask.kv_16_8.key);
+      hashes[n] = clib_bihash_hash_16_8 (&kvs[n]);
+      clib_bihash_prefetch_bucket_16_8 (h, hashes[n]);
+      n++;
+    }
+
+  return n;
+}
+
+static_always_inline u32
+ipsec_fp_ip6_prepare_keys (clib_bihash_40_8_t *h, ipsec_fp_5tuple_t *match,
+			   ipsec_fp_mask_id_t *mask_type_ids, int inbound,
+			   clib_bihash_kv_40_8_t *kvs, u64 *hashes)
+{
+  ipsec_main_t *im = &ipsec_main;
+  ipsec_fp_mask_type_entry_t *mte;
+  ipsec_fp_mask_id_t *mti;
+  u32 n = 0;
+
+  vec_foreach (mti, mask_type_ids)
+    {
+      mte = im->fp_mask_types + mti->mask_type_idx;
+      if ((mte->mask.action != 0) != inbound)
+	continue;
+
+      ipsec_fp_mask_key_40 (kvs[n].key, (u64 *) match->kv_40_8.key,
+			    (u64 *) mte->mask.kv_40_8.key);
+      hashes[n] = clib_bihash_hash_40_8 (&kvs[n]);
+      clib_bihash_prefetch_bucket_40_8 (h, hashes[n]);
+      n++;
+    }
+
+  return n;
+}
+
 static_always_inline int
 single_rule_out_match_5tuple (ipsec_policy_t *policy, ipsec_fp_5tuple_t *match)
 {
@@ -216,22 +300,21 @@ ipsec_fp_in_ip6_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   u32 last_priority[n];
   u32 i = 0;
   u32 counter = 0;
-  ipsec_fp_mask_type_entry_t *mte;
-  ipsec_fp_mask_id_t *mti;
   ipsec_fp_5tuple_t *match = tuples;
   ipsec_policy_t *policy;
   u32 n_left = n;
-  clib_bihash_kv_40_8_t kv;
   /* result of the lookup */
   clib_bihash_kv_40_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
-  u64 *pkey, *pmatch, *pmask;
   ipsec_main_t *im = &ipsec_main;
   ipsec_spd_fp_t *pspd_fp = (ipsec_spd_fp_t *) spd_fp;
   ipsec_fp_mask_id_t *mask_type_ids = pspd_fp->fp_mask_ids[match->action];
   clib_bihash_40_8_t *bihash_table = pool_elt_at_index (
     im->fp_ip6_lookup_hashes_pool, pspd_fp->ip6_in_lookup_hash_idx);
+  clib_bihash_kv_40_8_t kvs[vec_len (mask_type_ids) + 1];
+  u64 hashes[vec_len (mask_type_ids) + 1];
+  u32 k, n_keys;
 
   /* clear the list of matched policies pointers */
   clib_memset (policies, 0, n * sizeof (*policies));
@@ -239,25 +322,12 @@ ipsec_fp_in_ip6_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   n_left = n;
   while (n_left)
     {
-      vec_foreach (mti, mask_type_ids)
+      n_keys = ipsec_fp_ip6_prepare_keys (bihash_table, match, mask_type_ids,
+					   1, kvs, hashes);
+      for (k = 0; k < n_keys; k++)
 	{
-	  mte = im->fp_mask_types + mti->mask_type_idx;
-	  if (mte->mask.action == 0)
-	    continue;
-
-	  pmatch = (u64 *) match->kv_40_8.key;
-	  pmask = (u64 *) mte->mask.kv_40_8.key;
-	  pkey = (u64 *) kv.key;
-
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey = *pmatch & *pmask;
-
-	  int res =
-	    clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result);
-	  /* lookup the hash by each packet in the burst for this mask. */
+	  int res = clib_bihash_search_inline_2_with_hash_40_8 (
+	    bihash_table, hashes[k], &kvs[k], &result);
 
 	  if (res == 0)
 	    {
@@ -318,22 +388,21 @@ ipsec_fp_in_ip4_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   u32 last_priority[n];
   u32 i = 0;
   u32 counter = 0;
-  ipsec_fp_mask_type_entry_t *mte;
-  ipsec_fp_mask_id_t *mti;
   ipsec_fp_5tuple_t *match = tuples;
   ipsec_policy_t *policy;
   u32 n_left = n;
-  clib_bihash_kv_16_8_t kv;
   /* result of the lookup */
   clib_bihash_kv_16_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
-  u64 *pkey, *pmatch, *pmask;
   ipsec_main_t *im = &ipsec_main;
   ipsec_spd_fp_t *pspd_fp = (ipsec_spd_fp_t *) spd_fp;
   ipsec_fp_mask_id_t *mask_type_ids = pspd_fp->fp_mask_ids[match->action];
   clib_bihash_16_8_t *bihash_table = pool_elt_at_index (
     im->fp_ip4_lookup_hashes_pool, pspd_fp->ip4_in_lookup_hash_idx);
+  clib_bihash_kv_16_8_t kvs[vec_len (mask_type_ids) + 1];
+  u64 hashes[vec_len (mask_type_ids) + 1];
+  u32 k, n_keys;
 
   /* clear the list of matched policies pointers */
   clib_memset (policies, 0, n * sizeof (*policies));
@@ -341,21 +410,12 @@ ipsec_fp_in_ip4_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   n_left = n;
   while (n_left)
     {
-      vec_foreach (mti, mask_type_ids)
+      n_keys = ipsec_fp_ip4_prepare_keys (bihash_table, match, mask_type_ids,
+					   1, kvs, hashes);
+      for (k = 0; k < n_keys; k++)
 	{
-	  mte = im->fp_mask_types + mti->mask_type_idx;
-	  if (mte->mask.action == 0)
-	    continue;
-	  pmatch = (u64 *) match->kv_16_8.key;
-	  pmask = (u64 *) mte->mask.kv_16_8.key;
-	  pkey = (u64 *) kv.key;
-
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey = *pmatch & *pmask;
-
-	  int res =
-	    clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result);
-	  /* lookup the hash by each packet in the burst for this mask. */
+	  int res = clib_bihash_search_inline_2_with_hash_16_8 (
+	    bihash_table, hashes[k], &kvs[k], &result);
 
 	  if (res == 0)
 	    {
@@ -432,24 +492,23 @@ ipsec_fp_out_ip6_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   u32 last_priority[n];
   u32 i = 0;
   u32 counter = 0;
-  ipsec_fp_mask_type_entry_t *mte;
-  ipsec_fp_mask_id_t *mti;
   ipsec_fp_5tuple_t *match = tuples;
   ipsec_policy_t *policy;
 
   u32 n_left = n;
-  clib_bihash_kv_40_8_t kv;
   /* result of the lookup */
   clib_bihash_kv_40_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
-  u64 *pkey, *pmatch, *pmask;
   ipsec_main_t *im = &ipsec_main;
   ipsec_spd_fp_t *pspd_fp = (ipsec_spd_fp_t *) spd_fp;
   ipsec_fp_mask_id_t *mask_type_ids =
     pspd_fp->fp_mask_ids[IPSEC_SPD_POLICY_IP6_OUTBOUND];
   clib_bihash_40_8_t *bihash_table = pool_elt_at_index (
     im->fp_ip6_lookup_hashes_pool, pspd_fp->ip6_out_lookup_hash_idx);
+  clib_bihash_kv_40_8_t kvs[vec_len (mask_type_ids) + 1];
+  u64 hashes[vec_len (mask_type_ids) + 1];
+  u32 k, n_keys;
 
   /*clear the list of matched policies pointers */
   clib_memset (policies, 0, n * sizeof (*policies));
@@ -457,25 +516,12 @@ ipsec_fp_out_ip6_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   n_left = n;
   while (n_left)
     {
-      vec_foreach (mti, mask_type_ids)
+      n_keys = ipsec_fp_ip6_prepare_keys (bihash_table, match, mask_type_ids,
+					   0, kvs, hashes);
+      for (k = 0; k < n_keys; k++)
 	{
-	  mte = im->fp_mask_types + mti->mask_type_idx;
-	  if (mte->mask.action != 0)
-	    continue;
-
-	  pmatch = (u64 *) match->kv_40_8.key;
-	  pmask = (u64 *) mte->mask.kv_40_8.key;
-	  pkey = (u64 *) kv.key;
-
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey = *pmatch & *pmask;
-
-	  int res =
-	    clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result);
-	  /* lookup the hash by each packet in the burst for this mask. */
+	  int res = clib_bihash_search_inline_2_with_hash_40_8 (
+	    bihash_table, hashes[k], &kvs[k], &result);
 
 	  if (res == 0)
 	    {
@@ -539,24 +585,23 @@ ipsec_fp_out_ip4_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   u32 last_priority[n];
   u32 i = 0;
   u32 counter = 0;
-  ipsec_fp_mask_type_entry_t *mte;
-  ipsec_fp_mask_id_t *mti;
   ipsec_fp_5tuple_t *match = tuples;
   ipsec_policy_t *policy;
 
   u32 n_left = n;
-  clib_bihash_kv_16_8_t kv;
   /* result of the lookup */
   clib_bihash_kv_16_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
-  u64 *pkey, *pmatch, *pmask;
   ipsec_main_t *im = &ipsec_main;
   ipsec_spd_fp_t *pspd_fp = (ipsec_spd_fp_t *) spd_fp;
   ipsec_fp_mask_id_t *mask_type_ids =
     pspd_fp->fp_mask_ids[IPSEC_SPD_POLICY_IP4_OUTBOUND];
   clib_bihash_16_8_t *bihash_table = pool_elt_at_index (
     im->fp_ip4_lookup_hashes_pool, pspd_fp->ip4_out_lookup_hash_idx);
+  clib_bihash_kv_16_8_t kvs[vec_len (mask_type_ids) + 1];
+  u64 hashes[vec_len (mask_type_ids) + 1];
+  u32 k, n_keys;
 
   /* clear the list of matched policies pointers */
   clib_memset (policies, 0, n * sizeof (*policies));
@@ -564,22 +609,12 @@ ipsec_fp_out_ip4_policy_match_n (void *spd_fp, ipsec_fp_5tuple_t *tuples,
   n_left = n;
   while (n_left)
     {
-      vec_foreach (mti, mask_type_ids)
+      n_keys = ipsec_fp_ip4_prepare_keys (bihash_table, match, mask_type_ids,
+					   0, kvs, hashes);
+      for (k = 0; k < n_keys; k++)
 	{
-	  mte = im->fp_mask_types + mti->mask_type_idx;
-	  if (mte->mask.action != 0)
-	    continue;
-
-	  pmatch = (u64 *) match->kv_16_8.key;
-	  pmask = (u64 *) mte->mask.kv_16_8.key;
-	  pkey = (u64 *) kv.key;
-
-	  *pkey++ = *pmatch++ & *pmask++;
-	  *pkey = *pmatch & *pmask;
-
-	  int res =
-	    clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result);
-	  /* lookup the hash by each packet in the burst for this mask. */
+	  int res = clib_bihash_search_inline_2_with_hash_16_8 (
+	    bihash_table, hashes[k], &kvs[k], &result);
 
 	  if (res == 0)
 	    {
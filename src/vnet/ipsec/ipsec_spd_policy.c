@@ -134,15 +134,12 @@ ipsec_add_del_policy (vlib_main_t * vm,
        */
       if (im->epoch_count == 0xFFFFFFFF)
 	{
-	  /* Reset all the entries in flow cache */
-	  clib_memset_u8 (im->ipsec4_out_spd_hash_tbl, 0,
-			  im->ipsec4_out_spd_hash_num_buckets *
-			    (sizeof (*(im->ipsec4_out_spd_hash_tbl))));
+	  /* Reset all the entries in the per-thread flow caches */
+	  ipsec4_out_spd_flow_cache_flush (im);
 	}
-      /* Increment epoch counter by 1 */
+      /* Increment epoch counter by 1. Per-thread entry counters are tagged
+       * with the epoch they were taken in, so all of them go stale too. */
       clib_atomic_fetch_add_relax (&im->epoch_count, 1);
-      /* Reset spd flow cache counter since all old entries are stale */
-      clib_atomic_store_relax_n (&im->ipsec4_out_spd_flow_cache_entries, 0);
     }
 
   if ((policy->type == IPSEC_SPD_POLICY_IP4_INBOUND_PROTECT ||
@@ -559,36 +556,187 @@ ipsec_fp_mask_type_idx_cmp (ipsec_fp_mask_id_t *mask_id, u32 *idx)
   return mask_id->mask_type_idx == *idx;
 }
 
-int
-ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
-			 ipsec_policy_t *policy, u32 *stat_index)
+static_always_inline u32
+ipsec_fp_port_range_to_prefixes (u16 start, u16 stop, u16 *values, u16 *masks,
+				 u32 max)
 {
-  u32 mask_index, searched_idx;
-  ipsec_policy_t *vp;
-  ipsec_fp_mask_type_entry_t *mte;
-  u32 policy_index;
-  clib_bihash_kv_16_8_t kv;
-  clib_bihash_kv_16_8_t result;
-  ipsec_fp_lookup_value_t *result_val =
-    (ipsec_fp_lookup_value_t *) &result.value;
-  ipsec_fp_lookup_value_t *key_val = (ipsec_fp_lookup_value_t *) &kv.value;
+  u32 lo = start, hi = stop, size, n = 0;
 
-  ipsec_fp_5tuple_t mask, policy_5tuple;
-  int res;
-  bool inbound = ipsec_is_policy_inbound (policy);
-  clib_bihash_16_8_t *bihash_table =
-    inbound ? pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
-				 fp_spd->ip4_in_lookup_hash_idx) :
-		    pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
-				 fp_spd->ip4_out_lookup_hash_idx);
+  /* split [start, stop] into the fewest aligned power of two blocks */
+  while (lo <= hi)
+    {
+      size = lo ? (lo & (~lo + 1)) : (1 << 16);
+      while (lo + size - 1 > hi)
+	size >>= 1;
 
-  ipsec_fp_ip4_get_policy_mask (policy, &mask, inbound);
-  pool_get (im->policies, vp);
-  policy_index = vp - im->policies;
-  vlib_validate_combined_counter (&ipsec_spd_policy_counters, policy_index);
-  vlib_zero_combined_counter (&ipsec_spd_policy_counters, policy_index);
-  *stat_index = policy_index;
-  mask_index = find_mask_type_index (im, &mask);
+      if (n == max)
+	return max + 1;
+
+      values[n] = lo;
+      masks[n] = ~(size - 1);
+      n++;
+      lo += size;
+    }
+
+  return n;
+}
+
+/*
+ * Compile a policy into the (mask, key) pairs it is stored under.
+ *
+ * Outbound port ranges which are not a single prefix would otherwise get the
+ * covering mask and a bucket shared by many policies, each of them checked
+ * linearly at lookup time. Expand them into exact prefixes instead, as long
+ * as the number of entries stays bounded - past that the wider range is
+ * collapsed back to its covering mask. With expand unset, the policy gets
+ * its covering masks only.
+ */
+static u32
+ipsec_fp_get_policy_entries (ipsec_policy_t *policy, bool inbound,
+			     bool expand, ipsec_fp_5tuple_t *masks,
+			     ipsec_fp_5tuple_t *tuples)
+{
+  u16 lvals[IPSEC_FP_MAX_RANGE_EXPANSION], lmasks[IPSEC_FP_MAX_RANGE_EXPANSION];
+  u16 rvals[IPSEC_FP_MAX_RANGE_EXPANSION], rmasks[IPSEC_FP_MAX_RANGE_EXPANSION];
+  ipsec_fp_5tuple_t mask, tuple;
+  u32 nl = 1, nr = 1, i, j, n = 0;
+
+  if (policy->is_ipv6)
+    ipsec_fp_ip6_get_policy_mask (policy, &mask, inbound);
+  else
+    ipsec_fp_ip4_get_policy_mask (policy, &mask, inbound);
+  ipsec_fp_get_policy_5tuple (policy, &tuple, inbound);
+
+  lvals[0] = tuple.lport;
+  lmasks[0] = mask.lport;
+  rvals[0] = tuple.rport;
+  rmasks[0] = mask.rport;
+
+  if (expand && !inbound &&
+      ((policy->protocol == IP_PROTOCOL_TCP) ||
+       (policy->protocol == IP_PROTOCOL_UDP) ||
+       (policy->protocol == IP_PROTOCOL_SCTP)))
+    {
+      nl = ipsec_fp_port_range_to_prefixes (policy->lport.start,
+					    policy->lport.stop, lvals, lmasks,
+					    IPSEC_FP_MAX_RANGE_EXPANSION);
+      nr = ipsec_fp_port_range_to_prefixes (policy->rport.start,
+					    policy->rport.stop, rvals, rmasks,
+					    IPSEC_FP_MAX_RANGE_EXPANSION);
+
+      if (nl * nr > IPSEC_FP_MAX_RANGE_EXPANSION && nl >= nr)
+	{
+	  lvals[0] = tuple.lport;
+	  lmasks[0] = mask.lport;
+	  nl = 1;
+	}
+      if (nl * nr > IPSEC_FP_MAX_RANGE_EXPANSION)
+	{
+	  rvals[0] = tuple.rport;
+	  rmasks[0] = mask.rport;
+	  nr = 1;
+	}
+      if (nl * nr > IPSEC_FP_MAX_RANGE_EXPANSION)
+	{
+	  lvals[0] = tuple.lport;
+	  lmasks[0] = mask.lport;
+	  nl = 1;
+	}
+    }
+
+  for (i = 0; i < nl; i++)
+    for (j = 0; j < nr; j++)
+      {
+	masks[n] = mask;
+	masks[n].lport = lmasks[i];
+	masks[n].rport = rmasks[j];
+	tuples[n] = tuple;
+	tuples[n].lport = lvals[i];
+	tuples[n].rport = rvals[j];
+	n++;
+      }
+
+  return n;
+}
+
+/*
+ * Each mask type an expansion adds to the SPD is one more hash probe for
+ * every packet looked up, keep the expanded entries only while the policies
+ * of this type stay within IPSEC_FP_MAX_EXPANDED_MASK_TYPES mask types.
+ */
+static bool
+ipsec_fp_can_expand_ports (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+			   ipsec_policy_t *policy, ipsec_fp_5tuple_t *masks,
+			   u32 n)
+{
+  ipsec_fp_mask_id_t *mask_ids = fp_spd->fp_mask_ids[policy->type];
+  u32 e, f, mask_index, n_new = 0;
+
+  for (e = 0; e < n; e++)
+    {
+      mask_index = find_mask_type_index (im, &masks[e]);
+      if (~0 != mask_index &&
+	  ~0 != vec_search_with_function (mask_ids, &mask_index,
+					  ipsec_fp_mask_type_idx_cmp))
+	continue;
+      for (f = 0; f < e; f++)
+	if (!memcmp (&masks[f], &masks[e], sizeof (masks[e])))
+	  break;
+      if (f == e)
+	n_new++;
+    }
+
+  return vec_len (mask_ids) + n_new <= IPSEC_FP_MAX_EXPANDED_MASK_TYPES;
+}
+
+static_always_inline void
+ipsec_fp_spd_mask_id_unlock (ipsec_spd_fp_t *fp_spd, ipsec_policy_t *policy,
+			     u32 mask_index)
+{
+  u32 imt;
+
+  vec_foreach_index (imt, fp_spd->fp_mask_ids[policy->type])
+    {
+      if ((fp_spd->fp_mask_ids[policy->type] + imt)->mask_type_idx ==
+	  mask_index)
+	{
+	  if ((fp_spd->fp_mask_ids[policy->type] + imt)->refcount-- == 1)
+	    vec_del1 (fp_spd->fp_mask_ids[policy->type], imt);
+	  break;
+	}
+    }
+}
+
+static_always_inline void
+ipsec_fp_spd_mask_id_lock (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+			   ipsec_policy_t *policy, ipsec_fp_5tuple_t *mask,
+			   u32 mask_index)
+{
+  ipsec_fp_mask_type_entry_t *mte = im->fp_mask_types + mask_index;
+  u32 searched_idx;
+
+  if (mte->refcount == 0)
+    clib_memcpy (&mte->mask, mask, sizeof (*mask));
+
+  searched_idx =
+    vec_search_with_function (fp_spd->fp_mask_ids[policy->type], &mask_index,
+			      ipsec_fp_mask_type_idx_cmp);
+  if (~0 == searched_idx)
+    {
+      ipsec_fp_mask_id_t mask_id = { mask_index, 1 };
+      vec_add1 (fp_spd->fp_mask_ids[policy->type], mask_id);
+    }
+  else
+    (fp_spd->fp_mask_ids[policy->type] + searched_idx)->refcount++;
+
+  mte->refcount++;
+}
+
+static_always_inline u32
+ipsec_fp_get_mask_type (ipsec_main_t *im, ipsec_fp_5tuple_t *mask)
+{
+  ipsec_fp_mask_type_entry_t *mte;
+  u32 mask_index = find_mask_type_index (im, mask);
 
   if (mask_index == ~0)
     {
@@ -597,13 +745,37 @@ ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
       mask_index = mte - im->fp_mask_types;
       mte->refcount = 0;
     }
-  else
-    mte = im->fp_mask_types + mask_index;
 
-  policy->fp_mask_type_id = mask_index;
-  ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
+  return mask_index;
+}
+
+static_always_inline void
+ipsec_fp_put_unused_mask_type (ipsec_main_t *im, u32 mask_index)
+{
+  ipsec_fp_mask_type_entry_t *mte = im->fp_mask_types + mask_index;
+
+  if (mte->refcount == 0)
+    pool_put (im->fp_mask_types, mte);
+}
+
+static int
+ipsec_fp_ip4_add_entry (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+			clib_bihash_16_8_t *bihash_table,
+			ipsec_policy_t *policy, u32 policy_index,
+			ipsec_fp_5tuple_t *mask, ipsec_fp_5tuple_t *tuple,
+			u32 *mask_indexp)
+{
+  clib_bihash_kv_16_8_t kv;
+  clib_bihash_kv_16_8_t result;
+  ipsec_fp_lookup_value_t *result_val =
+    (ipsec_fp_lookup_value_t *) &result.value;
+  ipsec_fp_lookup_value_t *key_val = (ipsec_fp_lookup_value_t *) &kv.value;
+  u32 mask_index;
+  int res;
 
-  fill_ip4_hash_policy_kv (&policy_5tuple, &mask, &kv);
+  mask_index = ipsec_fp_get_mask_type (im, mask);
+
+  fill_ip4_hash_policy_kv (tuple, mask, &kv);
 
   res = clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result);
   if (res != 0)
@@ -613,7 +785,10 @@ ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
       res = clib_bihash_add_del_16_8 (bihash_table, &kv, 1);
 
       if (res != 0)
-	goto error;
+	{
+	  vec_free (key_val->fp_policies_ids);
+	  goto error;
+	}
     }
   else
     {
@@ -642,80 +817,120 @@ ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 	}
     }
 
-  if (mte->refcount == 0)
-    {
-      clib_memcpy (&mte->mask, &mask, sizeof (mask));
-      mte->refcount = 0;
-    }
+  ipsec_fp_spd_mask_id_lock (im, fp_spd, policy, mask, mask_index);
+  *mask_indexp = mask_index;
 
-  searched_idx =
-    vec_search_with_function (fp_spd->fp_mask_ids[policy->type], &mask_index,
-			      ipsec_fp_mask_type_idx_cmp);
-  if (~0 == searched_idx)
+  return 0;
+
+error:
+  ipsec_fp_put_unused_mask_type (im, mask_index);
+  return -1;
+}
+
+static int
+ipsec_fp_ip4_del_entry (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+			clib_bihash_16_8_t *bihash_table,
+			ipsec_policy_t *policy, u32 policy_index,
+			ipsec_fp_5tuple_t *mask, ipsec_fp_5tuple_t *tuple)
+{
+  clib_bihash_kv_16_8_t kv;
+  clib_bihash_kv_16_8_t result;
+  ipsec_fp_lookup_value_t *result_val =
+    (ipsec_fp_lookup_value_t *) &result.value;
+  u32 ii, mask_index;
+
+  fill_ip4_hash_policy_kv (tuple, mask, &kv);
+  if (clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result) != 0)
+    return -1;
+
+  vec_foreach_index (ii, result_val->fp_policies_ids)
     {
-      ipsec_fp_mask_id_t mask_id = { mask_index, 1 };
-      vec_add1 (fp_spd->fp_mask_ids[policy->type], mask_id);
-    }
-  else
-    (fp_spd->fp_mask_ids[policy->type] + searched_idx)->refcount++;
+      if (result_val->fp_policies_ids[ii] != policy_index)
+	continue;
 
-  mte->refcount++;
-  clib_memcpy (vp, policy, sizeof (*vp));
+      if (vec_len (result_val->fp_policies_ids) == 1)
+	{
+	  vec_free (result_val->fp_policies_ids);
+	  clib_bihash_add_del_16_8 (bihash_table, &result, 0);
+	}
+      else
+	vec_delete (result_val->fp_policies_ids, 1, ii);
 
-  return 0;
+      mask_index = find_mask_type_index (im, mask);
+      ipsec_fp_spd_mask_id_unlock (fp_spd, policy, mask_index);
+      ipsec_fp_release_mask_type (im, mask_index);
+      return 0;
+    }
 
-error:
-  pool_put (im->policies, vp);
-  ipsec_fp_release_mask_type (im, mask_index);
   return -1;
 }
 
 int
-ipsec_fp_ip6_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+ipsec_fp_ip4_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 			 ipsec_policy_t *policy, u32 *stat_index)
 {
-
-  u32 mask_index, searched_idx;
+  ipsec_fp_5tuple_t masks[IPSEC_FP_MAX_RANGE_EXPANSION];
+  ipsec_fp_5tuple_t tuples[IPSEC_FP_MAX_RANGE_EXPANSION];
   ipsec_policy_t *vp;
-  ipsec_fp_mask_type_entry_t *mte;
-  u32 policy_index;
-  clib_bihash_kv_40_8_t kv;
-  clib_bihash_kv_40_8_t result;
-  ipsec_fp_lookup_value_t *result_val =
-    (ipsec_fp_lookup_value_t *) &result.value;
-  ipsec_fp_lookup_value_t *key_val = (ipsec_fp_lookup_value_t *) &kv.value;
-
-  ipsec_fp_5tuple_t mask, policy_5tuple;
-  int res;
+  u32 policy_index, mask_index, e, n;
   bool inbound = ipsec_is_policy_inbound (policy);
+  clib_bihash_16_8_t *bihash_table =
+    inbound ? pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
+				 fp_spd->ip4_in_lookup_hash_idx) :
+		    pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
+				 fp_spd->ip4_out_lookup_hash_idx);
 
-  ipsec_fp_ip6_get_policy_mask (policy, &mask, inbound);
+  n = ipsec_fp_get_policy_entries (policy, inbound, 1, masks, tuples);
+  policy->fp_ports_expanded = n > 1;
+  if (n > 1 && !ipsec_fp_can_expand_ports (im, fp_spd, policy, masks, n))
+    {
+      n = ipsec_fp_get_policy_entries (policy, inbound, 0, masks, tuples);
+      policy->fp_ports_expanded = 0;
+    }
   pool_get (im->policies, vp);
   policy_index = vp - im->policies;
   vlib_validate_combined_counter (&ipsec_spd_policy_counters, policy_index);
   vlib_zero_combined_counter (&ipsec_spd_policy_counters, policy_index);
   *stat_index = policy_index;
-  mask_index = find_mask_type_index (im, &mask);
-  clib_bihash_40_8_t *bihash_table =
-    inbound ? pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
-				 fp_spd->ip6_in_lookup_hash_idx) :
-		    pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
-				 fp_spd->ip6_out_lookup_hash_idx);
+  clib_memcpy (vp, policy, sizeof (*vp));
 
-  if (mask_index == ~0)
+  for (e = 0; e < n; e++)
     {
-      /* mask type not found, we need to create a new entry */
-      pool_get (im->fp_mask_types, mte);
-      mask_index = mte - im->fp_mask_types;
-      mte->refcount = 0;
+      if (ipsec_fp_ip4_add_entry (im, fp_spd, bihash_table, vp, policy_index,
+				  &masks[e], &tuples[e], &mask_index))
+	goto error;
+      if (e == 0)
+	policy->fp_mask_type_id = vp->fp_mask_type_id = mask_index;
     }
-  else
-    mte = im->fp_mask_types + mask_index;
 
-  policy->fp_mask_type_id = mask_index;
-  ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
+  return 0;
 
-  fill_ip6_hash_policy_kv (&policy_5tuple, &mask, &kv);
+error:
+  while (e--)
+    ipsec_fp_ip4_del_entry (im, fp_spd, bihash_table, vp, policy_index,
+			    &masks[e], &tuples[e]);
+  pool_put (im->policies, vp);
+  return -1;
+}
+
+static int
+ipsec_fp_ip6_add_entry (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+			clib_bihash_40_8_t *bihash_table,
+			ipsec_policy_t *policy, u32 policy_index,
+			ipsec_fp_5tuple_t *mask, ipsec_fp_5tuple_t *tuple,
+			u32 *mask_indexp)
+{
+  clib_bihash_kv_40_8_t kv;
+  clib_bihash_kv_40_8_t result;
+  ipsec_fp_lookup_value_t *result_val =
+    (ipsec_fp_lookup_value_t *) &result.value;
+  ipsec_fp_lookup_value_t *key_val = (ipsec_fp_lookup_value_t *) &kv.value;
+  u32 mask_index;
+  int res;
+
+  mask_index = ipsec_fp_get_mask_type (im, mask);
+
+  fill_ip6_hash_policy_kv (tuple, mask, &kv);
 
   res = clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result);
   if (res != 0)
@@ -724,7 +939,10 @@ ipsec_fp_ip6_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
       vec_add1 (key_val->fp_policies_ids, policy_index);
       res = clib_bihash_add_del_40_8 (bihash_table, &kv, 1);
       if (res != 0)
-	goto error;
+	{
+	  vec_free (key_val->fp_policies_ids);
+	  goto error;
+	}
     }
   else
     {
@@ -753,31 +971,99 @@ ipsec_fp_ip6_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 	}
     }
 
-  if (mte->refcount == 0)
+  ipsec_fp_spd_mask_id_lock (im, fp_spd, policy, mask, mask_index);
+  *mask_indexp = mask_index;
+
+  return 0;
+
+error:
+  ipsec_fp_put_unused_mask_type (im, mask_index);
+  return -1;
+}
+
+static int
+ipsec_fp_ip6_del_entry (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+			clib_bihash_40_8_t *bihash_table,
+			ipsec_policy_t *policy, u32 policy_index,
+			ipsec_fp_5tuple_t *mask, ipsec_fp_5tuple_t *tuple)
+{
+  clib_bihash_kv_40_8_t kv;
+  clib_bihash_kv_40_8_t result;
+  ipsec_fp_lookup_value_t *result_val =
+    (ipsec_fp_lookup_value_t *) &result.value;
+  u32 ii, mask_index;
+
+  fill_ip6_hash_policy_kv (tuple, mask, &kv);
+  if (clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result) != 0)
+    return -1;
+
+  vec_foreach_index (ii, result_val->fp_policies_ids)
     {
-      clib_memcpy (&mte->mask, &mask, sizeof (mask));
-      mte->refcount = 0;
+      if (result_val->fp_policies_ids[ii] != policy_index)
+	continue;
+
+      if (vec_len (result_val->fp_policies_ids) == 1)
+	{
+	  vec_free (result_val->fp_policies_ids);
+	  clib_bihash_add_del_40_8 (bihash_table, &result, 0);
+	}
+      else
+	vec_delete (result_val->fp_policies_ids, 1, ii);
+
+      mask_index = find_mask_type_index (im, mask);
+      ipsec_fp_spd_mask_id_unlock (fp_spd, policy, mask_index);
+      ipsec_fp_release_mask_type (im, mask_index);
+      return 0;
     }
 
-  searched_idx =
-    vec_search_with_function (fp_spd->fp_mask_ids[policy->type], &mask_index,
-			      ipsec_fp_mask_type_idx_cmp);
-  if (~0 == searched_idx)
+  return -1;
+}
+
+int
+ipsec_fp_ip6_add_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
+			 ipsec_policy_t *policy, u32 *stat_index)
+{
+  ipsec_fp_5tuple_t masks[IPSEC_FP_MAX_RANGE_EXPANSION];
+  ipsec_fp_5tuple_t tuples[IPSEC_FP_MAX_RANGE_EXPANSION];
+  ipsec_policy_t *vp;
+  u32 policy_index, mask_index, e, n;
+  bool inbound = ipsec_is_policy_inbound (policy);
+  clib_bihash_40_8_t *bihash_table =
+    inbound ? pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
+				 fp_spd->ip6_in_lookup_hash_idx) :
+		    pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
+				 fp_spd->ip6_out_lookup_hash_idx);
+
+  n = ipsec_fp_get_policy_entries (policy, inbound, 1, masks, tuples);
+  policy->fp_ports_expanded = n > 1;
+  if (n > 1 && !ipsec_fp_can_expand_ports (im, fp_spd, policy, masks, n))
     {
-      ipsec_fp_mask_id_t mask_id = { mask_index, 1 };
-      vec_add1 (fp_spd->fp_mask_ids[policy->type], mask_id);
+      n = ipsec_fp_get_policy_entries (policy, inbound, 0, masks, tuples);
+      policy->fp_ports_expanded = 0;
     }
-  else
-    (fp_spd->fp_mask_ids[policy->type] + searched_idx)->refcount++;
-
-  mte->refcount++;
+  pool_get (im->policies, vp);
+  policy_index = vp - im->policies;
+  vlib_validate_combined_counter (&ipsec_spd_policy_counters, policy_index);
+  vlib_zero_combined_counter (&ipsec_spd_policy_counters, policy_index);
+  *stat_index = policy_index;
   clib_memcpy (vp, policy, sizeof (*vp));
 
+  for (e = 0; e < n; e++)
+    {
+      if (ipsec_fp_ip6_add_entry (im, fp_spd, bihash_table, vp, policy_index,
+				  &masks[e], &tuples[e], &mask_index))
+	goto error;
+      if (e == 0)
+	policy->fp_mask_type_id = vp->fp_mask_type_id = mask_index;
+    }
+
   return 0;
 
 error:
+  while (e--)
+    ipsec_fp_ip6_del_entry (im, fp_spd, bihash_table, vp, policy_index,
+			    &masks[e], &tuples[e]);
   pool_put (im->policies, vp);
-  ipsec_fp_release_mask_type (im, mask_index);
   return -1;
 }
 
@@ -785,8 +1071,8 @@ int
 ipsec_fp_ip6_del_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 			 ipsec_policy_t *policy)
 {
-  int res;
-  ipsec_fp_5tuple_t mask = { 0 }, policy_5tuple;
+  ipsec_fp_5tuple_t masks[IPSEC_FP_MAX_RANGE_EXPANSION];
+  ipsec_fp_5tuple_t tuples[IPSEC_FP_MAX_RANGE_EXPANSION];
   clib_bihash_kv_40_8_t kv;
   clib_bihash_kv_40_8_t result;
   ipsec_fp_lookup_value_t *result_val =
@@ -797,49 +1083,36 @@ ipsec_fp_ip6_del_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 				 fp_spd->ip6_in_lookup_hash_idx) :
 		    pool_elt_at_index (im->fp_ip6_lookup_hashes_pool,
 				 fp_spd->ip6_out_lookup_hash_idx);
-
   ipsec_policy_t *vp;
-  u32 ii, imt;
+  u32 ii, e, n, expand, policy_index;
 
-  ipsec_fp_ip6_get_policy_mask (policy, &mask, inbound);
-  ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
-  fill_ip6_hash_policy_kv (&policy_5tuple, &mask, &kv);
-  res = clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result);
-  if (res != 0)
-    return -1;
-
-  vec_foreach_index (ii, result_val->fp_policies_ids)
+  /*
+   * The first entry identifies the policy, the others follow by index.
+   * Whether the ports were expanded depends on the SPD at the time the
+   * policy was added, so try both.
+   */
+  for (expand = 0; expand < 2; expand++)
     {
-      vp =
-	pool_elt_at_index (im->policies, *(result_val->fp_policies_ids + ii));
-      if (ipsec_policy_is_equal (vp, policy))
-	{
-	  if (vec_len (result_val->fp_policies_ids) == 1)
-	    {
-	      vec_free (result_val->fp_policies_ids);
-	      clib_bihash_add_del_40_8 (bihash_table, &result, 0);
-	    }
-	  else
-	    vec_delete (result_val->fp_policies_ids, 1, ii);
+      n = ipsec_fp_get_policy_entries (policy, inbound, expand, masks,
+				       tuples);
+      fill_ip6_hash_policy_kv (&tuples[0], &masks[0], &kv);
+      if (clib_bihash_search_inline_2_40_8 (bihash_table, &kv, &result) != 0)
+	continue;
 
-	  vec_foreach_index (imt, fp_spd->fp_mask_ids[policy->type])
+      vec_foreach_index (ii, result_val->fp_policies_ids)
+	{
+	  policy_index = result_val->fp_policies_ids[ii];
+	  vp = pool_elt_at_index (im->policies, policy_index);
+	  if (vp->fp_ports_expanded == expand &&
+	      ipsec_policy_is_equal (vp, policy))
 	    {
-	      if ((fp_spd->fp_mask_ids[policy->type] + imt)->mask_type_idx ==
-		  vp->fp_mask_type_id)
-		{
-
-		  if ((fp_spd->fp_mask_ids[policy->type] + imt)->refcount-- ==
-		      1)
-		    vec_del1 (fp_spd->fp_mask_ids[policy->type], imt);
-
-		  break;
-		}
+	      for (e = 0; e < n; e++)
+		ipsec_fp_ip6_del_entry (im, fp_spd, bihash_table, vp,
+					policy_index, &masks[e], &tuples[e]);
+	      ipsec_sa_unlock (vp->sa_index);
+	      pool_put (im->policies, vp);
+	      return 0;
 	    }
-
-	  ipsec_fp_release_mask_type (im, vp->fp_mask_type_id);
-	  ipsec_sa_unlock (vp->sa_index);
-	  pool_put (im->policies, vp);
-	  return 0;
 	}
     }
   return -1;
@@ -849,60 +1122,48 @@ int
 ipsec_fp_ip4_del_policy (ipsec_main_t *im, ipsec_spd_fp_t *fp_spd,
 			 ipsec_policy_t *policy)
 {
-  int res;
-  ipsec_fp_5tuple_t mask = { 0 }, policy_5tuple;
+  ipsec_fp_5tuple_t masks[IPSEC_FP_MAX_RANGE_EXPANSION];
+  ipsec_fp_5tuple_t tuples[IPSEC_FP_MAX_RANGE_EXPANSION];
   clib_bihash_kv_16_8_t kv;
   clib_bihash_kv_16_8_t result;
   ipsec_fp_lookup_value_t *result_val =
     (ipsec_fp_lookup_value_t *) &result.value;
   bool inbound = ipsec_is_policy_inbound (policy);
   ipsec_policy_t *vp;
-  u32 ii, imt;
+  u32 ii, e, n, expand, policy_index;
   clib_bihash_16_8_t *bihash_table =
     inbound ? pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
 				 fp_spd->ip4_in_lookup_hash_idx) :
 		    pool_elt_at_index (im->fp_ip4_lookup_hashes_pool,
 				 fp_spd->ip4_out_lookup_hash_idx);
 
-  ipsec_fp_ip4_get_policy_mask (policy, &mask, inbound);
-  ipsec_fp_get_policy_5tuple (policy, &policy_5tuple, inbound);
-  fill_ip4_hash_policy_kv (&policy_5tuple, &mask, &kv);
-  res = clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result);
-
-  if (res != 0)
-    return -1;
-
-  vec_foreach_index (ii, result_val->fp_policies_ids)
+  /*
+   * The first entry identifies the policy, the others follow by index.
+   * Whether the ports were expanded depends on the SPD at the time the
+   * policy was added, so try both.
+   */
+  for (expand = 0; expand < 2; expand++)
     {
-      vp =
-	pool_elt_at_index (im->policies, *(result_val->fp_policies_ids + ii));
-      if (ipsec_policy_is_equal (vp, policy))
-	{
-	  if (vec_len (result_val->fp_policies_ids) == 1)
-	    {
-	      vec_free (result_val->fp_policies_ids);
-	      clib_bihash_add_del_16_8 (bihash_table, &result, 0);
-	    }
-	  else
-	    vec_delete (result_val->fp_policies_ids, 1, ii);
+      n = ipsec_fp_get_policy_entries (policy, inbound, expand, masks,
+				       tuples);
+      fill_ip4_hash_policy_kv (&tuples[0], &masks[0], &kv);
+      if (clib_bihash_search_inline_2_16_8 (bihash_table, &kv, &result) != 0)
+	continue;
 
-	  vec_foreach_index (imt, fp_spd->fp_mask_ids[policy->type])
+      vec_foreach_index (ii, result_val->fp_policies_ids)
+	{
+	  policy_index = result_val->fp_policies_ids[ii];
+	  vp = pool_elt_at_index (im->policies, policy_index);
+	  if (vp->fp_ports_expanded == expand &&
+	      ipsec_policy_is_equal (vp, policy))
 	    {
-	      if ((fp_spd->fp_mask_ids[policy->type] + imt)->mask_type_idx ==
-		  vp->fp_mask_type_id)
-		{
-
-		  if ((fp_spd->fp_mask_ids[policy->type] + imt)->refcount-- ==
-		      1)
-		    vec_del1 (fp_spd->fp_mask_ids[policy->type], imt);
-
-		  break;
-		}
+	      for (e = 0; e < n; e++)
+		ipsec_fp_ip4_del_entry (im, fp_spd, bihash_table, vp,
+					policy_index, &masks[e], &tuples[e]);
+	      ipsec_sa_unlock (vp->sa_index);
+	      pool_put (im->policies, vp);
+	      return 0;
 	    }
-	  ipsec_fp_release_mask_type (im, vp->fp_mask_type_id);
-	  ipsec_sa_unlock (vp->sa_index);
-	  pool_put (im->policies, vp);
-	  return 0;
 	}
     }
   return -1;
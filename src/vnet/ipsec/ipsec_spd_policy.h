@@ -25,6 +25,19 @@
 
 #define IPSEC_POLICY_PROTOCOL_ANY IP_PROTOCOL_RESERVED
 
+/**
+ * Max number of fast path entries an outbound policy with port ranges is
+ * expanded to, wider ranges fall back to a covering mask.
+ */
+#define IPSEC_FP_MAX_RANGE_EXPANSION 16
+
+/**
+ * Every mask type of an SPD costs one more hash probe per packet. Port
+ * ranges are only expanded while the policies of that type use no more
+ * mask types than this, the others fall back to a covering mask.
+ */
+#define IPSEC_FP_MAX_EXPANDED_MASK_TYPES 8
+
 /**
  * This number is calculated as ceil power of 2 for the number
  * sizeof(clib_bihash_kv_16_8_t)=24 * BIHASH_KVP_PER_PAGE=4 * COLLISIONS_NO=8
@@ -95,6 +108,8 @@ typedef struct ipsec_policy_t_
   u32 sa_id;
   u32 sa_index;
   u32 fp_mask_type_id;
+  // the port ranges were expanded into fast path prefixes
+  u8 fp_ports_expanded;
 } ipsec_policy_t;
 
 /**
@@ -61,6 +61,7 @@ bd_validate (l2_bridge_domain_t * bd_config)
   bd_config->tun_master_count = 0;
   bd_config->tun_normal_count = 0;
   bd_config->no_flood_count = 0;
+  bd_config->flood_sw_if_indices = 0;
   bd_config->mac_by_ip4 = 0;
   bd_config->mac_by_ip6 = hash_create_mem (0, sizeof (ip6_address_t),
 					   sizeof (uword));
@@ -133,6 +134,7 @@ bd_delete (bd_main_t * bdm, u32 bd_index)
 
   /* free memory used by BD */
   vec_free (bd->members);
+  vec_free (bd->flood_sw_if_indices);
   bd_free_ip_mac_tables (bd);
 
   return 0;
@@ -141,10 +143,18 @@ bd_delete (bd_main_t * bdm, u32 bd_index)
 static void
 update_flood_count (l2_bridge_domain_t * bd_config)
 {
+  i32 i;
+
   bd_config->flood_count = (vec_len (bd_config->members) -
 			    (bd_config->tun_master_count ?
 			     bd_config->tun_normal_count : 0));
   bd_config->flood_count -= bd_config->no_flood_count;
+
+  /* precompute the replication list walked by l2-flood */
+  vec_reset_length (bd_config->flood_sw_if_indices);
+  for (i = bd_config->flood_count - 1; i >= 0; i--)
+    vec_add1 (bd_config->flood_sw_if_indices,
+	      bd_config->members[i].sw_if_index);
 }
 
 void
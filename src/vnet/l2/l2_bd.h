@@ -98,6 +98,13 @@ typedef struct
   /* Interface on which packets are not flooded */
   u32 no_flood_count;
 
+  /*
+   * Ingress replication list: sw_if_index of each flooded member in
+   * replication order, i.e. the first flood_count members reversed so
+   * that the BVI (if flooded) is last. Rebuilt when membership changes.
+   */
+  u32 *flood_sw_if_indices;
+
   /* hash ip4/ip6 -> mac for arp/nd termination */
   uword *mac_by_ip4;
   uword *mac_by_ip6;
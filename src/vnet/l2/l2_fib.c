@@ -322,6 +322,24 @@ show_l2fib (vlib_main_t * vm,
 			 "Max macs in event: %d",
 			 lm->client_pid, msm->evt_scan_duration,
 			 msm->event_scan_delay, msm->max_macs_in_event);
+      if (lm->learn_queue_size)
+	{
+	  l2learn_per_thread_data_t *ptd;
+	  u64 n_queued = 0, n_queue_full = 0;
+
+	  vec_foreach (ptd, lm->per_thread_data)
+	    {
+	      n_queued += ptd->n_queued;
+	      n_queue_full += ptd->n_queue_full;
+	    }
+	  vlib_cli_output (vm, "L2 learn queues: size %d  queued %lu  "
+			   "queue full %lu  learned %lu  over limit %lu  "
+			   "rate %.2f/sec",
+			   lm->learn_queue_size, n_queued, n_queue_full,
+			   lm->n_learner_updates, lm->n_learner_limit,
+			   vlib_time_now (vm) - lm->learn_rate_time > 2.0 ?
+			   0.0 : lm->learn_rate);
+	}
     }
 
   if (raw)
@@ -464,7 +482,7 @@ l2fib_add_entry (const u8 * mac, u32 bd_index,
 	   * workers adding an entry simultaneously */
 	  /* learn_count variable may have little inaccuracy because they are
 	   * not incremented/decremented with atomic operations */
-	  /* l2fib_scan is call every 2sec fixing potential inaccuracy */
+	  /* the mac age scanner corrects them once per aging interval */
 	  if (lm->global_learn_count)
 	    lm->global_learn_count--;
 	  if (bd_config->learn_count)
@@ -1063,32 +1081,48 @@ allocate_mac_evt_buf (u32 client, u32 client_index)
   return mp;
 }
 
+/**
+ * Scan the buckets [first_bucket, first_bucket + n_buckets) of the mac
+ * table, sending the mac events and aging out the entries.
+ * The learn counts are decremented for the entries aged out. If
+ * learn_count_p is set, the learned entries left are counted into
+ * learn_count / bd_learn_counts, and *stable_p tells whether the learn
+ * counts were left alone by everyone else during the scan, so that the
+ * entries counted match them.
+ */
 static_always_inline f64
-l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
+l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only,
+	    u32 first_bucket, u32 n_buckets, u32 * learn_count_p,
+	    u32 ** bd_learn_counts_p, u8 * stable_p)
 {
   l2fib_main_t *fm = &l2fib_main;
   l2learn_main_t *lm = &l2learn_main;
 
   BVT (clib_bihash) * h = &fm->mac_table;
-  int i, j, k;
+  int i, j, k, last_bucket;
   f64 last_start = start_time;
   f64 accum_t = 0;
   f64 delta_t = 0;
   u32 evt_idx = 0;
   u32 learn_count = 0;
+  u32 start_learn_count = lm->global_learn_count;
+  u32 n_aged = 0;
   u32 client = lm->client_pid;
   u32 cl_idx = lm->client_index;
   vl_api_l2_macs_event_t *mp = 0;
   vl_api_registration_t *reg = 0;
-  u32 bd_index;
-  static u32 *bd_learn_counts = 0;
+  u32 *bd_learn_counts = 0;
 
   /* Don't scan the l2 fib if it hasn't been instantiated yet */
   if (alloc_arena (h) == 0)
     return 0.0;
 
-  vec_reset_length (bd_learn_counts);
-  vec_validate (bd_learn_counts, vec_len (l2input_main.bd_configs) - 1);
+  if (learn_count_p)
+    {
+      learn_count = *learn_count_p;
+      bd_learn_counts = *bd_learn_counts_p;
+      vec_validate (bd_learn_counts, vec_len (l2input_main.bd_configs) - 1);
+    }
 
   if (client)
     {
@@ -1096,7 +1130,8 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
       reg = vl_api_client_index_to_registration (lm->client_index);
     }
 
-  for (i = 0; i < h->nbuckets; i++)
+  last_bucket = clib_min ((u64) first_bucket + n_buckets, h->nbuckets);
+  for (i = first_bucket; i < last_bucket; i++)
     {
       /* allow no more than 20us without a pause */
       delta_t = vlib_time_now (vm) - last_start;
@@ -1104,13 +1139,14 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
 	{
 	  vlib_process_suspend (vm, 100e-6);	/* suspend for 100 us */
 	  /* in case a new bd was created while sleeping */
-	  vec_validate (bd_learn_counts,
-			vec_len (l2input_main.bd_configs) - 1);
+	  if (learn_count_p)
+	    vec_validate (bd_learn_counts,
+			  vec_len (l2input_main.bd_configs) - 1);
 	  last_start = vlib_time_now (vm);
 	  accum_t += delta_t;
 	}
 
-      if (i < (h->nbuckets - 3))
+      if (i + 3 < last_bucket)
 	{
 	  BVT (clib_bihash_bucket) * b =
 	    BV (clib_bihash_get_bucket) (h, i + 3);
@@ -1138,7 +1174,7 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
 	      l2fib_entry_key_t key = {.raw = v->kvp[k].key };
 	      l2fib_entry_result_t result = {.raw = v->kvp[k].value };
 
-	      if (!l2fib_entry_result_is_set_AGE_NOT (&result))
+	      if (learn_count_p && !l2fib_entry_result_is_set_AGE_NOT (&result))
 		{
 		  learn_count++;
 		  vec_elt (bd_learn_counts, key.fields.bd_index)++;
@@ -1229,8 +1265,21 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
 	      BVT (clib_bihash_kv) kv;
 	      kv.key = key.raw;
 	      BV (clib_bihash_add_del) (&fm->mac_table, &kv, 0);
-	      learn_count--;
-	      vec_elt (bd_learn_counts, key.fields.bd_index)--;
+	      l2_bridge_domain_t *age_bd_config =
+		vec_elt_at_index (l2input_main.bd_configs,
+				  key.fields.bd_index);
+	      if (lm->global_learn_count)
+		{
+		  lm->global_learn_count--;
+		  n_aged++;
+		}
+	      if (age_bd_config->learn_count)
+		age_bd_config->learn_count--;
+	      if (learn_count_p)
+		{
+		  learn_count--;
+		  vec_elt (bd_learn_counts, key.fields.bd_index)--;
+		}
 	      /*
 	       * Note: we may have just freed the bucket's backing
 	       * storage, so check right here...
@@ -1244,12 +1293,11 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
       ;
     }
 
-  /* keep learn count consistent */
-  l2learn_main.global_learn_count = learn_count;
-  vec_foreach_index (bd_index, l2input_main.bd_configs)
+  if (learn_count_p)
     {
-      vec_elt (l2input_main.bd_configs, bd_index).learn_count =
-	vec_elt (bd_learn_counts, bd_index);
+      *learn_count_p = learn_count;
+      *bd_learn_counts_p = bd_learn_counts;
+      *stable_p = lm->global_learn_count + n_aged == start_learn_count;
     }
 
   if (mp)
@@ -1276,6 +1324,83 @@ l2fib_scan (vlib_main_t * vm, f64 start_time, u8 event_only)
   return delta_t + accum_t;
 }
 
+/** Set the learn counts found by a complete pass over the mac table */
+static void
+l2fib_set_learn_counts (u32 learn_count, u32 * bd_learn_counts)
+{
+  u32 bd_index;
+
+  /* keep learn count consistent */
+  l2learn_main.global_learn_count = learn_count;
+  vec_foreach_index (bd_index, l2input_main.bd_configs)
+    {
+      vec_elt (l2input_main.bd_configs, bd_index).learn_count =
+	bd_index < vec_len (bd_learn_counts) ?
+	vec_elt (bd_learn_counts, bd_index) : 0;
+    }
+}
+
+/** Scan the whole mac table at once */
+static f64
+l2fib_scan_all (vlib_main_t * vm, f64 start_time, u8 event_only)
+{
+  l2fib_main_t *fm = &l2fib_main;
+  static u32 *bd_learn_counts = 0;
+  u32 learn_count = 0;
+  u8 stable = 0;
+  f64 scan_time;
+
+  /* Don't scan the l2 fib if it hasn't been instantiated yet */
+  if (alloc_arena (&fm->mac_table) == 0)
+    return 0.0;
+
+  vec_reset_length (bd_learn_counts);
+  scan_time = l2fib_scan (vm, start_time, event_only, 0,
+			  fm->mac_table.nbuckets, &learn_count,
+			  &bd_learn_counts, &stable);
+
+  /*
+   * The learn counts are kept up to date on every add and delete; the
+   * totals replace them, to correct the drift of the unlocked updates,
+   * unless a learn or a delete raced with the pass.
+   */
+  if (stable)
+    l2fib_set_learn_counts (learn_count, bd_learn_counts);
+  return scan_time;
+}
+
+/**
+ * Advance the aging wheel by one slot. The buckets of the mac table are
+ * split in L2FIB_AGE_WHEEL_N_SLOTS slots and one slot is scanned per
+ * tick, so that every entry is still checked once per
+ * L2FIB_AGE_SCAN_INTERVAL without walking the whole table in one go.
+ * Once per turn of the wheel, a pass which does not age counts the
+ * entries to correct the learn counts.
+ */
+static f64
+l2fib_age_wheel_tick (vlib_main_t * vm, f64 start_time)
+{
+  l2fib_main_t *fm = &l2fib_main;
+  u32 slot_buckets;
+  f64 scan_time;
+
+  if (alloc_arena (&fm->mac_table) == 0)
+    return 0.0;
+
+  slot_buckets = (fm->mac_table.nbuckets + L2FIB_AGE_WHEEL_N_SLOTS - 1) /
+    L2FIB_AGE_WHEEL_N_SLOTS;
+  scan_time = l2fib_scan (vm, start_time, 0,
+			  fm->age_wheel_slot * slot_buckets, slot_buckets,
+			  0, 0, 0);
+
+  if (++fm->age_wheel_slot == L2FIB_AGE_WHEEL_N_SLOTS)
+    {
+      fm->age_wheel_slot = 0;
+      scan_time += l2fib_scan_all (vm, start_time, 1);
+    }
+  return scan_time;
+}
+
 static uword
 l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 			       vlib_frame_t * f)
@@ -1303,13 +1428,20 @@ l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 
       start_time = vlib_time_now (vm);
       enum
-      { SCAN_MAC_AGE, SCAN_MAC_EVENT, SCAN_DISABLE } scan = SCAN_MAC_AGE;
+      {
+	SCAN_MAC_AGE,
+	SCAN_MAC_AGE_TICK,
+	SCAN_MAC_EVENT,
+	SCAN_DISABLE
+      } scan = SCAN_MAC_AGE;
 
       switch (event_type)
 	{
 	case ~0:		/* timer expired */
 	  if (lm->client_pid != 0 && start_time < next_age_scan_time)
 	    scan = SCAN_MAC_EVENT;
+	  else
+	    scan = SCAN_MAC_AGE_TICK;
 	  break;
 
 	case L2_MAC_AGE_PROCESS_EVENT_START:
@@ -1329,11 +1461,14 @@ l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	}
 
       if (scan == SCAN_MAC_EVENT)
-	l2fib_main.evt_scan_duration = l2fib_scan (vm, start_time, 1);
+	l2fib_main.evt_scan_duration = l2fib_scan_all (vm, start_time, 1);
       else
 	{
 	  if (scan == SCAN_MAC_AGE)
-	    l2fib_main.age_scan_duration = l2fib_scan (vm, start_time, 0);
+	    l2fib_main.age_scan_duration = l2fib_scan_all (vm, start_time, 0);
+	  if (scan == SCAN_MAC_AGE_TICK)
+	    l2fib_main.age_scan_duration =
+	      l2fib_age_wheel_tick (vm, start_time);
 	  if (scan == SCAN_DISABLE)
 	    {
 	      l2fib_main.age_scan_duration = 0;
@@ -1341,7 +1476,8 @@ l2fib_mac_age_scanner_process (vlib_main_t * vm, vlib_node_runtime_t * rt,
 	    }
 	  /* schedule next scan */
 	  if (enabled)
-	    next_age_scan_time = start_time + L2FIB_AGE_SCAN_INTERVAL;
+	    next_age_scan_time = start_time + L2FIB_AGE_SCAN_INTERVAL /
+	      L2FIB_AGE_WHEEL_N_SLOTS;
 	  else
 	    next_age_scan_time = CLIB_TIME_MAX;
 	}
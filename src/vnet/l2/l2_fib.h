@@ -30,6 +30,9 @@
 /* Ager scan interval is 1 minute for aging */
 #define L2FIB_AGE_SCAN_INTERVAL		(60.0)
 
+/* The ager scans 1/60th of the buckets per tick, i.e. once per second */
+#define L2FIB_AGE_WHEEL_N_SLOTS		(60)
+
 /* MAC event scan delay is 100 msec unless specified by MAC event client */
 #define L2FIB_EVENT_SCAN_DELAY_DEFAULT	(0.1)
 
@@ -58,6 +61,9 @@ typedef struct
   f64 evt_scan_duration;
   f64 age_scan_duration;
 
+  /* aging wheel slot to scan next */
+  u32 age_wheel_slot;
+
   /* delay between event scans, default to 100 msec */
   f64 event_scan_delay;
 
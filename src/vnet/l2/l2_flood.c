@@ -32,18 +32,24 @@
  * @file
  * @brief Ethernet Flooding.
  *
- * Flooding uses the packet replication infrastructure to send a copy of the
- * packet to each member interface. Logically the replication infrastructure
- * expects two graph nodes: a prep node that initiates replication and sends the
- * packet to the first destination, and a recycle node that is passed the packet
- * after it has been transmitted.
- *
- * To decrease the amount of code, l2 flooding implements both functions in
- * the same graph node. This node can tell if is it being called as the "prep"
- * or "recycle" using replication_is_recycled().
+ * Flooding sends a replica of the packet to each member interface of the
+ * bridge domain. Replicas are reference counted buffer clones, so only the
+ * packet headers are copied per member while the payload is shared.
  */
 
 
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+
+  /* flooded packets */
+  u64 n_packets;
+
+  /* replicas made by cloning, and the cycles spent making them */
+  u64 n_replicas;
+  u64 replication_cycles;
+} l2flood_per_thread_stats_t;
+
 typedef struct
 {
 
@@ -59,7 +65,19 @@ typedef struct
 
   /* per-cpu vector of cloned packets */
   u32 **clones;
-  l2_flood_member_t ***members;
+  /* per-cpu vector of the sw_if_index each clone is sent to */
+  u32 **members;
+
+  /* per-cpu vectors of the replicas to enqueue, in packet order, and
+   * their next nodes */
+  u32 **to_next;
+  u16 **nexts;
+
+  /* per-cpu replication statistics */
+  l2flood_per_thread_stats_t *stats;
+
+  /* count the cycles spent replicating, off by default */
+  u8 cycle_stats_enabled;
 } l2flood_main_t;
 
 typedef struct
@@ -120,241 +138,253 @@ typedef enum
   L2FLOOD_N_NEXT,
 } l2flood_next_t;
 
+static_always_inline void
+l2flood_trace_replica (vlib_main_t * vm, vlib_node_runtime_t * node,
+		       vlib_buffer_t * b0, vlib_buffer_t * c0,
+		       u32 sw_if_index0)
+{
+  ethernet_header_t *h0;
+  l2flood_trace_t *t;
+
+  if (PREDICT_TRUE (!((node->flags & VLIB_NODE_FLAG_TRACE) &&
+		      (b0->flags & VLIB_BUFFER_IS_TRACED))))
+    return;
+
+  t = vlib_add_trace (vm, node, c0, sizeof (*t));
+  h0 = vlib_buffer_get_current (c0);
+  t->sw_if_index = sw_if_index0;
+  t->bd_index = vnet_buffer (c0)->l2.bd_index;
+  clib_memcpy_fast (t->src, h0->src_address, 6);
+  clib_memcpy_fast (t->dst, h0->dst_address, 6);
+}
+
 /*
- * Perform flooding on one packet
+ * Perform flooding
  *
  * Due to the way BVI processing can modify the packet, the BVI interface
- * (if present) must be processed last in the replication. The member vector
- * is arranged so that the BVI interface is always the first element.
- * Flooding walks the vector in reverse.
+ * (if present) must be processed last in the replication. The BD's
+ * replication list (flood_sw_if_indices) is arranged so that the BVI
+ * interface is always the last element.
  *
  * BVI processing causes the packet to go to L3 processing. This strips the
- * L2 header, which is fine because the replication infrastructure restores
- * it. However L3 processing can trigger larger changes to the packet. For
- * example, an ARP request could be turned into an ARP reply, an ICMP request
- * could be turned into an ICMP reply. If BVI processing is not performed
- * last, the modified packet would be replicated to the remaining members.
+ * L2 header, which is fine because each replica has its own copy of the
+ * headers. However L3 processing can trigger larger changes to the packet.
+ * For example, an ARP request could be turned into an ARP reply, an ICMP
+ * request could be turned into an ICMP reply. If BVI processing is not
+ * performed last, the modified packet would be replicated to the remaining
+ * members.
+ *
+ * Replicas are buffer clones: the payload is shared and reference counted,
+ * only the first VLIB_BUFFER_CLONE_HEAD_SIZE bytes are copied per member.
+ * The replicas are queued with their next node in packet order and handed
+ * to vlib_buffer_enqueue_to_next in batches, so that each member sees the
+ * flooded packets in the order they were received.
  */
 VLIB_NODE_FN (l2flood_node) (vlib_main_t * vm,
 			     vlib_node_runtime_t * node, vlib_frame_t * frame)
 {
-  u32 n_left_from, *from, *to_next;
-  l2flood_next_t next_index;
   l2flood_main_t *msm = &l2flood_main;
   u32 thread_index = vm->thread_index;
+  l2flood_per_thread_stats_t *ts;
+  u8 cycle_stats = msm->cycle_stats_enabled;
+  u64 n_replicas = 0, cycles = 0, t0 = 0;
+  u32 n_left_from, *from, *to_next;
+  u16 *nexts;
 
   from = vlib_frame_vector_args (frame);
   n_left_from = frame->n_vectors;
-  next_index = node->cached_next_index;
+
+  to_next = msm->to_next[thread_index];
+  nexts = msm->nexts[thread_index];
+  vec_reset_length (to_next);
+  vec_reset_length (nexts);
 
   while (n_left_from > 0)
     {
-      u32 n_left_to_next;
-
-      vlib_get_next_frame (vm, node, next_index, to_next, n_left_to_next);
-
-      while (n_left_from > 0 && n_left_to_next > 0)
+      u32 n_targets, n_cloned, sw_if_index0, bi0, ci0, target0, i;
+      l2_bridge_domain_t *bd_config;
+      l2_flood_member_t *member;
+      vlib_buffer_t *b0, *c0;
+      u32 *targets, *clones;
+      u16 next0;
+      u8 in_shg;
+
+      bi0 = from[0];
+      from += 1;
+      n_left_from -= 1;
+      next0 = L2FLOOD_NEXT_L2_OUTPUT;
+
+      b0 = vlib_get_buffer (vm, bi0);
+
+      /* Get config for the bridge domain interface */
+      bd_config = vec_elt_at_index (l2input_main.bd_configs,
+				    vnet_buffer (b0)->l2.bd_index);
+      in_shg = vnet_buffer (b0)->l2.shg;
+      sw_if_index0 = vnet_buffer (b0)->sw_if_index[VLIB_RX];
+
+      targets = msm->members[thread_index];
+      vec_reset_length (targets);
+
+      if (PREDICT_TRUE (0 == in_shg))
+	{
+	  /* Only the reflection check applies: copy the BD's list around
+	   * the ingress interface */
+	  u32 *list = bd_config->flood_sw_if_indices;
+	  u32 n_list = vec_len (list);
+
+	  for (i = 0; i < n_list; i++)
+	    if (list[i] == sw_if_index0)
+	      break;
+
+	  vec_add (targets, list, i);
+	  if (i < n_list)
+	    vec_add (targets, list + i + 1, n_list - i - 1);
+	}
+      else
 	{
-	  u16 n_clones, n_cloned, clone0;
-	  l2_bridge_domain_t *bd_config;
-	  u32 sw_if_index0, bi0, ci0;
-	  l2_flood_member_t *member;
-	  vlib_buffer_t *b0, *c0;
-	  u16 next0;
-	  u8 in_shg;
-	  i32 mi;
-
-	  /* speculatively enqueue b0 to the current next frame */
-	  bi0 = from[0];
-	  from += 1;
-	  n_left_from -= 1;
-	  next0 = L2FLOOD_NEXT_L2_OUTPUT;
-
-	  b0 = vlib_get_buffer (vm, bi0);
-
-	  /* Get config for the bridge domain interface */
-	  bd_config = vec_elt_at_index (l2input_main.bd_configs,
-					vnet_buffer (b0)->l2.bd_index);
-	  in_shg = vnet_buffer (b0)->l2.shg;
-	  sw_if_index0 = vnet_buffer (b0)->sw_if_index[VLIB_RX];
-
-	  vec_validate (msm->members[thread_index],
-			vec_len (bd_config->members));
-
-	  vec_reset_length (msm->members[thread_index]);
-
-	  /* Find first members that passes the reflection and SHG checks */
-	  for (mi = bd_config->flood_count - 1; mi >= 0; mi--)
+	  /* Find the members that pass the reflection and SHG checks */
+	  for (i = bd_config->flood_count; i > 0; i--)
 	    {
-	      member = &bd_config->members[mi];
+	      member = &bd_config->members[i - 1];
 	      if ((member->sw_if_index != sw_if_index0) &&
-		  (!in_shg || (member->shg != in_shg)))
-		{
-		  vec_add1 (msm->members[thread_index], member);
-		}
+		  (member->shg != in_shg))
+		vec_add1 (targets, member->sw_if_index);
 	    }
+	}
 
-	  n_clones = vec_len (msm->members[thread_index]);
+      msm->members[thread_index] = targets;
+      n_targets = vec_len (targets);
 
-	  if (0 == n_clones)
-	    {
-	      /* No members to flood to */
-	      to_next[0] = bi0;
-	      to_next += 1;
-	      n_left_to_next -= 1;
-
-	      b0->error = node->errors[L2FLOOD_ERROR_NO_MEMBERS];
-	      vlib_validate_buffer_enqueue_x1 (vm, node, next_index,
-					       to_next, n_left_to_next,
-					       bi0, L2FLOOD_NEXT_DROP);
-	      continue;
-	    }
-	  else if (n_clones > 1)
-	    {
-	      vec_validate (msm->clones[thread_index], n_clones);
-
-	      /*
-	       * the header offset needs to be large enough to incorporate
-	       * all the L3 headers that could be touched when doing BVI
-	       * processing. So take the current l2 length plus 2 * IPv6
-	       * headers (for tunnel encap)
-	       */
-	      n_cloned = vlib_buffer_clone (vm, bi0,
-					    msm->clones[thread_index],
-					    n_clones,
-					    VLIB_BUFFER_CLONE_HEAD_SIZE);
-
-	      vec_set_len (msm->clones[thread_index], n_cloned);
-
-	      if (PREDICT_FALSE (n_cloned != n_clones))
-		{
-		  b0->error = node->errors[L2FLOOD_ERROR_REPL_FAIL];
-		  /* Worst-case, no clones, consume the original buf */
-		  if (n_cloned == 0)
-		    {
-		      ci0 = bi0;
-		      member = msm->members[thread_index][0];
-		      goto use_original_buffer;
-		    }
-		}
+      if (0 == n_targets)
+	{
+	  /* No members to flood to */
+	  b0->error = node->errors[L2FLOOD_ERROR_NO_MEMBERS];
+	  vec_add1 (to_next, bi0);
+	  vec_add1 (nexts, L2FLOOD_NEXT_DROP);
+	  continue;
+	}
+      else if (n_targets > 1)
+	{
+	  if (PREDICT_FALSE (cycle_stats))
+	    t0 = clib_cpu_time_now ();
 
-	      /*
-	       * for all but the last clone, these are not BVI bound
-	       */
-	      for (clone0 = 0; clone0 < n_cloned - 1; clone0++)
-		{
-		  member = msm->members[thread_index][clone0];
-		  ci0 = msm->clones[thread_index][clone0];
-		  c0 = vlib_get_buffer (vm, ci0);
-
-		  to_next[0] = ci0;
-		  to_next += 1;
-		  n_left_to_next -= 1;
-
-		  if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE) &&
-				     (b0->flags & VLIB_BUFFER_IS_TRACED)))
-		    {
-		      ethernet_header_t *h0;
-		      l2flood_trace_t *t;
-
-		      t = vlib_add_trace (vm, node, c0, sizeof (*t));
-		      h0 = vlib_buffer_get_current (c0);
-		      t->sw_if_index = sw_if_index0;
-		      t->bd_index = vnet_buffer (c0)->l2.bd_index;
-		      clib_memcpy_fast (t->src, h0->src_address, 6);
-		      clib_memcpy_fast (t->dst, h0->dst_address, 6);
-		    }
-
-		  /* Do normal L2 forwarding */
-		  vnet_buffer (c0)->sw_if_index[VLIB_TX] =
-		    member->sw_if_index;
-
-		  vlib_validate_buffer_enqueue_x1 (vm, node, next_index,
-						   to_next, n_left_to_next,
-						   ci0, next0);
-		  if (PREDICT_FALSE (0 == n_left_to_next))
-		    {
-		      vlib_put_next_frame (vm, node, next_index,
-					   n_left_to_next);
-		      vlib_get_next_frame (vm, node, next_index, to_next,
-					   n_left_to_next);
-		    }
-		}
-	      member = msm->members[thread_index][clone0];
-	      ci0 = msm->clones[thread_index][clone0];
-	    }
-	  else
-	    {
-	      /* one clone */
-	      ci0 = bi0;
-	      member = msm->members[thread_index][0];
-	    }
+	  vec_validate (msm->clones[thread_index], n_targets);
+	  clones = msm->clones[thread_index];
 
-	use_original_buffer:
 	  /*
-	   * the last clone that might go to a BVI
+	   * the header offset needs to be large enough to incorporate
+	   * all the L3 headers that could be touched when doing BVI
+	   * processing. So take the current l2 length plus 2 * IPv6
+	   * headers (for tunnel encap)
 	   */
-	  c0 = vlib_get_buffer (vm, ci0);
+	  n_cloned = vlib_buffer_clone (vm, bi0, clones, n_targets,
+					VLIB_BUFFER_CLONE_HEAD_SIZE);
 
-	  to_next[0] = ci0;
-	  to_next += 1;
-	  n_left_to_next -= 1;
+	  vec_set_len (clones, n_cloned);
 
-	  if (PREDICT_FALSE ((node->flags & VLIB_NODE_FLAG_TRACE) &&
-			     (b0->flags & VLIB_BUFFER_IS_TRACED)))
+	  if (PREDICT_FALSE (n_cloned != n_targets))
 	    {
-	      ethernet_header_t *h0;
-	      l2flood_trace_t *t;
-
-	      t = vlib_add_trace (vm, node, c0, sizeof (*t));
-	      h0 = vlib_buffer_get_current (c0);
-	      t->sw_if_index = sw_if_index0;
-	      t->bd_index = vnet_buffer (c0)->l2.bd_index;
-	      clib_memcpy_fast (t->src, h0->src_address, 6);
-	      clib_memcpy_fast (t->dst, h0->dst_address, 6);
-	    }
-	  /* Forward packet to the current member */
-	  if (PREDICT_FALSE (member->flags & L2_FLOOD_MEMBER_BVI))
-	    {
-	      /* Do BVI processing */
-	      u32 rc;
-	      rc = l2_to_bvi (vm,
-			      msm->vnet_main,
-			      c0, member->sw_if_index, &msm->l3_next, &next0);
-
-	      if (PREDICT_FALSE (rc != TO_BVI_ERR_OK))
+	      b0->error = node->errors[L2FLOOD_ERROR_REPL_FAIL];
+	      /* Worst-case, no clones, consume the original buf */
+	      if (n_cloned == 0)
 		{
-		  if (rc == TO_BVI_ERR_BAD_MAC)
-		    {
-		      c0->error = node->errors[L2FLOOD_ERROR_BVI_BAD_MAC];
-		    }
-		  else if (rc == TO_BVI_ERR_ETHERTYPE)
-		    {
-		      c0->error = node->errors[L2FLOOD_ERROR_BVI_ETHERTYPE];
-		    }
-		  next0 = L2FLOOD_NEXT_DROP;
+		  ci0 = bi0;
+		  target0 = targets[0];
+		  goto last_replica;
 		}
 	    }
-	  else
+
+	  /*
+	   * for all but the last clone, these are not BVI bound
+	   */
+	  for (i = 0; i < n_cloned - 1; i++)
 	    {
+	      c0 = vlib_get_buffer (vm, clones[i]);
 	      /* Do normal L2 forwarding */
-	      vnet_buffer (c0)->sw_if_index[VLIB_TX] = member->sw_if_index;
+	      vnet_buffer (c0)->sw_if_index[VLIB_TX] = targets[i];
+	      l2flood_trace_replica (vm, node, b0, c0, sw_if_index0);
 	    }
 
-	  vlib_validate_buffer_enqueue_x1 (vm, node, next_index,
-					   to_next, n_left_to_next,
-					   ci0, next0);
-	  if (PREDICT_FALSE (0 == n_left_to_next))
+	  vec_add (to_next, clones, n_cloned - 1);
+	  i = vec_len (nexts);
+	  vec_resize (nexts, n_cloned - 1);
+	  clib_memset_u16 (nexts + i, L2FLOOD_NEXT_L2_OUTPUT, n_cloned - 1);
+
+	  ci0 = clones[n_cloned - 1];
+	  target0 = targets[n_cloned - 1];
+
+	  n_replicas += n_cloned;
+	  if (PREDICT_FALSE (cycle_stats))
+	    cycles += clib_cpu_time_now () - t0;
+	}
+      else
+	{
+	  /* one clone */
+	  ci0 = bi0;
+	  target0 = targets[0];
+	}
+
+    last_replica:
+      /*
+       * the last clone that might go to a BVI
+       */
+      c0 = vlib_get_buffer (vm, ci0);
+      l2flood_trace_replica (vm, node, b0, c0, sw_if_index0);
+
+      /* Forward packet to the current member */
+      member = &bd_config->members[0];
+      if (PREDICT_FALSE ((member->flags & L2_FLOOD_MEMBER_BVI) &&
+			 target0 == member->sw_if_index))
+	{
+	  /* Do BVI processing */
+	  u32 rc;
+	  rc = l2_to_bvi (vm,
+			  msm->vnet_main,
+			  c0, target0, &msm->l3_next, &next0);
+
+	  if (PREDICT_FALSE (rc != TO_BVI_ERR_OK))
 	    {
-	      vlib_put_next_frame (vm, node, next_index, n_left_to_next);
-	      vlib_get_next_frame (vm, node, next_index,
-				   to_next, n_left_to_next);
+	      if (rc == TO_BVI_ERR_BAD_MAC)
+		{
+		  c0->error = node->errors[L2FLOOD_ERROR_BVI_BAD_MAC];
+		}
+	      else if (rc == TO_BVI_ERR_ETHERTYPE)
+		{
+		  c0->error = node->errors[L2FLOOD_ERROR_BVI_ETHERTYPE];
+		}
+	      next0 = L2FLOOD_NEXT_DROP;
 	    }
 	}
+      else
+	{
+	  /* Do normal L2 forwarding */
+	  vnet_buffer (c0)->sw_if_index[VLIB_TX] = target0;
+	}
+
+      vec_add1 (to_next, ci0);
+      vec_add1 (nexts, next0);
 
-      vlib_put_next_frame (vm, node, next_index, n_left_to_next);
+      /* flush once a frame's worth is queued, keeps the vectors small */
+      if (vec_len (to_next) >= VLIB_FRAME_SIZE)
+	{
+	  vlib_buffer_enqueue_to_next (vm, node, to_next, nexts,
+				       vec_len (to_next));
+	  vec_reset_length (to_next);
+	  vec_reset_length (nexts);
+	}
     }
 
+  if (vec_len (to_next))
+    vlib_buffer_enqueue_to_next (vm, node, to_next, nexts, vec_len (to_next));
+
+  msm->to_next[thread_index] = to_next;
+  msm->nexts[thread_index] = nexts;
+
+  ts = vec_elt_at_index (msm->stats, thread_index);
+  ts->n_packets += frame->n_vectors;
+  ts->n_replicas += n_replicas;
+  ts->replication_cycles += cycles;
+
   vlib_node_increment_counter (vm, node->node_index,
 			       L2FLOOD_ERROR_L2FLOOD, frame->n_vectors);
 
@@ -391,6 +421,10 @@ l2flood_init (vlib_main_t * vm)
 
   vec_validate (mp->clones, vlib_num_workers ());
   vec_validate (mp->members, vlib_num_workers ());
+  vec_validate (mp->to_next, vlib_num_workers ());
+  vec_validate (mp->nexts, vlib_num_workers ());
+  vec_validate_aligned (mp->stats, vlib_num_workers (),
+			CLIB_CACHE_LINE_BYTES);
 
   /* Initialize the feature next-node indexes */
   feat_bitmap_init_next_nodes (vm,
@@ -472,6 +506,104 @@ VLIB_CLI_COMMAND (int_flood_cli, static) = {
   .function = int_flood,
 };
 
+static clib_error_t *
+set_l2flood_cycle_statistics (vlib_main_t * vm, unformat_input_t * input,
+			      vlib_cli_command_t * cmd)
+{
+  l2flood_main_t *mp = &l2flood_main;
+  u8 enable = 1;
+
+  if (unformat (input, "disable"))
+    enable = 0;
+
+  mp->cycle_stats_enabled = enable;
+
+  return 0;
+}
+
+/*?
+ * Count the CPU cycles l2 flood spends replicating packets, reported
+ * as cycles/replica by 'show l2flood statistics'. Reading the time
+ * stamp counter per flooded packet is not free, so this is disabled
+ * by default.
+ *
+ * @cliexpar
+ * @cliexcmd{set l2flood cycle-statistics}
+ * @cliexcmd{set l2flood cycle-statistics disable}
+?*/
+VLIB_CLI_COMMAND (set_l2flood_cycle_statistics_cli, static) = {
+  .path = "set l2flood cycle-statistics",
+  .short_help = "set l2flood cycle-statistics [disable]",
+  .function = set_l2flood_cycle_statistics,
+};
+
+static clib_error_t *
+show_l2flood_statistics (vlib_main_t * vm,
+			 unformat_input_t * input, vlib_cli_command_t * cmd)
+{
+  l2flood_main_t *mp = &l2flood_main;
+  l2flood_per_thread_stats_t *ts;
+
+  vlib_cli_output (vm, "%-8s%16s%16s%16s", "thread", "packets", "replicas",
+		   "cycles/replica");
+  vec_foreach (ts, mp->stats)
+  {
+    vlib_cli_output (vm, "%-8d%16llu%16llu%16.2f",
+		     ts - mp->stats, ts->n_packets, ts->n_replicas,
+		     ts->n_replicas ?
+		     (f64) ts->replication_cycles / (f64) ts->n_replicas : 0);
+  }
+
+  return 0;
+}
+
+/*?
+ * Display per-thread l2 flood replication statistics: the number of
+ * flooded packets, the number of replicas made by cloning and the
+ * average number of CPU cycles spent making each replica, when enabled
+ * with 'set l2flood cycle-statistics'.
+ *
+ * @cliexpar
+ * @cliexstart{show l2flood statistics}
+ * thread          packets        replicas  cycles/replica
+ * 0                  1024           32768           21.37
+ * @cliexend
+?*/
+VLIB_CLI_COMMAND (show_l2flood_statistics_cli, static) = {
+  .path = "show l2flood statistics",
+  .short_help = "show l2flood statistics",
+  .function = show_l2flood_statistics,
+};
+
+static clib_error_t *
+clear_l2flood_statistics (vlib_main_t * vm,
+			  unformat_input_t * input, vlib_cli_command_t * cmd)
+{
+  l2flood_main_t *mp = &l2flood_main;
+  l2flood_per_thread_stats_t *ts;
+
+  vec_foreach (ts, mp->stats)
+  {
+    ts->n_packets = 0;
+    ts->n_replicas = 0;
+    ts->replication_cycles = 0;
+  }
+
+  return 0;
+}
+
+/*?
+ * Clear the l2 flood replication statistics.
+ *
+ * @cliexpar
+ * @cliexcmd{clear l2flood statistics}
+?*/
+VLIB_CLI_COMMAND (clear_l2flood_statistics_cli, static) = {
+  .path = "clear l2flood statistics",
+  .short_help = "clear l2flood statistics",
+  .function = clear_l2flood_statistics,
+};
+
 /*
  * fd.io coding-style-patch-verification: ON
  *
@@ -82,7 +82,8 @@ _(MAC_MOVE,          "L2 mac moves")			\
 _(MAC_MOVE_VIOLATE,  "L2 mac move violations")		\
 _(LIMIT,             "L2 not learned due to limit")	\
 _(HIT_UPDATE,        "L2 learn hit updates")		\
-_(FILTER_DROP,       "L2 filter mac drops")
+_(FILTER_DROP,       "L2 filter mac drops")		\
+_(QUEUE_FULL,        "L2 learn queue full")
 
 typedef enum
 {
@@ -106,11 +107,37 @@ typedef enum
 } l2learn_next_t;
 
 
+/** Queue a mac table update for the learner. */
+
+static_always_inline void
+l2learn_enqueue (l2learn_main_t * msm, l2learn_per_thread_data_t * ptd,
+		 u64 * counter_base, BVT (clib_bihash_kv) * kv)
+{
+  u32 mask = msm->learn_queue_size - 1;
+
+  if (kv->key == ptd->last.key && kv->value == ptd->last.value)
+    return;			/* Same update queued already */
+
+  if (ptd->tail - clib_atomic_load_acq_n (&ptd->head) > mask)
+    {
+      /* the packets of this mac will queue it again */
+      counter_base[L2LEARN_ERROR_QUEUE_FULL] += 1;
+      ptd->n_queue_full++;
+      return;
+    }
+
+  ptd->queue[ptd->tail & mask] = *kv;
+  clib_atomic_store_rel_n (&ptd->tail, ptd->tail + 1);
+  ptd->last = *kv;
+  ptd->n_queued++;
+}
+
 /** Perform learning on one packet based on the mac table lookup result. */
 
 static_always_inline void
 l2learn_process (vlib_node_runtime_t * node,
 		 l2learn_main_t * msm,
+		 l2learn_per_thread_data_t * ptd,
 		 u64 * counter_base,
 		 vlib_buffer_t * b0,
 		 u32 sw_if_index0,
@@ -176,9 +203,13 @@ l2learn_process (vlib_node_runtime_t * node,
       /* It is ok to learn */
       /* learn_count variable may have little inaccuracy because they are not
        * incremented/decremented with atomic operations */
-      /* l2fib_scan is call every 2sec fixing potential inaccuracy */
-      msm->global_learn_count++;
-      bd_config->learn_count++;
+      /* the mac age scanner corrects them once per aging interval */
+      /* with the learn queues, the learner keeps the counts */
+      if (!ptd)
+	{
+	  msm->global_learn_count++;
+	  bd_config->learn_count++;
+	}
       result0->raw = 0;		/* clear all fields */
       result0->fields.sw_if_index = sw_if_index0;
       if (msm->client_pid != 0)
@@ -219,9 +250,12 @@ l2learn_process (vlib_node_runtime_t * node,
 	  /* The mac was provisioned */
 	  /* learn_count variable may have little inaccuracy because they are
 	   * not incremented/decremented with atomic operations */
-	  /* l2fib_scan is call every 2sec fixing potential inaccuracy */
-	  msm->global_learn_count++;
-	  bd_config->learn_count++;
+	  /* the mac age scanner corrects them once per aging interval */
+	  if (!ptd)
+	    {
+	      msm->global_learn_count++;
+	      bd_config->learn_count++;
+	    }
 
 	  l2fib_entry_result_clear_AGE_NOT (result0);
 	}
@@ -243,6 +277,14 @@ l2learn_process (vlib_node_runtime_t * node,
   BVT (clib_bihash_kv) kv;
   kv.key = key0->raw;
   kv.value = result0->raw;
+
+  if (ptd)
+    {
+      /* Leave the update to the learner */
+      l2learn_enqueue (msm, ptd, counter_base, &kv);
+      return;
+    }
+
   BV (clib_bihash_add_del) (msm->mac_table, &kv, 1 /* is_add */ );
 
   /* Invalidate the cache */
@@ -265,6 +307,15 @@ l2learn_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
   u32 count = 0;
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
   u16 nexts[VLIB_FRAME_SIZE], *next;
+  l2learn_per_thread_data_t *ptd = 0;
+  u64 n_queued = 0;
+
+  if (msm->learn_queue_size)
+    {
+      ptd = vec_elt_at_index (msm->per_thread_data, vm->thread_index);
+      ptd->last.key = ~0ULL;
+      n_queued = ptd->n_queued;
+    }
 
   from = vlib_frame_vector_args (frame);
   n_left = frame->n_vectors;	/* number of packets to process */
@@ -367,19 +418,23 @@ l2learn_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		      &key0, &key1, &key2, &key3,
 		      &result0, &result1, &result2, &result3);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, ptd,
+		       &em->counters[node_counter_base_index],
 		       b[0], sw_if_index0, &key0, &cached_key,
 		       &count, &result0, next, timestamp);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, ptd,
+		       &em->counters[node_counter_base_index],
 		       b[1], sw_if_index1, &key1, &cached_key,
 		       &count, &result1, next + 1, timestamp);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, ptd,
+		       &em->counters[node_counter_base_index],
 		       b[2], sw_if_index2, &key2, &cached_key,
 		       &count, &result2, next + 2, timestamp);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, ptd,
+		       &em->counters[node_counter_base_index],
 		       b[3], sw_if_index3, &key3, &cached_key,
 		       &count, &result3, next + 3, timestamp);
 
@@ -417,7 +472,8 @@ l2learn_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 		      h0->src_address, vnet_buffer (b[0])->l2.bd_index,
 		      &key0, &result0);
 
-      l2learn_process (node, msm, &em->counters[node_counter_base_index],
+      l2learn_process (node, msm, ptd,
+		       &em->counters[node_counter_base_index],
 		       b[0], sw_if_index0, &key0, &cached_key,
 		       &count, &result0, next, timestamp);
 
@@ -428,6 +484,11 @@ l2learn_node_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 
   vlib_buffer_enqueue_to_next (vm, node, from, nexts, frame->n_vectors);
 
+  /* Kick the learner on the main thread */
+  if (ptd && ptd->n_queued != n_queued)
+    vlib_node_set_interrupt_pending (vlib_get_main_by_index (0),
+				     msm->learner_node_index);
+
   return frame->n_vectors;
 }
 
@@ -458,6 +519,112 @@ VLIB_REGISTER_NODE (l2learn_node) = {
 };
 
 #ifndef CLIB_MARCH_VARIANT
+/**
+ * Apply one queued update to the mac table. The entry may have changed
+ * since l2-learn queued the update, so the decision is taken again
+ * against the current entry.
+ */
+static void
+l2learn_apply (l2learn_main_t * lm, BVT (clib_bihash_kv) * kv, u64 hash)
+{
+  l2fib_entry_key_t key = {.raw = kv->key };
+  l2fib_entry_result_t result = {.raw = kv->value };
+  l2_bridge_domain_t *bd_config;
+  BVT (clib_bihash_kv) old;
+  int is_learn = 1;
+
+  if (key.fields.bd_index >= vec_len (l2input_main.bd_configs))
+    return;
+  bd_config = vec_elt_at_index (l2input_main.bd_configs,
+				key.fields.bd_index);
+
+  old.key = kv->key;
+  if (!BV (clib_bihash_search_inline_with_hash) (lm->mac_table, hash, &old))
+    {
+      l2fib_entry_result_t old_result = {.raw = old.value };
+
+      if (l2fib_entry_result_is_set_STATIC (&old_result) ||
+	  l2fib_entry_result_is_set_FILTER (&old_result))
+	return;			/* Provisioned since queued */
+      if (!l2fib_entry_result_is_set_AGE_NOT (&old_result))
+	is_learn = 0;		/* Refresh or move of a learned mac */
+      else if (old_result.fields.sw_if_index == result.fields.sw_if_index)
+	return;			/* Provisioned mac, no aging */
+    }
+
+  if (is_learn)
+    {
+      if ((lm->global_learn_count >= lm->global_learn_limit) ||
+	  (bd_config->learn_count >= bd_config->learn_limit))
+	{
+	  lm->n_learner_limit++;
+	  return;
+	}
+      lm->global_learn_count++;
+      bd_config->learn_count++;
+    }
+
+  BV (clib_bihash_add_del_with_hash) (lm->mac_table, kv, hash, 1);
+  lm->n_learner_updates++;
+}
+
+/**
+ * Drain the per-thread learn queues in batches. All the mac table
+ * updates of the learned macs are done from here, so the workers never
+ * contend on the mac table writer locks.
+ */
+static uword
+l2learner_node_fn (vlib_main_t * vm, vlib_node_runtime_t * node,
+		   vlib_frame_t * frame)
+{
+  l2learn_main_t *lm = &l2learn_main;
+  u32 mask = lm->learn_queue_size - 1;
+  u64 hashes[L2LEARN_LEARNER_BATCH];
+  l2learn_per_thread_data_t *ptd;
+  int more = 0;
+  f64 now;
+
+  vec_foreach (ptd, lm->per_thread_data)
+    {
+      u32 head = ptd->head;
+      u32 n_left = clib_atomic_load_acq_n (&ptd->tail) - head;
+      u32 i, n = clib_min (n_left, L2LEARN_LEARNER_BATCH);
+
+      /* hash the batch and prefetch the buckets first */
+      for (i = 0; i < n; i++)
+	{
+	  hashes[i] = BV (clib_bihash_hash) (&ptd->queue[(head + i) & mask]);
+	  BV (clib_bihash_prefetch_bucket) (lm->mac_table, hashes[i]);
+	}
+      for (i = 0; i < n; i++)
+	l2learn_apply (lm, &ptd->queue[(head + i) & mask], hashes[i]);
+
+      clib_atomic_store_rel_n (&ptd->head, head + n);
+      more |= n_left > n;
+    }
+
+  /* Come back for the rest */
+  if (more)
+    vlib_node_set_interrupt_pending (vm, node->node_index);
+
+  now = vlib_time_now (vm);
+  if (now - lm->learn_rate_time >= 1.0)
+    {
+      lm->learn_rate = (lm->n_learner_updates - lm->learn_rate_updates) /
+	(now - lm->learn_rate_time);
+      lm->learn_rate_updates = lm->n_learner_updates;
+      lm->learn_rate_time = now;
+    }
+  return 0;
+}
+
+VLIB_REGISTER_NODE (l2learner_node) = {
+  .function = l2learner_node_fn,
+  .name = "l2-learner",
+  .type = VLIB_NODE_TYPE_INPUT,
+  .state = VLIB_NODE_STATE_INTERRUPT,
+};
+
 clib_error_t *
 l2learn_init (vlib_main_t * vm)
 {
@@ -476,6 +643,8 @@ l2learn_init (vlib_main_t * vm)
   /* init the hash table ptr */
   mp->mac_table = get_mac_table ();
 
+  mp->learner_node_index = l2learner_node.index;
+
   /*
    * Set the default number of dynamically learned macs to the number
    * of buckets.
@@ -549,17 +718,33 @@ static clib_error_t *
 l2learn_config (vlib_main_t * vm, unformat_input_t * input)
 {
   l2learn_main_t *mp = &l2learn_main;
+  l2learn_per_thread_data_t *ptd;
+  u32 queue_size = 0;
 
   while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
     {
       if (unformat (input, "limit %d", &mp->global_learn_limit))
 	;
 
+      else if (unformat (input, "queue-size %u", &queue_size))
+	;
+
       else
 	return clib_error_return (0, "unknown input `%U'",
 				  format_unformat_error, input);
     }
 
+  if (queue_size)
+    {
+      mp->learn_queue_size = max_pow2 (queue_size);
+      vec_validate_aligned (mp->per_thread_data,
+			    vlib_get_thread_main ()->n_vlib_mains - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      vec_foreach (ptd, mp->per_thread_data)
+	vec_validate_aligned (ptd->queue, mp->learn_queue_size - 1,
+			      CLIB_CACHE_LINE_BYTES);
+    }
+
   return 0;
 }
 
@@ -23,6 +23,31 @@
 #include <vnet/ethernet/ethernet.h>
 
 
+/*
+ * Per-thread queue of mac table updates, filled by l2-learn on the
+ * thread and drained in batches by the l2-learner on the main thread.
+ */
+typedef struct
+{
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline0);
+
+  /* written by the owner thread */
+  BVT (clib_bihash_kv) * queue;
+  u32 tail;
+
+  /* last queued update, to skip duplicates within a burst */
+  BVT (clib_bihash_kv) last;
+
+  /* updates queued, and dropped because the queue was full */
+  u64 n_queued;
+  u64 n_queue_full;
+
+  CLIB_CACHE_LINE_ALIGN_MARK (cacheline1);
+
+  /* written by the learner */
+  u32 head;
+} l2learn_per_thread_data_t;
+
 typedef struct
 {
 
@@ -38,6 +63,25 @@ typedef struct
   /* maximum number of dynamically learned mac entries per bridge domain */
   u32 bd_default_learn_limit;
 
+  /*
+   * Per-thread learn queues, and their size. When the size is 0 the
+   * mac table is updated directly by l2-learn.
+   */
+  l2learn_per_thread_data_t *per_thread_data;
+  u32 learn_queue_size;
+
+  /* l2-learner node, interrupted by l2-learn when there are updates */
+  u32 learner_node_index;
+
+  /* updates applied by the learner, and dropped due to the learn limits */
+  u64 n_learner_updates;
+  u64 n_learner_limit;
+
+  /* updates per second applied by the learner, and when it was measured */
+  f64 learn_rate;
+  f64 learn_rate_time;
+  u64 learn_rate_updates;
+
   /* client waiting for L2 MAC events for learned and aged MACs */
   u32 client_pid;
   u32 client_index;
@@ -52,6 +96,9 @@ typedef struct
 
 #define L2LEARN_DEFAULT_LIMIT (L2FIB_NUM_BUCKETS * 64)
 
+/* Max updates the learner applies from one queue per run */
+#define L2LEARN_LEARNER_BATCH 256
+
 extern l2learn_main_t l2learn_main;
 
 extern vlib_node_registration_t l2fib_mac_age_scanner_process_node;
@@ -596,6 +596,24 @@ policer_classify_inline (vlib_main_t * vm,
 		}
 	      else
 		{
+		  vnet_classify_table_t
+		    *chain_tables[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+		  u32 chain_hashes[VNET_CLASSIFY_CHAIN_MAX_TABLES];
+		  vnet_classify_chain_t *c0 = 0;
+		  u32 chain_pos0 = 0;
+
+		  /* Tables always match at b->data here, so compiled chains
+		   * can be used unless some table uses the current data */
+		  if (t0->chain_index != ~0)
+		    {
+		      c0 = vnet_classify_chain_get (t0->chain_index);
+		      if (c0->use_current_data)
+			c0 = 0;
+		      else
+			vnet_classify_chain_hash_prefetch (
+			  c0, h0, h0, chain_tables, chain_hashes);
+		    }
+
 		  while (1)
 		    {
 		      if (PREDICT_TRUE (t0->next_table_index != ~0))
@@ -611,7 +629,8 @@ policer_classify_inline (vlib_main_t * vm,
 			  break;
 			}
 
-		      hash0 = vnet_classify_hash_packet (t0, (u8 *) h0);
+		      hash0 = c0 ? chain_hashes[++chain_pos0] :
+				   vnet_classify_hash_packet (t0, (u8 *) h0);
 		      e0 =
 			vnet_classify_find_entry (t0, (u8 *) h0, hash0, now);
 		      if (e0)
@@ -1088,6 +1088,31 @@ format_segment_manager (u8 *s, va_list *args)
   return s;
 }
 
+void
+segment_manager_collect_stats (segment_manager_stats_t *stats)
+{
+  segment_manager_main_t *smm = &sm_main;
+  segment_manager_t *sm;
+  fifo_segment_t *fs;
+
+  ASSERT (vlib_get_thread_index () == 0);
+
+  clib_memset (stats, 0, sizeof (*stats));
+
+  pool_foreach (sm, smm->segment_managers)
+    {
+      segment_manager_foreach_segment_w_lock (fs, sm, ({
+	stats->n_segments += 1;
+	stats->size += fifo_segment_size (fs);
+	stats->free_bytes += fifo_segment_free_bytes (fs);
+	stats->cached_bytes += fifo_segment_cached_bytes (fs);
+	stats->reclaimed_chunks += fifo_segment_num_reclaimed_chunks (fs);
+	stats->split_chunks += fifo_segment_num_split_chunks (fs);
+	stats->split_lost_bytes += fifo_segment_split_lost_bytes (fs);
+      }));
+    }
+}
+
 static clib_error_t *
 segment_manager_show_fn (vlib_main_t * vm, unformat_input_t * input,
 			 vlib_cli_command_t * cmd)
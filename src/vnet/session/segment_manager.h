@@ -190,6 +190,32 @@ void segment_manager_format_sessions (segment_manager_t * sm, int verbose);
 
 void segment_manager_main_init (void);
 
+#define foreach_segment_manager_stat					\
+  _ (n_segments, "fifo_segments")					\
+  _ (size, "fifo_segments_bytes")					\
+  _ (free_bytes, "fifo_segments_free_bytes")				\
+  _ (cached_bytes, "fifo_segments_cached_bytes")			\
+  _ (reclaimed_chunks, "fifo_segments_reclaimed_chunks")		\
+  _ (split_chunks, "fifo_segments_split_chunks")			\
+  _ (split_lost_bytes, "fifo_segments_split_lost_bytes")
+
+typedef struct segment_manager_stats_
+{
+#define _(sym, str) uword sym;
+  foreach_segment_manager_stat
+#undef _
+} segment_manager_stats_t;
+
+/**
+ * Aggregate memory stats of all fifo segments owned by segment managers
+ *
+ * Must be called from main thread, as segment manager pool is only
+ * updated by it.
+ *
+ * @param stats	stats to be filled in
+ */
+void segment_manager_collect_stats (segment_manager_stats_t *stats);
+
 segment_manager_props_t *segment_manager_props_init (segment_manager_props_t *
 						     sm);
 
@@ -1308,7 +1308,7 @@ session_stop_listen (session_t * s)
     return SESSION_E_NONE;
 
   if (!(tc->flags & TRANSPORT_CONNECTION_F_NO_LOOKUP))
-    session_lookup_del_connection (tc);
+    session_lookup_del_listener (tc);
 
   transport_stop_listen (tp, s->connection_index);
   return 0;
@@ -1735,6 +1735,7 @@ session_stats_collector_fn (vlib_stats_collector_data_t *d)
 {
   u32 i, n_workers, n_wrk_sessions, n_sessions = 0;
   session_main_t *smm = &session_main;
+  segment_manager_stats_t sm_stats;
   session_worker_t *wrk;
   counter_t **counters;
   counter_t *cb;
@@ -1755,6 +1756,12 @@ session_stats_collector_fn (vlib_stats_collector_data_t *d)
   vlib_stats_set_gauge (d->private_data, n_sessions);
   vlib_stats_set_gauge (smm->stats_seg_idx.tp_port_alloc_max_tries,
 			transport_port_alloc_max_tries ());
+
+  segment_manager_collect_stats (&sm_stats);
+#define _(sym, str)                                                           \
+  vlib_stats_set_gauge (smm->stats_seg_idx.sym, sm_stats.sym);
+  foreach_segment_manager_stat
+#undef _
 }
 
 static void
@@ -1773,6 +1780,11 @@ session_stats_collector_init (void)
   smm->stats_seg_idx.tp_port_alloc_max_tries =
     vlib_stats_add_gauge ("/sys/session/transport_port_alloc_max_tries");
   vlib_stats_set_gauge (smm->stats_seg_idx.tp_port_alloc_max_tries, 0);
+
+#define _(sym, str)                                                           \
+  smm->stats_seg_idx.sym = vlib_stats_add_gauge ("/sys/session/" str);
+  foreach_segment_manager_stat
+#undef _
 }
 
 static clib_error_t *
@@ -2102,6 +2114,9 @@ session_config_fn (vlib_main_t * vm, unformat_input_t * input)
       else if (unformat (input, "v6-halfopen-table-buckets %d",
 			 &smm->configured_v6_halfopen_table_buckets))
 	;
+      else if (unformat (input, "session-table-shards %d",
+			 &smm->configured_session_table_shards))
+	;
       else if (unformat (input, "v4-session-table-memory %U",
 			 unformat_memory_size, &tmp))
 	{
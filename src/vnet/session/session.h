@@ -21,6 +21,7 @@
 #include <vnet/session/session_debug.h>
 #include <svm/message_queue.h>
 #include <svm/fifo_segment.h>
+#include <vnet/session/segment_manager.h>
 #include <vlib/dma/dma.h>
 
 typedef struct session_wrk_stats_
@@ -202,6 +203,9 @@ typedef enum
 typedef struct session_stats_seg_indices_
 {
   u32 tp_port_alloc_max_tries;
+#define _(sym, str) u32 sym;
+  foreach_segment_manager_stat
+#undef _
 } session_stats_segs_indicies_t;
 
 typedef struct session_main_
@@ -286,6 +290,9 @@ typedef struct session_main_
   u32 configured_v6_halfopen_table_buckets;
   u32 configured_v6_halfopen_table_memory;
 
+  /** Number of shards for established and half-open session tables */
+  u32 configured_session_table_shards;
+
   /** Transport table (preallocation) size parameters */
   u32 local_endpoints_table_memory;
   u32 local_endpoints_table_buckets;
@@ -629,40 +636,11 @@ void session_fifo_tuning (session_t *s, svm_fifo_t *f, session_ft_action_t act,
 			  u32 len);
 
 /**
- * Discards bytes from buffer chain
+ * Enqueue buffer chain
  *
- * It discards n_bytes_to_drop starting at first buffer after chain_b
- */
-always_inline void
-session_enqueue_discard_chain_bytes (vlib_main_t *vm, vlib_buffer_t *b,
-				     vlib_buffer_t **chain_b,
-				     u32 n_bytes_to_drop)
-{
-  vlib_buffer_t *next = *chain_b;
-  u32 to_drop = n_bytes_to_drop;
-  ASSERT (b->flags & VLIB_BUFFER_NEXT_PRESENT);
-  while (to_drop && (next->flags & VLIB_BUFFER_NEXT_PRESENT))
-    {
-      next = vlib_get_buffer (vm, next->next_buffer);
-      if (next->current_length > to_drop)
-	{
-	  vlib_buffer_advance (next, to_drop);
-	  to_drop = 0;
-	}
-      else
-	{
-	  to_drop -= next->current_length;
-	  next->current_length = 0;
-	}
-    }
-  *chain_b = next;
-
-  if (to_drop == 0)
-    b->total_length_not_including_first_buffer -= n_bytes_to_drop;
-}
-
-/**
- * Enqueue buffer chain tail
+ * In-order chains, head included, are written to the fifo with one
+ * segment enqueue. Out-of-order chains only have their tail enqueued at
+ * offset, as the head is enqueued by the caller.
  */
 always_inline int
 session_enqueue_chain_tail (session_t *s, vlib_buffer_t *b, u32 offset,
@@ -674,25 +652,10 @@ session_enqueue_chain_tail (session_t *s, vlib_buffer_t *b, u32 offset,
   if (is_in_order)
     {
       session_worker_t *wrk = session_main_get_worker (s->thread_index);
-      u32 diff, written = 0;
-
-      if (offset)
-	{
-	  diff = offset - b->current_length;
-	  if (diff > b->total_length_not_including_first_buffer)
-	    return 0;
-	  chain_b = b;
-	  session_enqueue_discard_chain_bytes (wrk->vm, b, &chain_b, diff);
-	  chain_bi = vlib_get_buffer_index (wrk->vm, chain_b);
-	}
-      else
-	{
-	  chain_bi = b->next_buffer;
-	}
-
-      chain_b = vlib_get_buffer (wrk->vm, chain_bi);
       svm_fifo_seg_t *seg;
+      int written;
 
+      chain_b = b;
       while (chain_b)
 	{
 	  vec_add2 (wrk->rx_segs, seg, 1);
@@ -763,22 +726,17 @@ session_enqueue_stream_connection (transport_connection_t *tc,
 				   u8 queue_event, u8 is_in_order)
 {
   session_t *s;
-  int enqueued = 0, rv, in_order_off;
+  int enqueued = 0, rv;
 
   s = session_get (tc->s_index, tc->thread_index);
 
   if (is_in_order)
     {
-      enqueued = svm_fifo_enqueue (s->rx_fifo, b->current_length,
-				   vlib_buffer_get_current (b));
-      if (PREDICT_FALSE ((b->flags & VLIB_BUFFER_NEXT_PRESENT) &&
-			 enqueued >= 0))
-	{
-	  in_order_off = enqueued > b->current_length ? enqueued : 0;
-	  rv = session_enqueue_chain_tail (s, b, in_order_off, 1);
-	  if (rv > 0)
-	    enqueued += rv;
-	}
+      if (PREDICT_FALSE (b->flags & VLIB_BUFFER_NEXT_PRESENT))
+	enqueued = session_enqueue_chain_tail (s, b, 0, 1);
+      else
+	enqueued = svm_fifo_enqueue (s->rx_fifo, b->current_length,
+				     vlib_buffer_get_current (b));
     }
   else
     {
@@ -158,6 +158,50 @@ make_v6_ss_kv_from_tc (session_kv6_t * kv, transport_connection_t * tc)
 		 tc->rmt_port, tc->proto);
 }
 
+/**
+ * Add or delete entry in the shard of a sharded session table
+ */
+always_inline int
+session_shards_add_del4 (session_table_t *st, clib_bihash_16_8_t *shards,
+			 session_kv4_t *kv, int is_add)
+{
+  u64 hash = clib_bihash_hash_16_8 (kv);
+  u32 shard = session_table_shard_index (st, hash);
+  return clib_bihash_add_del_with_hash_16_8 (&shards[shard], kv, hash,
+					     is_add);
+}
+
+always_inline int
+session_shards_add_del6 (session_table_t *st, clib_bihash_48_8_t *shards,
+			 session_kv6_t *kv, int is_add)
+{
+  u64 hash = clib_bihash_hash_48_8 (kv);
+  u32 shard = session_table_shard_index (st, hash);
+  return clib_bihash_add_del_with_hash_48_8 (&shards[shard], kv, hash,
+					     is_add);
+}
+
+/**
+ * Search entry in the shard of a sharded session table
+ */
+always_inline int
+session_shards_search4 (session_table_t *st, clib_bihash_16_8_t *shards,
+			session_kv4_t *kv)
+{
+  u64 hash = clib_bihash_hash_16_8 (kv);
+  u32 shard = session_table_shard_index (st, hash);
+  return clib_bihash_search_inline_with_hash_16_8 (&shards[shard], hash, kv);
+}
+
+always_inline int
+session_shards_search6 (session_table_t *st, clib_bihash_48_8_t *shards,
+			session_kv6_t *kv)
+{
+  u64 hash = clib_bihash_hash_48_8 (kv);
+  u32 shard = session_table_shard_index (st, hash);
+  return clib_bihash_search_inline_with_hash_48_8 (&shards[shard], hash, kv);
+}
+
 static inline u8
 session_table_alloc_needs_sync (void)
 {
@@ -291,14 +335,14 @@ session_lookup_add_connection (transport_connection_t * tc, u64 value)
     {
       make_v4_ss_kv_from_tc (&kv4, tc);
       kv4.value = value;
-      return clib_bihash_add_del_16_8 (&st->v4_session_hash, &kv4,
+      return session_shards_add_del4 (st, st->v4_session_shards, &kv4,
 				       1 /* is_add */ );
     }
   else
     {
       make_v6_ss_kv_from_tc (&kv6, tc);
       kv6.value = value;
-      return clib_bihash_add_del_48_8 (&st->v6_session_hash, &kv6,
+      return session_shards_add_del6 (st, st->v6_session_shards, &kv6,
 				       1 /* is_add */ );
     }
 }
@@ -319,14 +363,14 @@ session_lookup_add_session_endpoint (u32 table_index,
       make_v4_listener_kv (&kv4, &sep->ip.ip4, sep->port,
 			   sep->transport_proto);
       kv4.value = value;
-      return clib_bihash_add_del_16_8 (&st->v4_session_hash, &kv4, 1);
+      return clib_bihash_add_del_16_8 (&st->v4_listener_hash, &kv4, 1);
     }
   else
     {
       make_v6_listener_kv (&kv6, &sep->ip.ip6, sep->port,
 			   sep->transport_proto);
       kv6.value = value;
-      return clib_bihash_add_del_48_8 (&st->v6_session_hash, &kv6, 1);
+      return clib_bihash_add_del_48_8 (&st->v6_listener_hash, &kv6, 1);
     }
 }
 
@@ -345,13 +389,13 @@ session_lookup_del_session_endpoint (u32 table_index,
     {
       make_v4_listener_kv (&kv4, &sep->ip.ip4, sep->port,
 			   sep->transport_proto);
-      return clib_bihash_add_del_16_8 (&st->v4_session_hash, &kv4, 0);
+      return clib_bihash_add_del_16_8 (&st->v4_listener_hash, &kv4, 0);
     }
   else
     {
       make_v6_listener_kv (&kv6, &sep->ip.ip6, sep->port,
 			   sep->transport_proto);
-      return clib_bihash_add_del_48_8 (&st->v6_session_hash, &kv6, 0);
+      return clib_bihash_add_del_48_8 (&st->v6_listener_hash, &kv6, 0);
     }
 }
 
@@ -371,13 +415,13 @@ session_lookup_del_session_endpoint2 (session_endpoint_t * sep)
     {
       make_v4_listener_kv (&kv4, &sep->ip.ip4, sep->port,
 			   sep->transport_proto);
-      return clib_bihash_add_del_16_8 (&st->v4_session_hash, &kv4, 0);
+      return clib_bihash_add_del_16_8 (&st->v4_listener_hash, &kv4, 0);
     }
   else
     {
       make_v6_listener_kv (&kv6, &sep->ip.ip6, sep->port,
 			   sep->transport_proto);
-      return clib_bihash_add_del_48_8 (&st->v6_session_hash, &kv6, 0);
+      return clib_bihash_add_del_48_8 (&st->v6_listener_hash, &kv6, 0);
     }
 }
 
@@ -402,17 +446,49 @@ session_lookup_del_connection (transport_connection_t * tc)
   if (tc->is_ip4)
     {
       make_v4_ss_kv_from_tc (&kv4, tc);
-      return clib_bihash_add_del_16_8 (&st->v4_session_hash, &kv4,
+      return session_shards_add_del4 (st, st->v4_session_shards, &kv4,
 				       0 /* is_add */ );
     }
   else
     {
       make_v6_ss_kv_from_tc (&kv6, tc);
-      return clib_bihash_add_del_48_8 (&st->v6_session_hash, &kv6,
+      return session_shards_add_del6 (st, st->v6_session_shards, &kv6,
 				       0 /* is_add */ );
     }
 }
 
+/**
+ * Delete listening transport connection from session table
+ *
+ * Listeners are not added as connections but as session endpoints so
+ * they are looked up in the listener table.
+ *
+ * @param tc		listening transport connection to be removed
+ *
+ * @return non-zero if failure
+ */
+int
+session_lookup_del_listener (transport_connection_t *tc)
+{
+  session_table_t *st;
+  session_kv4_t kv4;
+  session_kv6_t kv6;
+
+  st = session_table_get_for_connection (tc);
+  if (!st)
+    return -1;
+  if (tc->is_ip4)
+    {
+      make_v4_listener_kv (&kv4, &tc->lcl_ip.ip4, tc->lcl_port, tc->proto);
+      return clib_bihash_add_del_16_8 (&st->v4_listener_hash, &kv4, 0);
+    }
+  else
+    {
+      make_v6_listener_kv (&kv6, &tc->lcl_ip.ip6, tc->lcl_port, tc->proto);
+      return clib_bihash_add_del_48_8 (&st->v6_listener_hash, &kv6, 0);
+    }
+}
+
 int
 session_lookup_del_session (session_t * s)
 {
@@ -532,7 +608,7 @@ session_lookup_endpoint_listener (u32 table_index, session_endpoint_t * sep,
 
       make_v4_listener_kv (&kv4, &sep->ip.ip4, sep->port,
 			   sep->transport_proto);
-      rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+      rv = clib_bihash_search_inline_16_8 (&st->v4_listener_hash, &kv4);
       if (rv == 0)
 	return kv4.value;
       if (use_rules)
@@ -554,7 +630,7 @@ session_lookup_endpoint_listener (u32 table_index, session_endpoint_t * sep,
 
       make_v6_listener_kv (&kv6, &sep->ip.ip6, sep->port,
 			   sep->transport_proto);
-      rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+      rv = clib_bihash_search_inline_48_8 (&st->v6_listener_hash, &kv6);
       if (rv == 0)
 	return kv6.value;
 
@@ -624,7 +700,7 @@ session_lookup_local_endpoint (u32 table_index, session_endpoint_t * sep)
        */
       make_v4_listener_kv (&kv4, &sep->ip.ip4, sep->port,
 			   sep->transport_proto);
-      rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+      rv = clib_bihash_search_inline_16_8 (&st->v4_listener_hash, &kv4);
       if (rv == 0)
 	return kv4.value;
 
@@ -635,7 +711,7 @@ session_lookup_local_endpoint (u32 table_index, session_endpoint_t * sep)
       if (ip4_is_local_host (&sep->ip.ip4))
 	{
 	  kv4.key[0] = 0;
-	  rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+	  rv = clib_bihash_search_inline_16_8 (&st->v4_listener_hash, &kv4);
 	  if (rv == 0)
 	    return kv4.value;
 	}
@@ -648,7 +724,7 @@ session_lookup_local_endpoint (u32 table_index, session_endpoint_t * sep)
        * Zero out the port and check if we have proxy
        */
       kv4.key[1] = 0;
-      rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+      rv = clib_bihash_search_inline_16_8 (&st->v4_listener_hash, &kv4);
       if (rv == 0)
 	return kv4.value;
     }
@@ -669,7 +745,7 @@ session_lookup_local_endpoint (u32 table_index, session_endpoint_t * sep)
 
       make_v6_listener_kv (&kv6, &sep->ip.ip6, sep->port,
 			   sep->transport_proto);
-      rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+      rv = clib_bihash_search_inline_48_8 (&st->v6_listener_hash, &kv6);
       if (rv == 0)
 	return kv6.value;
 
@@ -680,7 +756,7 @@ session_lookup_local_endpoint (u32 table_index, session_endpoint_t * sep)
       if (ip6_is_local_host (&sep->ip.ip6))
 	{
 	  kv6.key[0] = kv6.key[1] = 0;
-	  rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+	  rv = clib_bihash_search_inline_48_8 (&st->v6_listener_hash, &kv6);
 	  if (rv == 0)
 	    return kv6.value;
 	}
@@ -693,7 +769,7 @@ session_lookup_local_endpoint (u32 table_index, session_endpoint_t * sep)
        * Zero out the port. Same logic as above.
        */
       kv6.key[4] = kv6.key[5] = 0;
-      rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+      rv = clib_bihash_search_inline_48_8 (&st->v6_listener_hash, &kv6);
       if (rv == 0)
 	return kv6.value;
     }
@@ -711,7 +787,7 @@ session_lookup_listener4_i (session_table_t * st, ip4_address_t * lcl,
    * First, try a fully formed listener
    */
   make_v4_listener_kv (&kv4, lcl, lcl_port, proto);
-  rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+  rv = clib_bihash_search_inline_16_8 (&st->v4_listener_hash, &kv4);
   if (rv == 0)
     return listen_session_get ((u32) kv4.value);
 
@@ -721,7 +797,7 @@ session_lookup_listener4_i (session_table_t * st, ip4_address_t * lcl,
   if (use_wildcard)
     {
       kv4.key[0] = 0;
-      rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+      rv = clib_bihash_search_inline_16_8 (&st->v4_listener_hash, &kv4);
       if (rv == 0)
 	return listen_session_get ((u32) kv4.value);
     }
@@ -734,7 +810,7 @@ session_lookup_listener4_i (session_table_t * st, ip4_address_t * lcl,
    * Zero out port and check if we have a proxy set up for our ip
    */
   make_v4_proxy_kv (&kv4, lcl, proto);
-  rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+  rv = clib_bihash_search_inline_16_8 (&st->v4_listener_hash, &kv4);
   if (rv == 0)
     return listen_session_get ((u32) kv4.value);
 
@@ -760,7 +836,7 @@ session_lookup_listener6_i (session_table_t * st, ip6_address_t * lcl,
   int rv;
 
   make_v6_listener_kv (&kv6, lcl, lcl_port, proto);
-  rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+  rv = clib_bihash_search_inline_48_8 (&st->v6_listener_hash, &kv6);
   if (rv == 0)
     return listen_session_get ((u32) kv6.value);
 
@@ -768,7 +844,7 @@ session_lookup_listener6_i (session_table_t * st, ip6_address_t * lcl,
   if (ip_wildcard)
     {
       kv6.key[0] = kv6.key[1] = 0;
-      rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+      rv = clib_bihash_search_inline_48_8 (&st->v6_listener_hash, &kv6);
       if (rv == 0)
 	return listen_session_get ((u32) kv6.value);
     }
@@ -778,7 +854,7 @@ session_lookup_listener6_i (session_table_t * st, ip6_address_t * lcl,
     }
 
   make_v6_proxy_kv (&kv6, lcl, proto);
-  rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+  rv = clib_bihash_search_inline_48_8 (&st->v6_listener_hash, &kv6);
   if (rv == 0)
     return listen_session_get ((u32) kv6.value);
   return 0;
@@ -849,14 +925,14 @@ session_lookup_add_half_open (transport_connection_t * tc, u64 value)
     {
       make_v4_ss_kv_from_tc (&kv4, tc);
       kv4.value = value;
-      return clib_bihash_add_del_16_8 (&st->v4_half_open_hash, &kv4,
+      return session_shards_add_del4 (st, st->v4_half_open_shards, &kv4,
 				       1 /* is_add */ );
     }
   else
     {
       make_v6_ss_kv_from_tc (&kv6, tc);
       kv6.value = value;
-      return clib_bihash_add_del_48_8 (&st->v6_half_open_hash, &kv6,
+      return session_shards_add_del6 (st, st->v6_half_open_shards, &kv6,
 				       1 /* is_add */ );
     }
 }
@@ -874,13 +950,13 @@ session_lookup_del_half_open (transport_connection_t * tc)
   if (tc->is_ip4)
     {
       make_v4_ss_kv_from_tc (&kv4, tc);
-      return clib_bihash_add_del_16_8 (&st->v4_half_open_hash, &kv4,
+      return session_shards_add_del4 (st, st->v4_half_open_shards, &kv4,
 				       0 /* is_add */ );
     }
   else
     {
       make_v6_ss_kv_from_tc (&kv6, tc);
-      return clib_bihash_add_del_48_8 (&st->v6_half_open_hash, &kv6,
+      return session_shards_add_del6 (st, st->v6_half_open_shards, &kv6,
 				       0 /* is_add */ );
     }
 }
@@ -901,7 +977,7 @@ session_lookup_half_open_handle (transport_connection_t * tc)
     {
       make_v4_ss_kv (&kv4, &tc->lcl_ip.ip4, &tc->rmt_ip.ip4, tc->lcl_port,
 		     tc->rmt_port, tc->proto);
-      rv = clib_bihash_search_inline_16_8 (&st->v4_half_open_hash, &kv4);
+      rv = session_shards_search4 (st, st->v4_half_open_shards, &kv4);
       if (rv == 0)
 	return kv4.value;
     }
@@ -909,7 +985,7 @@ session_lookup_half_open_handle (transport_connection_t * tc)
     {
       make_v6_ss_kv (&kv6, &tc->lcl_ip.ip6, &tc->rmt_ip.ip6, tc->lcl_port,
 		     tc->rmt_port, tc->proto);
-      rv = clib_bihash_search_inline_48_8 (&st->v6_half_open_hash, &kv6);
+      rv = session_shards_search6 (st, st->v6_half_open_shards, &kv6);
       if (rv == 0)
 	return kv6.value;
     }
@@ -962,7 +1038,8 @@ session_lookup_connection_wt4 (u32 fib_index, ip4_address_t * lcl,
   session_table_t *st;
   session_kv4_t kv4;
   session_t *s;
-  u32 action_index;
+  u32 action_index, shard;
+  u64 hash;
   int rv;
 
   st = session_table_get_for_fib_index (FIB_PROTOCOL_IP4, fib_index);
@@ -970,10 +1047,14 @@ session_lookup_connection_wt4 (u32 fib_index, ip4_address_t * lcl,
     return 0;
 
   /*
-   * Lookup session amongst established ones
+   * Lookup session amongst established ones. Half-open table is sharded
+   * like the established one, so the hash is computed only once
    */
   make_v4_ss_kv (&kv4, lcl, rmt, lcl_port, rmt_port, proto);
-  rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+  hash = clib_bihash_hash_16_8 (&kv4);
+  shard = session_table_shard_index (st, hash);
+  rv = clib_bihash_search_inline_with_hash_16_8 (
+    &st->v4_session_shards[shard], hash, &kv4);
   if (rv == 0)
     {
       if (PREDICT_FALSE ((u32) (kv4.value >> 32) != thread_index))
@@ -989,7 +1070,8 @@ session_lookup_connection_wt4 (u32 fib_index, ip4_address_t * lcl,
   /*
    * Try half-open connections
    */
-  rv = clib_bihash_search_inline_16_8 (&st->v4_half_open_hash, &kv4);
+  rv = clib_bihash_search_inline_with_hash_16_8 (
+    &st->v4_half_open_shards[shard], hash, &kv4);
   if (rv == 0)
     return transport_get_half_open (proto, kv4.value & 0xFFFFFFFF);
 
@@ -1058,7 +1140,7 @@ session_lookup_connection4 (u32 fib_index, ip4_address_t * lcl,
    * Lookup session amongst established ones
    */
   make_v4_ss_kv (&kv4, lcl, rmt, lcl_port, rmt_port, proto);
-  rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+  rv = session_shards_search4 (st, st->v4_session_shards, &kv4);
   if (rv == 0)
     {
       s = session_get_from_handle (kv4.value);
@@ -1069,7 +1151,7 @@ session_lookup_connection4 (u32 fib_index, ip4_address_t * lcl,
   /*
    * Try half-open connections
    */
-  rv = clib_bihash_search_inline_16_8 (&st->v4_half_open_hash, &kv4);
+  rv = session_shards_search4 (st, st->v4_half_open_shards, &kv4);
   if (rv == 0)
     return transport_get_half_open (proto, kv4.value & 0xFFFFFFFF);
 
@@ -1130,7 +1212,7 @@ session_lookup_safe4 (u32 fib_index, ip4_address_t * lcl, ip4_address_t * rmt,
    * Lookup session amongst established ones
    */
   make_v4_ss_kv (&kv4, lcl, rmt, lcl_port, rmt_port, proto);
-  rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+  rv = session_shards_search4 (st, st->v4_session_shards, &kv4);
   if (rv == 0)
     return session_get_from_handle_safe (kv4.value);
 
@@ -1193,7 +1275,8 @@ session_lookup_connection_wt6 (u32 fib_index, ip6_address_t * lcl,
   session_table_t *st;
   session_t *s;
   session_kv6_t kv6;
-  u32 action_index;
+  u32 action_index, shard;
+  u64 hash;
   int rv;
 
   st = session_table_get_for_fib_index (FIB_PROTOCOL_IP6, fib_index);
@@ -1201,7 +1284,10 @@ session_lookup_connection_wt6 (u32 fib_index, ip6_address_t * lcl,
     return 0;
 
   make_v6_ss_kv (&kv6, lcl, rmt, lcl_port, rmt_port, proto);
-  rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+  hash = clib_bihash_hash_48_8 (&kv6);
+  shard = session_table_shard_index (st, hash);
+  rv = clib_bihash_search_inline_with_hash_48_8 (
+    &st->v6_session_shards[shard], hash, &kv6);
   if (rv == 0)
     {
       if (PREDICT_FALSE ((u32) (kv6.value >> 32) != thread_index))
@@ -1215,7 +1301,8 @@ session_lookup_connection_wt6 (u32 fib_index, ip6_address_t * lcl,
     }
 
   /* Try half-open connections */
-  rv = clib_bihash_search_inline_48_8 (&st->v6_half_open_hash, &kv6);
+  rv = clib_bihash_search_inline_with_hash_48_8 (
+    &st->v6_half_open_shards[shard], hash, &kv6);
   if (rv == 0)
     return transport_get_half_open (proto, kv6.value & 0xFFFFFFFF);
 
@@ -1278,7 +1365,7 @@ session_lookup_connection6 (u32 fib_index, ip6_address_t * lcl,
     return 0;
 
   make_v6_ss_kv (&kv6, lcl, rmt, lcl_port, rmt_port, proto);
-  rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+  rv = session_shards_search6 (st, st->v6_session_shards, &kv6);
   if (rv == 0)
     {
       s = session_get_from_handle (kv6.value);
@@ -1287,7 +1374,7 @@ session_lookup_connection6 (u32 fib_index, ip6_address_t * lcl,
     }
 
   /* Try half-open connections */
-  rv = clib_bihash_search_inline_48_8 (&st->v6_half_open_hash, &kv6);
+  rv = session_shards_search6 (st, st->v6_half_open_shards, &kv6);
   if (rv == 0)
     return transport_get_half_open (proto, kv6.value & 0xFFFFFFFF);
 
@@ -1343,7 +1430,7 @@ session_lookup_safe6 (u32 fib_index, ip6_address_t * lcl, ip6_address_t * rmt,
     return 0;
 
   make_v6_ss_kv (&kv6, lcl, rmt, lcl_port, rmt_port, proto);
-  rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+  rv = session_shards_search6 (st, st->v6_session_shards, &kv6);
   if (rv == 0)
     return session_get_from_handle_safe (kv6.value);
 
@@ -1405,7 +1492,7 @@ session_lookup_6tuple (u32 fib_index, ip46_address_t *lcl, ip46_address_t *rmt,
        * Lookup session amongst established ones
        */
       make_v4_ss_kv (&kv4, &lcl->ip4, &rmt->ip4, lcl_port, rmt_port, proto);
-      rv = clib_bihash_search_inline_16_8 (&st->v4_session_hash, &kv4);
+      rv = session_shards_search4 (st, st->v4_session_shards, &kv4);
       if (rv == 0)
 	{
 	  s = session_get_from_handle (kv4.value);
@@ -1416,7 +1503,7 @@ session_lookup_6tuple (u32 fib_index, ip46_address_t *lcl, ip46_address_t *rmt,
       /*
        * Try half-open connections
        */
-      rv = clib_bihash_search_inline_16_8 (&st->v4_half_open_hash, &kv4);
+      rv = session_shards_search4 (st, st->v4_half_open_shards, &kv4);
       if (rv == 0)
 	return transport_get_half_open (proto, kv4.value & 0xFFFFFFFF);
     }
@@ -1429,7 +1516,7 @@ session_lookup_6tuple (u32 fib_index, ip46_address_t *lcl, ip46_address_t *rmt,
 	return 0;
 
       make_v6_ss_kv (&kv6, &lcl->ip6, &rmt->ip6, lcl_port, rmt_port, proto);
-      rv = clib_bihash_search_inline_48_8 (&st->v6_session_hash, &kv6);
+      rv = session_shards_search6 (st, st->v6_session_shards, &kv6);
       if (rv == 0)
 	{
 	  s = session_get_from_handle (kv6.value);
@@ -1438,7 +1525,7 @@ session_lookup_6tuple (u32 fib_index, ip46_address_t *lcl, ip46_address_t *rmt,
 	}
 
       /* Try half-open connections */
-      rv = clib_bihash_search_inline_48_8 (&st->v6_half_open_hash, &kv6);
+      rv = session_shards_search6 (st, st->v6_half_open_shards, &kv6);
       if (rv == 0)
 	return transport_get_half_open (proto, kv6.value & 0xFFFFFFFF);
     }
@@ -1588,6 +1675,8 @@ session_lookup_show_table_entries (vlib_main_t * vm, session_table_t * table,
     .vm = vm,
     .is_local = is_local,
   };
+  int i;
+
   if (!is_local)
     vlib_cli_output (vm, "%-40s%-30s", "Session", "Application");
   else
@@ -1596,8 +1685,13 @@ session_lookup_show_table_entries (vlib_main_t * vm, session_table_t * table,
     {
       /* main table v4 */
     case 0:
-      ip4_session_table_walk (&table->v4_session_hash, ip4_session_table_show,
+      ip4_session_table_walk (&table->v4_listener_hash, ip4_session_table_show,
 			      &ctx);
+      if (is_local)
+	break;
+      for (i = 0; i < vec_len (table->v4_session_shards); i++)
+	ip4_session_table_walk (&table->v4_session_shards[i],
+				ip4_session_table_show, &ctx);
       break;
     default:
       clib_warning ("not supported");
@@ -85,6 +85,7 @@ session_t *session_lookup_listener_wildcard (u32 table_index,
 					     session_endpoint_t * sep);
 int session_lookup_add_connection (transport_connection_t * tc, u64 value);
 int session_lookup_del_connection (transport_connection_t * tc);
+int session_lookup_del_listener (transport_connection_t *tc);
 u64 session_lookup_endpoint_listener (u32 table_index,
 				      session_endpoint_t * sepi,
 				      u8 use_rules);
@@ -1484,9 +1484,23 @@ session_tx_fifo_read_and_snd_i (session_worker_t * wrk,
 	  session_evt_add_head_old (wrk, elt);
 	  return SESSION_TX_NO_DATA;
 	}
-      snd_space = clib_min (ctx->sp.snd_space, snd_space);
-      ctx->sp.snd_space = snd_space >= ctx->sp.snd_mss ?
-	snd_space - snd_space % ctx->sp.snd_mss : snd_space;
+      if (ctx->tc->flags & TRANSPORT_CONNECTION_F_TX_PACED_ROUND_UP)
+	{
+	  /* Round burst up to full segments. Pacer bucket goes into debt
+	   * for the excess so average rate matches the pacing rate, whereas
+	   * rounding down would cap rate at the number of full segments that
+	   * fit a burst, regardless of the rate requested by transport */
+	  snd_space += ctx->sp.snd_mss - 1;
+	  snd_space -= snd_space % ctx->sp.snd_mss;
+	  ctx->sp.snd_space = clib_min (ctx->sp.snd_space, snd_space);
+	}
+      else
+	{
+	  snd_space = clib_min (ctx->sp.snd_space, snd_space);
+	  ctx->sp.snd_space = snd_space >= ctx->sp.snd_mss ?
+				snd_space - snd_space % ctx->sp.snd_mss :
+				snd_space;
+	}
     }
 
   /* Check how much we can pull. */
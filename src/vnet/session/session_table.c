@@ -61,38 +61,67 @@ session_table_get (u32 table_index)
   _(v6,halfopen,buckets,20000)                  \
   _(v6,halfopen,memory,(64<<20))
 
+/* Lower bounds for per shard table parameters */
+#define SESSION_TABLE_MIN_buckets 1024
+#define SESSION_TABLE_MIN_memory (1 << 20)
+
 void
 session_table_free (session_table_t *slt, u8 fib_proto)
 {
   u8 all = fib_proto > FIB_PROTOCOL_IP6 ? 1 : 0;
+  int i;
 
   session_rules_table_free (slt, fib_proto);
 
   if (fib_proto == FIB_PROTOCOL_IP4 || all)
     {
-      clib_bihash_free_16_8 (&slt->v4_session_hash);
-      clib_bihash_free_16_8 (&slt->v4_half_open_hash);
+      clib_bihash_free_16_8 (&slt->v4_listener_hash);
+      for (i = 0; i < vec_len (slt->v4_session_shards); i++)
+	{
+	  clib_bihash_free_16_8 (&slt->v4_session_shards[i]);
+	  clib_bihash_free_16_8 (&slt->v4_half_open_shards[i]);
+	}
+      vec_free (slt->v4_session_shards);
+      vec_free (slt->v4_half_open_shards);
     }
   if (fib_proto == FIB_PROTOCOL_IP6 || all)
     {
-      clib_bihash_free_48_8 (&slt->v6_session_hash);
-      clib_bihash_free_48_8 (&slt->v6_half_open_hash);
+      clib_bihash_free_48_8 (&slt->v6_listener_hash);
+      for (i = 0; i < vec_len (slt->v6_session_shards); i++)
+	{
+	  clib_bihash_free_48_8 (&slt->v6_session_shards[i]);
+	  clib_bihash_free_48_8 (&slt->v6_half_open_shards[i]);
+	}
+      vec_free (slt->v6_session_shards);
+      vec_free (slt->v6_half_open_shards);
     }
 
   vec_free (slt->appns_index);
   pool_put (lookup_tables, slt);
 }
 
+static u32
+session_table_n_shards (void)
+{
+  if (session_main.configured_session_table_shards)
+    return session_main.configured_session_table_shards;
+  return clib_max (vlib_num_workers (), 1);
+}
+
 /**
  * Initialize session table hash tables
  *
  * If vpp configured with set of table parameters it uses them,
- * otherwise it uses defaults above.
+ * otherwise it uses defaults above. Configured buckets and memory are
+ * split between the shards of the established and half-open tables, and
+ * the listener tables are sized like one shard.
  */
 void
 session_table_init (session_table_t *slt, u8 fib_proto)
 {
   u8 all = fib_proto > FIB_PROTOCOL_IP6 ? 1 : 0;
+  u32 n_shards;
+  int i;
 
 #define _(af,table,parm,value) 						\
   u32 configured_##af##_##table##_table_##parm = value;
@@ -106,50 +135,92 @@ session_table_init (session_table_t *slt, u8 fib_proto)
   foreach_hash_table_parameter;
 #undef _
 
+  n_shards = session_table_n_shards ();
+
+#define _(af,table,parm,value)                                          \
+  configured_##af##_##table##_table_##parm =                            \
+    clib_max (configured_##af##_##table##_table_##parm / n_shards,       \
+	      SESSION_TABLE_MIN_##parm);
+  foreach_hash_table_parameter;
+#undef _
+
   slt->srtg_handle = SESSION_SRTG_HANDLE_INVALID;
+  slt->n_shards = n_shards;
   if (fib_proto == FIB_PROTOCOL_IP4 || all)
     {
       clib_bihash_init2_args_16_8_t _a, *a = &_a;
 
       memset (a, 0, sizeof (*a));
-      a->h = &slt->v4_session_hash;
-      a->name = "v4 session table";
+      a->h = &slt->v4_listener_hash;
+      a->name = "v4 listener table";
       a->nbuckets = configured_v4_session_table_buckets;
       a->memory_size = configured_v4_session_table_memory;
       a->dont_add_to_all_bihash_list = 1;
       a->instantiate_immediately = 1;
       clib_bihash_init2_16_8 (a);
 
-      memset (a, 0, sizeof (*a));
-      a->h = &slt->v4_half_open_hash;
-      a->name = "v4 half-open table";
-      a->nbuckets = configured_v4_halfopen_table_buckets;
-      a->memory_size = configured_v4_halfopen_table_memory;
-      a->dont_add_to_all_bihash_list = 1;
-      a->instantiate_immediately = 1;
-      clib_bihash_init2_16_8 (a);
+      vec_validate_aligned (slt->v4_session_shards, n_shards - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      vec_validate_aligned (slt->v4_half_open_shards, n_shards - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      for (i = 0; i < n_shards; i++)
+	{
+	  memset (a, 0, sizeof (*a));
+	  a->h = &slt->v4_session_shards[i];
+	  a->name = "v4 session table";
+	  a->nbuckets = configured_v4_session_table_buckets;
+	  a->memory_size = configured_v4_session_table_memory;
+	  a->dont_add_to_all_bihash_list = 1;
+	  a->instantiate_immediately = 1;
+	  clib_bihash_init2_16_8 (a);
+
+	  memset (a, 0, sizeof (*a));
+	  a->h = &slt->v4_half_open_shards[i];
+	  a->name = "v4 half-open table";
+	  a->nbuckets = configured_v4_halfopen_table_buckets;
+	  a->memory_size = configured_v4_halfopen_table_memory;
+	  a->dont_add_to_all_bihash_list = 1;
+	  a->instantiate_immediately = 1;
+	  clib_bihash_init2_16_8 (a);
+	}
     }
   if (fib_proto == FIB_PROTOCOL_IP6 || all)
     {
       clib_bihash_init2_args_48_8_t _a, *a = &_a;
 
       memset (a, 0, sizeof (*a));
-      a->h = &slt->v6_session_hash;
-      a->name = "v6 session table";
+      a->h = &slt->v6_listener_hash;
+      a->name = "v6 listener table";
       a->nbuckets = configured_v6_session_table_buckets;
       a->memory_size = configured_v6_session_table_memory;
       a->dont_add_to_all_bihash_list = 1;
       a->instantiate_immediately = 1;
       clib_bihash_init2_48_8 (a);
 
-      memset (a, 0, sizeof (*a));
-      a->h = &slt->v6_half_open_hash;
-      a->name = "v6 half-open table";
-      a->nbuckets = configured_v6_halfopen_table_buckets;
-      a->memory_size = configured_v6_halfopen_table_memory;
-      a->dont_add_to_all_bihash_list = 1;
-      a->instantiate_immediately = 1;
-      clib_bihash_init2_48_8 (a);
+      vec_validate_aligned (slt->v6_session_shards, n_shards - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      vec_validate_aligned (slt->v6_half_open_shards, n_shards - 1,
+			    CLIB_CACHE_LINE_BYTES);
+      for (i = 0; i < n_shards; i++)
+	{
+	  memset (a, 0, sizeof (*a));
+	  a->h = &slt->v6_session_shards[i];
+	  a->name = "v6 session table";
+	  a->nbuckets = configured_v6_session_table_buckets;
+	  a->memory_size = configured_v6_session_table_memory;
+	  a->dont_add_to_all_bihash_list = 1;
+	  a->instantiate_immediately = 1;
+	  clib_bihash_init2_48_8 (a);
+
+	  memset (a, 0, sizeof (*a));
+	  a->h = &slt->v6_half_open_shards[i];
+	  a->name = "v6 half-open table";
+	  a->nbuckets = configured_v6_halfopen_table_buckets;
+	  a->memory_size = configured_v6_halfopen_table_memory;
+	  a->dont_add_to_all_bihash_list = 1;
+	  a->instantiate_immediately = 1;
+	  clib_bihash_init2_48_8 (a);
+	}
     }
 }
 
@@ -179,40 +250,61 @@ ip4_session_table_walk (clib_bihash_16_8_t * hash,
 					   &ctx);
 }
 
+static u64
+session_bihash_16_8_memory_size (clib_bihash_16_8_t *h)
+{
+  clib_bihash_alloc_chunk_16_8_t *c = h->chunks;
+  u64 size = 0;
+
+  while (c)
+    {
+      size += c->size;
+      c = c->next;
+    }
+  return size;
+}
+
+static u64
+session_bihash_48_8_memory_size (clib_bihash_48_8_t *h)
+{
+  clib_bihash_alloc_chunk_48_8_t *c = h->chunks;
+  u64 size = 0;
+
+  while (c)
+    {
+      size += c->size;
+      c = c->next;
+    }
+  return size;
+}
+
 u32
 session_table_memory_size (session_table_t *st)
 {
   u64 total_size = 0;
+  int i;
 
-  if (clib_bihash_is_initialised_16_8 (&st->v4_session_hash))
+  if (clib_bihash_is_initialised_16_8 (&st->v4_listener_hash))
     {
-      clib_bihash_alloc_chunk_16_8_t *c = st->v4_session_hash.chunks;
-      while (c)
+      total_size += session_bihash_16_8_memory_size (&st->v4_listener_hash);
+      for (i = 0; i < vec_len (st->v4_session_shards); i++)
 	{
-	  total_size += c->size;
-	  c = c->next;
-	}
-      c = st->v4_half_open_hash.chunks;
-      while (c)
-	{
-	  total_size += c->size;
-	  c = c->next;
+	  total_size +=
+	    session_bihash_16_8_memory_size (&st->v4_session_shards[i]);
+	  total_size +=
+	    session_bihash_16_8_memory_size (&st->v4_half_open_shards[i]);
 	}
     }
 
-  if (clib_bihash_is_initialised_48_8 (&st->v6_session_hash))
+  if (clib_bihash_is_initialised_48_8 (&st->v6_listener_hash))
     {
-      clib_bihash_alloc_chunk_48_8_t *c = st->v6_session_hash.chunks;
-      while (c)
+      total_size += session_bihash_48_8_memory_size (&st->v6_listener_hash);
+      for (i = 0; i < vec_len (st->v6_session_shards); i++)
 	{
-	  total_size += c->size;
-	  c = c->next;
-	}
-      c = st->v6_half_open_hash.chunks;
-      while (c)
-	{
-	  total_size += c->size;
-	  c = c->next;
+	  total_size +=
+	    session_bihash_48_8_memory_size (&st->v6_session_shards[i]);
+	  total_size +=
+	    session_bihash_48_8_memory_size (&st->v6_half_open_shards[i]);
 	}
     }
 
@@ -234,16 +326,31 @@ format_session_table (u8 *s, va_list *args)
       s = format (s, "%d", appns_index);
     }
   s = format (s, "\n");
-  if (clib_bihash_is_initialised_16_8 (&st->v4_session_hash))
+  s = format (s, "shards: %u\n", st->n_shards);
+  if (clib_bihash_is_initialised_16_8 (&st->v4_listener_hash))
     {
-      s = format (s, "%U", format_bihash_16_8, &st->v4_session_hash, 0);
-      s = format (s, "%U", format_bihash_16_8, &st->v4_half_open_hash, 0);
+      s = format (s, "%U", format_bihash_16_8, &st->v4_listener_hash, 0);
+      for (i = 0; i < vec_len (st->v4_session_shards); i++)
+	{
+	  s = format (s, "shard %u:\n", i);
+	  s = format (s, "%U", format_bihash_16_8, &st->v4_session_shards[i],
+		      0);
+	  s = format (s, "%U", format_bihash_16_8,
+		      &st->v4_half_open_shards[i], 0);
+	}
     }
 
-  if (clib_bihash_is_initialised_48_8 (&st->v6_session_hash))
+  if (clib_bihash_is_initialised_48_8 (&st->v6_listener_hash))
     {
-      s = format (s, "%U", format_bihash_48_8, &st->v6_session_hash, 0);
-      s = format (s, "%U", format_bihash_48_8, &st->v6_half_open_hash, 0);
+      s = format (s, "%U", format_bihash_48_8, &st->v6_listener_hash, 0);
+      for (i = 0; i < vec_len (st->v6_session_shards); i++)
+	{
+	  s = format (s, "shard %u:\n", i);
+	  s = format (s, "%U", format_bihash_48_8, &st->v6_session_shards[i],
+		      0);
+	  s = format (s, "%U", format_bihash_48_8,
+		      &st->v6_half_open_shards[i], 0);
+	}
     }
 
   return s;
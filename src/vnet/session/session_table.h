@@ -22,16 +22,27 @@
 typedef struct _session_lookup_table
 {
   /**
-   * Lookup tables for established sessions and listeners
+   * Lookup tables for listeners and session endpoints. Only updated when
+   * applications listen or stop listening, so readers on the connection
+   * setup path do not compete with connection churn
    */
-  clib_bihash_16_8_t v4_session_hash;
-  clib_bihash_48_8_t v6_session_hash;
+  clib_bihash_16_8_t v4_listener_hash;
+  clib_bihash_48_8_t v6_listener_hash;
 
   /**
-   * Lookup tables for half-open sessions
+   * Lookup tables for established sessions, sharded by key hash
    */
-  clib_bihash_16_8_t v4_half_open_hash;
-  clib_bihash_48_8_t v6_half_open_hash;
+  clib_bihash_16_8_t *v4_session_shards;
+  clib_bihash_48_8_t *v6_session_shards;
+
+  /**
+   * Lookup tables for half-open sessions, sharded like established ones
+   */
+  clib_bihash_16_8_t *v4_half_open_shards;
+  clib_bihash_48_8_t *v6_half_open_shards;
+
+  /** Number of established and half-open session table shards */
+  u32 n_shards;
 
   /**
    * Per fib proto and transport proto session rules tables
@@ -56,6 +67,20 @@ typedef struct _session_lookup_table
 #define SESSION_LOCAL_TABLE_PREFIX ((u32)~0)
 #define SESSION_DROP_HANDLE (((u64)~0) - 1)
 
+/**
+ * Shard of a session table for a key hash
+ *
+ * Bihash uses the low order bits of the hash to select the bucket so the
+ * shard is derived from the high order bits of its lower 32 bits. As the
+ * shard only depends on the key, all threads agree on it and a lookup
+ * never probes more than one shard.
+ */
+static inline u32
+session_table_shard_index (session_table_t *st, u64 hash)
+{
+  return (((u32) hash >> 16) * st->n_shards) >> 16;
+}
+
 typedef int (*ip4_session_table_walk_fn_t) (clib_bihash_kv_16_8_t * kvp,
 					    void *ctx);
 
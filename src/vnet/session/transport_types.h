@@ -42,6 +42,8 @@ typedef enum transport_service_type_
 
 /*
  * IS_TX_PACED : Connection sending is paced
+ * TX_PACED_ROUND_UP: Paced bursts are rounded up to full segments, for
+ * 		      transports that pace at a rate not derived from cwnd
  * NO_LOOKUP: Don't register connection in lookup. Does not apply to local
  * 	      apps and transports using the network layer (udp/tcp)
  * DESCHED: Connection descheduled by the session layer
@@ -51,6 +53,7 @@ typedef enum transport_service_type_
  */
 #define foreach_transport_connection_flag                                     \
   _ (IS_TX_PACED, "tx_paced")                                                 \
+  _ (TX_PACED_ROUND_UP, "tx_paced_round_up")                                  \
   _ (NO_LOOKUP, "no_lookup")                                                  \
   _ (DESCHED, "descheduled")                                                  \
   _ (CLESS, "connectionless")
@@ -764,6 +764,13 @@ tcp_connection_init_vars (tcp_connection_t * tc)
       || tcp_cfg.enable_tx_pacing)
     tcp_enable_pacing (tc);
 
+  /* RACK needs sacks and tx times tracked by the byte tracker */
+  if (tcp_cfg.enable_rack && tcp_opts_sack_permitted (&tc->rcv_opts))
+    {
+      tc->cfg_flags |= TCP_CFG_F_RACK | TCP_CFG_F_RATE_SAMPLE;
+      tcp_rack_init (tc);
+    }
+
   if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
     tcp_bt_init (tc);
 
@@ -962,7 +969,7 @@ tcp_set_attribute (tcp_connection_t *tc, transport_endpt_attr_t *attr)
 	{
 	  if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
 	    tcp_bt_cleanup (tc);
-	  tc->cfg_flags &= ~TCP_CFG_F_RATE_SAMPLE;
+	  tc->cfg_flags &= ~(TCP_CFG_F_RATE_SAMPLE | TCP_CFG_F_RACK);
 	}
       break;
     case TRANSPORT_ENDPT_ATTR_CC_ALGO:
@@ -971,6 +978,9 @@ tcp_set_attribute (tcp_connection_t *tc, transport_endpt_attr_t *attr)
       tcp_cc_cleanup (tc);
       tc->cc_algo = tcp_cc_algo_get (attr->cc_algo);
       tcp_cc_init (tc);
+      /* Algorithm may depend on delivery rate samples */
+      if ((tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE) && !tc->bt)
+	tcp_bt_init (tc);
       break;
     default:
       rv = -1;
@@ -1111,6 +1121,18 @@ tcp_snd_space (tcp_connection_t * tc)
   return tcp_snd_space_inline (tc);
 }
 
+static void
+tcp_recheck_gso (tcp_connection_t *tc)
+{
+  if (tc->cfg_flags & TCP_CFG_F_NO_TSO)
+    {
+      tc->gso_epoch = tcp_main.gso_epoch;
+      return;
+    }
+  tc->cfg_flags &= ~TCP_CFG_F_TSO;
+  tcp_check_gso (tc);
+}
+
 static int
 tcp_session_send_params (transport_connection_t * trans_conn,
 			 transport_send_params_t * sp)
@@ -1122,6 +1144,10 @@ tcp_session_send_params (transport_connection_t * trans_conn,
    * the current state of the connection. */
   tcp_update_burst_snd_vars (tc);
 
+  /* Output features changed, gso may no longer segment for us */
+  if (PREDICT_FALSE (tc->gso_epoch != tcp_main.gso_epoch))
+    tcp_recheck_gso (tc);
+
   if (PREDICT_FALSE (tc->cfg_flags & TCP_CFG_F_TSO))
     sp->snd_mss = tcp_session_cal_goal_size (tc);
   else
@@ -1641,6 +1667,8 @@ tcp_configuration_init (void)
   tcp_cfg.enable_tx_pacing = 1;
   tcp_cfg.allow_tso = 0;
   tcp_cfg.csum_offload = 1;
+  tcp_cfg.rx_coalesce = 1;
+  tcp_cfg.enable_rack = 0;
   tcp_cfg.cc_algo = TCP_CC_CUBIC;
   tcp_cfg.rwnd_min_update_ack = 1;
   tcp_cfg.max_gso_size = TCP_MAX_GSO_SZ;
@@ -1661,6 +1689,17 @@ tcp_configuration_init (void)
   tcp_cfg.syn_rcvd_time = TCP_ESTABLISH_TIME;
 }
 
+static void
+tcp_output_feature_update (u32 sw_if_index, u8 arc_index, u8 is_enable,
+			   void *data)
+{
+  tcp_main_t *tm = vnet_get_tcp_main ();
+
+  if (arc_index == ip4_main.lookup_main.output_feature_arc_index ||
+      arc_index == ip6_main.lookup_main.output_feature_arc_index)
+    tm->gso_epoch++;
+}
+
 static clib_error_t *
 tcp_init (vlib_main_t * vm)
 {
@@ -1688,6 +1727,8 @@ tcp_init (vlib_main_t * vm)
 
   tm->cc_algo_by_name = hash_create_string (0, sizeof (uword));
 
+  vnet_feature_register (tcp_output_feature_update, 0);
+
   return 0;
 }
 
@@ -50,6 +50,8 @@ typedef struct _tcp_lookup_dispatch
   _ (timer_expirations, u64, "timer expirations")                             \
   _ (rxt_segs, u64, "segments retransmitted")                                 \
   _ (tr_events, u32, "timer retransmit events")                               \
+  _ (tlp_probes, u32, "tail loss probes")                                     \
+  _ (reo_timeouts, u32, "rack reordering timeouts")                           \
   _ (to_establish, u32, "timeout establish")                                  \
   _ (to_persist, u32, "timeout persist")                                      \
   _ (to_closewait, u32, "timeout close-wait")                                 \
@@ -169,6 +171,12 @@ typedef struct tcp_configuration_
   /** Set if csum offloading is enabled */
   u8 csum_offload;
 
+  /** Coalesce in-order rx segments of a connection within a frame */
+  u8 rx_coalesce;
+
+  /** Use RACK-TLP loss detection for new connections */
+  u8 enable_rack;
+
   /** Default congestion control algorithm type */
   tcp_cc_algorithm_type_e cc_algo;
 
@@ -261,6 +269,10 @@ typedef struct _tcp_main
   /** Rotor for v6 source addresses */
   u32 last_v6_addr_rotor;
 
+  /** Bumped on ip output feature changes, e.g., gso enabled or disabled,
+   *  so connections recheck their tx offload */
+  u32 gso_epoch;
+
   /** Protocol configuration */
   tcp_configuration_t cfg;
 
@@ -326,6 +338,7 @@ void tcp_send_window_update_ack (tcp_connection_t * tc);
 void tcp_program_ack (tcp_connection_t * tc);
 void tcp_program_dupack (tcp_connection_t * tc);
 void tcp_program_retransmit (tcp_connection_t * tc);
+void tcp_enter_fast_recovery (tcp_connection_t *tc);
 
 void tcp_update_burst_snd_vars (tcp_connection_t * tc);
 u32 tcp_snd_space (tcp_connection_t * tc);
@@ -0,0 +1,691 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+/**
+ * BBR congestion control
+ *
+ * Model based congestion control that estimates the bottleneck bandwidth
+ * (windowed max of delivery rate samples) and the round-trip propagation
+ * delay (windowed min rtt) and paces at their product. Delivery rate
+ * samples are provided by the tcp byte tracker (@ref tcp_bt.c), so rate
+ * sampling is always enabled for connections that use bbr.
+ *
+ * The state machine follows BBR v1 (startup, drain, probe_bw, probe_rtt)
+ * while loss is handled as in BBR v2/v3: if a round sees more than
+ * @ref bbr_cfg_t.loss_thresh bytes lost, an upper bound on inflight is set
+ * and startup/bandwidth probing stops. The bound is relaxed again while
+ * probing for bandwidth, if inflight is limited by it and no excess loss
+ * is seen.
+ */
+
+#include <vnet/tcp/tcp.h>
+#include <vnet/tcp/tcp_inlines.h>
+
+#define BBR_HIGH_GAIN	     2.885 /* 2/ln(2) */
+#define BBR_DRAIN_GAIN	     (1 / BBR_HIGH_GAIN)
+#define BBR_CWND_GAIN	     2.0
+#define BBR_CYCLE_LEN	     8
+#define BBR_BW_FILTER_ROUNDS 10
+#define BBR_MIN_RTT_WIN	     10.0 /* s */
+#define BBR_PROBE_RTT_TIME   0.2  /* s */
+#define BBR_FULL_BW_THRESH   1.25
+#define BBR_FULL_BW_ROUNDS   3
+#define BBR_FULL_LOSS_SEGS   8
+#define BBR_MIN_CWND_SEGS    4
+#define BBR_PACING_MARGIN    0.99
+#define BBR_BETA	     0.7
+#define BBR_INFLIGHT_HEADROOM 0.85
+#define BBR_INITIAL_RTT	     0.1 /* s, same as tcp's initial srtt */
+
+static const f64 bbr_pacing_gains[BBR_CYCLE_LEN] = {
+  1.25, 0.75, 1, 1, 1, 1, 1, 1,
+};
+
+typedef struct bbr_cfg_
+{
+  u8 loss_response;
+  f64 loss_thresh;
+} bbr_cfg_t;
+
+static bbr_cfg_t bbr_cfg = {
+  .loss_response = 1,
+  .loss_thresh = 0.02,
+};
+
+typedef enum bbr_state_
+{
+  BBR_STATE_STARTUP,
+  BBR_STATE_DRAIN,
+  BBR_STATE_PROBE_BW,
+  BBR_STATE_PROBE_RTT,
+} __clib_packed bbr_state_t;
+
+typedef struct bbr_bw_sample_
+{
+  u64 bw;     /**< Delivery rate in bytes/s */
+  u32 round;  /**< Round in which sample was taken */
+} bbr_bw_sample_t;
+
+typedef struct bbr_data_
+{
+  /** Windowed max filter of delivery rate, best 3 samples */
+  bbr_bw_sample_t max_bw[3];
+
+  /** Delivered bytes that mark the end of the current round */
+  u64 next_round_delivered;
+
+  /** Delivered and lost bytes at the start of the current round */
+  u64 round_delivered;
+  u64 round_lost;
+
+  /** Bandwidth seen when startup growth was last confirmed */
+  u64 full_bw;
+
+  f64 min_rtt;		   /**< Min rtt estimate (s), 0 if unknown */
+  f64 min_rtt_stamp;	   /**< Time when min_rtt was last updated */
+  f64 probe_rtt_done_stamp; /**< Time when probe_rtt may end */
+  f64 cycle_stamp;	   /**< Start of current probe_bw gain phase */
+  f64 pacing_gain;
+  f64 cwnd_gain;
+
+  u32 round_count;	   /**< Number of packet timed rounds */
+  u32 prior_cwnd;	   /**< cwnd before recovery or probe_rtt */
+  u32 inflight_hi;	   /**< Inflight bound after loss, 0 if none */
+
+  bbr_state_t state;
+  u8 cycle_idx;		   /**< Index in @ref bbr_pacing_gains */
+  u8 full_bw_cnt;	   /**< Rounds without bandwidth growth */
+  u8 full_bw_reached;	   /**< Startup found the pipe full */
+  u8 round_start;	   /**< Ack started a new round */
+  u8 probe_rtt_round_done; /**< Full round spent in probe_rtt */
+  u8 packet_conservation;  /**< First round of recovery */
+  u8 idle_restart;	   /**< Restarting after idle */
+} bbr_data_t;
+
+STATIC_ASSERT (sizeof (bbr_data_t *) <= TCP_CC_DATA_SZ, "bbr data len");
+
+static inline bbr_data_t *
+bbr_data (tcp_connection_t *tc)
+{
+  return *(bbr_data_t **) tcp_cc_data (tc);
+}
+
+static inline f64
+bbr_time (u32 thread_index)
+{
+  return tcp_time_now_us (thread_index);
+}
+
+static inline u64
+bbr_max_bw (bbr_data_t *bd)
+{
+  return bd->max_bw[0].bw;
+}
+
+static inline u32
+bbr_min_cwnd (tcp_connection_t *tc)
+{
+  return BBR_MIN_CWND_SEGS * tc->snd_mss;
+}
+
+/**
+ * Kathleen Nichols' windowed max filter, as used by the reference bbr
+ * implementation. Tracks the best, second best and third best samples
+ * over the last @ref BBR_BW_FILTER_ROUNDS rounds.
+ */
+static void
+bbr_bw_filter_update (bbr_data_t *bd, u64 bw)
+{
+  bbr_bw_sample_t *s = bd->max_bw, val = { .bw = bw,
+					   .round = bd->round_count };
+  u32 win = BBR_BW_FILTER_ROUNDS, dt;
+
+  /* New max or nothing left in window, reset all estimates */
+  if (bw >= s[0].bw || val.round - s[2].round > win)
+    {
+      s[0] = s[1] = s[2] = val;
+      return;
+    }
+
+  if (bw >= s[1].bw)
+    s[2] = s[1] = val;
+  else if (bw >= s[2].bw)
+    s[2] = val;
+
+  /* Expire best sample if out of window and make sure the other
+   * samples are spread over the window */
+  dt = val.round - s[0].round;
+  if (dt > win)
+    {
+      s[0] = s[1];
+      s[1] = s[2];
+      s[2] = val;
+      if (val.round - s[0].round > win)
+	{
+	  s[0] = s[1];
+	  s[1] = s[2];
+	  s[2] = val;
+	}
+    }
+  else if (s[1].round == s[0].round && dt > win / 4)
+    {
+      s[2] = s[1] = val;
+    }
+  else if (s[2].round == s[1].round && dt > win / 2)
+    {
+      s[2] = val;
+    }
+}
+
+/**
+ * Bytes in flight needed to fully use the estimated bandwidth-delay
+ * product, scaled by gain
+ */
+static u32
+bbr_bdp (tcp_connection_t *tc, bbr_data_t *bd, f64 gain)
+{
+  u64 bw = bbr_max_bw (bd);
+
+  /* No estimate yet, start with initial window */
+  if (!bw || !bd->min_rtt)
+    return tcp_initial_cwnd (tc);
+
+  return clib_min ((u64) (gain * bw * bd->min_rtt), 0x7FFFFFFFU);
+}
+
+static u32
+bbr_target_cwnd (tcp_connection_t *tc, bbr_data_t *bd, f64 gain)
+{
+  u32 cwnd;
+
+  cwnd = bbr_bdp (tc, bd, gain);
+
+  /* Allow enough for send and receive side batching and delayed acks */
+  cwnd += 3 * tc->snd_mss;
+  cwnd = (cwnd + tc->snd_mss - 1) / tc->snd_mss * tc->snd_mss;
+
+  /* Make sure probing for bandwidth does not stall on delayed acks */
+  if (bd->state == BBR_STATE_PROBE_BW && bd->cycle_idx == 0)
+    cwnd += 2 * tc->snd_mss;
+
+  return clib_max (cwnd, bbr_min_cwnd (tc));
+}
+
+static void
+bbr_save_cwnd (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  /* Don't overwrite cwnd saved before recovery or probe_rtt */
+  if (!tcp_in_cong_recovery (tc) && bd->state != BBR_STATE_PROBE_RTT)
+    bd->prior_cwnd = tc->cwnd;
+  else
+    bd->prior_cwnd = clib_max (bd->prior_cwnd, tc->cwnd);
+}
+
+static void
+bbr_enter_startup (bbr_data_t *bd)
+{
+  bd->state = BBR_STATE_STARTUP;
+  bd->pacing_gain = BBR_HIGH_GAIN;
+  bd->cwnd_gain = BBR_HIGH_GAIN;
+}
+
+static inline u8
+bbr_is_probing_bw (bbr_data_t *bd)
+{
+  return (bd->state == BBR_STATE_STARTUP
+	  || (bd->state == BBR_STATE_PROBE_BW && bd->pacing_gain > 1));
+}
+
+static void
+bbr_advance_cycle (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  bd->cycle_idx = (bd->cycle_idx + 1) % BBR_CYCLE_LEN;
+  bd->cycle_stamp = bbr_time (tc->c_thread_index);
+  bd->pacing_gain = bbr_pacing_gains[bd->cycle_idx];
+}
+
+static void
+bbr_enter_probe_bw (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  bd->state = BBR_STATE_PROBE_BW;
+  bd->cwnd_gain = BBR_CWND_GAIN;
+
+  /* Randomize starting phase, but never start with the drain phase.
+   * Advancing from the last phase starts with a probe */
+  bd->cycle_idx = BBR_CYCLE_LEN - 1
+		  - clib_cpu_time_now () % (BBR_CYCLE_LEN - 1);
+  bbr_advance_cycle (tc, bd);
+}
+
+static void
+bbr_update_round (tcp_connection_t *tc, bbr_data_t *bd,
+		  tcp_rate_sample_t *rs)
+{
+  bd->round_start = 0;
+  if (rs->prior_delivered < bd->next_round_delivered)
+    return;
+
+  bd->next_round_delivered = tc->delivered;
+  bd->round_count += 1;
+  bd->round_start = 1;
+  bd->packet_conservation = 0;
+}
+
+static void
+bbr_update_bw (tcp_connection_t *tc, bbr_data_t *bd, tcp_rate_sample_t *rs)
+{
+  u64 bw;
+
+  if (!rs->delivered || rs->interval_time <= 0)
+    return;
+
+  bw = rs->delivered / rs->interval_time;
+
+  /* App limited samples underestimate the bandwidth, so only use them if
+   * they're larger than what we already have */
+  if (!(rs->flags & TCP_BTS_IS_APP_LIMITED) || bw >= bbr_max_bw (bd))
+    bbr_bw_filter_update (bd, bw);
+}
+
+/**
+ * Loss response as in BBR v2. If a round spent probing for bandwidth lost
+ * more than loss_thresh of the bytes sent, bound inflight and stop probing.
+ * Loss while not probing is not caused by the flow, e.g., random loss, and
+ * is ignored, otherwise the bound would keep shrinking with the estimated
+ * bandwidth
+ */
+static void
+bbr_check_loss (tcp_connection_t *tc, bbr_data_t *bd, tcp_rate_sample_t *rs)
+{
+  u64 lost, delivered;
+  u32 bound;
+
+  if (!bd->round_start)
+    return;
+
+  lost = tc->lost - bd->round_lost;
+  delivered = tc->delivered - bd->round_delivered;
+  bd->round_lost = tc->lost;
+  bd->round_delivered = tc->delivered;
+
+  if (!bbr_cfg.loss_response || !bbr_is_probing_bw (bd) || !lost
+      || lost <= bbr_cfg.loss_thresh * (lost + delivered))
+    return;
+
+  /* Small windows in startup see a high loss rate after a single loss */
+  if (bd->state == BBR_STATE_STARTUP
+      && lost < BBR_FULL_LOSS_SEGS * tc->snd_mss)
+    return;
+
+  /* Inflight at the time the lost data was sent was too high, back off
+   * by beta but don't go below what's needed to fill the pipe */
+  bound = clib_max ((u64) (rs->tx_in_flight * BBR_BETA),
+		    bbr_bdp (tc, bd, 1.0));
+  bd->inflight_hi = clib_max (bound, bbr_min_cwnd (tc));
+
+  if (bd->state == BBR_STATE_STARTUP)
+    bd->full_bw_reached = 1;
+  else
+    bbr_advance_cycle (tc, bd);
+}
+
+static void
+bbr_check_full_bw_reached (bbr_data_t *bd, tcp_rate_sample_t *rs)
+{
+  u64 bw;
+
+  if (bd->full_bw_reached || !bd->round_start
+      || (rs->flags & TCP_BTS_IS_APP_LIMITED))
+    return;
+
+  bw = bbr_max_bw (bd);
+  if (bw >= bd->full_bw * BBR_FULL_BW_THRESH)
+    {
+      bd->full_bw = bw;
+      bd->full_bw_cnt = 0;
+      return;
+    }
+
+  bd->full_bw_cnt += 1;
+  bd->full_bw_reached = bd->full_bw_cnt >= BBR_FULL_BW_ROUNDS;
+}
+
+static void
+bbr_check_drain (tcp_connection_t *tc, bbr_data_t *bd)
+{
+  if (bd->state == BBR_STATE_STARTUP && bd->full_bw_reached)
+    {
+      bd->state = BBR_STATE_DRAIN;
+      bd->pacing_gain = BBR_DRAIN_GAIN;
+      bd->cwnd_gain = BBR_HIGH_GAIN;
+      tc->ssthresh = bbr_target_cwnd (tc, bd, 1.0);
+    }
+
+  if (bd->state == BBR_STATE_DRAIN
+      && tcp_flight_size (tc) <= bbr_target_cwnd (tc, bd, 1.0))
+    bbr_enter_probe_bw (tc, bd);
+}
+
+static int
+bbr_is_next_cycle_phase (tcp_connection_t *tc, bbr_data_t *bd,
+			 tcp_rate_sample_t *rs)
+{
+  f64 now = bbr_time (tc->c_thread_index);
+  u8 is_full_length = now - bd->cycle_stamp > bd->min_rtt;
+  u32 inflight;
+
+  if (bd->pacing_gain == 1)
+    return is_full_length;
+
+  inflight = tcp_flight_size (tc);
+
+  /* Probe until inflight reaches the gain scaled bdp or loss is seen */
+  if (bd->pacing_gain > 1)
+    return is_full_length
+	   && (rs->last_lost || inflight >= bbr_bdp (tc, bd, bd->pacing_gain));
+
+  /* Drain phase ends early once the queue built while probing is gone */
+  return is_full_length || inflight <= bbr_bdp (tc, bd, 1.0);
+}
+
+static void
+bbr_update_cycle_phase (tcp_connection_t *tc, bbr_data_t *bd,
+			tcp_rate_sample_t *rs)
+{
+  if (bd->state == BBR_STATE_PROBE_BW
+      && bbr_is_next_cycle_phase (tc, bd, rs))
+    bbr_advance_cycle (tc, bd);
+}
+
+static void
+bbr_update_min_rtt (tcp_connection_t *tc, bbr_data_t *bd,
+		    tcp_rate_sample_t *rs)
+{
+  f64 now = bbr_time (tc->c_thread_index), rtt;
+  u8 expired;
+
+  /* Use the rtt measured by tcp, which follows Karn's rule, as opposed to
+   * the rate sample rtt */
+  rtt = tc->mrtt_us;
+  expired = now > bd->min_rtt_stamp + BBR_MIN_RTT_WIN;
+  if (rtt > 0 && rtt < BBR_MIN_RTT_WIN
+      && (!bd->min_rtt || rtt < bd->min_rtt || expired))
+    {
+      bd->min_rtt = rtt;
+      bd->min_rtt_stamp = now;
+    }
+
+  /* Min rtt not refreshed in a while, drain the queue to measure it */
+  if (expired && !bd->idle_restart && bd->state != BBR_STATE_PROBE_RTT)
+    {
+      bbr_save_cwnd (tc, bd);
+      bd->state = BBR_STATE_PROBE_RTT;
+      bd->pacing_gain = 1;
+      bd->cwnd_gain = 1;
+      bd->probe_rtt_done_stamp = 0;
+    }
+
+  if (bd->state == BBR_STATE_PROBE_RTT)
+    {
+      if (!bd->probe_rtt_done_stamp
+	  && tcp_flight_size (tc) <= bbr_min_cwnd (tc))
+	{
+	  bd->probe_rtt_done_stamp = now + BBR_PROBE_RTT_TIME;
+	  bd->probe_rtt_round_done = 0;
+	  bd->next_round_delivered = tc->delivered;
+	}
+      else if (bd->probe_rtt_done_stamp)
+	{
+	  if (bd->round_start)
+	    bd->probe_rtt_round_done = 1;
+	  if (bd->probe_rtt_round_done && now > bd->probe_rtt_done_stamp)
+	    {
+	      bd->min_rtt_stamp = now;
+	      tc->cwnd = clib_max (tc->cwnd, bd->prior_cwnd);
+	      if (bd->full_bw_reached)
+		bbr_enter_probe_bw (tc, bd);
+	      else
+		bbr_enter_startup (bd);
+	    }
+	}
+    }
+
+  if (rs->delivered)
+    bd->idle_restart = 0;
+}
+
+static void
+bbr_update_model (tcp_connection_t *tc, bbr_data_t *bd,
+		  tcp_rate_sample_t *rs)
+{
+  bbr_update_round (tc, bd, rs);
+  bbr_update_bw (tc, bd, rs);
+  bbr_check_loss (tc, bd, rs);
+  bbr_update_cycle_phase (tc, bd, rs);
+  bbr_check_full_bw_reached (bd, rs);
+  bbr_check_drain (tc, bd);
+  bbr_update_min_rtt (tc, bd, rs);
+}
+
+static void
+bbr_set_cwnd (tcp_connection_t *tc, bbr_data_t *bd, tcp_rate_sample_t *rs)
+{
+  u32 target, cwnd = tc->cwnd, acked = rs->acked_and_sacked;
+
+  if (!acked)
+    goto done;
+
+  /* First round of recovery, send one segment for every segment that
+   * left the network */
+  if (tcp_in_cong_recovery (tc) && bd->packet_conservation)
+    {
+      cwnd = clib_max (cwnd, tcp_flight_size (tc) + acked);
+      goto done;
+    }
+
+  target = bbr_target_cwnd (tc, bd, bd->cwnd_gain);
+  if (bd->full_bw_reached)
+    cwnd = clib_min (cwnd + acked, target);
+  else if (cwnd < target || tc->delivered < tcp_initial_cwnd (tc))
+    cwnd = cwnd + acked;
+
+done:
+
+  if (bd->inflight_hi)
+    {
+      /* Probing and limited by the bound, grow it with delivered data as
+       * in slow start. Excess loss caps it again */
+      if (bd->state == BBR_STATE_PROBE_BW && bd->pacing_gain > 1
+	  && tcp_flight_size (tc) + acked >= bd->inflight_hi)
+	bd->inflight_hi += acked;
+
+      u32 bound = bd->inflight_hi;
+      /* Leave headroom for other flows unless probing */
+      if (bd->state == BBR_STATE_PROBE_BW && bd->pacing_gain <= 1)
+	bound *= BBR_INFLIGHT_HEADROOM;
+      cwnd = clib_min (cwnd, bound);
+    }
+
+  /* Constrained by tx fifo, can't grow further */
+  cwnd = clib_min (cwnd, clib_max (tc->tx_fifo_size, tc->cwnd));
+  cwnd = clib_max (cwnd, bbr_min_cwnd (tc));
+
+  if (bd->state == BBR_STATE_PROBE_RTT)
+    cwnd = clib_min (cwnd, bbr_min_cwnd (tc));
+
+  tc->cwnd = cwnd;
+}
+
+static void
+bbr_rcv_ack (tcp_connection_t *tc, tcp_rate_sample_t *rs)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  bbr_update_model (tc, bd, rs);
+  bbr_set_cwnd (tc, bd, rs);
+}
+
+static void
+bbr_rcv_cong_ack (tcp_connection_t *tc, tcp_cc_ack_t ack_type,
+		  tcp_rate_sample_t *rs)
+{
+  /* Model is updated with all feedback, including dupacks that sack
+   * new data. Recovery is handled by cwnd update */
+  bbr_rcv_ack (tc, rs);
+}
+
+static void
+bbr_congestion (tcp_connection_t *tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  bbr_save_cwnd (tc, bd);
+  bd->packet_conservation = 1;
+  bd->next_round_delivered = tc->delivered;
+
+  /* Loss is not a congestion signal for the model. Proportional rate
+   * reduction is not paced, so let it converge to the estimated bdp, but
+   * never above the pre-loss cwnd as that would grow flight in recovery */
+  tc->ssthresh = bbr_target_cwnd (tc, bd, 1.0);
+  if (bd->inflight_hi)
+    tc->ssthresh = clib_min (tc->ssthresh, bd->inflight_hi);
+  tc->ssthresh = clib_min (tc->ssthresh, tc->prev_cwnd);
+  tc->ssthresh = clib_max (tc->ssthresh, bbr_min_cwnd (tc));
+  tc->cwnd = clib_max (tcp_flight_size (tc) + tc->snd_mss,
+		       bbr_min_cwnd (tc));
+}
+
+static void
+bbr_loss (tcp_connection_t *tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  bbr_save_cwnd (tc, bd);
+  bd->packet_conservation = 1;
+  bd->next_round_delivered = tc->delivered;
+  tc->cwnd = tcp_loss_wnd (tc);
+}
+
+static void
+bbr_recovered (tcp_connection_t *tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+
+  bd->packet_conservation = 0;
+  tc->cwnd = clib_max (tc->cwnd, bd->prior_cwnd);
+}
+
+static void
+bbr_event (tcp_connection_t *tc, tcp_cc_event_t evt)
+{
+  bbr_data_t *bd;
+
+  if (evt != TCP_CC_EVT_START_TX)
+    return;
+
+  /* Restarting after idle. Don't probe_rtt because of the idle period and
+   * pace at estimated bandwidth until the pipe is refilled */
+  bd = bbr_data (tc);
+  bd->idle_restart = 1;
+  if (bd->state == BBR_STATE_PROBE_BW)
+    bd->pacing_gain = 1;
+}
+
+static u64
+bbr_get_pacing_rate (tcp_connection_t *tc)
+{
+  bbr_data_t *bd = bbr_data (tc);
+  u64 bw = bbr_max_bw (bd);
+  f64 srtt;
+
+  if (bw)
+    return bd->pacing_gain * bw * BBR_PACING_MARGIN;
+
+  /* No bandwidth sample yet, pace initial window over srtt or, if there's
+   * no rtt sample either, over the initial rtt */
+  srtt = clib_min ((f64) tc->srtt * TCP_TICK, tc->mrtt_us);
+  if (srtt <= 0)
+    srtt = BBR_INITIAL_RTT;
+  return bd->pacing_gain * ((f64) tc->cwnd / srtt);
+}
+
+static void
+bbr_conn_init (tcp_connection_t *tc)
+{
+  bbr_data_t **bdp = (bbr_data_t **) tcp_cc_data (tc), *bd;
+
+  bd = clib_mem_alloc (sizeof (*bd));
+  clib_memset (bd, 0, sizeof (*bd));
+  *bdp = bd;
+
+  bbr_enter_startup (bd);
+  bd->min_rtt_stamp = bbr_time (tc->c_thread_index);
+  bd->cycle_stamp = bd->min_rtt_stamp;
+
+  tc->ssthresh = 0x7FFFFFFFU;
+  tc->cwnd = tcp_initial_cwnd (tc);
+
+  /* Model depends on delivery rate samples */
+  tc->cfg_flags |= TCP_CFG_F_RATE_SAMPLE;
+  /* Pacing rate is the model's, full segments must not cap it */
+  tc->connection.flags |= TRANSPORT_CONNECTION_F_TX_PACED_ROUND_UP;
+}
+
+static void
+bbr_conn_cleanup (tcp_connection_t *tc)
+{
+  bbr_data_t **bdp = (bbr_data_t **) tcp_cc_data (tc);
+
+  clib_mem_free (*bdp);
+  *bdp = 0;
+}
+
+static uword
+bbr_unformat_config (unformat_input_t *input)
+{
+  u32 loss_thresh;
+
+  if (!input)
+    return 0;
+
+  unformat_skip_white_space (input);
+
+  while (unformat_check_input (input) != UNFORMAT_END_OF_INPUT)
+    {
+      if (unformat (input, "no-loss-response"))
+	bbr_cfg.loss_response = 0;
+      else if (unformat (input, "loss-thresh %u", &loss_thresh)
+	       && loss_thresh < 100)
+	bbr_cfg.loss_thresh = loss_thresh / 100.0;
+      else
+	return 0;
+    }
+  return 1;
+}
+
+const static tcp_cc_algorithm_t tcp_bbr = {
+  .name = "bbr",
+  .unformat_cfg = bbr_unformat_config,
+  .init = bbr_conn_init,
+  .cleanup = bbr_conn_cleanup,
+  .congestion = bbr_congestion,
+  .loss = bbr_loss,
+  .recovered = bbr_recovered,
+  .rcv_ack = bbr_rcv_ack,
+  .rcv_cong_ack = bbr_rcv_cong_ack,
+  .event = bbr_event,
+  .get_pacing_rate = bbr_get_pacing_rate,
+};
+
+clib_error_t *
+bbr_init (vlib_main_t *vm)
+{
+  clib_error_t *error = 0;
+
+  tcp_cc_algo_register (TCP_CC_BBR, &tcp_bbr);
+
+  return error;
+}
+
+VLIB_INIT_FUNCTION (bbr_init);
@@ -489,6 +489,16 @@ tcp_bt_sample_to_rate_sample (tcp_connection_t * tc, tcp_bt_sample_t * bts,
   tc->first_tx_time = bts->tx_time;
 }
 
+static inline void
+tcp_bt_sample_to_rack (tcp_connection_t *tc, tcp_bt_sample_t *bts,
+		       u32 end_seq)
+{
+  if (!(tc->cfg_flags & TCP_CFG_F_RACK) || (bts->flags & TCP_BTS_IS_SACKED))
+    return;
+
+  tcp_rack_update (tc, bts->tx_time, end_seq, bts->flags & TCP_BTS_IS_RXT);
+}
+
 static void
 tcp_bt_walk_samples (tcp_connection_t * tc, tcp_rate_sample_t * rs)
 {
@@ -500,12 +510,14 @@ tcp_bt_walk_samples (tcp_connection_t * tc, tcp_rate_sample_t * rs)
     {
       next = bt_next_sample (bt, cur);
       tcp_bt_sample_to_rate_sample (tc, cur, rs);
+      tcp_bt_sample_to_rack (tc, cur, cur->max_seq);
       bt_free_sample (bt, cur);
       cur = next;
     }
 
   if (cur && seq_lt (cur->min_seq, tc->snd_una))
     {
+      tcp_bt_sample_to_rack (tc, cur, tc->snd_una);
       bt_update_sample (bt, cur, tc->snd_una);
       tcp_bt_sample_to_rate_sample (tc, cur, rs);
     }
@@ -548,6 +560,7 @@ tcp_bt_walk_samples_ooo (tcp_connection_t * tc, tcp_rate_sample_t * rs)
 	  if (!(cur->flags & TCP_BTS_IS_SACKED))
 	    {
 	      tcp_bt_sample_to_rate_sample (tc, cur, rs);
+	      tcp_bt_sample_to_rack (tc, cur, cur->max_seq);
 	      cur->flags |= TCP_BTS_IS_SACKED;
 	      if (prev && (prev->flags & TCP_BTS_IS_SACKED))
 		{
@@ -574,6 +587,7 @@ tcp_bt_walk_samples_ooo (tcp_connection_t * tc, tcp_rate_sample_t * rs)
       if (cur && seq_lt (cur->min_seq, blk->end))
 	{
 	  tcp_bt_sample_to_rate_sample (tc, cur, rs);
+	  tcp_bt_sample_to_rack (tc, cur, blk->end);
 	  prev = bt_prev_sample (bt, cur);
 	  /* Extend previous to include the newly sacked bytes */
 	  if (prev && (prev->flags & TCP_BTS_IS_SACKED))
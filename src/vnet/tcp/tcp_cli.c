@@ -159,6 +159,24 @@ format_tcp_congestion (u8 * s, va_list * args)
   return s;
 }
 
+static u8 *
+format_tcp_rack (u8 *s, va_list *args)
+{
+  tcp_connection_t *tc = va_arg (*args, tcp_connection_t *);
+  static const char *timer_str[] = { "rto", "reo", "tlp" };
+  u32 indent = format_get_indent (s);
+  tcp_rack_t *rack = &tc->rack;
+
+  s = format (s, "end_seq %u fack %u rtt %.3f min_rtt %.3f reordering %u\n",
+	      rack->end_seq - tc->iss, rack->fack - tc->iss, rack->rtt * 1e3,
+	      rack->min_rtt * 1e3, rack->reordering_seen);
+  s = format (s, "%Ureo_timeout %.3f timer %s tlp_high_seq %u",
+	      format_white_space, indent, rack->reo_timeout * 1e3,
+	      timer_str[rack->timer],
+	      rack->tlp_high_seq ? rack->tlp_high_seq - tc->iss : 0);
+  return s;
+}
+
 static u8 *
 format_tcp_stats (u8 * s, va_list * args)
 {
@@ -217,6 +235,8 @@ format_tcp_vars (u8 * s, va_list * args)
     {
       s = format (s, " sboard: %U\n", format_tcp_scoreboard, &tc->sack_sb,
 		  tc);
+      if (tc->cfg_flags & TCP_CFG_F_RACK)
+	s = format (s, " rack: %U\n", format_tcp_rack, tc);
       s = format (s, " stats: %U\n", format_tcp_stats, tc);
     }
   if (vec_len (tc->snd_sacks))
@@ -857,6 +877,10 @@ format_tcp_cfg (u8 *s, va_list *args)
   s = format (s, "tso: %s\n", tm_cfg.allow_tso ? "allowed" : "disallowed");
   s = format (s, "checksum offload: %s\n",
 	      tm_cfg.csum_offload ? "enabled" : "disabled");
+  s = format (s, "rx coalescing: %s\n",
+	      tm_cfg.rx_coalesce ? "enabled" : "disabled");
+  s = format (s, "rack-tlp: %s\n",
+	      tm_cfg.enable_rack ? "enabled" : "disabled");
   s = format (s, "congestion control algorithm: %s\n",
 	      tcp_cc_algo_get (tm_cfg.cc_algo)->name);
   s = format (s, "min rwnd update ack: %u\n", tm_cfg.rwnd_min_update_ack);
@@ -1069,6 +1093,10 @@ tcp_config_fn (vlib_main_t * vm, unformat_input_t * input)
 	tcp_cfg.allow_tso = 1;
       else if (unformat (input, "no-csum-offload"))
 	tcp_cfg.csum_offload = 0;
+      else if (unformat (input, "no-rx-coalesce"))
+	tcp_cfg.rx_coalesce = 0;
+      else if (unformat (input, "rack"))
+	tcp_cfg.enable_rack = 1;
       else if (unformat (input, "max-gso-size %u", &max_gso_size))
 	tcp_cfg.max_gso_size = clib_min (max_gso_size, TCP_MAX_GSO_SZ);
       else if (unformat (input, "cc-algo %U", unformat_tcp_cc_algo,
@@ -18,6 +18,7 @@
 #include <vnet/fib/ip6_fib.h>
 #include <vnet/tcp/tcp.h>
 #include <vnet/tcp/tcp_inlines.h>
+#include <vnet/gso/gso.h>
 #include <vnet/session/session.h>
 #include <math.h>
 
@@ -598,6 +599,7 @@ tcp_update_snd_wnd (tcp_connection_t * tc, u32 seq, u32 ack, u32 snd_wnd)
     }
 }
 
+#ifndef CLIB_MARCH_VARIANT
 /**
  * Init loss recovery/fast recovery.
  *
@@ -630,6 +632,22 @@ tcp_cc_init_congestion (tcp_connection_t * tc)
   TCP_EVT (TCP_EVT_CC_EVT, tc, 4);
 }
 
+/**
+ * Enter fast recovery and program retransmit of lost segments
+ */
+void
+tcp_enter_fast_recovery (tcp_connection_t *tc)
+{
+  tcp_cc_init_congestion (tc);
+
+  if (tcp_opts_sack_permitted (&tc->rcv_opts))
+    scoreboard_init_rxt (&tc->sack_sb, tc->snd_una);
+
+  tcp_connection_tx_pacer_reset (tc, tc->cwnd, 0 /* start bucket */);
+  tcp_program_retransmit (tc);
+}
+#endif /* CLIB_MARCH_VARIANT */
+
 static void
 tcp_cc_congestion_undo (tcp_connection_t * tc)
 {
@@ -658,6 +676,10 @@ tcp_cc_is_spurious_retransmit (tcp_connection_t * tc)
 static inline u8
 tcp_should_fastrecover (tcp_connection_t * tc, u8 has_sack)
 {
+  /* RACK marks holes as lost once reordering window expires */
+  if (tc->cfg_flags & TCP_CFG_F_RACK)
+    return tc->sack_sb.lost_bytes != 0;
+
   if (!has_sack)
     {
       /* If of of the two conditions lower hold, reset dupacks because
@@ -770,15 +792,7 @@ tcp_cc_handle_event (tcp_connection_t * tc, tcp_rate_sample_t * rs,
       tcp_cc_rcv_cong_ack (tc, TCP_CC_DUPACK, rs);
 
       if (tcp_should_fastrecover (tc, has_sack))
-	{
-	  tcp_cc_init_congestion (tc);
-
-	  if (has_sack)
-	    scoreboard_init_rxt (&tc->sack_sb, tc->snd_una);
-
-	  tcp_connection_tx_pacer_reset (tc, tc->cwnd, 0 /* start bucket */ );
-	  tcp_program_retransmit (tc);
-	}
+	tcp_enter_fast_recovery (tc);
 
       return;
     }
@@ -811,7 +825,8 @@ tcp_cc_handle_event (tcp_connection_t * tc, tcp_rate_sample_t * rs,
 	tcp_fastrecovery_first_on (tc);
 
       tc->rxt_delivered += tc->sack_sb.rxt_sacked;
-      tc->prr_delivered += rs->delivered;
+      /* Bytes delivered by this ack, not by the rate sample interval */
+      tc->prr_delivered += rs->acked_and_sacked;
     }
   else
     {
@@ -857,6 +872,26 @@ tcp_cc_handle_event (tcp_connection_t * tc, tcp_rate_sample_t * rs,
     tcp_cc_rcv_cong_ack (tc, TCP_CC_PARTIALACK, rs);
 }
 
+/**
+ * RACK-TLP ack processing. Marks segments deemed lost and enters recovery
+ * if needed. If reordering window has not yet elapsed for some segments,
+ * the retransmit timer is armed for it, unless already armed for an
+ * earlier window. When that expires, loss detection is retried and the
+ * timer rearmed.
+ */
+static void
+tcp_rack_rcv_ack (tcp_worker_ctx_t *wrk, tcp_connection_t *tc)
+{
+  tcp_rack_tlp_rcv_ack (tc);
+
+  if (tcp_rack_detect_loss (tc) && !tcp_in_cong_recovery (tc)
+      && !tcp_is_lost_fin (tc) && !tc->sack_sb.is_reneging)
+    tcp_enter_fast_recovery (tc);
+
+  if (tc->rack.reo_timeout > 0 && tc->rack.timer != TCP_RXT_TIMER_REO)
+    tcp_retransmit_timer_update (&wrk->timer_wheel, tc);
+}
+
 static void
 tcp_handle_old_ack (tcp_connection_t * tc, tcp_rate_sample_t * rs)
 {
@@ -959,8 +994,11 @@ tcp_rcv_ack (tcp_worker_ctx_t * wrk, tcp_connection_t * tc, vlib_buffer_t * b,
   if (tc->cfg_flags & TCP_CFG_F_RATE_SAMPLE)
     tcp_bt_sample_delivery_rate (tc, &rs);
   else
-    rs.delivered = tc->bytes_acked + tc->sack_sb.last_sacked_bytes -
-		   tc->sack_sb.last_bytes_delivered;
+    {
+      rs.delivered = tc->bytes_acked + tc->sack_sb.last_sacked_bytes -
+		     tc->sack_sb.last_bytes_delivered;
+      rs.acked_and_sacked = rs.delivered;
+    }
 
   if (tc->bytes_acked + tc->sack_sb.last_sacked_bytes)
     {
@@ -969,6 +1007,9 @@ tcp_rcv_ack (tcp_worker_ctx_t * wrk, tcp_connection_t * tc, vlib_buffer_t * b,
 	tcp_program_dequeue (wrk, tc);
     }
 
+  if (tc->cfg_flags & TCP_CFG_F_RACK)
+    tcp_rack_rcv_ack (wrk, tc);
+
   TCP_EVT (TCP_EVT_ACK_RCVD, tc);
 
   /*
@@ -1394,14 +1435,87 @@ tcp_segment_handle_exception (tcp_connection_t *tc, tcp_header_t *th,
     }
 }
 
+/**
+ * Coalesce in-order segments that follow b[0] in the frame
+ *
+ * Payloads of contiguous segments of the same connection, whose headers
+ * differ only in sequence number and checksum, are chained to the head
+ * buffer so the whole run is validated, acked and enqueued to the rx fifo
+ * in one pass. Only segments that can be enqueued in order are merged.
+ *
+ * @return number of buffers chained to b[0]
+ */
+static_always_inline u32
+tcp_segment_coalesce (vlib_main_t *vm, tcp_connection_t *tc,
+		      vlib_buffer_t **b, u32 *bi, u32 n_left)
+{
+  vlib_buffer_t *hb = b[0], *last = b[0], *nb;
+  tcp_header_t *th, *nth;
+  u32 i, hdr_len, data_len, seq_end;
+
+  th = tcp_buffer_hdr (hb);
+  data_len = vnet_buffer (hb)->tcp.data_len;
+  if (tc->state != TCP_STATE_ESTABLISHED || !data_len ||
+      vnet_buffer (hb)->tcp.seq_number != tc->rcv_nxt ||
+      (hb->flags & VLIB_BUFFER_NEXT_PRESENT) ||
+      (th->flags & ~TCP_FLAG_PSH) != TCP_FLAG_ACK)
+    return 0;
+
+  hdr_len = tcp_header_bytes (th);
+  seq_end = vnet_buffer (hb)->tcp.seq_end;
+
+  for (i = 1; i < n_left; i++)
+    {
+      nb = b[i];
+      nth = tcp_buffer_hdr (nb);
+      if (vnet_buffer (nb)->tcp.connection_index !=
+	    vnet_buffer (hb)->tcp.connection_index ||
+	  vnet_buffer (nb)->tcp.seq_number != seq_end ||
+	  !vnet_buffer (nb)->tcp.data_len ||
+	  data_len + vnet_buffer (nb)->tcp.data_len > TCP_RX_COALESCE_MAX ||
+	  (nb->flags & VLIB_BUFFER_NEXT_PRESENT) ||
+	  nth->ack_number != th->ack_number || nth->window != th->window ||
+	  (nth->flags & ~TCP_FLAG_PSH) != TCP_FLAG_ACK ||
+	  tcp_header_bytes (nth) != hdr_len ||
+	  memcmp (nth + 1, th + 1, hdr_len - sizeof (tcp_header_t)))
+	break;
+
+      /* Chain payload, i.e., without headers and trailing bytes */
+      vlib_buffer_advance (nb, vnet_buffer (nb)->tcp.data_offset);
+      nb->current_length = vnet_buffer (nb)->tcp.data_len;
+      last->next_buffer = bi[i];
+      last->flags |= VLIB_BUFFER_NEXT_PRESENT;
+      last = nb;
+
+      data_len += nb->current_length;
+      seq_end = vnet_buffer (nb)->tcp.seq_end;
+    }
+
+  if (i == 1)
+    return 0;
+
+  hb->current_length = vnet_buffer (hb)->tcp.data_offset +
+		       vnet_buffer (hb)->tcp.data_len;
+  hb->total_length_not_including_first_buffer =
+    data_len - vnet_buffer (hb)->tcp.data_len;
+  hb->flags |= VLIB_BUFFER_TOTAL_LENGTH_VALID;
+  vnet_buffer (hb)->tcp.data_len = data_len;
+  vnet_buffer (hb)->tcp.seq_end = seq_end;
+  tc->data_segs_in += i - 1;
+
+  return i - 1;
+}
+
 always_inline uword
 tcp46_established_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 			  vlib_frame_t * frame, int is_ip4)
 {
-  u32 thread_index = vm->thread_index, n_left_from, *from;
+  u32 thread_index = vm->thread_index, n_left_from, *from, *bi;
   tcp_worker_ctx_t *wrk = tcp_get_worker (thread_index);
   vlib_buffer_t *bufs[VLIB_FRAME_SIZE], **b;
+  u32 to_free[VLIB_FRAME_SIZE], n_free = 0;
   u16 err_counters[TCP_N_ERROR] = { 0 };
+  u8 rx_coalesce = tcp_cfg.rx_coalesce;
 
   if (node->flags & VLIB_NODE_FLAG_TRACE)
     tcp_established_trace_frame (vm, node, frame, is_ip4);
@@ -1411,10 +1525,11 @@ tcp46_established_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 
   vlib_get_buffers (vm, from, bufs, n_left_from);
   b = bufs;
+  bi = from;
 
   while (n_left_from > 0)
     {
-      u32 error = TCP_ERROR_ACK_OK;
+      u32 error = TCP_ERROR_ACK_OK, n_merged = 0;
       tcp_connection_t *tc;
       tcp_header_t *th;
 
@@ -1434,6 +1549,10 @@ tcp46_established_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	  goto done;
 	}
 
+      /* Merge in-order data segments that follow into one chain */
+      if (rx_coalesce && n_left_from > 1)
+	n_merged = tcp_segment_coalesce (vm, tc, b, bi, n_left_from);
+
       /* TODO header prediction fast path */
 
       /* 1-4: check SEQ, RST, SYN */
@@ -1458,17 +1577,22 @@ tcp46_established_inline (vlib_main_t * vm, vlib_node_runtime_t * node,
 	tcp_rcv_fin (wrk, tc, b[0], &error);
 
     done:
-      tcp_inc_err_counter (err_counters, error, 1);
+      tcp_inc_err_counter (err_counters, error, 1 + n_merged);
+      tcp_inc_err_counter (err_counters, TCP_ERROR_COALESCED, n_merged);
 
-      n_left_from -= 1;
-      b += 1;
+      /* Merged buffers are freed with the head's chain */
+      to_free[n_free++] = bi[0];
+
+      n_left_from -= 1 + n_merged;
+      b += 1 + n_merged;
+      bi += 1 + n_merged;
     }
 
   session_main_flush_enqueue_events (TRANSPORT_PROTO_TCP, thread_index);
   tcp_store_err_counters (established, err_counters);
   tcp_handle_postponed_dequeues (wrk);
   tcp_handle_disconnects (wrk);
-  vlib_buffer_free (vm, from, frame->n_vectors);
+  vlib_buffer_free (vm, to_free, n_free);
 
   return frame->n_vectors;
 }
@@ -1674,6 +1798,8 @@ tcp_check_tx_offload (tcp_connection_t * tc, int is_ipv4)
   vnet_hw_interface_t *hw_if;
   u32 sw_if_idx, lb_idx;
 
+  tc->gso_epoch = tcp_main.gso_epoch;
+
   if (is_ipv4)
     {
       ip4_address_t *dst_addr = &(tc->c_rmt_ip.ip4);
@@ -1697,6 +1823,9 @@ tcp_check_tx_offload (tcp_connection_t * tc, int is_ipv4)
   hw_if = vnet_get_sup_hw_interface (vnm, sw_if_idx);
   if (hw_if->caps & VNET_HW_IF_CAP_TCP_GSO)
     tc->cfg_flags |= TCP_CFG_F_TSO;
+  /* Segmentation deferred to the gso node, which works on any interface */
+  else if (vnet_sw_interface_gso_is_enabled (sw_if_idx, !is_ipv4))
+    tc->cfg_flags |= TCP_CFG_F_TSO;
 }
 
 static void
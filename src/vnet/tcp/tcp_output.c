@@ -1305,6 +1305,35 @@ tcp_check_syn_flood (tcp_connection_t *tc)
   tm->sdl_cb (&args);
 }
 
+/**
+ * Tail loss probe timeout. RFC 8985 Sec. 7.3
+ *
+ * Retransmit the last segment sent to elicit an ack that triggers fast
+ * recovery, if tail segments were lost, and fall back to rto afterwards.
+ */
+static void
+tcp_timer_tlp_handler (tcp_worker_ctx_t *wrk, tcp_connection_t *tc)
+{
+  vlib_buffer_t *b = 0;
+  u32 n_bytes, offset;
+
+  tc->rack.timer = TCP_RXT_TIMER_RTO;
+
+  n_bytes = clib_min (tc->snd_mss, tc->snd_nxt - tc->snd_una);
+  offset = tc->snd_nxt - tc->snd_una - n_bytes;
+  n_bytes = tcp_prepare_retransmit_segment (wrk, tc, offset, n_bytes, &b);
+  if (n_bytes)
+    {
+      tcp_enqueue_to_output (wrk, b, vlib_get_buffer_index (wrk->vm, b),
+			     tc->c_is_ip4);
+      tc->rack.tlp_high_seq = tc->snd_nxt;
+      tc->rack.tlp_ts = tcp_tstamp (tc);
+      tcp_worker_stats_inc (wrk, tlp_probes, 1);
+    }
+
+  tcp_retransmit_timer_update (&wrk->timer_wheel, tc);
+}
+
 void
 tcp_timer_retransmit_handler (tcp_connection_t * tc)
 {
@@ -1344,6 +1373,16 @@ tcp_timer_retransmit_handler (tcp_connection_t * tc)
 	  return;
 	}
 
+      /* Timer was armed for RACK-TLP, not for an rto */
+      if (PREDICT_FALSE (tc->rack.timer != TCP_RXT_TIMER_RTO))
+	{
+	  if (tc->rack.timer == TCP_RXT_TIMER_TLP)
+	    tcp_timer_tlp_handler (wrk, tc);
+	  else
+	    tcp_rack_reo_timer_handler (tc);
+	  return;
+	}
+
       /* We're not in recovery so make sure rto_boff is 0. Can be non 0 due
        * to persist timer timeout */
       if (!tcp_in_recovery (tc) && tc->rto_boff > 0)
@@ -1394,6 +1433,7 @@ tcp_timer_retransmit_handler (tcp_connection_t * tc)
       tcp_retransmit_timer_update (&wrk->timer_wheel, tc);
 
       tc->rto_boff += 1;
+      tc->rack.tlp_high_seq = 0;
       if (tc->rto_boff == 1)
 	{
 	  tcp_cc_init_rxt_timeout (tc);
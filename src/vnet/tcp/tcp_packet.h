@@ -174,6 +174,7 @@ typedef struct
 #define TCP_OPTS_ALIGN                  4
 #define TCP_OPTS_MAX_SACK_BLOCKS        3
 #define TCP_MAX_GSO_SZ 			65536
+#define TCP_RX_COALESCE_MAX		65535U	/* Max coalesced payload */
 
 /* Modulo arithmetic for TCP sequence numbers */
 #define seq_lt(_s1, _s2) ((i32)((_s1)-(_s2)) < 0)
@@ -0,0 +1,265 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+/**
+ * RACK-TLP loss detection (RFC 8985)
+ *
+ * Segments are considered lost based on time, not on the number of
+ * segments sacked above them: a segment is lost if a segment sent after it
+ * was delivered and more than one rtt plus a reordering window have passed
+ * since it was sent. Transmit times are provided by the tcp byte tracker
+ * (@ref tcp_bt.c) so rate sampling is enabled for connections that use
+ * RACK. Lost segments are marked in the sack scoreboard, which replaces the
+ * dupack threshold based marking for these connections.
+ *
+ * The reordering window and tail loss probe timeouts do not use timers of
+ * their own. They are armed on the connection's retransmit timer instead,
+ * and @ref tcp_rack_t.timer records which event is pending, so the number
+ * of timers per connection in the timer wheel does not change.
+ */
+
+#include <vnet/tcp/tcp_rack.h>
+#include <vnet/tcp/tcp.h>
+#include <vnet/tcp/tcp_inlines.h>
+
+void
+tcp_rack_init (tcp_connection_t *tc)
+{
+  tcp_rack_t *rack = &tc->rack;
+
+  clib_memset (rack, 0, sizeof (*rack));
+  rack->end_seq = rack->fack = tc->snd_una;
+  rack->timer = TCP_RXT_TIMER_RTO;
+}
+
+/**
+ * Update RACK state with segment delivered, i.e., acked or sacked, by the
+ * ack being processed. RFC 8985 Sec. 6.2, steps 1-3.
+ */
+void
+tcp_rack_update (tcp_connection_t *tc, f64 tx_time, u32 end_seq, u8 is_rxt)
+{
+  tcp_rack_t *rack = &tc->rack;
+  f64 rtt;
+
+  rtt = tcp_time_now_us (tc->c_thread_index) - tx_time;
+
+  if (is_rxt)
+    {
+      /* Ack might be for the original transmission, so rtt is ambiguous */
+      if (rtt < rack->min_rtt)
+	return;
+    }
+  else
+    {
+      if (!rack->min_rtt || rtt < rack->min_rtt)
+	rack->min_rtt = rtt;
+      /* Segment delivered after one with higher sequence number */
+      if (seq_lt (end_seq, rack->fack))
+	rack->reordering_seen = 1;
+    }
+
+  if (seq_gt (end_seq, rack->fack))
+    rack->fack = end_seq;
+
+  if (tx_time > rack->xmit_ts
+      || (tx_time == rack->xmit_ts && seq_gt (end_seq, rack->end_seq)))
+    {
+      rack->xmit_ts = tx_time;
+      rack->end_seq = end_seq;
+      rack->rtt = rtt;
+    }
+}
+
+/**
+ * Reordering window. RFC 8985 Sec. 6.2, step 4.
+ *
+ * If no reordering was seen, do not wait for reordering once in recovery
+ * or once dupthresh segments have been sacked. Otherwise, use a quarter of
+ * the min rtt, bounded by srtt.
+ */
+static f64
+tcp_rack_reo_wnd (tcp_connection_t *tc)
+{
+  tcp_rack_t *rack = &tc->rack;
+
+  if (!rack->reordering_seen
+      && (tcp_in_cong_recovery (tc)
+	  || tc->sack_sb.sacked_bytes >= TCP_DUPACK_THRESHOLD * tc->snd_mss))
+    return 0;
+
+  return clib_min (rack->min_rtt / 4, tc->srtt * TCP_TICK);
+}
+
+/**
+ * Mark scoreboard holes as lost if their segments were sent before the
+ * most recently sent delivered segment and their rtt plus reordering window
+ * has elapsed. RFC 8985 Sec. 6.2, step 5.
+ *
+ * If some segments could still be reordered, time left until the last of
+ * them is deemed lost is saved in @ref tcp_rack_t.reo_timeout.
+ *
+ * @return number of bytes newly marked as lost
+ */
+u32
+tcp_rack_detect_loss (tcp_connection_t *tc)
+{
+  sack_scoreboard_t *sb = &tc->sack_sb;
+  tcp_byte_tracker_t *bt = tc->bt;
+  tcp_rack_t *rack = &tc->rack;
+  sack_scoreboard_hole_t *hole;
+  f64 now, reo_wnd, left, timeout = 0;
+  u32 bts_index, lost = 0;
+  tcp_bt_sample_t *bts;
+
+  rack->reo_timeout = 0;
+
+  hole = scoreboard_first_hole (sb);
+  if (!hole || !rack->xmit_ts || bt->head == TCP_BTS_INVALID_INDEX)
+    return 0;
+
+  now = tcp_time_now_us (tc->c_thread_index);
+  reo_wnd = tcp_rack_reo_wnd (tc);
+
+  /* Samples and holes are both sorted by sequence number. Stop at the
+   * first original transmission newer than the rack reference */
+  bts_index = bt->head;
+  while (bts_index != TCP_BTS_INVALID_INDEX)
+    {
+      bts = pool_elt_at_index (bt->samples, bts_index);
+      bts_index = bts->next;
+
+      /* Not sent before the most recently delivered segment. Original
+       * transmissions after it, and their retransmissions, are newer still,
+       * so only retransmissions can be followed by older samples */
+      if (bts->tx_time > rack->xmit_ts
+	  || (bts->tx_time == rack->xmit_ts
+	      && seq_geq (bts->max_seq, rack->end_seq)))
+	{
+	  if (!(bts->flags & TCP_BTS_IS_RXT))
+	    break;
+	  continue;
+	}
+
+      if (bts->flags & TCP_BTS_IS_SACKED)
+	continue;
+
+      while (hole && seq_leq (hole->end, bts->min_seq))
+	hole = scoreboard_next_hole (sb, hole);
+
+      if (!hole)
+	break;
+
+      if (hole->is_lost || seq_leq (bts->max_seq, hole->start))
+	continue;
+
+      left = bts->tx_time + rack->rtt + reo_wnd - now;
+      if (left <= 0)
+	{
+	  lost += scoreboard_hole_bytes (hole);
+	  hole->is_lost = 1;
+	}
+      else
+	timeout = clib_max (timeout, left);
+    }
+
+  sb->lost_bytes += lost;
+  sb->last_lost_bytes += lost;
+  rack->reo_timeout = timeout;
+
+  return lost;
+}
+
+/**
+ * Retransmit timer interval and use, given the rto in timer ticks.
+ *
+ * Pending reordering window timeouts take precedence. If none, and no
+ * probe is outstanding, schedule a tail loss probe if probe timeout
+ * (RFC 8985 Sec. 7.2) is shorter than the rto.
+ */
+u32
+tcp_rack_timer_interval (tcp_connection_t *tc, u32 rto)
+{
+  tcp_rack_t *rack = &tc->rack;
+  u32 pto, reo;
+
+  rack->timer = TCP_RXT_TIMER_RTO;
+
+  if (tc->state < TCP_STATE_ESTABLISHED || tc->rto_boff
+      || (tc->flags & TCP_CONN_FINSNT))
+    return rto;
+
+  if (rack->reo_timeout > 0)
+    {
+      rack->timer = TCP_RXT_TIMER_REO;
+      reo = clib_max ((u32) (rack->reo_timeout / TCP_TIMER_TICK), 1);
+      return clib_min (reo, rto);
+    }
+
+  if (rack->tlp_high_seq || tcp_in_cong_recovery (tc))
+    return rto;
+
+  /* Account for delayed ack if only one segment is in flight */
+  pto = 2 * tc->srtt;
+  if (tcp_flight_size (tc) <= tc->snd_mss)
+    pto += TCP_RTO_MIN;
+  pto = clib_max ((u32) (pto * TCP_TO_TIMER_TICK), 1);
+  if (pto >= rto)
+    return rto;
+
+  rack->timer = TCP_RXT_TIMER_TLP;
+  return pto;
+}
+
+/**
+ * Check if ack ends tail loss probe episode. RFC 8985 Sec. 7.4
+ *
+ * If the ack echoes a timestamp older than the probe, the original tail
+ * segment was delivered so the probe was not needed. Otherwise, the probe
+ * repaired a loss and congestion control must react to it.
+ */
+void
+tcp_rack_tlp_rcv_ack (tcp_connection_t *tc)
+{
+  tcp_rack_t *rack = &tc->rack;
+
+  if (!rack->tlp_high_seq || seq_lt (tc->snd_una, rack->tlp_high_seq))
+    return;
+
+  rack->tlp_high_seq = 0;
+
+  if (tcp_in_cong_recovery (tc))
+    return;
+
+  if (tcp_opts_tstamp (&tc->rcv_opts)
+      && timestamp_lt (tc->rcv_opts.tsecr, rack->tlp_ts))
+    return;
+
+  tc->prev_ssthresh = tc->ssthresh;
+  tc->prev_cwnd = tc->cwnd;
+  tcp_cc_congestion (tc);
+  tcp_cc_recovered (tc);
+}
+
+/**
+ * Reordering window expired. Mark segments that are now deemed lost
+ * and retransmit them.
+ */
+void
+tcp_rack_reo_timer_handler (tcp_connection_t *tc)
+{
+  tcp_worker_ctx_t *wrk = tcp_get_worker (tc->c_thread_index);
+
+  tcp_worker_stats_inc (wrk, reo_timeouts, 1);
+
+  if (tcp_rack_detect_loss (tc))
+    {
+      if (!tcp_in_cong_recovery (tc))
+	tcp_enter_fast_recovery (tc);
+      else
+	tcp_program_retransmit (tc);
+    }
+
+  tcp_retransmit_timer_update (&wrk->timer_wheel, tc);
+}
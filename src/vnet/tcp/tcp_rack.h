@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+#ifndef SRC_VNET_TCP_TCP_RACK_H_
+#define SRC_VNET_TCP_TCP_RACK_H_
+
+#include <vnet/tcp/tcp_types.h>
+
+void tcp_rack_init (tcp_connection_t *tc);
+void tcp_rack_update (tcp_connection_t *tc, f64 tx_time, u32 end_seq,
+		      u8 is_rxt);
+u32 tcp_rack_detect_loss (tcp_connection_t *tc);
+u32 tcp_rack_timer_interval (tcp_connection_t *tc, u32 rto);
+void tcp_rack_tlp_rcv_ack (tcp_connection_t *tc);
+void tcp_rack_reo_timer_handler (tcp_connection_t *tc);
+
+#endif /* SRC_VNET_TCP_TCP_RACK_H_ */
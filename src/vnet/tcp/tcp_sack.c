@@ -112,7 +112,8 @@ scoreboard_update_sacked (sack_scoreboard_t * sb, u32 start, u32 end,
 }
 
 always_inline void
-scoreboard_update_bytes (sack_scoreboard_t * sb, u32 ack, u32 snd_mss)
+scoreboard_update_bytes (sack_scoreboard_t *sb, u32 ack, u32 snd_mss,
+			 u8 time_based)
 {
   sack_scoreboard_hole_t *left, *right;
   u32 sacked = 0, blks = 0, old_sacked;
@@ -143,9 +144,11 @@ scoreboard_update_bytes (sack_scoreboard_t * sb, u32 ack, u32 snd_mss)
    *   'SeqNum' or more than (DupThresh - 1) * SMSS bytes with sequence
    *   numbers greater than 'SeqNum' have been SACKed.
    * To avoid spurious retransmits, use reordering estimate instead of
-   * DupThresh to detect loss.
+   * DupThresh to detect loss. If loss detection is time based, i.e., RACK,
+   * holes are only marked as lost by it, so just count the bytes.
    */
-  while (sacked <= (sb->reorder - 1) * snd_mss && blks < sb->reorder)
+  while (time_based
+	 || (sacked <= (sb->reorder - 1) * snd_mss && blks < sb->reorder))
     {
       if (right->is_lost)
 	sb->lost_bytes += scoreboard_hole_bytes (right);
@@ -544,7 +547,8 @@ tcp_rcv_sacks (tcp_connection_t * tc, u32 ack)
     }
 
   sb->high_sacked = high_sacked;
-  scoreboard_update_bytes (sb, ack, tc->snd_mss);
+  scoreboard_update_bytes (sb, ack, tc->snd_mss,
+			   tc->cfg_flags & TCP_CFG_F_RACK);
 
   ASSERT (sb->last_sacked_bytes <= sb->sacked_bytes || tcp_in_recovery (tc));
   ASSERT (sb->sacked_bytes == 0 || tcp_in_recovery (tc)
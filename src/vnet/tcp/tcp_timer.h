@@ -16,6 +16,7 @@
 #define __included_tcp_timer_h__
 
 #include <vnet/tcp/tcp_types.h>
+#include <vnet/tcp/tcp_rack.h>
 
 static inline u8
 tcp_timer_thread_is_valid (tcp_connection_t *tc)
@@ -65,12 +66,26 @@ tcp_timer_is_active (tcp_connection_t *tc, tcp_timers_e timer)
 	 (tc->pending_timers & (1 << timer));
 }
 
+/**
+ * Retransmit timer interval. With RACK-TLP, the timer may be armed for a
+ * reordering window or tail loss probe timeout instead of the rto
+ */
+always_inline u32
+tcp_retransmit_timer_interval (tcp_connection_t *tc)
+{
+  u32 rto = clib_max ((u32) tc->rto * TCP_TO_TIMER_TICK, 1);
+
+  if (PREDICT_FALSE (tc->cfg_flags & TCP_CFG_F_RACK))
+    return tcp_rack_timer_interval (tc, rto);
+  return rto;
+}
+
 always_inline void
 tcp_retransmit_timer_set (tcp_timer_wheel_t * tw, tcp_connection_t * tc)
 {
   ASSERT (tc->snd_una != tc->snd_nxt);
   tcp_timer_set (tw, tc, TCP_TIMER_RETRANSMIT,
-		 clib_max ((u32) tc->rto * TCP_TO_TIMER_TICK, 1));
+		 tcp_retransmit_timer_interval (tc));
 }
 
 always_inline void
@@ -105,7 +120,7 @@ tcp_retransmit_timer_update (tcp_timer_wheel_t * tw, tcp_connection_t * tc)
     }
   else
     tcp_timer_update (tw, tc, TCP_TIMER_RETRANSMIT,
-		      clib_max ((u32) tc->rto * TCP_TO_TIMER_TICK, 1));
+		      tcp_retransmit_timer_interval (tc));
 }
 
 always_inline void
@@ -97,6 +97,7 @@ typedef enum _tcp_timers
   _(NO_TSO, "TSO off")				\
   _(TSO, "TSO")					\
   _(NO_ENDPOINT,"No endpoint")			\
+  _(RACK, "RACK-TLP")				\
 
 typedef enum tcp_cfg_flag_bits_
 {
@@ -247,9 +248,33 @@ typedef enum _tcp_cc_algorithm_type
 {
   TCP_CC_NEWRENO,
   TCP_CC_CUBIC,
-  TCP_CC_LAST = TCP_CC_CUBIC
+  TCP_CC_BBR,
+  TCP_CC_LAST = TCP_CC_BBR
 } tcp_cc_algorithm_type_e;
 
+/** Use of the retransmit timer. RACK-TLP timers share the slot with RTO */
+typedef enum tcp_rxt_timer_
+{
+  TCP_RXT_TIMER_RTO,
+  TCP_RXT_TIMER_REO,
+  TCP_RXT_TIMER_TLP,
+} __clib_packed tcp_rxt_timer_e;
+
+/** RACK-TLP (RFC 8985) loss detection state */
+typedef struct tcp_rack_
+{
+  f64 xmit_ts;		/**< Tx time of most recently sent delivered seg */
+  f64 rtt;		/**< RTT of most recently sent delivered seg */
+  f64 min_rtt;		/**< Min RTT of non-retransmitted segments */
+  f64 reo_timeout;	/**< Time left until reordering window expires */
+  u32 end_seq;		/**< End seq of most recently sent delivered seg */
+  u32 fack;		/**< Highest delivered end seq */
+  u32 tlp_high_seq;	/**< snd_nxt when tail loss probe was sent */
+  u32 tlp_ts;		/**< Timestamp when tail loss probe was sent */
+  u8 reordering_seen;	/**< Set if peer reordering was detected */
+  tcp_rxt_timer_e timer;	/**< Event armed on retransmit timer */
+} tcp_rack_t;
+
 typedef struct _tcp_cc_algorithm tcp_cc_algorithm_t;
 
 typedef enum _tcp_cc_ack_t
@@ -376,6 +401,7 @@ typedef struct _tcp_connection
   f64 first_tx_time;		/**< Send time for recently delivered/sent */
   u64 lost;			/**< Total bytes lost */
   tcp_byte_tracker_t *bt;	/**< Tx byte tracker */
+  tcp_rack_t rack;		/**< RACK-TLP loss detection state */
 
   tcp_errors_t errors;	/**< Soft connection errors */
 
@@ -383,6 +409,7 @@ typedef struct _tcp_connection
   u32 irs;		/**< initial remote sequence */
   f64 start_ts;		/**< Timestamp when connection initialized */
   u32 last_fib_check;	/**< Last time we checked fib route for peer */
+  u32 gso_epoch;	/**< Output feature epoch tx offload was checked at */
   u16 mss;		/**< Our max seg size that includes options */
   u32 ipv6_flow_label;	/**< flow label for ipv6 header */
 
@@ -0,0 +1,550 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+#ifndef __clib_chacha20_h__
+#define __clib_chacha20_h__
+
+#include <vppinfra/clib.h>
+#include <vppinfra/vector.h>
+#include <vppinfra/cache.h>
+#include <vppinfra/string.h>
+
+/* implementation of DJB's chacha20 (RFC 8439 variant with 32-bit block
+ * counter and 96-bit nonce)
+ *
+ * Blocks are computed 4, 8 or 16 at a time. Each of the 16 state words is
+ * kept in its own vector register and every vector lane holds a different
+ * block, so lanes can either be consecutive blocks of the same stream or
+ * blocks of unrelated streams (multi-buffer). */
+
+#define CHACHA20_KEY_SIZE   32
+#define CHACHA20_NONCE_SIZE 12
+#define CHACHA20_BLOCK_SIZE 64
+
+#if defined(CLIB_HAVE_VEC512)
+#define CHACHA20_MAX_LANES 16
+#elif defined(CLIB_HAVE_VEC256)
+#define CHACHA20_MAX_LANES 8
+#else
+#define CHACHA20_MAX_LANES 4
+#endif
+
+/* state words 4 - 15, words 0 - 3 are constant */
+typedef struct
+{
+  u32 key[8];
+  u32 counter;
+  u32 nonce[3];
+} clib_chacha20_state_t;
+
+typedef struct
+{
+  clib_chacha20_state_t state;
+  u8 keystream[CHACHA20_BLOCK_SIZE];
+  u32 n_keystream_bytes; /* unused bytes at the end of keystream[] */
+} clib_chacha20_ctx_t;
+
+#define _chacha20_sigma(i)                                                    \
+  ((i) == 0 ? 0x61707865 :                                                    \
+   (i) == 1 ? 0x3320646e :                                                    \
+   (i) == 2 ? 0x79622d32 :                                                    \
+	      0x6b206574)
+
+#if defined(__AVX512F__) || !defined(CLIB_HAVE_VEC128)
+/* compiler emits single instruction rotate (vprold) */
+#define _chacha20_rotl16(v, t) (((v) << 16) | ((v) >> 16))
+#define _chacha20_rotl8(v, t)  (((v) << 8) | ((v) >> 24))
+#else
+/* 16 and 8 bit rotations are cheaper as byte shuffles */
+#define _chacha20_rotl16(v, t) _chacha20_rotl16_##t (v)
+#define _chacha20_rotl8(v, t)  _chacha20_rotl8_##t (v)
+#endif
+#define _chacha20_rotl(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+static_always_inline u32
+_chacha20_rotl16_u32 (u32 v)
+{
+  return _chacha20_rotl (v, 16);
+}
+
+static_always_inline u32
+_chacha20_rotl8_u32 (u32 v)
+{
+  return _chacha20_rotl (v, 8);
+}
+
+static_always_inline u32x4
+_chacha20_rotl16_u32x4 (u32x4 v)
+{
+  return (u32x4) u8x16_shuffle ((u8x16) v, 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8,
+				9, 14, 15, 12, 13);
+}
+
+static_always_inline u32x4
+_chacha20_rotl8_u32x4 (u32x4 v)
+{
+  return (u32x4) u8x16_shuffle ((u8x16) v, 3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9,
+				10, 15, 12, 13, 14);
+}
+
+#if defined(CLIB_HAVE_VEC256)
+static_always_inline u32x8
+_chacha20_rotl16_u32x8 (u32x8 v)
+{
+  return (u32x8) u8x32_shuffle ((u8x32) v, 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8,
+				9, 14, 15, 12, 13, 18, 19, 16, 17, 22, 23, 20,
+				21, 26, 27, 24, 25, 30, 31, 28, 29);
+}
+
+static_always_inline u32x8
+_chacha20_rotl8_u32x8 (u32x8 v)
+{
+  return (u32x8) u8x32_shuffle ((u8x32) v, 3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9,
+				10, 15, 12, 13, 14, 19, 16, 17, 18, 23, 20, 21,
+				22, 27, 24, 25, 26, 31, 28, 29, 30);
+}
+#endif
+
+#define _chacha20_quarter_round(x, a, b, c, d, t)                             \
+  do                                                                          \
+    {                                                                         \
+      x[a] += x[b];                                                           \
+      x[d] = _chacha20_rotl16 (x[d] ^ x[a], t);                               \
+      x[c] += x[d];                                                           \
+      x[b] = _chacha20_rotl (x[b] ^ x[c], 12);                                \
+      x[a] += x[b];                                                           \
+      x[d] = _chacha20_rotl8 (x[d] ^ x[a], t);                                \
+      x[c] += x[d];                                                           \
+      x[b] = _chacha20_rotl (x[b] ^ x[c], 7);                                 \
+    }                                                                         \
+  while (0)
+
+/* 20 rounds followed by addition of the input state */
+#define _chacha20_rounds(x, t)                                                \
+  do                                                                          \
+    {                                                                         \
+      t s[16];                                                                \
+      for (int i = 0; i < 16; i++)                                            \
+	s[i] = x[i];                                                          \
+      for (int i = 0; i < 10; i++)                                            \
+	{                                                                     \
+	  _chacha20_quarter_round (x, 0, 4, 8, 12, t);                        \
+	  _chacha20_quarter_round (x, 1, 5, 9, 13, t);                        \
+	  _chacha20_quarter_round (x, 2, 6, 10, 14, t);                       \
+	  _chacha20_quarter_round (x, 3, 7, 11, 15, t);                       \
+	  _chacha20_quarter_round (x, 0, 5, 10, 15, t);                       \
+	  _chacha20_quarter_round (x, 1, 6, 11, 12, t);                       \
+	  _chacha20_quarter_round (x, 2, 7, 8, 13, t);                        \
+	  _chacha20_quarter_round (x, 3, 4, 9, 14, t);                        \
+	}                                                                     \
+      for (int i = 0; i < 16; i++)                                            \
+	x[i] += s[i];                                                         \
+    }                                                                         \
+  while (0)
+
+/* initial state, lane i gets counter + i of the given stream */
+#define _chacha20_load_stream(x, st, t, n_lanes)                              \
+  do                                                                          \
+    {                                                                         \
+      const u32 *w = &(st)->key[0];                                           \
+      for (int i = 0; i < 4; i++)                                             \
+	x[i] = (t){} + _chacha20_sigma (i);                                   \
+      for (int i = 0; i < 12; i++)                                            \
+	x[i + 4] = (t){} + w[i];                                              \
+      for (int i = 0; i < n_lanes; i++)                                       \
+	x[12][i] += i;                                                        \
+    }                                                                         \
+  while (0)
+
+/* initial state, lane i gets the current block of stream st[i] */
+#define _chacha20_load_multi(x, st, t, n_lanes)                               \
+  do                                                                          \
+    {                                                                         \
+      u32 w[12][n_lanes];                                                     \
+      for (int j = 0; j < n_lanes; j++)                                       \
+	for (int i = 0; i < 12; i++)                                          \
+	  w[i][j] = (&(st)[j]->key[0])[i];                                    \
+      for (int i = 0; i < 4; i++)                                             \
+	x[i] = (t){} + _chacha20_sigma (i);                                   \
+      for (int i = 0; i < 12; i++)                                            \
+	x[i + 4] = *(t##u *) w[i];                                            \
+    }                                                                         \
+  while (0)
+
+/* transpose 4x4 blocks of 32-bit words inside each 128-bit lane and store
+ * the result so that block of lane i lands at ks + i * 64 */
+static_always_inline void
+_chacha20_store_u32x4 (u32x4 x[16], u8 *ks)
+{
+  for (int g = 0; g < 4; g++)
+    {
+      u32x4 *r = x + 4 * g;
+      u32x4 t0 = u32x4_shuffle2 (r[0], r[1], 0, 4, 1, 5);
+      u32x4 t1 = u32x4_shuffle2 (r[0], r[1], 2, 6, 3, 7);
+      u32x4 t2 = u32x4_shuffle2 (r[2], r[3], 0, 4, 1, 5);
+      u32x4 t3 = u32x4_shuffle2 (r[2], r[3], 2, 6, 3, 7);
+      u32x4 o[4] = {
+	(u32x4) u64x2_shuffle2 ((u64x2) t0, (u64x2) t2, 0, 2),
+	(u32x4) u64x2_shuffle2 ((u64x2) t0, (u64x2) t2, 1, 3),
+	(u32x4) u64x2_shuffle2 ((u64x2) t1, (u64x2) t3, 0, 2),
+	(u32x4) u64x2_shuffle2 ((u64x2) t1, (u64x2) t3, 1, 3),
+      };
+      for (int i = 0; i < 4; i++)
+	*(u32x4u *) (ks + i * CHACHA20_BLOCK_SIZE + g * 16) = o[i];
+    }
+}
+
+static_always_inline void
+clib_chacha20_blocks_x4 (const clib_chacha20_state_t *st, u8 *ks)
+{
+  u32x4 x[16];
+  _chacha20_load_stream (x, st, u32x4, 4);
+  _chacha20_rounds (x, u32x4);
+  _chacha20_store_u32x4 (x, ks);
+}
+
+static_always_inline void
+clib_chacha20_multi_x4 (const clib_chacha20_state_t *st[4], u8 *ks)
+{
+  u32x4 x[16];
+  _chacha20_load_multi (x, st, u32x4, 4);
+  _chacha20_rounds (x, u32x4);
+  _chacha20_store_u32x4 (x, ks);
+}
+
+#if defined(CLIB_HAVE_VEC256)
+static_always_inline void
+_chacha20_store_u32x8 (u32x8 x[16], u8 *ks)
+{
+  for (int g = 0; g < 4; g++)
+    {
+      u32x8 *r = x + 4 * g;
+      u32x8 t0 = u32x8_shuffle2 (r[0], r[1], 0, 8, 1, 9, 4, 12, 5, 13);
+      u32x8 t1 = u32x8_shuffle2 (r[0], r[1], 2, 10, 3, 11, 6, 14, 7, 15);
+      u32x8 t2 = u32x8_shuffle2 (r[2], r[3], 0, 8, 1, 9, 4, 12, 5, 13);
+      u32x8 t3 = u32x8_shuffle2 (r[2], r[3], 2, 10, 3, 11, 6, 14, 7, 15);
+      u32x8 o[4] = {
+	(u32x8) u64x4_shuffle2 ((u64x4) t0, (u64x4) t2, 0, 4, 2, 6),
+	(u32x8) u64x4_shuffle2 ((u64x4) t0, (u64x4) t2, 1, 5, 3, 7),
+	(u32x8) u64x4_shuffle2 ((u64x4) t1, (u64x4) t3, 0, 4, 2, 6),
+	(u32x8) u64x4_shuffle2 ((u64x4) t1, (u64x4) t3, 1, 5, 3, 7),
+      };
+      for (int i = 0; i < 4; i++)
+	{
+	  u32x8_union_t u = { .as_u32x8 = o[i] };
+	  *(u32x4u *) (ks + i * CHACHA20_BLOCK_SIZE + g * 16) =
+	    *(u32x4 *) (u.as_u32 + 0);
+	  *(u32x4u *) (ks + (i + 4) * CHACHA20_BLOCK_SIZE + g * 16) =
+	    *(u32x4 *) (u.as_u32 + 4);
+	}
+    }
+}
+
+static_always_inline void
+clib_chacha20_blocks_x8 (const clib_chacha20_state_t *st, u8 *ks)
+{
+  u32x8 x[16];
+  _chacha20_load_stream (x, st, u32x8, 8);
+  _chacha20_rounds (x, u32x8);
+  _chacha20_store_u32x8 (x, ks);
+}
+
+static_always_inline void
+clib_chacha20_multi_x8 (const clib_chacha20_state_t *st[8], u8 *ks)
+{
+  u32x8 x[16];
+  _chacha20_load_multi (x, st, u32x8, 8);
+  _chacha20_rounds (x, u32x8);
+  _chacha20_store_u32x8 (x, ks);
+}
+#endif
+
+#if defined(CLIB_HAVE_VEC512)
+static_always_inline void
+_chacha20_store_u32x16 (u32x16 x[16], u8 *ks)
+{
+  for (int g = 0; g < 4; g++)
+    {
+      u32x16 *r = x + 4 * g;
+      u32x16 t0 = u32x16_shuffle2 (r[0], r[1], 0, 16, 1, 17, 4, 20, 5, 21, 8,
+				   24, 9, 25, 12, 28, 13, 29);
+      u32x16 t1 = u32x16_shuffle2 (r[0], r[1], 2, 18, 3, 19, 6, 22, 7, 23, 10,
+				   26, 11, 27, 14, 30, 15, 31);
+      u32x16 t2 = u32x16_shuffle2 (r[2], r[3], 0, 16, 1, 17, 4, 20, 5, 21, 8,
+				   24, 9, 25, 12, 28, 13, 29);
+      u32x16 t3 = u32x16_shuffle2 (r[2], r[3], 2, 18, 3, 19, 6, 22, 7, 23, 10,
+				   26, 11, 27, 14, 30, 15, 31);
+      u32x16 o[4] = {
+	(u32x16) u64x8_shuffle2 ((u64x8) t0, (u64x8) t2, 0, 8, 2, 10, 4, 12, 6,
+				 14),
+	(u32x16) u64x8_shuffle2 ((u64x8) t0, (u64x8) t2, 1, 9, 3, 11, 5, 13, 7,
+				 15),
+	(u32x16) u64x8_shuffle2 ((u64x8) t1, (u64x8) t3, 0, 8, 2, 10, 4, 12, 6,
+				 14),
+	(u32x16) u64x8_shuffle2 ((u64x8) t1, (u64x8) t3, 1, 9, 3, 11, 5, 13, 7,
+				 15),
+      };
+      for (int i = 0; i < 4; i++)
+	{
+	  u32x16_union_t u = { .as_u32x16 = o[i] };
+	  for (int c = 0; c < 4; c++)
+	    *(u32x4u *) (ks + (i + 4 * c) * CHACHA20_BLOCK_SIZE + g * 16) =
+	      *(u32x4 *) (u.as_u32 + 4 * c);
+	}
+    }
+}
+
+static_always_inline void
+clib_chacha20_blocks_x16 (const clib_chacha20_state_t *st, u8 *ks)
+{
+  u32x16 x[16];
+  _chacha20_load_stream (x, st, u32x16, 16);
+  _chacha20_rounds (x, u32x16);
+  _chacha20_store_u32x16 (x, ks);
+}
+
+static_always_inline void
+clib_chacha20_multi_x16 (const clib_chacha20_state_t *st[16], u8 *ks)
+{
+  u32x16 x[16];
+  _chacha20_load_multi (x, st, u32x16, 16);
+  _chacha20_rounds (x, u32x16);
+  _chacha20_store_u32x16 (x, ks);
+}
+#endif
+
+/* compute n_blocks (up to CHACHA20_MAX_LANES) consecutive keystream blocks
+ * starting at st->counter, counter is not updated */
+static_always_inline void
+clib_chacha20_blocks (const clib_chacha20_state_t *st, u8 *ks, u32 n_blocks)
+{
+#if defined(CLIB_HAVE_VEC512)
+  if (n_blocks > 8)
+    {
+      clib_chacha20_blocks_x16 (st, ks);
+      return;
+    }
+#endif
+#if defined(CLIB_HAVE_VEC256)
+  if (n_blocks > 4)
+    {
+      clib_chacha20_blocks_x8 (st, ks);
+      return;
+    }
+#endif
+  clib_chacha20_blocks_x4 (st, ks);
+}
+
+/* compute current keystream block of n (up to CHACHA20_MAX_LANES) unrelated
+ * streams, block of st[i] is stored at ks + i * 64 */
+static_always_inline void
+clib_chacha20_multi (const clib_chacha20_state_t *st[], u8 *ks, u32 n)
+{
+  const clib_chacha20_state_t *s[CHACHA20_MAX_LANES];
+  u32 n_lanes = 4;
+
+#if defined(CLIB_HAVE_VEC512)
+  if (n > 8)
+    n_lanes = 16;
+  else
+#endif
+#if defined(CLIB_HAVE_VEC256)
+    if (n > 4)
+    n_lanes = 8;
+#endif
+
+  /* unused lanes compute a copy of the first stream */
+  for (u32 i = 0; i < n_lanes; i++)
+    s[i] = st[i < n ? i : 0];
+
+#if defined(CLIB_HAVE_VEC512)
+  if (n_lanes == 16)
+    {
+      clib_chacha20_multi_x16 (s, ks);
+      return;
+    }
+#endif
+#if defined(CLIB_HAVE_VEC256)
+  if (n_lanes == 8)
+    {
+      clib_chacha20_multi_x8 (s, ks);
+      return;
+    }
+#endif
+  clib_chacha20_multi_x4 (s, ks);
+}
+
+static_always_inline void
+_clib_chacha20_xor (u8 *dst, const u8 *src, const u8 *ks, uword n_bytes)
+{
+#if defined(CLIB_HAVE_VEC512)
+  for (; n_bytes >= 64; n_bytes -= 64, dst += 64, src += 64, ks += 64)
+    *(u8x64u *) dst = *(u8x64u *) src ^ *(u8x64u *) ks;
+#endif
+#if defined(CLIB_HAVE_VEC256)
+  for (; n_bytes >= 32; n_bytes -= 32, dst += 32, src += 32, ks += 32)
+    *(u8x32u *) dst = *(u8x32u *) src ^ *(u8x32u *) ks;
+#endif
+  for (; n_bytes >= 16; n_bytes -= 16, dst += 16, src += 16, ks += 16)
+    *(u8x16u *) dst = *(u8x16u *) src ^ *(u8x16u *) ks;
+  for (; n_bytes; n_bytes--)
+    *dst++ = *src++ ^ *ks++;
+}
+
+static_always_inline void
+clib_chacha20_init (clib_chacha20_ctx_t *ctx, const u8 key[32],
+		    const u8 nonce[12], u32 counter)
+{
+  for (int i = 0; i < 8; i++)
+    ctx->state.key[i] = ((u32u *) key)[i];
+  for (int i = 0; i < 3; i++)
+    ctx->state.nonce[i] = ((u32u *) nonce)[i];
+  ctx->state.counter = counter;
+  ctx->n_keystream_bytes = 0;
+}
+
+static_always_inline void
+clib_chacha20_transform (clib_chacha20_ctx_t *ctx, const u8 *src, u8 *dst,
+			 uword len)
+{
+  u8 ks[CHACHA20_MAX_LANES * CHACHA20_BLOCK_SIZE];
+  u32 n_blocks;
+
+  if (ctx->n_keystream_bytes)
+    {
+      u32 n = clib_min (len, ctx->n_keystream_bytes);
+      u8 *k = ctx->keystream + CHACHA20_BLOCK_SIZE - ctx->n_keystream_bytes;
+      _clib_chacha20_xor (dst, src, k, n);
+      ctx->n_keystream_bytes -= n;
+      len -= n;
+      src += n;
+      dst += n;
+    }
+
+  while (len >= sizeof (ks))
+    {
+      clib_chacha20_blocks (&ctx->state, ks, CHACHA20_MAX_LANES);
+      ctx->state.counter += CHACHA20_MAX_LANES;
+      _clib_chacha20_xor (dst, src, ks, sizeof (ks));
+      len -= sizeof (ks);
+      src += sizeof (ks);
+      dst += sizeof (ks);
+    }
+
+  if (len == 0)
+    return;
+
+  n_blocks = round_pow2 (len, CHACHA20_BLOCK_SIZE) / CHACHA20_BLOCK_SIZE;
+  clib_chacha20_blocks (&ctx->state, ks, n_blocks);
+  ctx->state.counter += n_blocks;
+  _clib_chacha20_xor (dst, src, ks, len);
+
+  if (len % CHACHA20_BLOCK_SIZE)
+    {
+      ctx->n_keystream_bytes = CHACHA20_BLOCK_SIZE - len % CHACHA20_BLOCK_SIZE;
+      clib_memcpy_fast (ctx->keystream, ks + (n_blocks - 1) * 64, 64);
+    }
+}
+
+/* transform n (up to CHACHA20_MAX_LANES) unrelated streams together: every
+ * kernel call computes the next keystream block of each stream that has data
+ * left, so short buffers of different streams share the vector lanes. Once
+ * one stream is left it continues with consecutive blocks. Contexts must not
+ * hold unused keystream bytes. */
+static_always_inline void
+clib_chacha20_transform_multi (clib_chacha20_ctx_t *ctx[], const u8 *src[],
+			       u8 *dst[], const u32 len[], u32 n)
+{
+  const clib_chacha20_state_t *st[CHACHA20_MAX_LANES];
+  u8 ks[CHACHA20_MAX_LANES * CHACHA20_BLOCK_SIZE];
+  u32 lane[CHACHA20_MAX_LANES];
+  u32 off = 0, n_active, i, j;
+
+  while (1)
+    {
+      n_active = 0;
+      for (i = 0; i < n; i++)
+	if (len[i] > off)
+	  {
+	    ASSERT (ctx[i]->n_keystream_bytes == 0);
+	    lane[n_active] = i;
+	    st[n_active++] = &ctx[i]->state;
+	  }
+
+      if (n_active == 0)
+	return;
+
+      if (n_active == 1)
+	{
+	  i = lane[0];
+	  clib_chacha20_transform (ctx[i], src[i] + off, dst[i] + off,
+				   len[i] - off);
+	  return;
+	}
+
+      clib_chacha20_multi (st, ks, n_active);
+
+      for (j = 0; j < n_active; j++)
+	{
+	  u8 *k = ks + j * CHACHA20_BLOCK_SIZE;
+	  u32 n_bytes;
+
+	  i = lane[j];
+	  n_bytes = clib_min (len[i] - off, CHACHA20_BLOCK_SIZE);
+	  _clib_chacha20_xor (dst[i] + off, src[i] + off, k, n_bytes);
+	  ctx[i]->state.counter++;
+
+	  if (n_bytes < CHACHA20_BLOCK_SIZE)
+	    {
+	      ctx[i]->n_keystream_bytes = CHACHA20_BLOCK_SIZE - n_bytes;
+	      clib_memcpy_fast (ctx[i]->keystream, k, CHACHA20_BLOCK_SIZE);
+	    }
+	}
+
+      off += CHACHA20_BLOCK_SIZE;
+    }
+}
+
+static_always_inline void
+clib_chacha20 (const u8 key[32], const u8 nonce[12], u32 counter,
+	       const u8 *src, u8 *dst, uword len)
+{
+  clib_chacha20_ctx_t ctx;
+  clib_chacha20_init (&ctx, key, nonce, counter);
+  clib_chacha20_transform (&ctx, src, dst, len);
+}
+
+/* HChaCha20 (draft-irtf-cfrg-xchacha), used to derive XChaCha20 subkey */
+static_always_inline void
+clib_hchacha20 (const u8 key[32], const u8 nonce[16], u8 subkey[32])
+{
+  u32 x[16];
+
+  for (int i = 0; i < 4; i++)
+    x[i] = _chacha20_sigma (i);
+  for (int i = 0; i < 8; i++)
+    x[i + 4] = ((u32u *) key)[i];
+  for (int i = 0; i < 4; i++)
+    x[i + 12] = ((u32u *) nonce)[i];
+
+  for (int i = 0; i < 10; i++)
+    {
+      _chacha20_quarter_round (x, 0, 4, 8, 12, u32);
+      _chacha20_quarter_round (x, 1, 5, 9, 13, u32);
+      _chacha20_quarter_round (x, 2, 6, 10, 14, u32);
+      _chacha20_quarter_round (x, 3, 7, 11, 15, u32);
+      _chacha20_quarter_round (x, 0, 5, 10, 15, u32);
+      _chacha20_quarter_round (x, 1, 6, 11, 12, u32);
+      _chacha20_quarter_round (x, 2, 7, 8, 13, u32);
+      _chacha20_quarter_round (x, 3, 4, 9, 14, u32);
+    }
+
+  for (int i = 0; i < 4; i++)
+    {
+      ((u32u *) subkey)[i] = x[i];
+      ((u32u *) subkey)[i + 4] = x[i + 12];
+    }
+}
+
+#endif /* __clib_chacha20_h__ */
@@ -0,0 +1,180 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+#ifndef __clib_chacha20_poly1305_h__
+#define __clib_chacha20_poly1305_h__
+
+#include <vppinfra/crypto/chacha20.h>
+#include <vppinfra/crypto/poly1305.h>
+
+/* RFC 8439 AEAD construction */
+
+typedef struct
+{
+  clib_chacha20_ctx_t chacha20;
+  clib_poly1305_ctx poly1305;
+  u64 aad_len;
+  u64 data_len;
+} clib_chacha20_poly1305_ctx_t;
+
+static_always_inline void
+_clib_chacha20_poly1305_pad16 (clib_chacha20_poly1305_ctx_t *ctx, u64 len)
+{
+  static const u8 zeros[16] = {};
+  if (len % 16)
+    clib_poly1305_update (&ctx->poly1305, zeros, 16 - len % 16);
+}
+
+/* initialize n (up to CHACHA20_MAX_LANES) contexts, poly1305 one-time keys
+ * of all of them are computed in parallel */
+static_always_inline void
+clib_chacha20_poly1305_init_multi (clib_chacha20_poly1305_ctx_t *ctx[],
+				   const u8 *key[], const u8 *nonce[], u32 n)
+{
+  const clib_chacha20_state_t *st[CHACHA20_MAX_LANES];
+  u8 ks[CHACHA20_MAX_LANES * CHACHA20_BLOCK_SIZE];
+
+  for (u32 i = 0; i < n; i++)
+    {
+      clib_chacha20_init (&ctx[i]->chacha20, key[i], nonce[i], 0);
+      st[i] = &ctx[i]->chacha20.state;
+    }
+
+  clib_chacha20_multi (st, ks, n);
+
+  for (u32 i = 0; i < n; i++)
+    {
+      clib_poly1305_init (&ctx[i]->poly1305, ks + i * CHACHA20_BLOCK_SIZE);
+      ctx[i]->chacha20.state.counter = 1;
+      ctx[i]->aad_len = ctx[i]->data_len = 0;
+    }
+
+  clib_memset_u8 (ks, 0, sizeof (ks));
+}
+
+static_always_inline void
+clib_chacha20_poly1305_init (clib_chacha20_poly1305_ctx_t *ctx,
+			     const u8 key[32], const u8 nonce[12])
+{
+  clib_chacha20_poly1305_init_multi (&ctx, &key, &nonce, 1);
+}
+
+/* must be called once, before any data is processed */
+static_always_inline void
+clib_chacha20_poly1305_aad (clib_chacha20_poly1305_ctx_t *ctx, const u8 *aad,
+			    uword len)
+{
+  clib_poly1305_update (&ctx->poly1305, aad, len);
+  _clib_chacha20_poly1305_pad16 (ctx, len);
+  ctx->aad_len = len;
+}
+
+static_always_inline void
+clib_chacha20_poly1305_enc_update (clib_chacha20_poly1305_ctx_t *ctx,
+				   const u8 *src, u8 *dst, uword len)
+{
+  clib_chacha20_transform (&ctx->chacha20, src, dst, len);
+  clib_poly1305_update (&ctx->poly1305, dst, len);
+  ctx->data_len += len;
+}
+
+static_always_inline void
+clib_chacha20_poly1305_dec_update (clib_chacha20_poly1305_ctx_t *ctx,
+				   const u8 *src, u8 *dst, uword len)
+{
+  clib_poly1305_update (&ctx->poly1305, src, len);
+  clib_chacha20_transform (&ctx->chacha20, src, dst, len);
+  ctx->data_len += len;
+}
+
+/* process the data of n (up to CHACHA20_MAX_LANES) contexts, keystream
+ * blocks of all of them are computed together, poly1305 runs per context */
+static_always_inline void
+clib_chacha20_poly1305_enc_update_multi (clib_chacha20_poly1305_ctx_t *ctx[],
+					 const u8 *src[], u8 *dst[],
+					 const u32 len[], u32 n)
+{
+  clib_chacha20_ctx_t *cc[CHACHA20_MAX_LANES];
+
+  for (u32 i = 0; i < n; i++)
+    cc[i] = &ctx[i]->chacha20;
+
+  clib_chacha20_transform_multi (cc, src, dst, len, n);
+
+  for (u32 i = 0; i < n; i++)
+    {
+      clib_poly1305_update (&ctx[i]->poly1305, dst[i], len[i]);
+      ctx[i]->data_len += len[i];
+    }
+}
+
+static_always_inline void
+clib_chacha20_poly1305_dec_update_multi (clib_chacha20_poly1305_ctx_t *ctx[],
+					 const u8 *src[], u8 *dst[],
+					 const u32 len[], u32 n)
+{
+  clib_chacha20_ctx_t *cc[CHACHA20_MAX_LANES];
+
+  for (u32 i = 0; i < n; i++)
+    {
+      clib_poly1305_update (&ctx[i]->poly1305, src[i], len[i]);
+      ctx[i]->data_len += len[i];
+      cc[i] = &ctx[i]->chacha20;
+    }
+
+  clib_chacha20_transform_multi (cc, src, dst, len, n);
+}
+
+static_always_inline void
+clib_chacha20_poly1305_final (clib_chacha20_poly1305_ctx_t *ctx, u8 tag[16])
+{
+  u64 lengths[2] = { clib_host_to_little_u64 (ctx->aad_len),
+		     clib_host_to_little_u64 (ctx->data_len) };
+
+  _clib_chacha20_poly1305_pad16 (ctx, ctx->data_len);
+  clib_poly1305_update (&ctx->poly1305, (u8 *) lengths, sizeof (lengths));
+  clib_poly1305_final (&ctx->poly1305, tag);
+}
+
+/* compare calculated tag with expected one in constant time */
+static_always_inline int
+clib_chacha20_poly1305_final_verify (clib_chacha20_poly1305_ctx_t *ctx,
+				     const u8 *tag, u32 tag_len)
+{
+  u8 calc[16], diff = 0;
+
+  clib_chacha20_poly1305_final (ctx, calc);
+
+  for (u32 i = 0; i < tag_len; i++)
+    diff |= calc[i] ^ tag[i];
+
+  return diff == 0;
+}
+
+static_always_inline void
+clib_chacha20_poly1305_enc (const u8 key[32], const u8 nonce[12],
+			    const u8 *aad, uword aad_len, const u8 *src,
+			    u8 *dst, uword len, u8 tag[16])
+{
+  clib_chacha20_poly1305_ctx_t ctx;
+  clib_chacha20_poly1305_init (&ctx, key, nonce);
+  clib_chacha20_poly1305_aad (&ctx, aad, aad_len);
+  clib_chacha20_poly1305_enc_update (&ctx, src, dst, len);
+  clib_chacha20_poly1305_final (&ctx, tag);
+}
+
+/* returns 1 if tag matches */
+static_always_inline int
+clib_chacha20_poly1305_dec (const u8 key[32], const u8 nonce[12],
+			    const u8 *aad, uword aad_len, const u8 *src,
+			    u8 *dst, uword len, const u8 tag[16])
+{
+  clib_chacha20_poly1305_ctx_t ctx;
+  clib_chacha20_poly1305_init (&ctx, key, nonce);
+  clib_chacha20_poly1305_aad (&ctx, aad, aad_len);
+  clib_chacha20_poly1305_dec_update (&ctx, src, dst, len);
+  return clib_chacha20_poly1305_final_verify (&ctx, tag, 16);
+}
+
+#endif /* __clib_chacha20_poly1305_h__ */
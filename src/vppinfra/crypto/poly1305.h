@@ -154,6 +154,7 @@ static_always_inline void
 clib_poly1305_update (clib_poly1305_ctx *ctx, const u8 *msg, uword len)
 {
   uword n_left = len;
+  const u8 *end = msg + len;
 
   if (n_left == 0)
     return;
@@ -182,7 +183,7 @@ clib_poly1305_update (clib_poly1305_ctx *ctx, const u8 *msg, uword len)
   if (n_left)
     {
       ctx->partial.as_u64[0] = ctx->partial.as_u64[1] = 0;
-      clib_memcpy_fast (ctx->partial.as_u8, msg + len - n_left, n_left);
+      clib_memcpy_fast (ctx->partial.as_u8, end - n_left, n_left);
       ctx->n_partial_bytes = n_left;
     }
 }
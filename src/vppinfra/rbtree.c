@@ -94,6 +94,7 @@ rb_tree_fixup_inline (rb_tree_t * rt, rb_node_t * y, rb_node_t * z)
 	      y->color = RBTREE_BLACK;
 	      zpp->color = RBTREE_RED;
 	      z = zpp;
+	      y = rb_node_parent (rt, z);
 	    }
 	  else
 	    {
@@ -118,6 +119,7 @@ rb_tree_fixup_inline (rb_tree_t * rt, rb_node_t * y, rb_node_t * z)
 	      y->color = RBTREE_BLACK;
 	      zpp->color = RBTREE_RED;
 	      z = zpp;
+	      y = rb_node_parent (rt, z);
 	    }
 	  else
 	    {
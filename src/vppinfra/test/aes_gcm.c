@@ -847,6 +847,52 @@ test_clib_aes128_gcm_enc (clib_error_t *err)
 
 perftest_aesXXX_enc_var_sz (128);
 
+/* packet size mixes, packets are spread over the keys of n_keys SAs */
+static const u16 perf_mix_64[] = { 64 };
+static const u16 perf_mix_small[] = { 40, 64, 64, 96, 128, 64, 48, 256 };
+static const u16 perf_mix_imix[] = { 64, 64, 64, 64, 64, 64, 64, 576,
+				     64, 64, 64, 64, 64, 64, 64, 576,
+				     64, 64, 64, 64, 64, 64, 64, 1500 };
+
+static_always_inline void
+perftest_aes128_enc_mix (test_perf_t *tp, const u16 *mix, u32 mix_len,
+			 u32 n_keys)
+{
+  u32 n = tp->n_ops, stride = 1536;
+  aes_gcm_key_data_t *kd = test_mem_alloc (sizeof (*kd) * n_keys);
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (n * stride, 0, 0);
+  u8 *dst = test_mem_alloc (n * stride);
+  u8 *tag = test_mem_alloc (n * 16);
+  u8 *key = test_mem_alloc_and_fill_inc_u8 (32, 192, 0);
+  u8 *iv = test_mem_alloc_and_fill_inc_u8 (16, 128, 0);
+
+  for (u32 i = 0; i < n_keys; i++)
+    {
+      key[0] = i;
+      clib_aes_gcm_key_expand (kd + i, key, AES_KEY_128);
+    }
+
+  test_perf_event_enable (tp);
+  for (u32 i = 0; i < n; i++)
+    clib_aes128_gcm_enc (kd + (i * 7) % n_keys, src + i * stride,
+			 mix[i % mix_len], 0, 0, iv, 16, dst + i * stride,
+			 tag + i * 16);
+  test_perf_event_disable (tp);
+}
+
+#define _(m, k)                                                               \
+  void __test_perf_fn perftest_aes128_enc_##m##_##k##sa (test_perf_t *tp)     \
+  {                                                                           \
+    perftest_aes128_enc_mix (tp, perf_mix_##m, ARRAY_LEN (perf_mix_##m), k);  \
+  }
+_ (64, 1)
+_ (64, 1024)
+_ (small, 1)
+_ (small, 1024)
+_ (imix, 1)
+_ (imix, 1024)
+#undef _
+
 REGISTER_TEST (clib_aes128_gcm_enc) = {
   .name = "clib_aes128_gcm_enc",
   .fn = test_clib_aes128_gcm_enc,
@@ -855,7 +901,25 @@ REGISTER_TEST (clib_aes128_gcm_enc) = {
 			      .fn = perftest_aes128_enc_var_sz },
 			    { .name = "variable size (per byte)",
 			      .n_ops = 1 << 20,
-			      .fn = perftest_aes128_enc_var_sz }),
+			      .fn = perftest_aes128_enc_var_sz },
+			    { .name = "64B, 1 SA (per packet)",
+			      .n_ops = 1024,
+			      .fn = perftest_aes128_enc_64_1sa },
+			    { .name = "64B, 1024 SAs (per packet)",
+			      .n_ops = 1024,
+			      .fn = perftest_aes128_enc_64_1024sa },
+			    { .name = "40-256B mix, 1 SA (per packet)",
+			      .n_ops = 1024,
+			      .fn = perftest_aes128_enc_small_1sa },
+			    { .name = "40-256B mix, 1024 SAs (per packet)",
+			      .n_ops = 1024,
+			      .fn = perftest_aes128_enc_small_1024sa },
+			    { .name = "imix, 1 SA (per packet)",
+			      .n_ops = 1024,
+			      .fn = perftest_aes128_enc_imix_1sa },
+			    { .name = "imix, 1024 SAs (per packet)",
+			      .n_ops = 1024,
+			      .fn = perftest_aes128_enc_imix_1024sa }),
 };
 
 static clib_error_t *
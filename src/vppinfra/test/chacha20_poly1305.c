@@ -0,0 +1,402 @@
+/* SPDX-License-Identifier: Apache-2.0
+ * Copyright(c) 2025 Cisco Systems, Inc.
+ */
+
+#include <vppinfra/format.h>
+#include <vppinfra/test/test.h>
+#include <vppinfra/crypto/chacha20_poly1305.h>
+
+/* RFC 8439 2.4.2 and 2.8.2 */
+static const u8 sunscreen[114] =
+  "Ladies and Gentlemen of the class of '99: If I could offer you only one "
+  "tip for the future, sunscreen would be it.";
+
+static const u8 rfc_2_4_2_nonce[12] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+					0x00, 0x4a, 0x00, 0x00, 0x00, 0x00 };
+
+static const u8 rfc_2_4_2_ct[114] = {
+  0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28,
+  0xdd, 0x0d, 0x69, 0x81, 0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2,
+  0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b, 0xf9, 0x1b, 0x65, 0xc5,
+  0x52, 0x47, 0x33, 0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57,
+  0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35,
+  0x9f, 0x08, 0x61, 0xd8, 0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61,
+  0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e, 0x52, 0xbc, 0x51, 0x4d,
+  0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36,
+  0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 0xb4, 0x0b, 0x8e, 0xed,
+  0xf2, 0x78, 0x5e, 0x42, 0x87, 0x4d
+};
+
+static const u8 rfc_2_8_2_nonce[12] = { 0x07, 0x00, 0x00, 0x00, 0x40, 0x41,
+					0x42, 0x43, 0x44, 0x45, 0x46, 0x47 };
+
+static const u8 rfc_2_8_2_aad[12] = { 0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1,
+				      0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7 };
+
+static const u8 rfc_2_8_2_ct[114] = {
+  0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc,
+  0x53, 0xef, 0x7e, 0xc2, 0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe,
+  0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6, 0x3d, 0xbe, 0xa4, 0x5e,
+  0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+  0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6,
+  0x7e, 0xcd, 0x3b, 0x36, 0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c,
+  0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58, 0xfa, 0xb3, 0x24, 0xe4,
+  0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+  0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65,
+  0x86, 0xce, 0xc6, 0x4b, 0x61, 0x16
+};
+
+static const u8 rfc_2_8_2_tag[16] = { 0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09,
+				      0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb,
+				      0xd0, 0x60, 0x06, 0x91 };
+
+/* draft-irtf-cfrg-xchacha 2.2.1 */
+static const u8 hchacha20_nonce[16] = { 0x00, 0x00, 0x00, 0x09, 0x00, 0x00,
+					0x00, 0x4a, 0x00, 0x00, 0x00, 0x00,
+					0x31, 0x41, 0x59, 0x27 };
+static const u8 hchacha20_subkey[32] = {
+  0x82, 0x41, 0x3b, 0x42, 0x27, 0xb2, 0x7b, 0xfe, 0xd3, 0x0e, 0x42,
+  0x50, 0x8a, 0x87, 0x7d, 0x73, 0xa0, 0xf9, 0xe4, 0xd5, 0x8a, 0x74,
+  0xa8, 0x53, 0xc1, 0x2e, 0xc4, 0x13, 0x26, 0xd3, 0xec, 0xdc
+};
+
+/* key 00..1f, rfc_2_8_2_nonce, no aad, plaintext 00 01 02 .. */
+static const struct
+{
+  const u16 n_bytes;
+  const u8 tag[16];
+} inc_test_cases[] = {
+  {
+    .n_bytes = 0,
+    .tag = { 0xdb, 0x38, 0xec, 0x2a, 0xf4, 0x84, 0x0e, 0xf0, 0xbe, 0xf1, 0xaa,
+	     0xea, 0x2d, 0x64, 0xa9, 0x08 },
+  },
+  {
+    .n_bytes = 1,
+    .tag = { 0xa3, 0x0d, 0xeb, 0x5b, 0xed, 0xd4, 0xad, 0x1a, 0xb1, 0x73, 0xe2,
+	     0xe4, 0x68, 0x8b, 0x6c, 0x00 },
+  },
+  {
+    .n_bytes = 7,
+    .tag = { 0x6a, 0x51, 0xf2, 0x05, 0xf7, 0x7f, 0x69, 0x51, 0xc7, 0xe7, 0x69,
+	     0xe4, 0x3c, 0xa1, 0x46, 0x5e },
+  },
+  {
+    .n_bytes = 16,
+    .tag = { 0xab, 0xcb, 0x80, 0x3a, 0x9f, 0x40, 0x46, 0x10, 0x12, 0x7b, 0xe4,
+	     0x13, 0xb9, 0xe5, 0xb5, 0x14 },
+  },
+  {
+    .n_bytes = 63,
+    .tag = { 0x65, 0xb2, 0x4e, 0x9b, 0x40, 0x9f, 0x42, 0xd5, 0x36, 0xaa, 0x9b,
+	     0x0c, 0x1e, 0x66, 0x55, 0x0e },
+  },
+  {
+    .n_bytes = 64,
+    .tag = { 0xce, 0xbb, 0x2d, 0x09, 0x9d, 0xd7, 0x5f, 0xea, 0x95, 0xe7, 0xb0,
+	     0x8f, 0x1c, 0x71, 0x2d, 0x52 },
+  },
+  {
+    .n_bytes = 65,
+    .tag = { 0xb8, 0x65, 0x91, 0xdf, 0xe8, 0x20, 0xf9, 0x6b, 0x4c, 0x9e, 0x5f,
+	     0x00, 0x8c, 0xd2, 0x18, 0x8d },
+  },
+  {
+    .n_bytes = 128,
+    .tag = { 0x94, 0x92, 0xf0, 0x3d, 0x30, 0xa7, 0x10, 0x1e, 0x0c, 0xe7, 0xdb,
+	     0xc8, 0x10, 0x6b, 0xb6, 0x9d },
+  },
+  {
+    .n_bytes = 255,
+    .tag = { 0x3b, 0x80, 0x74, 0xa7, 0x88, 0x26, 0x5e, 0x84, 0x8b, 0x7a, 0x25,
+	     0xf8, 0xe0, 0x4c, 0xbd, 0xc9 },
+  },
+  {
+    .n_bytes = 511,
+    .tag = { 0x45, 0x29, 0x7f, 0x12, 0x6a, 0xe0, 0xed, 0xc5, 0x4d, 0x9f, 0x69,
+	     0xa8, 0x66, 0xa7, 0xe5, 0xb9 },
+  },
+  {
+    .n_bytes = 512,
+    .tag = { 0xe8, 0x48, 0xc4, 0x06, 0x8b, 0x02, 0x82, 0xa0, 0x42, 0xa7, 0xcb,
+	     0x96, 0x66, 0x4e, 0xfc, 0x5d },
+  },
+  {
+    .n_bytes = 1023,
+    .tag = { 0xcc, 0xd5, 0xa1, 0xc5, 0x76, 0x74, 0xfb, 0x5a, 0xd2, 0xfc, 0xd2,
+	     0xf9, 0xa4, 0x66, 0x11, 0xba },
+  },
+  {
+    .n_bytes = 1024,
+    .tag = { 0x47, 0xdf, 0xa7, 0x13, 0x06, 0x25, 0x06, 0x04, 0x01, 0x6a, 0x9b,
+	     0x58, 0xe3, 0xe1, 0xf2, 0xd1 },
+  },
+  {
+    .n_bytes = 1500,
+    .tag = { 0x3e, 0xc0, 0xda, 0xc2, 0xbb, 0xbe, 0xc6, 0xbf, 0xf0, 0x9b, 0x58,
+	     0x39, 0x9d, 0xfb, 0x0c, 0xce },
+  },
+  {
+    .n_bytes = 2047,
+    .tag = { 0xd3, 0xab, 0x26, 0x80, 0xff, 0x29, 0x9f, 0x39, 0x34, 0x33, 0xed,
+	     0x29, 0x2c, 0x7c, 0x4e, 0xd6 },
+  },
+  {
+    .n_bytes = 4096,
+    .tag = { 0x64, 0x66, 0x04, 0xaf, 0x1e, 0xce, 0xae, 0x79, 0xda, 0x42, 0x55,
+	     0x7c, 0xa5, 0x14, 0xa6, 0xe5 },
+  },
+};
+
+#define MAX_TEST_DATA_LEN 4096
+
+static clib_error_t *
+test_clib_chacha20 (clib_error_t *err)
+{
+  u8 key[32], ct[sizeof (sunscreen)], subkey[32];
+
+  for (int i = 0; i < 32; i++)
+    key[i] = i;
+
+  clib_chacha20 (key, rfc_2_4_2_nonce, 1, sunscreen, ct, sizeof (ct));
+  if (memcmp (ct, rfc_2_4_2_ct, sizeof (ct)))
+    return clib_error_return (err, "RFC8439 2.4.2: invalid ciphertext");
+
+  clib_hchacha20 (key, hchacha20_nonce, subkey);
+  if (memcmp (subkey, hchacha20_subkey, sizeof (subkey)))
+    return clib_error_return (err, "hchacha20: invalid subkey");
+
+  return err;
+}
+
+REGISTER_TEST (clib_chacha20) = {
+  .name = "clib_chacha20",
+  .fn = test_clib_chacha20,
+};
+
+static clib_error_t *
+test_clib_chacha20_poly1305 (clib_error_t *err)
+{
+  clib_chacha20_poly1305_ctx_t ctx[CHACHA20_MAX_LANES];
+  clib_chacha20_poly1305_ctx_t *cp[CHACHA20_MAX_LANES];
+  const u8 *keys[CHACHA20_MAX_LANES], *nonces[CHACHA20_MAX_LANES];
+  const u8 *src[CHACHA20_MAX_LANES];
+  u8 *dst[CHACHA20_MAX_LANES];
+  u32 len[CHACHA20_MAX_LANES];
+  u8 key[32], tag[16];
+  u8 pt[MAX_TEST_DATA_LEN];
+  u8 ct[MAX_TEST_DATA_LEN];
+  static u8 mct[CHACHA20_MAX_LANES][MAX_TEST_DATA_LEN];
+
+  for (int i = 0; i < 32; i++)
+    key[i] = 0x80 + i;
+
+  clib_chacha20_poly1305_enc (key, rfc_2_8_2_nonce, rfc_2_8_2_aad,
+			      sizeof (rfc_2_8_2_aad), sunscreen, ct,
+			      sizeof (sunscreen), tag);
+  if (memcmp (ct, rfc_2_8_2_ct, sizeof (rfc_2_8_2_ct)))
+    return clib_error_return (err, "RFC8439 2.8.2: invalid ciphertext");
+  if (memcmp (tag, rfc_2_8_2_tag, sizeof (tag)))
+    return clib_error_return (err, "RFC8439 2.8.2: invalid tag");
+
+  if (!clib_chacha20_poly1305_dec (key, rfc_2_8_2_nonce, rfc_2_8_2_aad,
+				   sizeof (rfc_2_8_2_aad), rfc_2_8_2_ct, pt,
+				   sizeof (rfc_2_8_2_ct), rfc_2_8_2_tag))
+    return clib_error_return (err, "RFC8439 2.8.2: tag check failed");
+  if (memcmp (pt, sunscreen, sizeof (sunscreen)))
+    return clib_error_return (err, "RFC8439 2.8.2: invalid plaintext");
+
+  tag[15] ^= 1;
+  if (clib_chacha20_poly1305_dec (key, rfc_2_8_2_nonce, rfc_2_8_2_aad,
+				  sizeof (rfc_2_8_2_aad), rfc_2_8_2_ct, pt,
+				  sizeof (rfc_2_8_2_ct), tag))
+    return clib_error_return (err, "RFC8439 2.8.2: corrupted tag accepted");
+
+  for (int i = 0; i < 32; i++)
+    key[i] = i;
+  for (int i = 0; i < sizeof (pt); i++)
+    pt[i] = i;
+
+  FOREACH_ARRAY_ELT (tc, inc_test_cases)
+    {
+      clib_chacha20_poly1305_enc (key, rfc_2_8_2_nonce, 0, 0, pt, ct,
+				  tc->n_bytes, tag);
+      if (memcmp (tc->tag, tag, 16) != 0)
+	return clib_error_return (err, "incremental %u bytes: invalid tag",
+				  tc->n_bytes);
+
+      /* same data, fed in small chunks of different sizes */
+      clib_chacha20_poly1305_init (ctx, key, rfc_2_8_2_nonce);
+      for (u32 off = 0, n = 1; off < tc->n_bytes; off += n, n += 7)
+	{
+	  n = clib_min (n, tc->n_bytes - off);
+	  clib_chacha20_poly1305_enc_update (ctx, pt + off, ct + off, n);
+	}
+      clib_chacha20_poly1305_final (ctx, tag);
+      if (memcmp (tc->tag, tag, 16) != 0)
+	return clib_error_return (
+	  err, "incremental %u bytes: invalid chunked tag", tc->n_bytes);
+
+      if (!clib_chacha20_poly1305_dec (key, rfc_2_8_2_nonce, 0, 0, ct, ct,
+				       tc->n_bytes, tc->tag) ||
+	  memcmp (ct, pt, tc->n_bytes))
+	return clib_error_return (err, "incremental %u bytes: decrypt failed",
+				  tc->n_bytes);
+    }
+
+  /* multi-buffer init, every lane encrypts a different test case */
+  for (int i = 0; i < CHACHA20_MAX_LANES; i++)
+    {
+      cp[i] = ctx + i;
+      keys[i] = key;
+      nonces[i] = rfc_2_8_2_nonce;
+    }
+
+  for (int n = 1; n <= CHACHA20_MAX_LANES; n++)
+    {
+      clib_chacha20_poly1305_init_multi (cp, keys, nonces, n);
+      for (int i = 0; i < n; i++)
+	{
+	  u32 tci = (n + i) % ARRAY_LEN (inc_test_cases);
+	  u32 n_bytes = inc_test_cases[tci].n_bytes;
+	  clib_chacha20_poly1305_enc_update (cp[i], pt, ct, n_bytes);
+	  clib_chacha20_poly1305_final (cp[i], tag);
+	  if (memcmp (inc_test_cases[tci].tag, tag, 16) != 0)
+	    return clib_error_return (
+	      err, "multi-buffer %u lanes, %u bytes: invalid tag", n,
+	      n_bytes);
+	}
+    }
+
+  /* multi-buffer update, lanes of different lengths share the kernel calls
+   * and finish at different blocks */
+  for (int n = 1; n <= CHACHA20_MAX_LANES; n++)
+    {
+      clib_chacha20_poly1305_init_multi (cp, keys, nonces, n);
+      for (int i = 0; i < n; i++)
+	{
+	  src[i] = pt;
+	  dst[i] = mct[i];
+	  len[i] = inc_test_cases[(n + i) % ARRAY_LEN (inc_test_cases)].n_bytes;
+	}
+      clib_chacha20_poly1305_enc_update_multi (cp, src, dst, len, n);
+      for (int i = 0; i < n; i++)
+	{
+	  u32 tci = (n + i) % ARRAY_LEN (inc_test_cases);
+	  clib_chacha20_poly1305_final (cp[i], tag);
+	  if (memcmp (inc_test_cases[tci].tag, tag, 16) != 0)
+	    return clib_error_return (
+	      err, "multi-buffer update %u lanes, %u bytes: invalid tag", n,
+	      len[i]);
+	}
+
+      /* decrypt in place */
+      clib_chacha20_poly1305_init_multi (cp, keys, nonces, n);
+      for (int i = 0; i < n; i++)
+	src[i] = mct[i];
+      clib_chacha20_poly1305_dec_update_multi (cp, src, dst, len, n);
+      for (int i = 0; i < n; i++)
+	{
+	  u32 tci = (n + i) % ARRAY_LEN (inc_test_cases);
+	  if (!clib_chacha20_poly1305_final_verify (
+		cp[i], inc_test_cases[tci].tag, 16) ||
+	      memcmp (mct[i], pt, len[i]))
+	    return clib_error_return (
+	      err, "multi-buffer update %u lanes, %u bytes: decrypt failed", n,
+	      len[i]);
+	}
+    }
+
+  return err;
+}
+
+void __test_perf_fn
+perftest_enc_var_sz (test_perf_t *tp)
+{
+  u32 n = tp->n_ops;
+  u8 *dst = test_mem_alloc (n + 16);
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (n + 16, 0, 0);
+  u8 *tag = test_mem_alloc (16);
+  u8 *key = test_mem_alloc_and_fill_inc_u8 (32, 192, 0);
+  u8 *iv = test_mem_alloc_and_fill_inc_u8 (16, 128, 0);
+
+  test_perf_event_enable (tp);
+  clib_chacha20_poly1305_enc (key, iv, 0, 0, src, dst, n, tag);
+  test_perf_event_disable (tp);
+}
+
+void __test_perf_fn
+perftest_dec_var_sz (test_perf_t *tp)
+{
+  u32 n = tp->n_ops;
+  u8 *dst = test_mem_alloc (n + 16);
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (n + 16, 0, 0);
+  u8 *tag = test_mem_alloc (16);
+  u8 *key = test_mem_alloc_and_fill_inc_u8 (32, 192, 0);
+  u8 *iv = test_mem_alloc_and_fill_inc_u8 (16, 128, 0);
+
+  test_perf_event_enable (tp);
+  clib_chacha20_poly1305_dec (key, iv, 0, 0, src, dst, n, tag);
+  test_perf_event_disable (tp);
+}
+
+/* n_ops 64-byte packets, each with its own key and nonce */
+void __test_perf_fn
+perftest_enc_64byte_multi (test_perf_t *tp)
+{
+  clib_chacha20_poly1305_ctx_t ctx[CHACHA20_MAX_LANES];
+  clib_chacha20_poly1305_ctx_t *cp[CHACHA20_MAX_LANES];
+  const u8 *keys[CHACHA20_MAX_LANES], *nonces[CHACHA20_MAX_LANES];
+  const u8 *srcs[CHACHA20_MAX_LANES];
+  u8 *dsts[CHACHA20_MAX_LANES];
+  u32 lens[CHACHA20_MAX_LANES];
+  u32 n = tp->n_ops;
+  u8 *dst = test_mem_alloc (n * 64);
+  u8 *src = test_mem_alloc_and_fill_inc_u8 (n * 64, 0, 0);
+  u8 *tag = test_mem_alloc (n * 16);
+  u8 *key = test_mem_alloc_and_fill_inc_u8 (n * 32, 192, 0);
+  u8 *iv = test_mem_alloc_and_fill_inc_u8 (n * 12, 128, 0);
+
+  for (int i = 0; i < CHACHA20_MAX_LANES; i++)
+    cp[i] = ctx + i;
+
+  test_perf_event_enable (tp);
+  for (u32 i = 0; i < n; i += CHACHA20_MAX_LANES)
+    {
+      u32 n_lanes = clib_min (n - i, CHACHA20_MAX_LANES);
+      for (u32 j = 0; j < n_lanes; j++)
+	{
+	  keys[j] = key + (i + j) * 32;
+	  nonces[j] = iv + (i + j) * 12;
+	  srcs[j] = src + (i + j) * 64;
+	  dsts[j] = dst + (i + j) * 64;
+	  lens[j] = 64;
+	}
+      clib_chacha20_poly1305_init_multi (cp, keys, nonces, n_lanes);
+      clib_chacha20_poly1305_enc_update_multi (cp, srcs, dsts, lens, n_lanes);
+      for (u32 j = 0; j < n_lanes; j++)
+	clib_chacha20_poly1305_final (cp[j], tag + (i + j) * 16);
+    }
+  test_perf_event_disable (tp);
+}
+
+REGISTER_TEST (clib_chacha20_poly1305) = {
+  .name = "clib_chacha20_poly1305",
+  .fn = test_clib_chacha20_poly1305,
+  .perf_tests = PERF_TESTS (
+    { .name = "enc variable size (per byte)",
+      .n_ops = 1424,
+      .fn = perftest_enc_var_sz },
+    { .name = "enc variable size (per byte)",
+      .n_ops = 9008,
+      .fn = perftest_enc_var_sz },
+    { .name = "dec variable size (per byte)",
+      .n_ops = 1424,
+      .fn = perftest_dec_var_sz },
+    { .name = "dec variable size (per byte)",
+      .n_ops = 9008,
+      .fn = perftest_dec_var_sz },
+    { .name = "enc 64 byte packets, multi-buffer",
+      .n_ops = 1024,
+      .fn = perftest_enc_64byte_multi }),
+};
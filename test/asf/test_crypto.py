@@ -24,6 +24,14 @@ class TestCrypto(VppAsfTestCase):
             self.logger.critical(error)
         self.assertNotIn("FAIL", error)
 
+    def test_crypto_reorder(self):
+        """Crypto async frame reorder Unit Tests"""
+        error = self.vapi.cli("test crypto reorder")
+
+        if error:
+            self.logger.critical(error)
+        self.assertIn("OK", error)
+
 
 if __name__ == "__main__":
     unittest.main(testRunner=VppTestRunner)
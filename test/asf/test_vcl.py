@@ -503,6 +503,28 @@ class VCLCutThruTestCase(VCLTestCase):
             self.client_bi_dir_nsock_test_args,
         )
 
+    def test_vcl_cut_thru_ring_bi_dir_nsock(self):
+        """run VCL cut thru completion ring bi-directional test"""
+
+        self.timeout = self.client_bi_dir_nsock_timeout
+        self.cut_thru_test(
+            "vcl_test_server",
+            self.server_args,
+            "vcl_test_client",
+            ["-r"] + self.client_bi_dir_nsock_test_args,
+        )
+
+    def test_vcl_cut_thru_ring_uni_dir_nsock(self):
+        """run VCL cut thru completion ring uni-directional test"""
+
+        self.timeout = self.client_uni_dir_nsock_timeout
+        self.cut_thru_test(
+            "vcl_test_server",
+            self.server_args,
+            "vcl_test_client",
+            ["-r"] + self.client_uni_dir_nsock_test_args,
+        )
+
 
 @unittest.skipIf(
     "hs_apps" in config.excluded_plugins, "Exclude tests requiring hs_apps plugin"
@@ -366,17 +366,21 @@ class TestClassifier(VppTestCase):
                 "didn't arrive" % (dst_if.name, i.name),
             )
 
-    def create_classify_table(self, key, mask, data_offset=0, next_table_index=None):
+    def create_classify_table(
+        self, key, mask, data_offset=0, next_table_index=None, nbuckets=2
+    ):
         """Create Classify Table
 
         :param str key: key for classify table (ex, ACL name).
         :param str mask: mask value for interested traffic.
         :param int data_offset:
         :param str next_table_index
+        :param int nbuckets: number of hash buckets.
         """
         mask_match, mask_match_len = self._resolve_mask_match(mask)
         r = self.vapi.classify_add_del_table(
             is_add=1,
+            nbuckets=nbuckets,
             mask=mask_match,
             mask_len=mask_match_len,
             match_n_vectors=(len(mask) - 1) // 32 + 1,
@@ -338,18 +338,23 @@ class IpsecTcpTests(IpsecTcp):
 class IpsecTra4(object):
     """verify methods for Transport v4"""
 
-    def get_replay_counts(self, p):
-        replay_node_name = "/err/%s/replay" % self.tra4_decrypt_node_name[0]
+    def get_replay_counts(self, p, err="replay"):
+        replay_node_name = "/err/%s/%s" % (self.tra4_decrypt_node_name[0], err)
         count = self.statistics.get_err_counter(replay_node_name)
 
         if p.async_mode:
-            replay_post_node_name = (
-                "/err/%s/replay" % self.tra4_decrypt_node_name[p.async_mode]
+            replay_post_node_name = "/err/%s/%s" % (
+                self.tra4_decrypt_node_name[p.async_mode],
+                err,
             )
             count += self.statistics.get_err_counter(replay_post_node_name)
 
         return count
 
+    def get_late_counts(self, p):
+        # packets left of the window, duplicates are counted as replay
+        return self.get_replay_counts(p, "late")
+
     def get_hash_failed_counts(self, p):
         if ESP == self.encryption_type and p.crypt_algo in ("AES-GCM", "AES-NULL-GMAC"):
             hash_failed_node_name = (
@@ -641,6 +646,8 @@ class IpsecTra4(object):
         seq_cycle_node_name = "/err/%s/seq_cycled" % self.tra4_encrypt_node_name
         replay_count = self.get_replay_counts(p)
         initial_sa_node_replay_diff = replay_count - p.tra_sa_in.get_err("replay")
+        late_count = self.get_late_counts(p)
+        initial_sa_node_late_diff = late_count - p.tra_sa_in.get_err("late")
         hash_failed_count = self.get_hash_failed_counts(p)
         seq_cycle_count = self.statistics.get_err_counter(seq_cycle_node_name)
         initial_sa_node_cycled_diff = seq_cycle_count - p.tra_sa_in.get_err(
@@ -691,6 +698,7 @@ class IpsecTra4(object):
         self.assertEqual(self.get_replay_counts(p), replay_count)
         err = p.tra_sa_in.get_err("replay") + initial_sa_node_replay_diff
         self.assertEqual(err, replay_count)
+        self.assertEqual(self.get_late_counts(p), late_count)
 
         #
         # now send a batch of packets all with the same sequence number
@@ -709,6 +717,7 @@ class IpsecTra4(object):
         self.assertEqual(self.get_replay_counts(p), replay_count)
         err = p.tra_sa_in.get_err("replay") + initial_sa_node_replay_diff
         self.assertEqual(err, replay_count)
+        self.assertEqual(self.get_late_counts(p), late_count)
 
         #
         # now move the window over to anti_replay_window_size + 100 and into Case A
@@ -730,6 +739,7 @@ class IpsecTra4(object):
         self.assertEqual(self.get_replay_counts(p), replay_count)
         err = p.tra_sa_in.get_err("replay") + initial_sa_node_replay_diff
         self.assertEqual(err, replay_count)
+        self.assertEqual(self.get_late_counts(p), late_count)
 
         # the window size is anti_replay_window_size packets
         # in window are still accepted
@@ -810,12 +820,15 @@ class IpsecTra4(object):
             if hash_err != "":
                 err = p.tra_sa_in.get_err(hash_err) + initial_sa_node_hash_diff
                 self.assertEqual(err, hash_failed_count)
+            self.assertEqual(self.get_late_counts(p), late_count)
 
         else:
-            replay_count += 17
+            # left of the window, counted as late and not as replay
+            late_count += 17
+            self.assertEqual(self.get_late_counts(p), late_count)
+            err = p.tra_sa_in.get_err("late") + initial_sa_node_late_diff
+            self.assertEqual(err, late_count)
             self.assertEqual(self.get_replay_counts(p), replay_count)
-            err = p.tra_sa_in.get_err("replay") + initial_sa_node_replay_diff
-            self.assertEqual(err, replay_count)
 
         # valid packet moves the window over to anti_replay_window_size + 258
         pkt = Ether(
@@ -1101,6 +1114,7 @@ class IpsecTra4(object):
 
         seq_cycle_node_name = "/err/%s/seq_cycled" % self.tra4_encrypt_node_name
         replay_count = self.get_replay_counts(p)
+        late_count = self.get_late_counts(p)
         hash_failed_count = self.get_hash_failed_counts(p)
         seq_cycle_count = self.statistics.get_err_counter(seq_cycle_node_name)
 
@@ -1195,6 +1209,7 @@ class IpsecTra4(object):
         # some packets are rejected by the pre-crypto check
         replay_count += 5
         self.assertEqual(self.get_replay_counts(p), replay_count)
+        self.assertEqual(self.get_late_counts(p), late_count)
 
         # out-of-window packets fail integrity check
         hash_failed_count += len(pkts) - 5
@@ -1372,6 +1387,7 @@ class IpsecTra4(object):
         # some packets are rejected by the pre-crypto check
         replay_count += 5
         self.assertEqual(self.get_replay_counts(p), replay_count)
+        self.assertEqual(self.get_late_counts(p), late_count)
 
         # out-of-window packets fail integrity check
         hash_failed_count += len(pkts) - 5
@@ -1457,6 +1473,7 @@ class IpsecTra4(object):
         # some packets are rejected by the pre-crypto check
         replay_count += 5
         self.assertEqual(self.get_replay_counts(p), replay_count)
+        self.assertEqual(self.get_late_counts(p), late_count)
 
         # out-of-window packets fail integrity check
         hash_failed_count += len(pkts) - 5
@@ -1643,6 +1660,7 @@ class IpsecTra4(object):
         # some packets are rejected by the pre-crypto check
         replay_count += 5
         self.assertEqual(self.get_replay_counts(p), replay_count)
+        self.assertEqual(self.get_late_counts(p), late_count)
 
         # out-of-window packets fail integrity check
         hash_failed_count += len(pkts) - 5
@@ -1681,6 +1699,7 @@ class IpsecTra4(object):
 
         seq_cycle_node_name = "/err/%s/seq_cycled" % self.tra4_encrypt_node_name
         replay_count = self.get_replay_counts(p)
+        late_count = self.get_late_counts(p)
         hash_failed_count = self.get_hash_failed_counts(p)
         seq_cycle_count = self.statistics.get_err_counter(seq_cycle_node_name)
 
@@ -1732,7 +1751,8 @@ class IpsecTra4(object):
 
         # out-of-window packets
         self.send_and_assert_no_replies(self.tra_if, pkts, timeout=0.2)
-        replay_count += len(pkts)
+        late_count += len(pkts)
+        self.assertEqual(self.get_late_counts(p), late_count)
         self.assertEqual(self.get_replay_counts(p), replay_count)
 
         """
@@ -1771,6 +1791,7 @@ class IpsecTra4(object):
         # replayed packets
         replay_count += 5
         self.assertEqual(self.get_replay_counts(p), replay_count)
+        self.assertEqual(self.get_late_counts(p), late_count)
 
         """
             case c: Seql > Tl
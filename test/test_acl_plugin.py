@@ -4,6 +4,7 @@
 
 import unittest
 import random
+import re
 
 from config import config
 from scapy.packet import Raw
@@ -229,6 +230,14 @@ class TestACLplugin(VppTestCase):
         acl_if = VppAclInterface(self, sw_if_index=sw_if_index, n_input=1, acls=[acl])
         return acl.acl_index
 
+    def set_lookup_engine(self, engine):
+        """Switch all the ACL lookup contexts to the given lookup engine"""
+        reply = self.vapi.cli("show acl-plugin lookup context")
+        for lc_index in re.findall(r"^index (\d+):", reply, re.M):
+            self.vapi.cli(
+                "set acl-plugin lookup-context %s engine %s" % (lc_index, engine)
+            )
+
     def etype_whitelist(self, whitelist, n_input, add=True):
         # Apply whitelists on all the interfaces
         if add:
@@ -1622,6 +1631,82 @@ class TestACLplugin(VppTestCase):
 
         self.logger.info("ACLP_TEST_FINISH_0315")
 
+    def test_0400_tcp_deny_permit_tree_engine(self):
+        """deny then permit TCPv4/v6 with the tree lookup engine"""
+        self.logger.info("ACLP_TEST_START_0400")
+
+        # Add an ACL
+        rules = []
+        rules.append(
+            self.create_rule(
+                self.IPV4, self.DENY, self.PORTS_RANGE, self.proto[self.IP][self.TCP]
+            )
+        )
+        rules.append(
+            self.create_rule(
+                self.IPV6, self.DENY, self.PORTS_RANGE, self.proto[self.IP][self.TCP]
+            )
+        )
+        # permit ip any any in the end
+        rules.append(self.create_rule(self.IPV4, self.PERMIT, self.PORTS_ALL, 0))
+        rules.append(self.create_rule(self.IPV6, self.PERMIT, self.PORTS_ALL, 0))
+
+        # Apply rules and compile them into decision trees
+        acl_index = self.apply_rules(rules, "deny ip4/ip6 tcp")
+        self.set_lookup_engine("tree")
+
+        # the trees are compiled by a process, off the barrier
+        self.sleep(0.1)
+        reply = self.vapi.cli("show acl-plugin tables tree")
+        self.logger.info(reply)
+        self.assertIn("lc_index", reply)
+
+        # enable counters
+        reply = self.vapi.papi.acl_stats_intf_counters_enable(enable=1)
+
+        # Traffic should not pass
+        self.run_verify_negat_test(
+            self.IP, self.IPRANDOM, self.proto[self.IP][self.TCP]
+        )
+
+        # tree matches are counted per ACE
+        matches = self.statistics.get_counter("/acl/%d/matches" % acl_index)
+        self.logger.info("stat segment counters: %s" % repr(matches))
+        total_hits = sum(m["packets"] for t in matches for m in t[:2])
+        self.assertGreater(total_hits, 0)
+        reply = self.vapi.cli("show acl-plugin tables tree verbose 1")
+        self.logger.info(reply)
+        self.assertRegex(reply, r"rule 0 acl_pos 0 hitcount [1-9]")
+
+        # disable counters
+        reply = self.vapi.papi.acl_stats_intf_counters_enable(enable=0)
+
+        # Replacing the ACL recompiles the trees
+        rules = []
+        rules.append(
+            self.create_rule(
+                self.IPV4, self.PERMIT, self.PORTS_RANGE, self.proto[self.IP][self.TCP]
+            )
+        )
+        rules.append(
+            self.create_rule(
+                self.IPV6, self.PERMIT, self.PORTS_RANGE, self.proto[self.IP][self.TCP]
+            )
+        )
+        # deny ip any any in the end
+        rules.append(self.create_rule(self.IPV4, self.DENY, self.PORTS_ALL, 0))
+        rules.append(self.create_rule(self.IPV6, self.DENY, self.PORTS_ALL, 0))
+        acl = VppAcl(self, rules, acl_index=acl_index, tag="permit ip4/ip6 tcp")
+        acl.add_vpp_config()
+        self.sleep(0.1)
+
+        # Traffic should still pass
+        self.run_verify_test(self.IP, self.IPRANDOM, self.proto[self.IP][self.TCP])
+
+        self.set_lookup_engine("hash")
+
+        self.logger.info("ACLP_TEST_FINISH_0400")
+
 
 if __name__ == "__main__":
     unittest.main(testRunner=VppTestRunner)
@@ -408,3 +408,34 @@ class ACLPluginConnTestCase(VppTestCase):
     def test_3006_tcp_transient_teardown_conn_test(self):
         """IPv6: transient TCP session (3WHS,ACK,FINACK), ref. on egress"""
         self.run_tcp_transient_teardown_conn_test(AF_INET6, 1)
+
+    def test_4000_prepare_for_shared_sessions_test(self):
+        """Prepare for the shared sessions mode tests"""
+        self.vapi.ppcli("set acl-plugin shared-sessions 1")
+        self.vapi.ppcli("set acl-plugin session timeout udp idle 1")
+        self.vapi.ppcli("set acl-plugin session timeout tcp idle 10")
+        self.vapi.ppcli("set acl-plugin session timeout tcp transient 1")
+
+    def test_4001_shared_basic_conn_test(self):
+        """IPv4: shared sessions, basic conn timeout test, ref. on ingress"""
+        self.run_basic_conn_test(AF_INET, 0)
+
+    def test_4002_shared_active_conn_test(self):
+        """IPv4: shared sessions, idle conn behind active conn, ref. on egress"""
+        self.run_active_conn_test(AF_INET, 1)
+
+    def test_4003_shared_clear_conn_test(self):
+        """IPv4: shared sessions, reflect ingress, clear conn"""
+        self.run_clear_conn_test(AF_INET, 0)
+
+    def test_4004_shared_tcp_established_conn_test(self):
+        """IPv6: shared sessions, established TCP session, ref. on ingress"""
+        self.run_tcp_established_conn_test(AF_INET6, 0)
+
+    def test_4005_shared_tcp_transient_teardown_conn_test(self):
+        """IPv6: shared sessions, TCP session (3WHS,ACK,FINACK), ref. on egress"""
+        self.run_tcp_transient_teardown_conn_test(AF_INET6, 1)
+
+    def test_4099_shared_sessions_off(self):
+        """Turn the shared sessions mode off"""
+        self.vapi.ppcli("set acl-plugin shared-sessions 0")
@@ -833,6 +833,195 @@ class TestClassifierComplex(TestClassifier):
         self.pg2.assert_nothing_captured(remark="packets forwarded")
         self.pg3.assert_nothing_captured(remark="packets forwarded")
 
+    def test_iacl_nested_compiled(self):
+        """Nested input ACL test with compiled chain
+
+        Test scenario for nested ACL with and without a compiled chain
+            - Create 1st classifier table, without any entries
+            - Create nested acl matching on ethernet+ip+udp header fields
+            - Send matching and non-matching IPv4 streams pg0 -> pg1
+            - Compile the chain and verify the same packets pass and drop
+        """
+
+        sport = 13720
+        dport = 9080
+        mask = self.build_mac_mask(
+            src_mac="ffffffffffff", dst_mac="ffffffffffff", ether_type="ffff"
+        ) + self.build_ip_mask(
+            proto="ff",
+            src_ip="ffffffff",
+            dst_ip="ffffffff",
+            src_port="ffff",
+            dst_port="ffff",
+        )
+
+        subtable_key = "subtable_compiled"
+        self.create_classify_table(subtable_key, mask, data_offset=-14)
+
+        key = "nested_compiled"
+        self.create_classify_table(
+            key,
+            mask,
+            next_table_index=self.acl_tbl_idx.get(subtable_key),
+            data_offset=-14,
+        )
+
+        self.create_classify_session(
+            self.acl_tbl_idx.get(subtable_key),
+            self.build_mac_match(
+                src_mac=self.pg0.remote_mac,
+                dst_mac=self.pg0.local_mac,
+                # ipv4 next header
+                ether_type="0800",
+            )
+            + self.build_ip_match(
+                proto=socket.IPPROTO_UDP,
+                src_ip=self.pg0.remote_ip4,
+                dst_ip=self.pg1.remote_ip4,
+                src_port=sport,
+                dst_port=dport,
+            ),
+        )
+
+        self.input_acl_set_interface(self.pg0, self.acl_tbl_idx.get(key))
+        self.acl_active_table = key
+
+        def send_and_verify():
+            # session hit in the second table of the chain is forwarded
+            pkts = self.create_stream(
+                self.pg0,
+                self.pg1,
+                self.pg_if_packet_sizes,
+                UDP(sport=sport, dport=dport),
+            )
+            self.pg0.add_stream(pkts)
+            self.pg_enable_capture(self.pg_interfaces)
+            self.pg_start()
+            pkts = self.pg1.get_capture(len(pkts))
+            self.verify_capture(self.pg1, pkts)
+
+            # chain miss is dropped
+            pkts = self.create_stream(
+                self.pg0,
+                self.pg1,
+                self.pg_if_packet_sizes,
+                UDP(sport=sport, dport=dport + 1),
+            )
+            self.pg0.add_stream(pkts)
+            self.pg_enable_capture(self.pg_interfaces)
+            self.pg_start()
+            self.pg1.assert_nothing_captured(remark="packets forwarded")
+            self.pg2.assert_nothing_captured(remark="packets forwarded")
+            self.pg3.assert_nothing_captured(remark="packets forwarded")
+
+        send_and_verify()
+
+        table_index = self.acl_tbl_idx.get(key)
+        self.vapi.cli("classify compile-chain table %d" % table_index)
+        reply = self.vapi.cli("show classify tables index %d" % table_index)
+        self.assertIn("compiled chain", reply)
+
+        send_and_verify()
+
+        self.vapi.cli("classify compile-chain table %d del" % table_index)
+
+    def test_iacl_compiled_sorted(self):
+        """Input ACL test with a sorted compiled chain
+
+        Test scenario for a compiled chain reordered by mask specificity
+            - Create a chain of 3 tables, ip src+dst, 5-tuple and ip src
+              masks, with a session in the last one
+            - Compile the chain and sort it, the 5-tuple table is the new
+              head and the ip src+dst table is now in the middle
+            - Send IPv4 stream pg0 -> pg1 with the acl on the old and then
+              on the new head, verify packets hit the session
+        """
+
+        sport = 13720
+        dport = 9080
+        mac_mask = self.build_mac_mask(
+            src_mac="ffffffffffff", dst_mac="ffffffffffff", ether_type="ffff"
+        )
+        mac_match = self.build_mac_match(
+            src_mac=self.pg0.remote_mac,
+            dst_mac=self.pg0.local_mac,
+            # ipv4 next header
+            ether_type="0800",
+        )
+
+        # with many buckets a hash computed for another table misses
+        key_src = "sorted_src"
+        self.create_classify_table(
+            key_src,
+            mac_mask + self.build_ip_mask(src_ip="ffffffff"),
+            data_offset=-14,
+            nbuckets=1024,
+        )
+        key_5t = "sorted_5tuple"
+        self.create_classify_table(
+            key_5t,
+            mac_mask
+            + self.build_ip_mask(
+                proto="ff",
+                src_ip="ffffffff",
+                dst_ip="ffffffff",
+                src_port="ffff",
+                dst_port="ffff",
+            ),
+            next_table_index=self.acl_tbl_idx.get(key_src),
+            data_offset=-14,
+            nbuckets=1024,
+        )
+        key = "sorted_src_dst"
+        self.create_classify_table(
+            key,
+            mac_mask + self.build_ip_mask(src_ip="ffffffff", dst_ip="ffffffff"),
+            next_table_index=self.acl_tbl_idx.get(key_5t),
+            data_offset=-14,
+            nbuckets=1024,
+        )
+
+        self.create_classify_session(
+            self.acl_tbl_idx.get(key_src),
+            mac_match + self.build_ip_match(src_ip=self.pg0.remote_ip4),
+        )
+
+        table_index = self.acl_tbl_idx.get(key)
+        self.vapi.cli("classify compile-chain table %d" % table_index)
+
+        # sort masks, most specific first
+        r = self.vapi.classify_trace_set_table(table_index=table_index, sort_masks=1)
+        head_index = r.table_index
+        self.assertEqual(head_index, self.acl_tbl_idx.get(key_5t))
+        reply = self.vapi.cli("show classify tables index %d" % head_index)
+        self.assertIn("compiled chain", reply)
+
+        def send_and_verify():
+            pkts = self.create_stream(
+                self.pg0,
+                self.pg1,
+                self.pg_if_packet_sizes,
+                UDP(sport=sport, dport=dport),
+            )
+            self.pg0.add_stream(pkts)
+            self.pg_enable_capture(self.pg_interfaces)
+            self.pg_start()
+            pkts = self.pg1.get_capture(len(pkts))
+            self.verify_capture(self.pg1, pkts)
+
+        # old head now only links to the ip src table
+        self.input_acl_set_interface(self.pg0, table_index)
+        send_and_verify()
+        self.input_acl_set_interface(self.pg0, table_index, 0)
+
+        # new head walks the whole compiled chain
+        self.input_acl_set_interface(self.pg0, head_index)
+        send_and_verify()
+        self.input_acl_set_interface(self.pg0, head_index, 0)
+
+        # drop the trace chain, which deletes its tables
+        self.vapi.classify_trace_set_table()
+
 
 class TestClassifierPBR(TestClassifier):
     """Classifier PBR Test Case"""
@@ -827,6 +827,51 @@ class TestIpsecEspAsync(TemplateIpsecEsp):
         self.p_async.spd.remove_vpp_config()
         self.p_async.sa.remove_vpp_config()
 
+    def test_async_multi_worker(self):
+        """Async frames completed by several workers"""
+        p = self.params[self.p_sync.addr_type]
+        self.vapi.ipsec_set_async_mode(async_enable=True)
+
+        def gen_pkts():
+            pkts = [
+                (
+                    Ether(src=self.pg1.remote_mac, dst=self.pg1.local_mac)
+                    / IP(src=self.pg1.remote_ip4, dst=p.remote_tun_if_host)
+                    / UDP(sport=4444, dport=4444)
+                    / Raw(b"0x0" * 200)
+                )
+            ]
+            return pkts * 1023
+
+        def verify(rxs):
+            for rx in rxs:
+                self.assertEqual(rx[ESP].spi, p.vpp_tun_spi)
+                p.vpp_tun_sa.decrypt(rx[IP])
+
+        # worker 0 does no crypto, so worker 1 processes all the batches
+        # of the frames enqueued on worker 0
+        self.vapi.cli("set sw_scheduler worker 0 crypto off")
+        rxs = self.send_and_expect(self.pg1, gen_pkts(), self.pg0, worker=0)
+        verify(rxs)
+        reply = self.vapi.cli("show sw_scheduler workers")
+        self.logger.info(reply)
+        # ID Name Crypto Numa Stolen-batches Stolen-elts Remote-batches
+        stolen = int(reply.splitlines()[2].split()[-2])
+        self.assertGreaterEqual(stolen, 1023)
+
+        # both workers share the batches of the same frames
+        self.vapi.cli("set sw_scheduler worker 0 crypto on")
+        for worker in [0, 1]:
+            rxs = self.send_and_expect(self.pg1, gen_pkts(), self.pg0, worker=worker)
+            verify(rxs)
+        self.logger.info(self.vapi.cli("show sw_scheduler workers"))
+
+        self.p_sync.spd.remove_vpp_config()
+        self.p_sync.sa.remove_vpp_config()
+        self.p_async.spd.remove_vpp_config()
+        self.p_async.sa.remove_vpp_config()
+        self.vapi.ipsec_set_async_mode(async_enable=False)
+
 
 class TestIpsecEspHandoff(
     TemplateIpsecEsp, IpsecTun6HandoffTests, IpsecTun4HandoffTests
@@ -836,6 +881,77 @@ class TestIpsecEspHandoff(
     pass
 
 
+class TestIpsecEspMultiWorker(TemplateIpsecEsp):
+    """Ipsec ESP - multi-worker SA tests"""
+
+    vpp_worker_count = 2
+
+    def setUp(self):
+        super(TemplateIpsecEsp, self).setUp()
+        saf = VppEnum.vl_api_ipsec_sad_flags_t
+        for p in self.params.values():
+            p.flags |= saf.IPSEC_API_SAD_FLAG_MULTI_WORKER
+        self.config_anti_replay(self.params.values())
+        self.config_network(self.params.values())
+
+    def test_tun_multi_worker_44(self):
+        """ipsec 4o4 tunnel SA on all workers"""
+        self.vapi.cli("clear errors")
+        self.vapi.cli("clear ipsec sa")
+
+        N_PKTS = 15
+        p = self.params[socket.AF_INET]
+        seqs = set()
+
+        # inject alternately on worker 0 and 1, nothing is handed off
+        for worker in [0, 1, 0, 1]:
+            send_pkts = self.gen_encrypt_pkts(
+                p,
+                p.scapy_tun_sa,
+                self.tun_if,
+                src=p.remote_tun_if_host,
+                dst=self.pg1.remote_ip4,
+                count=N_PKTS,
+            )
+            recv_pkts = self.send_and_expect(
+                self.tun_if, send_pkts, self.pg1, worker=worker
+            )
+            self.verify_decrypted(p, recv_pkts)
+
+            send_pkts = self.gen_pkts(
+                self.pg1,
+                src=self.pg1.remote_ip4,
+                dst=p.remote_tun_if_host,
+                count=N_PKTS,
+            )
+            recv_pkts = self.send_and_expect(
+                self.pg1, send_pkts, self.tun_if, worker=worker
+            )
+            self.verify_encrypted(p, p.vpp_tun_sa, recv_pkts)
+            seqs.update(rx[ESP].seq for rx in recv_pkts)
+
+        # each worker draws from its own block of sequence numbers
+        self.assertEqual(len(seqs), 4 * N_PKTS)
+
+        for worker in [0, 1]:
+            self.assertEqual(p.tun_sa_in.get_stats(worker)["packets"], 2 * N_PKTS)
+            self.assertEqual(p.tun_sa_out.get_stats(worker)["packets"], 2 * N_PKTS)
+
+        # a replay is caught whichever worker receives it
+        replay = self.gen_encrypt_pkts(
+            p,
+            p.scapy_tun_sa,
+            self.tun_if,
+            src=p.remote_tun_if_host,
+            dst=self.pg1.remote_ip4,
+            count=1,
+        )
+        self.send_and_expect(self.tun_if, replay, self.pg1, worker=0)
+        self.pg_send(self.tun_if, replay, worker=1)
+        self.pg1.assert_nothing_captured()
+        self.assertEqual(p.tun_sa_in.get_err("replay"), 1)
+
+
 class TemplateIpsecEspUdp(ConfigIpsecESP):
     """
     UDP encapped ESP
@@ -1194,6 +1310,7 @@ class RunTestIpsecEspAll(ConfigIpsecESP, IpsecTra4, IpsecTra6, IpsecTun4, IpsecT
         if flag & saf.IPSEC_API_SAD_FLAG_USE_ANTI_REPLAY:
             for anti_replay_window_size in (
                 64,
+                4096,
                 131072,
             ):
                 self.unconfig_network()
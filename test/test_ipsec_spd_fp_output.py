@@ -174,6 +174,185 @@ class IPSec4SpdTestCaseAddPortRange(SpdFastPathOutbound):
         self.verify_policy_match(0, policy_1)
 
 
+class IPSec4SpdTestCaseUnalignedPortRange(SpdFastPathOutbound):
+    """ IPSec/IPv4 outbound: Policy mode test case with fast path \
+        (port ranges expanded to prefixes, then removed)"""
+
+    def test_ipsec_spd_outbound_unaligned_port_range(self):
+        # Port ranges which are not a single prefix are expanded to
+        # several fast path entries. A HIGH priority BYPASS rule covers
+        # local ports 1000-2000 and a LOW priority DISCARD rule covers
+        # all ports. Port 2000 is inside the BYPASS range, port 2001 is
+        # outside of it but inside its covering prefix 0-2047.
+        self.create_interfaces(2)
+        pkt_count = 5
+        self.spd_create_and_intf_add(1, [self.pg1])
+        policy_0 = self.spd_add_rem_policy(  # outbound, priority 10
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=10,
+            policy_type="bypass",
+            all_ips=True,
+            local_port_start=1000,
+            local_port_stop=2000,
+        )
+        policy_1 = self.spd_add_rem_policy(  # outbound, priority 5
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=5,
+            policy_type="discard",
+            all_ips=True,
+        )
+
+        # inside the range - bypassed
+        packets = self.create_stream(self.pg0, self.pg1, pkt_count, 2000, 5444)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        capture = self.pg1.get_capture()
+        self.pg0.assert_nothing_captured()
+        self.verify_capture(self.pg0, self.pg1, capture)
+        self.verify_policy_match(pkt_count, policy_0)
+        self.verify_policy_match(0, policy_1)
+
+        # just past the range - discarded
+        packets = self.create_stream(self.pg0, self.pg1, pkt_count, 2001, 5444)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        self.pg0.assert_nothing_captured()
+        self.pg1.assert_nothing_captured()
+        self.verify_policy_match(pkt_count, policy_0)
+        self.verify_policy_match(pkt_count, policy_1)
+
+        # removing the expanded rule removes all of its entries
+        self.spd_add_rem_policy(  # outbound, priority 10
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=10,
+            policy_type="bypass",
+            all_ips=True,
+            local_port_start=1000,
+            local_port_stop=2000,
+            remove=True,
+        )
+        packets = self.create_stream(self.pg0, self.pg1, pkt_count, 1000, 5444)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        self.pg0.assert_nothing_captured()
+        self.pg1.assert_nothing_captured()
+        self.verify_policy_match(pkt_count, policy_0)
+        self.verify_policy_match(2 * pkt_count, policy_1)
+
+
+class IPSec4SpdTestCaseExpansionMaskTypeLimit(SpdFastPathOutbound):
+    """ IPSec/IPv4 outbound: Policy mode test case with fast path \
+        (port range kept on its covering mask past the mask type limit)"""
+
+    def test_ipsec_spd_outbound_expansion_mask_type_limit(self):
+        # Local ports 1000-2000 expand to 7 mask types. Remote ports 3-12
+        # would add 2 more, past the limit of 8, so that range stays on its
+        # covering prefix 0-15 and is checked linearly.
+        self.create_interfaces(2)
+        pkt_count = 5
+        self.spd_create_and_intf_add(1, [self.pg1])
+        policy_0 = self.spd_add_rem_policy(  # outbound, priority 10
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=10,
+            policy_type="bypass",
+            all_ips=True,
+            local_port_start=1000,
+            local_port_stop=2000,
+        )
+        policy_1 = self.spd_add_rem_policy(  # outbound, priority 10
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=10,
+            policy_type="bypass",
+            all_ips=True,
+            remote_port_start=3,
+            remote_port_stop=12,
+        )
+        policy_2 = self.spd_add_rem_policy(  # outbound, priority 5
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=5,
+            policy_type="discard",
+            all_ips=True,
+        )
+
+        # inside the remote range - bypassed
+        packets = self.create_stream(self.pg0, self.pg1, pkt_count, 5000, 12)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        capture = self.pg1.get_capture()
+        self.pg0.assert_nothing_captured()
+        self.verify_capture(self.pg0, self.pg1, capture)
+        self.verify_policy_match(0, policy_0)
+        self.verify_policy_match(pkt_count, policy_1)
+        self.verify_policy_match(0, policy_2)
+
+        # inside the covering prefix only - discarded
+        packets = self.create_stream(self.pg0, self.pg1, pkt_count, 5000, 13)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        self.pg0.assert_nothing_captured()
+        self.pg1.assert_nothing_captured()
+        self.verify_policy_match(pkt_count, policy_1)
+        self.verify_policy_match(pkt_count, policy_2)
+
+        # the policy is removed from its covering mask entry
+        self.spd_add_rem_policy(  # outbound, priority 10
+            1,
+            self.pg0,
+            self.pg1,
+            socket.IPPROTO_UDP,
+            is_out=1,
+            priority=10,
+            policy_type="bypass",
+            all_ips=True,
+            remote_port_start=3,
+            remote_port_stop=12,
+            remove=True,
+        )
+        packets = self.create_stream(self.pg0, self.pg1, pkt_count, 5000, 12)
+        self.pg0.add_stream(packets)
+        self.pg0.enable_capture()
+        self.pg1.enable_capture()
+        self.pg_start()
+        self.pg0.assert_nothing_captured()
+        self.pg1.assert_nothing_captured()
+        self.verify_policy_match(pkt_count, policy_1)
+        self.verify_policy_match(2 * pkt_count, policy_2)
+
+
 class IPSec4SpdTestCaseAddIPRange(SpdFastPathOutbound):
     """ IPSec/IPv4 outbound: Policy mode test case with fast path \
         (add  ips  range with any port rule)"""
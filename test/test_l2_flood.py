@@ -213,6 +213,72 @@ class TestL2Flood(VppTestCase):
             )
         self.vapi.bridge_domain_add_del_v2(bd_id=1, is_add=0)
 
+    def test_flood_order(self):
+        """L2 Flood packet order"""
+
+        #
+        # Create a single bridge Domain with 4 members and a BVI
+        #
+        self.vapi.bridge_domain_add_del_v2(
+            bd_id=1, is_add=1, flood=1, uu_flood=1, forward=1, learn=1
+        )
+        for i in self.pg_interfaces[:4]:
+            self.vapi.sw_interface_set_l2_bridge(
+                rx_sw_if_index=i.sw_if_index, bd_id=1, shg=0
+            )
+        self.vapi.sw_interface_set_l2_bridge(
+            rx_sw_if_index=self.bvi0.sw_if_index,
+            bd_id=1,
+            port_type=L2_PORT_TYPE.BVI,
+        )
+
+        #
+        # numbered broadcasts from pg0 and pg3 at the same time, so that
+        # the flood node sees frames with a different last member per
+        # packet
+        #
+        def stream(src, n):
+            return [
+                (
+                    Ether(dst="ff:ff:ff:ff:ff:ff", src=src)
+                    / IP(src="10.10.10.10", dst="1.1.1.1")
+                    / UDP(sport=1000 + j, dport=1234)
+                    / Raw(b"\xa5" * 100)
+                )
+                for j in range(n)
+            ]
+
+        self.pg0.add_stream(stream("00:00:de:ad:be:00", NUM_PKTS))
+        self.pg3.add_stream(stream("00:00:de:ad:be:03", NUM_PKTS))
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+
+        #
+        # each member receives each sender's packets in the order sent
+        #
+        for i in self.pg_interfaces[:4]:
+            n_expected = NUM_PKTS if i in (self.pg0, self.pg3) else 2 * NUM_PKTS
+            rx = i.get_capture(n_expected, timeout=1)
+            for src in ("00:00:de:ad:be:00", "00:00:de:ad:be:03"):
+                sports = [p[UDP].sport for p in rx if p[Ether].src == src]
+                if sports:
+                    self.assertEqual(sports, list(range(1000, 1000 + NUM_PKTS)))
+
+        #
+        # cleanup
+        #
+        for i in self.pg_interfaces[:4]:
+            self.vapi.sw_interface_set_l2_bridge(
+                rx_sw_if_index=i.sw_if_index, bd_id=1, enable=0
+            )
+        self.vapi.sw_interface_set_l2_bridge(
+            rx_sw_if_index=self.bvi0.sw_if_index,
+            bd_id=1,
+            port_type=L2_PORT_TYPE.BVI,
+            enable=0,
+        )
+        self.vapi.bridge_domain_add_del_v2(bd_id=1, is_add=0)
+
     def test_uu_fwd(self):
         """UU Flood"""
 
@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+
+import unittest
+
+from scapy.layers.l2 import Ether
+
+from config import config
+from framework import VppTestCase
+from asfframework import VppTestRunner
+from util import Host
+
+
+class TestL2LearnQueue(VppTestCase):
+    """L2 Bridge Domain Learn queue Test Case"""
+
+    extra_vpp_config = ["l2learn", "{", "queue-size", "1024", "}"]
+
+    @classmethod
+    def setUpClass(self):
+        super(TestL2LearnQueue, self).setUpClass()
+        self.create_pg_interfaces(range(2))
+
+    @classmethod
+    def tearDownClass(cls):
+        super(TestL2LearnQueue, cls).tearDownClass()
+
+    def create_hosts(self, pg_if, n_hosts_per_if, subnet):
+        """
+        Create required number of host MAC addresses and distribute them among
+        interfaces. Create host IPv4 address for every host MAC address.
+
+        :param int n_hosts_per_if: Number of per interface hosts to
+            create MAC/IPv4 addresses for.
+        """
+
+        hosts = dict()
+        swif = pg_if.sw_if_index
+
+        def mac(j):
+            return "00:00:%02x:ff:%02x:%02x" % (subnet, swif, j)
+
+        def ip(j):
+            return "172.%02u.1%02x.%u" % (subnet, swif, j)
+
+        def h(j):
+            return Host(mac(j), ip(j))
+
+        hosts[swif] = [h(j) for j in range(n_hosts_per_if)]
+
+        return hosts
+
+    def learn_hosts(self, pg_if, hosts):
+        """
+        Create and send per interface L2 MAC broadcast packet stream to
+        let the bridge domain learn these MAC addresses.
+
+        :param dict hosts: dict of hosts per interface
+        """
+
+        swif = pg_if.sw_if_index
+        packets = [Ether(dst="ff:ff:ff:ff:ff:ff", src=host.mac) for host in hosts[swif]]
+        pg_if.add_stream(packets)
+        self.logger.info("Sending broadcast eth frames for MAC learning")
+        self.pg_start()
+
+    def bd_learn_count(self, bd_id):
+        """Learn count of a bridge domain, as shown by the CLI"""
+        reply = self.vapi.cli("show bridge-domain %d" % bd_id)
+        self.logger.info(reply)
+        # BD-ID Index BSN Age(min) Learning U-Forwrd UU-Flood Flooding
+        # ARP-Term arp-ufwd Learn-co Learn-li BVI-Intf
+        return int(reply.splitlines()[1].split()[10])
+
+    def wait_for_learn_count(self, bd_id, count, timeout=5):
+        for i in range(int(timeout / 0.1)):
+            if self.bd_learn_count(bd_id) == count:
+                break
+            self.sleep(0.1)
+        self.assertEqual(self.bd_learn_count(bd_id), count)
+
+    def test_l2bd_learn_queue_limit(self):
+        """L2BD learn queue with bridge domain limit and flush"""
+        self.vapi.bridge_domain_set_learn_limit(1, 5)
+
+        hosts = self.create_hosts(self.pg_interfaces[0], 20, 2)
+        self.learn_hosts(self.pg_interfaces[0], hosts)
+
+        # the learner applies the queued updates up to the limit
+        self.wait_for_learn_count(1, 5)
+        self.assertEqual(len(self.vapi.l2_fib_table_dump(1)), 5)
+
+        # the ager pass started by the flush deletes the entries and
+        # gives the learn count back
+        self.vapi.l2fib_flush_bd(bd_id=1)
+        self.wait_for_learn_count(1, 0)
+        self.assertEqual(len(self.vapi.l2_fib_table_dump(1)), 0)
+
+        # so that as many new macs can be learned again
+        hosts = self.create_hosts(self.pg_interfaces[0], 20, 3)
+        self.learn_hosts(self.pg_interfaces[0], hosts)
+        self.wait_for_learn_count(1, 5)
+        self.assertEqual(len(self.vapi.l2_fib_table_dump(1)), 5)
+
+    @unittest.skipUnless(config.extended, "part of extended tests")
+    def test_l2bd_learn_queue_ageing(self):
+        """L2BD learn queue with mac ageing"""
+        hosts = self.create_hosts(self.pg_interfaces[1], 10, 4)
+        self.learn_hosts(self.pg_interfaces[1], hosts)
+        self.wait_for_learn_count(1, 10)
+
+        # the aging wheel checks every entry once a minute, age after 1 min
+        self.vapi.cli("set bridge-domain mac-age 1 1")
+        self.wait_for_learn_count(1, 0, timeout=150)
+        self.assertEqual(len(self.vapi.l2_fib_table_dump(1)), 0)
+
+    def setUp(self):
+        super(TestL2LearnQueue, self).setUp()
+
+        self.vapi.bridge_domain_add_del_v2(
+            bd_id=1, is_add=1, flood=1, uu_flood=1, forward=1, learn=1
+        )
+
+        self.vapi.sw_interface_set_l2_bridge(self.pg_interfaces[0].sw_if_index, bd_id=1)
+        self.vapi.sw_interface_set_l2_bridge(self.pg_interfaces[1].sw_if_index, bd_id=1)
+
+    def tearDown(self):
+        super(TestL2LearnQueue, self).tearDown()
+        self.vapi.sw_interface_set_l2_bridge(
+            rx_sw_if_index=self.pg_interfaces[0].sw_if_index, bd_id=1, enable=0
+        )
+        self.vapi.sw_interface_set_l2_bridge(
+            rx_sw_if_index=self.pg_interfaces[1].sw_if_index, bd_id=1, enable=0
+        )
+        self.vapi.bridge_domain_add_del_v2(bd_id=1, is_add=0)
+
+
+if __name__ == "__main__":
+    unittest.main(testRunner=VppTestRunner)
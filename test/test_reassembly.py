@@ -25,6 +25,7 @@ from util import ppp, fragment_rfc791, fragment_rfc8200
 from vpp_gre_interface import VppGreInterface
 from vpp_ip_route import VppIpRoute, VppRoutePath
 from vpp_papi import VppEnum
+from vpp_papi_provider import CliFailedCommandError
 from config import config
 
 # 35 is enough to have >257 400-byte fragments
@@ -589,6 +590,87 @@ Ethernet-Payload.IPv4-Packet.IPv4-Header.Fragment-Offset; Test-case: 5737"""
         self.verify_capture(packets, dropped_packet_indexes)
         self.src_if.assert_nothing_captured()
 
+    def test_lru(self):
+        """least recently used reassembly is evicted at the limit"""
+
+        error_cnt_str = "/err/ip4-full-reassembly-feature/reass_lru_evicted"
+        error_cnt = self.statistics.get_err_counter(error_cnt_str)
+
+        self.vapi.ip_reassembly_set(
+            timeout_ms=1000000,
+            max_reassemblies=1,
+            max_reassembly_length=1000,
+            expire_walk_interval_ms=10000,
+        )
+
+        # leave one reassembly incomplete, then complete another one
+        multi = [
+            (index, frags) for (index, frags, _, _) in self.pkt_infos if len(frags) > 1
+        ]
+        (_, stale), (fresh_index, fresh) = multi[0], multi[1]
+        dropped_packet_indexes = set(
+            index for (index, _, _, _) in self.pkt_infos if index != fresh_index
+        )
+
+        self.pg_enable_capture()
+        self.src_if.add_stream([stale[0]] + fresh)
+        self.pg_start()
+
+        packets = self.dst_if.get_capture(1)
+        self.verify_capture(packets, dropped_packet_indexes)
+        self.src_if.assert_nothing_captured()
+        self.assertEqual(self.statistics.get_err_counter(error_cnt_str), error_cnt + 1)
+
+    @unittest.skipUnless(config.extended, "part of extended tests")
+    def test_throughput(self):
+        """reassembly throughput with 64-fragment datagrams"""
+
+        datagram_count = 256
+        in_flight = 32
+
+        # 8192 bytes of UDP in 128-byte fragments yields 64 fragments each
+        datagrams = [
+            [
+                f
+                for f in fragment_rfc791(
+                    Ether(dst=self.src_if.local_mac, src=self.src_if.remote_mac)
+                    / IP(id=i, src=self.src_if.remote_ip4, dst=self.dst_if.remote_ip4)
+                    / UDP(sport=1234, dport=5678)
+                    / Raw(b"\xa5" * (8192 - 8)),
+                    162,
+                )
+            ]
+            for i in range(datagram_count)
+        ]
+
+        # in order, and interleaved across datagrams in flight as seen when
+        # several senders share the path
+        in_order = [f for frags in datagrams for f in frags]
+        interleaved = [
+            f
+            for base in range(0, datagram_count, in_flight)
+            for fragments in zip(*datagrams[base : base + in_flight])
+            for f in fragments
+        ]
+
+        for name, stream in (("in-order", in_order), ("interleaved", interleaved)):
+            self.vapi.cli("clear runtime")
+            self.pg_enable_capture()
+            self.src_if.add_stream(stream)
+            self.pg_start()
+
+            packets = self.dst_if.get_capture(datagram_count)
+            for p in packets:
+                self.assertEqual(len(p[Raw]), 8192 - 8)
+            self.logger.info(
+                "%s: %u fragments\n%s"
+                % (
+                    name,
+                    len(stream),
+                    self.vapi.ppcli("show runtime ip4-full-reassembly-feature"),
+                )
+            )
+
     @unittest.skipIf(
         "ping" in config.excluded_plugins, "Exclude tests requiring Ping plugin"
     )
@@ -935,6 +1017,35 @@ class TestIPv4SVReassembly(VppTestCase):
             ]
         )
 
+    def test_steering_enable_disable(self):
+        """fragment steering falls back to software handoff"""
+        # pg interfaces cannot offload flows, nothing gets programmed
+        with self.assertRaises(CliFailedCommandError):
+            self.vapi.cli("set ip4-sv-reassembly steering %s" % self.src_if.name)
+        reply = self.vapi.cli("show ip4-sv-reassembly")
+        self.assertNotIn("Fragment steering", reply)
+        with self.assertRaises(CliFailedCommandError):
+            self.vapi.cli(
+                "set ip4-sv-reassembly steering %s disable" % self.src_if.name
+            )
+
+        # and the fragments still go through the reassembly
+        p = (
+            Ether(dst=self.src_if.local_mac, src=self.src_if.remote_mac)
+            / IP(id=1, src=self.src_if.remote_ip4, dst=self.dst_if.remote_ip4)
+            / UDP(sport=1234, dport=5678)
+            / Raw(b"\xa5" * 1000)
+        )
+        fragments = fragment_rfc791(p, 250)
+        self.pg_enable_capture()
+        self.src_if.add_stream(fragments)
+        self.pg_start()
+        c = self.dst_if.get_capture(len(fragments))
+        for sent, recvd in zip(fragments, c):
+            self.assertEqual(sent[IP].src, recvd[IP].src)
+            self.assertEqual(sent[IP].dst, recvd[IP].dst)
+            self.assertEqual(sent[Raw].payload, recvd[Raw].payload)
+
 
 class TestIPv4MWReassembly(VppTestCase):
     """IPv4 Reassembly (multiple workers)"""
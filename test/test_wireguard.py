@@ -2905,6 +2905,104 @@ class WireguardHandoffTests(TestWg):
         peer_1.remove_vpp_config()
         wg0.remove_vpp_config()
 
+    def test_wg_parallel(self):
+        """Parallel mode"""
+
+        port = 12393
+
+        self.vapi.wg_set_parallel_mode(True)
+
+        # Create interfaces
+        wg0 = VppWgInterface(self, self.pg1.local_ip4, port).add_vpp_config()
+        wg0.admin_up()
+        wg0.config_ip4()
+
+        self.pg_enable_capture(self.pg_interfaces)
+        self.pg_start()
+
+        peer_1 = VppWgPeer(
+            self, wg0, self.pg1.remote_ip4, port + 1, ["10.11.3.0/24"]
+        ).add_vpp_config()
+
+        r1 = VppIpRoute(
+            self, "10.11.3.0", 24, [VppRoutePath("10.11.3.1", wg0.sw_if_index)]
+        ).add_vpp_config()
+
+        # skip the first automatic handshake
+        self.pg1.get_capture(1, timeout=HANDSHAKE_JITTER)
+
+        p = peer_1.mk_handshake(self.pg1)
+        rx = self.send_and_expect(self.pg1, [p], self.pg1)
+        peer_1.consume_response(rx[0])
+
+        def mk_data(counter):
+            return (
+                peer_1.mk_tunnel_header(self.pg1)
+                / Wireguard(message_type=4, reserved_zero=0)
+                / WireguardTransport(
+                    receiver_index=peer_1.sender,
+                    counter=counter,
+                    encrypted_encapsulated_packet=peer_1.encrypt_transport(
+                        (
+                            IP(src="10.11.3.1", dst=self.pg0.remote_ip4, ttl=20)
+                            / UDP(sport=222, dport=223)
+                            / Raw()
+                        )
+                    ),
+                )
+            )
+
+        # the peer is decrypted on both workers without a handoff
+        p0 = [mk_data(ii) for ii in range(32)]
+        rxs = self.send_and_expect(self.pg1, p0, self.pg0, worker=0)
+        for rx in rxs:
+            self.assertEqual(rx[IP].ttl, 19)
+        rxs = self.send_and_expect(
+            self.pg1, [mk_data(ii) for ii in range(32, 64)], self.pg0, worker=1
+        )
+        for rx in rxs:
+            self.assertEqual(rx[IP].ttl, 19)
+
+        # the replay window is shared, a counter accepted on worker 0
+        # is a replay on worker 1
+        self.send_and_assert_no_replies(self.pg1, [p0[5]], worker=1)
+
+        # each worker reserves a block of 32 nonces, so sending a block
+        # from each keeps the counters seen by the peer contiguous
+        pe = (
+            Ether(dst=self.pg0.local_mac, src=self.pg0.remote_mac)
+            / IP(src=self.pg0.remote_ip4, dst="10.11.3.2")
+            / UDP(sport=555, dport=556)
+            / Raw(b"\x00" * 80)
+        )
+        rxs = self.send_and_expect(self.pg0, pe * 32, self.pg1, worker=1)
+        peer_1.validate_encapped(rxs, pe)
+        rxs = self.send_and_expect(self.pg0, pe * 32, self.pg1, worker=0)
+        peer_1.validate_encapped(rxs, pe)
+
+        # the nonces are no longer contiguous from here on, only check them
+        def counters(rxs):
+            return [Wireguard(bytes(rx[Raw]))[WireguardTransport].counter for rx in rxs]
+
+        # leave most of worker 1's next block unused, then go serial
+        rxs = self.send_and_expect(self.pg0, pe * 4, self.pg1, worker=1)
+        self.vapi.wg_set_parallel_mode(False)
+        rxs = self.send_and_expect(self.pg0, pe * 40, self.pg1, worker=1)
+        last = max(counters(rxs))
+
+        # the blocks reserved before are dropped when the mode changes, so
+        # the nonces continue from the ones sent serially
+        self.vapi.wg_set_parallel_mode(True)
+        rxs = self.send_and_expect(self.pg0, pe * 4, self.pg1, worker=1)
+        for counter in counters(rxs):
+            self.assertGreater(counter, last)
+
+        r1.remove_vpp_config()
+        peer_1.remove_vpp_config()
+        wg0.remove_vpp_config()
+
+        self.vapi.wg_set_parallel_mode(False)
+
     @unittest.skip("test disabled")
     def test_wg_multi_interface(self):
         """Multi-tunnel on the same port"""